@@ -12,6 +12,7 @@
 #include "em_device.h"
 
 extern void log_panic(const char *fmt, ...);
+extern uint32_t RAIL_GetTime(void);
 
 /// enable preemptive multithreading
 #define configUSE_PREEMPTION                                    1
@@ -65,7 +66,16 @@ extern void log_panic(const char *fmt, ...);
 #define configUSE_APPLICATION_TASK_TAG                          0
 #define configUSE_COUNTING_SEMAPHORES                           1
 #define configUSE_QUEUE_SETS                                    1
-#define configGENERATE_RUN_TIME_STATS                           0
+/**
+ * @brief Task run time statistics
+ *
+ * Run time is accounted in µs, using the radio timebase: it's free running once RAIL has been
+ * initialized (before the scheduler starts) so no extra timer needs to be set up. The 32-bit
+ * counters wrap after about 71 minutes; read them out more often than that.
+ */
+#define configGENERATE_RUN_TIME_STATS                           1
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()                        RAIL_GetTime()
 
 /// Disable coroutines
 #define configUSE_CO_ROUTINES                                   0
@@ -201,16 +201,19 @@ extern void do_log(const unsigned int inLevel, const char *fmt, ...);
 #endif
 
 // SPIFFS_LOCK and SPIFFS_UNLOCK protects spiffs from reentrancy on api level
-// These should be defined on a multithreaded system
-// TODO: define these (using a FreeRTOS mutex?)
+// These take the flash bus lock (Fs::Flash::Lock), which also serializes the filesystem against
+// the other users of the flash; they're implemented in NorFs.cpp
+struct spiffs_t;
+extern void fs_lock(struct spiffs_t *fs);
+extern void fs_unlock(struct spiffs_t *fs);
 
 // define this to enter a mutex if you're running on a multithreaded system
 #ifndef SPIFFS_LOCK
-#define SPIFFS_LOCK(fs)
+#define SPIFFS_LOCK(fs) fs_lock(fs)
 #endif
 // define this to exit a mutex if you're running on a multithreaded system
 #ifndef SPIFFS_UNLOCK
-#define SPIFFS_UNLOCK(fs)
+#define SPIFFS_UNLOCK(fs) fs_unlock(fs)
 #endif
 
 // Enable if only one spiffs instance with constant configuration will exist
@@ -0,0 +1,136 @@
+/**
+ * @file FreeRTOS Configuration (host simulator)
+ *
+ * Same kernel configuration as the firmware, adapted for the POSIX port: priorities, tick rate
+ * and the feature set match the device, so tasks are scheduled the same way.
+ */
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <stdint.h>
+
+#include "em_device.h"
+
+extern void log_panic(const char *fmt, ...);
+extern uint32_t RAIL_GetTime(void);
+
+/// enable preemptive multithreading
+#define configUSE_PREEMPTION                                    1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION                 0
+
+/**
+ * @brief Idle hook
+ *
+ * The idle hook blocks the idle task's thread until the simulator raises an interrupt, instead of
+ * spinning on a host core.
+ */
+#define configUSE_IDLE_HOOK                                     1
+/// Disable tick hook
+#define configUSE_TICK_HOOK                                     0
+
+/// Nominal CPU core clock (same as the device)
+#define configCPU_CLOCK_HZ                                      (SystemCoreClock)
+/// Ticks per second (same as the device)
+#define configTICK_RATE_HZ                                      ((TickType_t) 250)
+
+#define configMAX_PRIORITIES                                    56
+#define configMINIMAL_STACK_SIZE                                ((unsigned short) 130)
+
+#define configMAX_TASK_NAME_LEN                                 (16)
+#define configUSE_TRACE_FACILITY                                1
+#define configUSE_16_BIT_TICKS                                  0
+#define configUSE_TIME_SLICING                                  1
+#define configIDLE_SHOULD_YIELD                                 1
+#define configUSE_MUTEXES                                       1
+#define configQUEUE_REGISTRY_SIZE                               0
+
+/**
+ * @brief Stack overflow checking
+ *
+ * Tasks run on their own pthread stacks (the port only uses the task stack if it's large enough)
+ * so the kernel can't check them; use the address sanitizer instead.
+ */
+#define configCHECK_FOR_STACK_OVERFLOW                          0
+/// Enable recursive mutex
+#define configUSE_RECURSIVE_MUTEXES                             1
+/// Callback on failed malloc
+#define configUSE_MALLOC_FAILED_HOOK                            1
+#define configUSE_APPLICATION_TASK_TAG                          0
+#define configUSE_COUNTING_SEMAPHORES                           1
+#define configUSE_QUEUE_SETS                                    1
+/**
+ * @brief Task run time statistics
+ *
+ * Accounted in µs using the (simulated) radio timebase, same as the device.
+ */
+#define configGENERATE_RUN_TIME_STATS                           1
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()                        RAIL_GetTime()
+
+/// Disable coroutines
+#define configUSE_CO_ROUTINES                                   0
+
+/// Enable software timers
+#define configUSE_TIMERS                                        1
+// Run at middleware priority
+#define configTIMER_TASK_PRIORITY                               (2)
+#define configTIMER_QUEUE_LENGTH                                5
+#define configTIMER_TASK_STACK_DEPTH                            (configMINIMAL_STACK_SIZE * 2)
+
+/*
+ * Enable direct-to-task notifications. Each task should get 4 notification values.
+ */
+#define configUSE_TASK_NOTIFICATIONS                            1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES                   4
+
+/*
+ * Enable thread local storage
+ */
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS                 4
+
+/// Enable static allocation support
+#define configSUPPORT_STATIC_ALLOCATION                         1
+/// Disable dynamic allocation support
+#define configSUPPORT_DYNAMIC_ALLOCATION                        0
+
+/* Set the following definitions to 1 to include the API function, or zero
+to exclude the API function. */
+#define INCLUDE_vTaskPrioritySet                                1
+#define INCLUDE_uxTaskPriorityGet                               1
+#define INCLUDE_vTaskDelete                                     1
+#define INCLUDE_vTaskCleanUpResources                           1
+#define INCLUDE_vTaskSuspend                                    1
+#define INCLUDE_vTaskDelayUntil                                 1
+#define INCLUDE_vTaskDelay                                      1
+#define INCLUDE_eTaskGetState                                   1
+#define INCLUDE_xTimerPendFunctionCall                          1
+
+// routines required for cmsis-rtos2 support
+#define INCLUDE_xTaskGetSchedulerState                          1
+#define INCLUDE_uxTaskGetStackHighWaterMark                     1
+// include various functions for acquiring task handles
+#define INCLUDE_xTaskGetCurrentTaskHandle                       1
+#define INCLUDE_xTaskGetIdleTaskHandle                          1
+
+// mutex functions to include
+#define INCLUDE_xSemaphoreGetMutexHolder                        1
+
+/*
+ * Interrupt priorities: only used by firmware code to configure the (simulated) NVIC, since all
+ * simulated interrupts are serviced at the same level.
+ */
+#define configLIBRARY_LOWEST_INTERRUPT_PRIORITY                 0x07
+#define configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY            5
+
+/**
+ * @brief assert() style helper
+ *
+ * Same semantics as assert() from the C library; we should make this actually do stuff.
+ */
+#define configASSERT( x ) if( ( x ) == 0 ) { \
+    taskDISABLE_INTERRUPTS();\
+    log_panic("FreeRTOS assertion failure: %s (at %s:%u)", #x, __FILE__, __LINE__);\
+    for( ;; );\
+}\
+
+#endif
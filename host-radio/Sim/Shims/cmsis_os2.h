@@ -0,0 +1,76 @@
+/**
+ * @file
+ *
+ * @brief CMSIS-RTOS2 stand-in
+ *
+ * Only the priority definitions are used by the firmware; they're identical to the CMSIS ones, so
+ * tasks run at the same FreeRTOS priorities as on the device.
+ */
+#ifndef SIM_SHIMS_CMSIS_OS2_H
+#define SIM_SHIMS_CMSIS_OS2_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    osPriorityNone                              = 0,
+    osPriorityIdle                              = 1,
+    osPriorityLow                               = 8,
+    osPriorityLow1                              = 8+1,
+    osPriorityLow2                              = 8+2,
+    osPriorityLow3                              = 8+3,
+    osPriorityLow4                              = 8+4,
+    osPriorityLow5                              = 8+5,
+    osPriorityLow6                              = 8+6,
+    osPriorityLow7                              = 8+7,
+    osPriorityBelowNormal                       = 16,
+    osPriorityBelowNormal1                      = 16+1,
+    osPriorityBelowNormal2                      = 16+2,
+    osPriorityBelowNormal3                      = 16+3,
+    osPriorityBelowNormal4                      = 16+4,
+    osPriorityBelowNormal5                      = 16+5,
+    osPriorityBelowNormal6                      = 16+6,
+    osPriorityBelowNormal7                      = 16+7,
+    osPriorityNormal                            = 24,
+    osPriorityNormal1                           = 24+1,
+    osPriorityNormal2                           = 24+2,
+    osPriorityNormal3                           = 24+3,
+    osPriorityNormal4                           = 24+4,
+    osPriorityNormal5                           = 24+5,
+    osPriorityNormal6                           = 24+6,
+    osPriorityNormal7                           = 24+7,
+    osPriorityAboveNormal                       = 32,
+    osPriorityAboveNormal1                      = 32+1,
+    osPriorityAboveNormal2                      = 32+2,
+    osPriorityAboveNormal3                      = 32+3,
+    osPriorityAboveNormal4                      = 32+4,
+    osPriorityAboveNormal5                      = 32+5,
+    osPriorityAboveNormal6                      = 32+6,
+    osPriorityAboveNormal7                      = 32+7,
+    osPriorityHigh                              = 40,
+    osPriorityHigh1                             = 40+1,
+    osPriorityHigh2                             = 40+2,
+    osPriorityHigh3                             = 40+3,
+    osPriorityHigh4                             = 40+4,
+    osPriorityHigh5                             = 40+5,
+    osPriorityHigh6                             = 40+6,
+    osPriorityHigh7                             = 40+7,
+    osPriorityRealtime                          = 48,
+    osPriorityRealtime1                         = 48+1,
+    osPriorityRealtime2                         = 48+2,
+    osPriorityRealtime3                         = 48+3,
+    osPriorityRealtime4                         = 48+4,
+    osPriorityRealtime5                         = 48+5,
+    osPriorityRealtime6                         = 48+6,
+    osPriorityRealtime7                         = 48+7,
+    osPriorityISR                               = 56,
+    osPriorityError                             = -1,
+    osPriorityReserved                          = 0x7FFFFFFF,
+} osPriority_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
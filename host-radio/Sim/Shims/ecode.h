@@ -0,0 +1,17 @@
+/**
+ * @file
+ *
+ * @brief emdrv error codes
+ */
+#ifndef SIM_SHIMS_ECODE_H
+#define SIM_SHIMS_ECODE_H
+
+#include <stdint.h>
+
+typedef uint32_t Ecode_t;
+
+#define ECODE_OK                                ((Ecode_t) 0)
+#define ECODE_EMDRV_SPIDRV_BASE                 ((Ecode_t) 0xF0000000)
+#define ECODE_EMDRV_UARTDRV_BASE                ((Ecode_t) 0xF0001000)
+
+#endif
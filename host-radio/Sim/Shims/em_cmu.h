@@ -0,0 +1,43 @@
+/**
+ * @file
+ *
+ * @brief Clock management unit stand-in
+ *
+ * Clocks are always running in the simulator; all calls are ignored.
+ */
+#ifndef SIM_SHIMS_EM_CMU_H
+#define SIM_SHIMS_EM_CMU_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    cmuClock_LDMA,
+    cmuClock_LDMAXBAR,
+    cmuClock_GPIO,
+    cmuClock_EUSART0,
+    cmuClock_EUSART1,
+    cmuClock_EUSART2,
+    cmuClock_SEMAILBOX,
+    cmuClock_TRACECLK,
+} CMU_Clock_TypeDef;
+
+static inline void CMU_ClockEnable(CMU_Clock_TypeDef clock, bool enable) {
+    (void) clock;
+    (void) enable;
+}
+
+static inline void CMU_ClockDivSet(CMU_Clock_TypeDef clock, uint32_t div) {
+    (void) clock;
+    (void) div;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * @file
+ *
+ * @brief Device header stand-in
+ *
+ * Provides the handful of CMSIS core and device definitions used by the firmware: interrupt
+ * numbers, NVIC configuration (ignored), system reset (which ends the process), the low power
+ * wait instruction (mapped to the simulated interrupt controller) and the device information page.
+ */
+#ifndef SIM_SHIMS_EM_DEVICE_H
+#define SIM_SHIMS_EM_DEVICE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Number of NVIC priority bits (same as the EFR32FG23)
+#define __NVIC_PRIO_BITS                        4
+
+/**
+ * @brief Interrupt numbers
+ *
+ * Only those referenced by the firmware are defined.
+ */
+typedef enum IRQn {
+    FRC_PRI_IRQn                                = 35,
+    FRC_IRQn                                    = 36,
+    MODEM_IRQn                                  = 37,
+    PROTIMER_IRQn                               = 38,
+    RAC_RSM_IRQn                                = 39,
+    RAC_SEQ_IRQn                                = 40,
+    SYNTH_IRQn                                  = 42,
+    RFECA0_IRQn                                 = 43,
+    RFECA1_IRQn                                 = 44,
+    AGC_IRQn                                    = 46,
+    BUFC_IRQn                                   = 47,
+    SYSRTC_APP_IRQn                             = 67,
+} IRQn_Type;
+
+/**
+ * @brief Device information page
+ */
+typedef struct {
+    uint32_t EUI64L;
+    uint32_t EUI64H;
+} DEVINFO_TypeDef;
+
+/// Device information page (filled in by the simulator)
+extern DEVINFO_TypeDef sim_devinfo;
+#define DEVINFO                                 (&sim_devinfo)
+
+/// Core clock frequency
+extern uint32_t SystemCoreClock;
+
+/// Exit status of the simulator process when the firmware resets the system
+#define SIM_RESET_EXIT_STATUS                   3
+
+void sim_wait_for_interrupt(void);
+__attribute__((noreturn)) void sim_system_reset(void);
+
+static inline void NVIC_SetPriorityGrouping(uint32_t group) {
+    (void) group;
+}
+static inline void NVIC_SetPriority(IRQn_Type irq, uint32_t priority) {
+    (void) irq;
+    (void) priority;
+}
+/// The firmware can't be restarted in place; a reset exits with SIM_RESET_EXIT_STATUS instead
+__attribute__((noreturn)) static inline void NVIC_SystemReset(void) {
+    sim_system_reset();
+}
+
+/// Simulated interrupt handlers run in a task (see Sim::Interrupts), so this is never in an ISR
+static inline uint32_t __get_IPSR(void) {
+    return 0;
+}
+
+/// Wait for interrupt: block the idle task until the simulator raises an interrupt
+#define __WFI()                                 sim_wait_for_interrupt()
+/// Interrupts can't be disabled from outside the kernel; panics halt the process instead
+#define __disable_irq()                         do {} while(0)
+/// Breakpoints abort the process (so they're caught by debuggers and sanitizers)
+#define __BKPT(value)                           abort()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
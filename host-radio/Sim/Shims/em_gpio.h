@@ -0,0 +1,51 @@
+/**
+ * @file
+ *
+ * @brief GPIO stand-in
+ *
+ * Pin state is kept in memory by the simulator (see Sim/Gpio.h) so that the host side can observe
+ * outputs such as the interrupt line.
+ */
+#ifndef SIM_SHIMS_EM_GPIO_H
+#define SIM_SHIMS_EM_GPIO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    gpioPortA                                   = 0,
+    gpioPortB                                   = 1,
+    gpioPortC                                   = 2,
+    gpioPortD                                   = 3,
+} GPIO_Port_TypeDef;
+
+typedef enum {
+    gpioModeDisabled,
+    gpioModeInput,
+    gpioModeInputPull,
+    gpioModePushPull,
+    gpioModeWiredAnd,
+    gpioModeWiredAndPullUp,
+} GPIO_Mode_TypeDef;
+
+/*
+ * Ports are taken as plain integers: the firmware stores them that way (see Hw/Indicators.h) and
+ * C++ won't implicitly convert them back to the enum.
+ */
+void GPIO_PinModeSet(unsigned int port, unsigned int pin, GPIO_Mode_TypeDef mode,
+        unsigned int out);
+void GPIO_PinOutSet(unsigned int port, unsigned int pin);
+void GPIO_PinOutClear(unsigned int port, unsigned int pin);
+void GPIO_PinOutToggle(unsigned int port, unsigned int pin);
+unsigned int GPIO_PinOutGet(unsigned int port, unsigned int pin);
+unsigned int GPIO_PinInGet(unsigned int port, unsigned int pin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
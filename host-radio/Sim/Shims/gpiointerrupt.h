@@ -0,0 +1,21 @@
+/**
+ * @file
+ *
+ * @brief GPIO interrupt dispatcher stand-in
+ *
+ * The firmware doesn't use any GPIO interrupts, so there is nothing to dispatch.
+ */
+#ifndef SIM_SHIMS_GPIOINTERRUPT_H
+#define SIM_SHIMS_GPIOINTERRUPT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline void GPIOINT_Init(void) {}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,21 @@
+/**
+ * @file
+ *
+ * @brief RAIL utility plugin stand-in
+ *
+ * The simulated radio needs no plugin configuration; initialization does nothing.
+ */
+#ifndef SIM_SHIMS_PA_CONVERSIONS_EFR32_H
+#define SIM_SHIMS_PA_CONVERSIONS_EFR32_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline void sl_rail_util_pa_init(void) {}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
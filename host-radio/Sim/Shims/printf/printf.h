@@ -0,0 +1,14 @@
+/**
+ * @file
+ *
+ * @brief Embedded printf stand-in
+ *
+ * The firmware's printf implementation is replaced by the C library's.
+ */
+#ifndef SIM_SHIMS_PRINTF_PRINTF_H
+#define SIM_SHIMS_PRINTF_PRINTF_H
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#endif
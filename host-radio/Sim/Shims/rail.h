@@ -0,0 +1,67 @@
+/**
+ * @file
+ *
+ * @brief RAIL stand-in
+ *
+ * Implemented by the simulated radio (see Sim/Radio.h), which carries frames between the firmware
+ * and the simulation. Events are delivered to sl_rail_util_on_event() from the simulated
+ * interrupt context, as on the device.
+ */
+#ifndef SIM_SHIMS_RAIL_H
+#define SIM_SHIMS_RAIL_H
+
+#include <stddef.h>
+
+#include "rail_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+RAIL_Time_t RAIL_GetTime(void);
+
+RAIL_Status_t RAIL_StartRx(RAIL_Handle_t handle, uint16_t channel,
+        const RAIL_SchedulerInfo_t *schedulerInfo);
+RAIL_Status_t RAIL_StartTx(RAIL_Handle_t handle, uint16_t channel, RAIL_TxOptions_t options,
+        const RAIL_SchedulerInfo_t *schedulerInfo);
+RAIL_Status_t RAIL_StartCcaCsmaTx(RAIL_Handle_t handle, uint16_t channel,
+        RAIL_TxOptions_t options, const RAIL_CsmaConfig_t *csmaConfig,
+        const RAIL_SchedulerInfo_t *schedulerInfo);
+uint16_t RAIL_WriteTxFifo(RAIL_Handle_t handle, const uint8_t *dataPtr, uint16_t writeLength,
+        bool reset);
+void RAIL_ResetFifo(RAIL_Handle_t handle, bool txFifo, bool rxFifo);
+
+RAIL_RxPacketHandle_t RAIL_HoldRxPacket(RAIL_Handle_t handle);
+RAIL_RxPacketHandle_t RAIL_GetRxPacketInfo(RAIL_Handle_t handle,
+        RAIL_RxPacketHandle_t packetHandle, RAIL_RxPacketInfo_t *pPacketInfo);
+RAIL_Status_t RAIL_GetRxPacketDetails(RAIL_Handle_t handle, RAIL_RxPacketHandle_t packetHandle,
+        RAIL_RxPacketDetails_t *pPacketDetails);
+RAIL_Status_t RAIL_ReleaseRxPacket(RAIL_Handle_t handle, RAIL_RxPacketHandle_t packetHandle);
+void RAIL_CopyRxPacket(uint8_t *pDest, const RAIL_RxPacketInfo_t *pPacketInfo);
+
+RAIL_Status_t RAIL_IsValidChannel(RAIL_Handle_t handle, uint16_t channel);
+RAIL_Status_t RAIL_GetChannel(RAIL_Handle_t handle, uint16_t *channel);
+RAIL_RadioState_t RAIL_GetRadioState(RAIL_Handle_t handle);
+
+RAIL_TxPowerLevel_t RAIL_ConvertDbmToRaw(RAIL_Handle_t handle, RAIL_TxPowerMode_t mode,
+        RAIL_TxPower_t power);
+RAIL_TxPower_t RAIL_ConvertRawToDbm(RAIL_Handle_t handle, RAIL_TxPowerMode_t mode,
+        RAIL_TxPowerLevel_t powerLevel);
+RAIL_Status_t RAIL_SetTxPower(RAIL_Handle_t handle, RAIL_TxPowerLevel_t powerLevel);
+RAIL_TxPowerLevel_t RAIL_GetTxPower(RAIL_Handle_t handle);
+
+RAIL_Status_t RAIL_ConfigAutoAck(RAIL_Handle_t handle, const RAIL_AutoAckConfig_t *config);
+RAIL_Status_t RAIL_WriteAutoAckFifo(RAIL_Handle_t handle, const uint8_t *ackData,
+        uint8_t ackDataLen);
+
+void RAIL_EnablePaCal(bool enable);
+RAIL_Status_t RAIL_CalibrateIr(RAIL_Handle_t handle, uint32_t *imageRejection);
+RAIL_Status_t RAIL_Calibrate(RAIL_Handle_t handle, RAIL_CalValues_t *calValues,
+        RAIL_CalMask_t calForce);
+RAIL_CalMask_t RAIL_GetPendingCal(RAIL_Handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
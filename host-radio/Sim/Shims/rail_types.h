@@ -0,0 +1,201 @@
+/**
+ * @file
+ *
+ * @brief RAIL type definitions stand-in
+ *
+ * Subset of the RAIL types used by the firmware. Names and semantics follow RAIL, but layouts and
+ * numeric values are the simulator's own.
+ */
+#ifndef SIM_SHIMS_RAIL_TYPES_H
+#define SIM_SHIMS_RAIL_TYPES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void *RAIL_Handle_t;
+typedef uint32_t RAIL_Time_t;
+typedef uint32_t RAIL_TxOptions_t;
+typedef uint32_t RAIL_CalMask_t;
+typedef int16_t RAIL_TxPower_t;
+typedef uint8_t RAIL_TxPowerLevel_t;
+typedef void *RAIL_RxPacketHandle_t;
+
+/**
+ * @brief Status codes
+ */
+typedef enum RAIL_Status {
+    RAIL_STATUS_NO_ERROR                        = 0,
+    RAIL_STATUS_INVALID_PARAMETER               = 1,
+    RAIL_STATUS_INVALID_STATE                   = 2,
+    RAIL_STATUS_INVALID_CALL                    = 3,
+    RAIL_STATUS_SUSPENDED                       = 4,
+} RAIL_Status_t;
+
+typedef uint32_t RAIL_AssertErrorCodes_t;
+
+/**
+ * @brief Radio events
+ */
+typedef uint64_t RAIL_Events_t;
+
+#define RAIL_EVENTS_NONE                        (0ULL)
+#define RAIL_EVENT_RSSI_AVERAGE_DONE            (1ULL << 0)
+#define RAIL_EVENT_RX_ACK_TIMEOUT               (1ULL << 1)
+#define RAIL_EVENT_RX_FIFO_ALMOST_FULL          (1ULL << 2)
+#define RAIL_EVENT_RX_PACKET_RECEIVED           (1ULL << 3)
+#define RAIL_EVENT_RX_PREAMBLE_LOST             (1ULL << 4)
+#define RAIL_EVENT_RX_PREAMBLE_DETECT           (1ULL << 5)
+#define RAIL_EVENT_RX_SYNC1_DETECT              (1ULL << 6)
+#define RAIL_EVENT_RX_SYNC2_DETECT              (1ULL << 7)
+#define RAIL_EVENT_RX_FRAME_ERROR               (1ULL << 8)
+#define RAIL_EVENT_RX_FIFO_FULL                 (1ULL << 9)
+#define RAIL_EVENT_RX_FIFO_OVERFLOW             (1ULL << 10)
+#define RAIL_EVENT_RX_ADDRESS_FILTERED          (1ULL << 11)
+#define RAIL_EVENT_RX_TIMEOUT                   (1ULL << 12)
+#define RAIL_EVENT_SCHEDULED_RX_STARTED         (1ULL << 13)
+#define RAIL_EVENT_RX_SCHEDULED_RX_END          (1ULL << 14)
+#define RAIL_EVENT_RX_SCHEDULED_RX_MISSED       (1ULL << 15)
+#define RAIL_EVENT_RX_PACKET_ABORTED            (1ULL << 16)
+#define RAIL_EVENT_RX_FILTER_PASSED             (1ULL << 17)
+#define RAIL_EVENT_RX_TIMING_LOST               (1ULL << 18)
+#define RAIL_EVENT_RX_TIMING_DETECT             (1ULL << 19)
+#define RAIL_EVENT_RX_CHANNEL_HOPPING_COMPLETE  (1ULL << 20)
+#define RAIL_EVENT_RX_DUTY_CYCLE_RX_END         (1ULL << 21)
+#define RAIL_EVENT_IEEE802154_DATA_REQUEST_COMMAND (1ULL << 22)
+#define RAIL_EVENT_ZWAVE_BEAM                   (1ULL << 23)
+#define RAIL_EVENT_ZWAVE_LR_ACK_REQUEST_COMMAND (1ULL << 24)
+#define RAIL_EVENT_TX_FIFO_ALMOST_EMPTY         (1ULL << 25)
+#define RAIL_EVENT_TX_PACKET_SENT               (1ULL << 26)
+#define RAIL_EVENT_TXACK_PACKET_SENT            (1ULL << 27)
+#define RAIL_EVENT_TX_ABORTED                   (1ULL << 28)
+#define RAIL_EVENT_TXACK_ABORTED                (1ULL << 29)
+#define RAIL_EVENT_TX_BLOCKED                   (1ULL << 30)
+#define RAIL_EVENT_TXACK_BLOCKED                (1ULL << 31)
+#define RAIL_EVENT_TX_UNDERFLOW                 (1ULL << 32)
+#define RAIL_EVENT_TXACK_UNDERFLOW              (1ULL << 33)
+#define RAIL_EVENT_TX_CHANNEL_CLEAR             (1ULL << 34)
+#define RAIL_EVENT_TX_CHANNEL_BUSY              (1ULL << 35)
+#define RAIL_EVENT_TX_CCA_RETRY                 (1ULL << 36)
+#define RAIL_EVENT_TX_START_CCA                 (1ULL << 37)
+#define RAIL_EVENT_TX_STARTED                   (1ULL << 38)
+#define RAIL_EVENT_TX_SCHEDULED_TX_MISSED       (1ULL << 39)
+#define RAIL_EVENT_CONFIG_UNSCHEDULED           (1ULL << 40)
+#define RAIL_EVENT_CONFIG_SCHEDULED             (1ULL << 41)
+#define RAIL_EVENT_SCHEDULER_STATUS             (1ULL << 42)
+#define RAIL_EVENT_CAL_NEEDED                   (1ULL << 43)
+#define RAIL_EVENT_DETECT_RSSI_THRESHOLD        (1ULL << 44)
+#define RAIL_EVENTS_ALL                         (0xFFFFFFFFFFFFFFFFULL)
+
+/**
+ * @brief Radio state (bit mask)
+ */
+typedef enum RAIL_RadioState {
+    RAIL_RF_STATE_INACTIVE                      = 0,
+    RAIL_RF_STATE_ACTIVE                        = (1 << 0),
+    RAIL_RF_STATE_RX                            = (1 << 1),
+    RAIL_RF_STATE_TX                            = (1 << 2),
+    RAIL_RF_STATE_IDLE                          = RAIL_RF_STATE_ACTIVE,
+} RAIL_RadioState_t;
+
+typedef struct RAIL_StateTransitions {
+    RAIL_RadioState_t success;
+    RAIL_RadioState_t error;
+} RAIL_StateTransitions_t;
+
+/**
+ * @brief Automatic acknowledgement configuration
+ */
+typedef struct RAIL_AutoAckConfig {
+    bool enable;
+    uint16_t ackTimeout;
+    RAIL_StateTransitions_t rxTransitions;
+    RAIL_StateTransitions_t txTransitions;
+} RAIL_AutoAckConfig_t;
+
+/**
+ * @brief CSMA-CA configuration
+ */
+typedef struct RAIL_CsmaConfig {
+    uint8_t csmaMinBoExp;
+    uint8_t csmaMaxBoExp;
+    uint8_t csmaTries;
+    int8_t ccaThreshold;
+    uint16_t ccaBackoff;
+    uint16_t ccaDuration;
+    RAIL_Time_t csmaTimeout;
+} RAIL_CsmaConfig_t;
+
+/// Scheduler info (multiprotocol only; unused)
+typedef struct RAIL_SchedulerInfo RAIL_SchedulerInfo_t;
+/// Channel configuration entry (unused)
+typedef struct RAIL_ChannelConfigEntry RAIL_ChannelConfigEntry_t;
+
+/**
+ * @brief Calibration values
+ */
+typedef struct RAIL_CalValues {
+    uint32_t imageRejection;
+} RAIL_CalValues_t;
+
+#define RAIL_CAL_INVALID_VALUE                  (0xFFFFFFFFUL)
+#define RAIL_IRCALVALUES_UNINIT                 {RAIL_CAL_INVALID_VALUE}
+#define RAIL_CAL_ALL_PENDING                    (0x00000000UL)
+
+typedef enum RAIL_TxPowerMode {
+    RAIL_TX_POWER_MODE_2P4GIG_HP,
+    RAIL_TX_POWER_MODE_SUBGIG,
+} RAIL_TxPowerMode_t;
+
+/**
+ * @brief Receive packet status
+ */
+typedef enum RAIL_RxPacketStatus {
+    RAIL_RX_PACKET_NONE                         = 0,
+    RAIL_RX_PACKET_READY_SUCCESS                = 7,
+} RAIL_RxPacketStatus_t;
+
+/**
+ * @brief Basic receive packet information
+ */
+typedef struct RAIL_RxPacketInfo {
+    RAIL_RxPacketStatus_t packetStatus;
+    uint16_t packetBytes;
+    uint16_t firstPortionBytes;
+    uint8_t *firstPortionData;
+    uint8_t *lastPortionData;
+} RAIL_RxPacketInfo_t;
+
+typedef struct RAIL_PacketTimeStamp {
+    RAIL_Time_t packetTime;
+} RAIL_PacketTimeStamp_t;
+
+/**
+ * @brief Detailed receive packet information
+ */
+typedef struct RAIL_RxPacketDetails {
+    RAIL_PacketTimeStamp_t timeReceived;
+    bool crcPassed;
+    bool isAck;
+    int8_t rssi;
+    uint8_t lqi;
+    uint8_t syncWordId;
+    uint8_t subPhyId;
+    uint8_t antennaId;
+    uint8_t channelHoppingChannelIndex;
+    uint16_t channel;
+} RAIL_RxPacketDetails_t;
+
+#define RAIL_RX_PACKET_HANDLE_INVALID           ((RAIL_RxPacketHandle_t) NULL)
+#define RAIL_RX_PACKET_HANDLE_OLDEST            ((RAIL_RxPacketHandle_t) 1)
+#define RAIL_RX_PACKET_HANDLE_NEWEST            ((RAIL_RxPacketHandle_t) 2)
+#define RAIL_RX_PACKET_HANDLE_OLDEST_COMPLETE   ((RAIL_RxPacketHandle_t) 3)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,36 @@
+/**
+ * @file
+ *
+ * @brief SWO trace stand-in
+ *
+ * There is no trace port; output written to it is discarded.
+ */
+#ifndef SIM_SHIMS_SL_DEBUG_SWO_H
+#define SIM_SHIMS_SL_DEBUG_SWO_H
+
+#include <stdint.h>
+
+#include "sl_status.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline sl_status_t sl_debug_swo_init(void) {
+    return SL_STATUS_OK;
+}
+static inline sl_status_t sl_debug_swo_enable_itm(uint32_t channel) {
+    (void) channel;
+    return SL_STATUS_OK;
+}
+static inline sl_status_t sl_debug_swo_write_u8(uint32_t channel, uint8_t byte) {
+    (void) channel;
+    (void) byte;
+    return SL_STATUS_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
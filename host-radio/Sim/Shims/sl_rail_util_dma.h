@@ -0,0 +1,21 @@
+/**
+ * @file
+ *
+ * @brief RAIL utility plugin stand-in
+ *
+ * The simulated radio needs no plugin configuration; initialization does nothing.
+ */
+#ifndef SIM_SHIMS_SL_RAIL_UTIL_DMA_H
+#define SIM_SHIMS_SL_RAIL_UTIL_DMA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline void sl_rail_util_dma_init(void) {}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
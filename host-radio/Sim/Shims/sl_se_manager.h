@@ -0,0 +1,24 @@
+/**
+ * @file
+ *
+ * @brief Secure engine manager stand-in
+ *
+ * The simulator has no secure engine; initialization always succeeds.
+ */
+#ifndef SIM_SHIMS_SL_SE_MANAGER_H
+#define SIM_SHIMS_SL_SE_MANAGER_H
+
+#include "sl_status.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+sl_status_t sl_se_init(void);
+sl_status_t sl_se_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
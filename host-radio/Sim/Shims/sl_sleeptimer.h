@@ -0,0 +1,54 @@
+/**
+ * @file
+ *
+ * @brief Sleeptimer stand-in
+ *
+ * Backed by the simulated low frequency timer (see Sim/Sleeptimer.h), which counts at the same
+ * rate as on the device; timer callbacks are invoked from the simulated interrupt context.
+ */
+#ifndef SIM_SHIMS_SL_SLEEPTIMER_H
+#define SIM_SHIMS_SL_SLEEPTIMER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sl_status.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sl_sleeptimer_timer_handle;
+
+typedef void (*sl_sleeptimer_timer_callback_t)(struct sl_sleeptimer_timer_handle *handle,
+        void *data);
+
+/**
+ * @brief Timer instance
+ */
+typedef struct sl_sleeptimer_timer_handle {
+    /// Argument passed to the callback
+    void *callback_data;
+    /// Invoked when the timer expires
+    sl_sleeptimer_timer_callback_t callback;
+    /// Whether the timer is running
+    bool running;
+    /// Absolute tick at which the timer expires (simulator only)
+    uint64_t expiry;
+} sl_sleeptimer_timer_handle_t;
+
+sl_status_t sl_sleeptimer_init(void);
+
+uint32_t sl_sleeptimer_get_timer_frequency(void);
+uint32_t sl_sleeptimer_get_tick_count(void);
+
+sl_status_t sl_sleeptimer_start_timer(sl_sleeptimer_timer_handle_t *handle, uint32_t timeout,
+        sl_sleeptimer_timer_callback_t callback, void *callback_data, uint8_t priority,
+        uint16_t option_flags);
+sl_status_t sl_sleeptimer_stop_timer(sl_sleeptimer_timer_handle_t *handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,20 @@
+/**
+ * @file
+ *
+ * @brief Gecko SDK status codes
+ */
+#ifndef SIM_SHIMS_SL_STATUS_H
+#define SIM_SHIMS_SL_STATUS_H
+
+#include <stdint.h>
+
+typedef uint32_t sl_status_t;
+
+#define SL_STATUS_OK                            ((sl_status_t) 0x0000)
+#define SL_STATUS_FAIL                          ((sl_status_t) 0x0001)
+#define SL_STATUS_INVALID_STATE                 ((sl_status_t) 0x0002)
+#define SL_STATUS_NOT_READY                     ((sl_status_t) 0x0003)
+#define SL_STATUS_BUSY                          ((sl_status_t) 0x0004)
+#define SL_STATUS_INVALID_PARAMETER             ((sl_status_t) 0x0021)
+
+#endif
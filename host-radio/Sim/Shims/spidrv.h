@@ -0,0 +1,71 @@
+/**
+ * @file
+ *
+ * @brief SPI driver stand-in
+ *
+ * Slave transfers are backed by the simulated host link (see Sim/HostLink.h): a transfer armed by
+ * the firmware is completed once the host has clocked the requested number of bytes, and the
+ * completion callback is invoked from the simulated interrupt context. Benchmarks and fuzzers link
+ * against a stub instead (see Stubs/Spidrv.h), which is driven directly by the caller.
+ *
+ * Master transfers go to the simulated NOR flash (see Sim/NorFlash.h) in all builds.
+ */
+#ifndef SIM_SHIMS_SPIDRV_H
+#define SIM_SHIMS_SPIDRV_H
+
+#include <stdint.h>
+
+#include "ecode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ECODE_EMDRV_SPIDRV_OK                   (ECODE_OK)
+#define ECODE_EMDRV_SPIDRV_ILLEGAL_HANDLE       (ECODE_EMDRV_SPIDRV_BASE | 0x00000001)
+#define ECODE_EMDRV_SPIDRV_PARAM_ERROR          (ECODE_EMDRV_SPIDRV_BASE | 0x00000002)
+#define ECODE_EMDRV_SPIDRV_BUSY                 (ECODE_EMDRV_SPIDRV_BASE | 0x00000003)
+#define ECODE_EMDRV_SPIDRV_TIMEOUT              (ECODE_EMDRV_SPIDRV_BASE | 0x00000004)
+#define ECODE_EMDRV_SPIDRV_ABORTED              (ECODE_EMDRV_SPIDRV_BASE | 0x00000006)
+
+typedef enum {
+    spidrvMaster                                = 0,
+    spidrvSlave                                 = 1,
+} SPIDRV_Type_t;
+
+struct SPIDRV_HandleData;
+
+typedef void (*SPIDRV_Callback_t)(struct SPIDRV_HandleData *handle, Ecode_t transferStatus,
+        int itemsTransferred);
+
+/**
+ * @brief SPI driver instance
+ */
+typedef struct SPIDRV_HandleData {
+    /// Master or slave
+    SPIDRV_Type_t type;
+    /// Instance name (for diagnostics)
+    const char *name;
+} SPIDRV_HandleData_t;
+
+typedef SPIDRV_HandleData_t *SPIDRV_Handle_t;
+
+Ecode_t SPIDRV_SReceive(SPIDRV_Handle_t handle, void *buffer, int count,
+        SPIDRV_Callback_t callback, int timeoutMs);
+Ecode_t SPIDRV_STransmit(SPIDRV_Handle_t handle, const void *buffer, int count,
+        SPIDRV_Callback_t callback, int timeoutMs);
+Ecode_t SPIDRV_AbortTransfer(SPIDRV_Handle_t handle);
+
+Ecode_t SPIDRV_MTransmitB(SPIDRV_Handle_t handle, const void *buffer, int count);
+Ecode_t SPIDRV_MReceiveB(SPIDRV_Handle_t handle, void *buffer, int count);
+Ecode_t SPIDRV_MTransmit(SPIDRV_Handle_t handle, const void *buffer, int count,
+        SPIDRV_Callback_t callback);
+Ecode_t SPIDRV_MReceive(SPIDRV_Handle_t handle, void *buffer, int count,
+        SPIDRV_Callback_t callback);
+Ecode_t SPIDRV_SetBitrate(SPIDRV_Handle_t handle, uint32_t bitRate);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,49 @@
+/**
+ * @file
+ *
+ * @brief UART driver stand-in
+ *
+ * Data transmitted on any UART is written to the simulator's standard error; completion callbacks
+ * are invoked from the simulated interrupt context.
+ */
+#ifndef SIM_SHIMS_UARTDRV_H
+#define SIM_SHIMS_UARTDRV_H
+
+#include <stdint.h>
+
+#include "ecode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ECODE_EMDRV_UARTDRV_OK                  (ECODE_OK)
+#define ECODE_EMDRV_UARTDRV_ILLEGAL_HANDLE      (ECODE_EMDRV_UARTDRV_BASE | 0x00000002)
+#define ECODE_EMDRV_UARTDRV_PARAM_ERROR         (ECODE_EMDRV_UARTDRV_BASE | 0x00000003)
+
+typedef uint32_t UARTDRV_Count_t;
+
+struct UARTDRV_HandleData;
+
+typedef void (*UARTDRV_Callback_t)(struct UARTDRV_HandleData *handle, Ecode_t transferStatus,
+        uint8_t *data, UARTDRV_Count_t transferCount);
+
+/**
+ * @brief UART driver instance
+ */
+typedef struct UARTDRV_HandleData {
+    /// Instance name (for diagnostics)
+    const char *name;
+} UARTDRV_HandleData_t;
+
+typedef UARTDRV_HandleData_t *UARTDRV_Handle_t;
+
+Ecode_t UARTDRV_Transmit(UARTDRV_Handle_t handle, uint8_t *data, UARTDRV_Count_t count,
+        UARTDRV_Callback_t callback);
+Ecode_t UARTDRV_ForceTransmit(UARTDRV_Handle_t handle, uint8_t *data, UARTDRV_Count_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
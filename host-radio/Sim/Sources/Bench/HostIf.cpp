@@ -0,0 +1,143 @@
+/**
+ * @file
+ *
+ * @brief Host interface command benchmarks
+ *
+ * Runs the command handlers' read (response serialization) and write (request parsing) routines
+ * through the real dispatch table, in the same way commands in a batch are executed.
+ */
+#include <string.h>
+
+#include <vector>
+
+#include <etl/array.h>
+#include <BlazeNet/HostIf/Commands.h>
+#include <benchmark/benchmark.h>
+#include <rail.h>
+
+#include "HostIf/Task.h"
+#include "Packet/Handler.h"
+
+#include "Stubs/Fixtures.h"
+
+using namespace Stubs;
+using HostIf::CommandId;
+using Packet::Handler;
+
+/// Buffer large enough for any command's payload
+using PayloadBuffer = etl::array<uint8_t, 256>;
+
+/**
+ * @brief Read out a fixed size response
+ *
+ * @tparam Command Command to execute
+ * @tparam Response Response structure; its size is the number of bytes requested
+ */
+template<CommandId Command, typename Response>
+static void BM_HostIfRead(benchmark::State &state) {
+    PayloadBuffer buffer;
+
+    for(auto _ : state) {
+        const auto ret = HostIf::Task::ExecuteInline(static_cast<uint8_t>(Command), true, {},
+                {buffer.data(), sizeof(Response)});
+        benchmark::DoNotOptimize(ret);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_HostIfRead, CommandId::GetInfo, HostIf::Response::GetInfo);
+BENCHMARK_TEMPLATE(BM_HostIfRead, CommandId::GetStatus, HostIf::Response::GetStatus);
+BENCHMARK_TEMPLATE(BM_HostIfRead, CommandId::IrqConfig, HostIf::Response::IrqConfig);
+BENCHMARK_TEMPLATE(BM_HostIfRead, CommandId::GetPacketQueueStatus,
+        HostIf::Response::GetPacketQueueStatus);
+BENCHMARK_TEMPLATE(BM_HostIfRead, CommandId::GetCounters, HostIf::Response::GetCounters);
+BENCHMARK_TEMPLATE(BM_HostIfRead, CommandId::IrqStatus, HostIf::Response::IrqStatus);
+BENCHMARK_TEMPLATE(BM_HostIfRead, CommandId::StatusSnapshot, HostIf::Response::StatusSnapshot);
+
+/**
+ * @brief Read out a batch of received packets
+ *
+ * Each read copies the packet into the response, then releases it (post-read callback.)
+ */
+static void BM_HostIfReadPacket(benchmark::State &state) {
+    const RxFrame frame(state.range(0));
+    const auto depth = state.range(1);
+    const auto responseSize = sizeof(HostIf::Response::ReadPacket) + frame.data.size();
+
+    PayloadBuffer buffer;
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        for(int64_t i = 0; i < depth; i++) {
+            Handler::HandleRxPacket(frame.info, frame.details);
+        }
+        state.ResumeTiming();
+
+        for(int64_t i = 0; i < depth; i++) {
+            const auto ret = HostIf::Task::ExecuteInline(
+                    static_cast<uint8_t>(CommandId::ReadPacket), true, {},
+                    {buffer.data(), responseSize});
+            benchmark::DoNotOptimize(ret);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * depth);
+    state.SetBytesProcessed(state.iterations() * depth * responseSize);
+}
+BENCHMARK(BM_HostIfReadPacket)->ArgNames({"size", "depth"})->ArgsProduct({{16, 64, 250}, {1, 8}});
+
+/**
+ * @brief Submit a batch of packets for transmission
+ */
+static void BM_HostIfTransmitPacket(benchmark::State &state) {
+    const RxFrame frame(state.range(0));
+    const auto depth = state.range(1);
+
+    // request header, followed by the frame
+    std::vector<uint8_t> request(sizeof(HostIf::Request::TransmitPacket) + frame.data.size());
+
+    HostIf::Request::TransmitPacket hdr{};
+    hdr.priority = static_cast<uint8_t>(Handler::TxPacketPriority::Normal);
+    memcpy(request.data(), &hdr, sizeof(hdr));
+    memcpy(request.data() + sizeof(hdr), frame.data.data(), frame.data.size());
+
+    for(auto _ : state) {
+        for(int64_t i = 0; i < depth; i++) {
+            const auto ret = HostIf::Task::ExecuteInline(
+                    static_cast<uint8_t>(CommandId::TransmitPacket), false, request, {});
+            benchmark::DoNotOptimize(ret);
+        }
+
+        state.PauseTiming();
+        DrainTx();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * depth);
+    state.SetBytesProcessed(state.iterations() * depth * request.size());
+}
+BENCHMARK(BM_HostIfTransmitPacket)->ArgNames({"size", "depth"})
+    ->ArgsProduct({{16, 64, 250}, {1, 8, 15}});
+
+/**
+ * @brief Update the interrupt configuration
+ */
+static void BM_HostIfWriteIrqConfig(benchmark::State &state) {
+    HostIf::Request::IrqConfig request{};
+    request.commandError = 1;
+    request.rxQueueNotEmpty = 1;
+    request.txQueueEmpty = 1;
+
+    const etl::span<const uint8_t> payload{reinterpret_cast<const uint8_t *>(&request),
+        sizeof(request)};
+
+    for(auto _ : state) {
+        const auto ret = HostIf::Task::ExecuteInline(static_cast<uint8_t>(CommandId::IrqConfig),
+                false, payload, {});
+        benchmark::DoNotOptimize(ret);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HostIfWriteIrqConfig);
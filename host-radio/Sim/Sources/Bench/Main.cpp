@@ -0,0 +1,39 @@
+/**
+ * @file
+ *
+ * @brief Firmware microbenchmarks
+ *
+ * Benchmarks the packet handler and host interface hot paths of the firmware core, against a
+ * null RAIL implementation. The scheduler is never started: the code under test is called
+ * directly from the main thread, in the same way it's called from the firmware tasks.
+ *
+ * Accepts the usual Google Benchmark arguments; use `--benchmark_out=FILE
+ * --benchmark_out_format=json` to record results for comparison.
+ */
+#include <benchmark/benchmark.h>
+
+#include "HostIf/IrqManager.h"
+#include "Hw/Clocks.h"
+#include "Hw/Identity.h"
+#include "Log/Logger.h"
+#include "Packet/Handler.h"
+
+int main(int argc, char **argv) {
+    // bring up only what the code under test needs (no tasks)
+    Hw::Clocks::Init();
+    Logger::Init();
+    Hw::Identity::Init();
+
+    HostIf::IrqManager::Init();
+    Packet::Handler::Init();
+
+    benchmark::Initialize(&argc, argv);
+    if(benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return 0;
+}
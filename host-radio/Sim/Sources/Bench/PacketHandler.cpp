@@ -0,0 +1,229 @@
+/**
+ * @file
+ *
+ * @brief Packet handler benchmarks
+ *
+ * Covers the receive and transmit queue operations, and acknowledgement generation, at varying
+ * frame sizes and queue depths. Each benchmark performs a batch of `depth` operations per
+ * iteration, starting from empty queues; setup and cleanup of a batch are not timed.
+ */
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <rail.h>
+
+#include "Packet/Handler.h"
+#include "Radio/Task.h"
+
+#include "Stubs/Fixtures.h"
+
+using namespace Stubs;
+using Packet::Handler;
+
+/// Frame sizes to benchmark (bytes)
+static const std::vector<int64_t> kFrameSizes{16, 64, 255};
+/// Receive queue depths to benchmark; the largest fills most of the receive buffer budget
+static const std::vector<int64_t> kRxDepths{1, 8, 24};
+/// Transmit queue depths to benchmark; the largest fills most of the transmit buffer budget
+static const std::vector<int64_t> kTxDepths{1, 8, 15};
+
+/**
+ * @brief Receive a batch of frames
+ */
+static void BM_HandleRxPacket(benchmark::State &state) {
+    const RxFrame frame(state.range(0));
+    const auto depth = state.range(1);
+
+    for(auto _ : state) {
+        for(int64_t i = 0; i < depth; i++) {
+            benchmark::DoNotOptimize(Handler::HandleRxPacket(frame.info, frame.details));
+        }
+
+        state.PauseTiming();
+        DrainRx();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+BENCHMARK(BM_HandleRxPacket)->ArgNames({"size", "depth"})->ArgsProduct({kFrameSizes, kRxDepths});
+
+/**
+ * @brief Release a batch of received frames (without acknowledgement)
+ */
+static void BM_DiscardRxPacket(benchmark::State &state) {
+    const RxFrame frame(state.range(0));
+    const auto depth = state.range(1);
+
+    std::vector<Handler::RxPacketBuffer *> packets;
+    packets.reserve(depth);
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        for(int64_t i = 0; i < depth; i++) {
+            Handler::HandleRxPacket(frame.info, frame.details);
+        }
+        while(!Handler::GetRxEmptyFlag()) {
+            packets.push_back(Handler::PopRxQueue());
+        }
+        state.ResumeTiming();
+
+        for(auto packet : packets) {
+            Handler::DiscardRxPacket(packet, false);
+        }
+        packets.clear();
+    }
+
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+BENCHMARK(BM_DiscardRxPacket)->ArgNames({"size", "depth"})->ArgsProduct({kFrameSizes, kRxDepths});
+
+/**
+ * @brief Release a batch of received frames that request an acknowledgement
+ *
+ * Each release builds and queues an acknowledgement frame.
+ */
+static void BM_DiscardRxPacketAck(benchmark::State &state) {
+    const RxFrame frame(64, true);
+    const auto depth = state.range(0);
+
+    std::vector<Handler::RxPacketBuffer *> packets;
+    packets.reserve(depth);
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        for(int64_t i = 0; i < depth; i++) {
+            Handler::HandleRxPacket(frame.info, frame.details);
+        }
+        while(!Handler::GetRxEmptyFlag()) {
+            packets.push_back(Handler::PopRxQueue());
+        }
+        state.ResumeTiming();
+
+        for(auto packet : packets) {
+            Handler::DiscardRxPacket(packet, true);
+        }
+        packets.clear();
+
+        state.PauseTiming();
+        DrainTx();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+BENCHMARK(BM_DiscardRxPacketAck)->ArgName("depth")->Arg(1)->Arg(8)->Arg(16);
+
+/**
+ * @brief Queue a batch of frames for transmission
+ *
+ * The first frame of each batch goes straight to the radio; the remainder are queued.
+ */
+static void BM_QueueTxPacket(benchmark::State &state) {
+    const RxFrame frame(state.range(0));
+    const auto depth = state.range(1);
+
+    for(auto _ : state) {
+        for(int64_t i = 0; i < depth; i++) {
+            benchmark::DoNotOptimize(Handler::QueueTxPacket(Handler::TxPacketPriority::Normal,
+                        frame.data));
+        }
+
+        state.PauseTiming();
+        DrainTx();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+BENCHMARK(BM_QueueTxPacket)->ArgNames({"size", "depth"})->ArgsProduct({kFrameSizes, kTxDepths});
+
+/**
+ * @brief Pop a batch of frames from the transmit queues
+ *
+ * Frames are spread across all priorities, so the pops have to search the queues.
+ */
+static void BM_PopTxQueue(benchmark::State &state) {
+    const RxFrame frame(64);
+    const auto depth = state.range(0);
+
+    std::vector<Handler::TxPacketBuffer *> packets;
+    packets.reserve(depth);
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        // one extra frame, which is in flight (and thus not in any queue)
+        for(int64_t i = 0; i <= depth; i++) {
+            Handler::QueueTxPacket(static_cast<Handler::TxPacketPriority>(i % 4), frame.data);
+        }
+        state.ResumeTiming();
+
+        for(int64_t i = 0; i < depth; i++) {
+            packets.push_back(Handler::PopTxQueue());
+        }
+
+        state.PauseTiming();
+        for(auto packet : packets) {
+            Handler::DiscardTxPacket(packet);
+        }
+        packets.clear();
+        DrainTx();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+BENCHMARK(BM_PopTxQueue)->ArgName("depth")->Arg(1)->Arg(8)->Arg(32);
+
+/**
+ * @brief Release a batch of transmitted frames
+ */
+static void BM_DiscardTxPacket(benchmark::State &state) {
+    const RxFrame frame(state.range(0));
+    const auto depth = state.range(1);
+
+    std::vector<Handler::TxPacketBuffer *> packets;
+    packets.reserve(depth);
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        // the first frame is in flight; release it last, as the radio task would
+        for(int64_t i = 0; i < depth; i++) {
+            Handler::QueueTxPacket(Handler::TxPacketPriority::Normal, frame.data);
+        }
+        while(auto packet = Handler::PopTxQueue()) {
+            packets.push_back(packet);
+        }
+        packets.push_back(GetInFlightTx());
+        state.ResumeTiming();
+
+        for(auto packet : packets) {
+            Handler::DiscardTxPacket(packet);
+        }
+        packets.clear();
+    }
+
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+BENCHMARK(BM_DiscardTxPacket)->ArgNames({"size", "depth"})->ArgsProduct({kFrameSizes, kTxDepths});
+
+/**
+ * @brief Build and queue a batch of acknowledgements
+ */
+static void BM_QueueAck(benchmark::State &state) {
+    const RxFrame frame(64, true);
+    const auto depth = state.range(0);
+
+    for(auto _ : state) {
+        for(int64_t i = 0; i < depth; i++) {
+            Radio::Task::QueueAck(frame.data);
+        }
+
+        state.PauseTiming();
+        DrainTx();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+BENCHMARK(BM_QueueAck)->ArgName("depth")->Arg(1)->Arg(8)->Arg(16);
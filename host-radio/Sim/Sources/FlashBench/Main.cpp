@@ -0,0 +1,348 @@
+/**
+ * @file
+ *
+ * @brief Flash throughput benchmark
+ *
+ * Runs the flash driver (Fs::Flash) against the simulated NOR flash, with the scheduler running,
+ * and measures the throughput of reads (at several transfer sizes) and page programs; each case
+ * is run with blocking transfers, then with asynchronous (DMA) transfers. Reads are measured with
+ * the regular read command (at the clock the chip supports for it) and then with the fast read
+ * command, as the driver uses by default. The simulated flash is busy for the typical duration of
+ * each page program, so that case includes the driver's completion polling.
+ *
+ * While each case runs, a task at the lowest priority counts loop iterations: compared to an idle
+ * baseline, this gives the share of CPU time left over for other tasks during flash I/O.
+ *
+ * The flash contents are kept in the file given with `--file` (a temporary file by default.)
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <etl/array.h>
+#include <em_gpio.h>
+#include <sl_sleeptimer.h>
+
+#include "sl_spidrv_eusart_flash_config.h"
+
+#include "Fs/Flash.h"
+#include "Fs/FlashInfo.h"
+#include "Hw/Clocks.h"
+#include "Log/Logger.h"
+#include "Rtos/Rtos.h"
+
+#include "Sim/Interrupts.h"
+#include "Sim/NorFlash.h"
+
+using Clock = std::chrono::steady_clock;
+using Sim::Interrupts;
+using Sim::NorFlash;
+
+/// Flash to simulate
+constexpr static const etl::array<uint8_t, 3> kJedecId{{0xef, 0x40, 0x17}};
+/// Read transfer sizes to measure
+constexpr static const size_t kReadSizes[]{256, 4096, 65536};
+/// Stack size for the benchmark tasks (words)
+constexpr static const size_t kStackSize{4096};
+
+/// Benchmark parameters
+struct Params {
+    /// Flash backing file; if empty, a temporary file is used
+    std::string path;
+    /// Number of bytes to read in each read case
+    size_t readBytes{1024 * 1024};
+    /// Number of pages to program
+    size_t programPages{256};
+};
+
+/// Result of a single benchmark case
+struct Result {
+    /// Name of the case
+    std::string name;
+    /// Whether asynchronous transfers were used
+    bool async;
+    /// Bus clock (Hz)
+    uint32_t bitrate;
+    /// Number of operations performed
+    size_t ops;
+    /// Number of payload bytes transferred
+    size_t bytes;
+    /// Total duration (seconds)
+    double seconds;
+    /// Share of CPU time left over for other tasks
+    double cpuFree;
+    /// Whether all operations succeeded
+    bool ok;
+};
+
+static Params gParams;
+static std::vector<Result> gResults;
+static const Fs::FlashInfo *gInfo{nullptr};
+static Fs::Flash *gFlash{nullptr};
+
+/// Loop iterations of the background task
+static std::atomic<uint64_t> gSpins{0};
+/// Background task loop iterations per second, while the system is otherwise idle
+static double gIdleSpinRate{0};
+
+/**
+ * @brief Background task
+ *
+ * Counts loop iterations; it's preempted by all other tasks and by interrupts, so the rate at
+ * which it counts is proportional to the CPU time not used by them.
+ */
+static void BackgroundMain(void *) {
+    while(true) {
+        gSpins.fetch_add(1, std::memory_order_relaxed);
+        Interrupts::Poll();
+    }
+}
+
+/**
+ * @brief Run a benchmark case
+ *
+ * @param work Invoked to perform the work; returns whether it succeeded
+ */
+static void Measure(const std::string &name, const bool async, const size_t ops,
+        const size_t bytes, std::function<bool()> work) {
+    const auto spins = gSpins.load(std::memory_order_relaxed);
+    const auto start = Clock::now();
+
+    const auto ok = work();
+
+    const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    const auto spinRate = (gSpins.load(std::memory_order_relaxed) - spins) / seconds;
+
+    gResults.push_back({name, async, gFlash->getBitrate(), ops, bytes, seconds,
+            spinRate / gIdleSpinRate, ok});
+}
+
+/**
+ * @brief Benchmark reads of a particular transfer size
+ *
+ * @param label Name of the read command used
+ */
+static void BenchRead(const std::string &label, const size_t chunkSize, const bool async) {
+    static std::vector<uint8_t> buffer;
+    buffer.resize(chunkSize);
+
+    const auto capacity = gFlash->getInfo()->capacityBytes();
+    const auto numChunks = std::max<size_t>(gParams.readBytes / chunkSize, 1);
+
+    Measure(label + " " + std::to_string(chunkSize), async, numChunks, numChunks * chunkSize,
+            [&] {
+        for(size_t i = 0; i < numChunks; i++) {
+            if(gFlash->read((i * chunkSize) % capacity, buffer, async)) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+/**
+ * @brief Benchmark page programs
+ *
+ * The area is erased first (not measured); the programmed data is verified afterwards.
+ */
+static void BenchProgram(const bool async) {
+    const auto pageSize = gFlash->getInfo()->pageSizeBytes();
+    const auto sectorSize = gFlash->getInfo()->sectorSizeBytes();
+    const auto length = ((gParams.programPages * pageSize + sectorSize - 1) / sectorSize) *
+        sectorSize;
+
+    std::vector<uint8_t> data(gParams.programPages * pageSize);
+    for(size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<uint8_t>(i * 7 + async);
+    }
+
+    if(gFlash->erase(0, length)) {
+        gResults.push_back({"page program", async, gFlash->getBitrate(), 0, 0, 0, 0, false});
+        return;
+    }
+
+    Measure("page program", async, gParams.programPages, data.size(), [&] {
+        for(size_t i = 0; i < gParams.programPages; i++) {
+            if(gFlash->writePage(i * pageSize, {data.data() + (i * pageSize), pageSize}, async)) {
+                return false;
+            }
+        }
+        return true;
+    });
+
+    std::vector<uint8_t> readBack(data.size());
+    if(gFlash->read(0, readBack, false) || readBack != data) {
+        gResults.back().ok = false;
+    }
+}
+
+/**
+ * @brief Benchmark task
+ *
+ * Measures the idle baseline, then runs all cases and stops the scheduler.
+ */
+static void BenchMain(void *) {
+    const auto spins = gSpins.load(std::memory_order_relaxed);
+    const auto start = Clock::now();
+    vTaskDelay(pdMS_TO_TICKS(500));
+    gIdleSpinRate = (gSpins.load(std::memory_order_relaxed) - spins) /
+        std::chrono::duration<double>(Clock::now() - start).count();
+
+    // reads, with the regular and fast read commands
+    auto slowInfo = *gInfo;
+    slowInfo.cmdFastRead = 0;
+
+    const Fs::FlashInfo *variants[]{&slowInfo, gInfo};
+
+    for(const auto info : variants) {
+        Fs::Flash flash(info);
+        gFlash = &flash;
+
+        for(const auto async : {false, true}) {
+            for(const auto size : kReadSizes) {
+                BenchRead(info->cmdFastRead ? "fast read" : "read", size, async);
+            }
+        }
+    }
+
+    // page programs
+    Fs::Flash flash(gInfo);
+    gFlash = &flash;
+
+    for(const auto async : {false, true}) {
+        BenchProgram(async);
+    }
+
+    gFlash = nullptr;
+
+    Interrupts::Pend([] {
+        vTaskEndScheduler();
+    });
+    vTaskSuspend(nullptr);
+}
+
+static void Usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--file PATH] [--read-bytes N] [--pages N]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    // parse arguments
+    for(int i = 1; i < argc; i++) {
+        const std::string_view arg{argv[i]};
+
+        if(i + 1 >= argc) {
+            Usage(argv[0]);
+            return 1;
+        }
+        const char *value = argv[++i];
+
+        if(arg == "--file") {
+            gParams.path = value;
+        } else if(arg == "--read-bytes") {
+            gParams.readBytes = strtoul(value, nullptr, 0);
+        } else if(arg == "--pages") {
+            gParams.programPages = strtoul(value, nullptr, 0);
+        } else {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if(!gParams.readBytes) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    bool isTemporary{false};
+    if(gParams.path.empty()) {
+        char path[]{"/tmp/host-flash-bench.XXXXXX"};
+        const auto fd = mkstemp(path);
+        if(fd == -1) {
+            perror("mkstemp");
+            return 1;
+        }
+        close(fd);
+
+        gParams.path = path;
+        isTemporary = true;
+    }
+
+    // bring up only what the flash driver needs
+    Interrupts::Init();
+    Hw::Clocks::Init();
+    Logger::Init();
+    sl_sleeptimer_init();
+
+    if(!Fs::IdentifyFlash(kJedecId, gInfo)) {
+        fprintf(stderr, "unknown flash\n");
+        return 1;
+    }
+
+    GPIO_PinModeSet(SL_SPIDRV_EUSART_FLASH_CS_PORT, SL_SPIDRV_EUSART_FLASH_CS_PIN,
+            gpioModePushPull, true);
+    if(!NorFlash::Open({
+        .path = gParams.path,
+        .info = gInfo,
+        .jedecId = {kJedecId[0], kJedecId[1], kJedecId[2]},
+        .bitrate = SL_SPIDRV_EUSART_FLASH_BITRATE,
+    })) {
+        fprintf(stderr, "failed to attach simulated flash\n");
+        return 1;
+    }
+
+    etl::array<uint8_t, 3> jedecId;
+    if(Fs::Flash::Identify(jedecId) || jedecId != kJedecId) {
+        fprintf(stderr, "failed to identify simulated flash\n");
+        return 1;
+    }
+
+    // run the benchmark
+    static StaticTask_t gBenchTask, gBackgroundTask;
+    static StackType_t gBenchStack[kStackSize], gBackgroundStack[kStackSize];
+
+    xTaskCreateStatic(BenchMain, "Bench", kStackSize, nullptr, Rtos::TaskPriority::AppLow,
+            gBenchStack, &gBenchTask);
+    xTaskCreateStatic(BackgroundMain, "Background", kStackSize, nullptr,
+            Rtos::TaskPriority::Background, gBackgroundStack, &gBackgroundTask);
+
+    vTaskStartScheduler();
+
+    NorFlash::Close();
+    if(isTemporary) {
+        unlink(gParams.path.c_str());
+    }
+
+    // print results
+    bool ok{true};
+    printf("%-16s %-5s %6s %12s %10s %8s\n", "case", "mode", "MHz", "KiB/s", "us/op",
+            "cpu free");
+
+    for(const auto &result : gResults) {
+        const auto kibPerSec = result.seconds ? (result.bytes / result.seconds / 1024.) : 0;
+        const auto usPerOp = result.ops ? (result.seconds * 1e6 / result.ops) : 0;
+
+        printf("%-16s %-5s %6.1f %12.1f %10.1f %7.1f%%%s\n", result.name.c_str(),
+                result.async ? "async" : "block", result.bitrate / 1e6, kibPerSec, usPerOp,
+                result.cpuFree * 100., result.ok ? "" : " (FAILED)");
+        ok &= result.ok;
+    }
+
+    const auto stats = NorFlash::GetStats();
+    if(stats.clockViolations) {
+        printf("%zu commands were clocked faster than the flash supports\n",
+                stats.clockViolations);
+        ok = false;
+    }
+
+    return ok ? 0 : 2;
+}
@@ -0,0 +1,612 @@
+/**
+ * @file
+ *
+ * @brief Filesystem latency benchmark
+ *
+ * Mounts the filesystem (Fs::NorFs) on the simulated NOR flash, with the scheduler running, and
+ * populates it with a set of files. Then it measures the latency of opening, stat-ing and reading
+ * randomly chosen files, first with the block cache (Fs::BlockCache) disabled and then enabled;
+ * SPIFFS' own page cache is in use in both cases.
+ *
+ * Last, it rewrites random files, pausing after every few writes, first without and then with the
+ * maintenance task (Fs::Maintenance) reclaiming space during the pauses. Besides the latency of
+ * the writes, it counts the garbage collection runs that happened inside them.
+ *
+ * Then it compares the key/value store (Fs::KvStore) against SPIFFS for small values: reading
+ * and writing a randomly chosen key, versus a file per key holding the same value. Writes pause
+ * as above, with the maintenance task enabled; for the key/value store, compactions inside writes
+ * are counted as garbage collection runs.
+ *
+ * Last, it prints the wear (sector erase counts) of both partitions.
+ *
+ * The flash contents are kept in the file given with `--file` (a temporary file by default); an
+ * existing filesystem in it is reused, and only missing files are created. Program and erase
+ * times are the flash's typical ones, scaled by `--time-scale`.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <etl/array.h>
+#include <em_gpio.h>
+#include <sl_sleeptimer.h>
+#include <spiffs.h>
+
+#include "sl_spidrv_eusart_flash_config.h"
+
+#include "Fs/BlockCache.h"
+#include "Fs/Flash.h"
+#include "Fs/FlashInfo.h"
+#include "Fs/Init.h"
+#include "Fs/KvStore.h"
+#include "Fs/Maintenance.h"
+#include "Fs/NorFs.h"
+#include "Hw/Clocks.h"
+#include "Log/Logger.h"
+#include "Rtos/Rtos.h"
+
+#include "Sim/Interrupts.h"
+#include "Sim/NorFlash.h"
+
+using Clock = std::chrono::steady_clock;
+using Sim::Interrupts;
+using Sim::NorFlash;
+
+/// Flash to simulate
+constexpr static const etl::array<uint8_t, 3> kJedecId{{0xef, 0x40, 0x17}};
+/// Stack size for the benchmark task (words)
+constexpr static const size_t kStackSize{4096};
+/// Number of rewrites between pauses
+constexpr static const size_t kPauseEvery{50};
+/// Pause between rewrites; long enough for the maintenance task to notice it's quiet
+constexpr static const TickType_t kPause{pdMS_TO_TICKS(1000)};
+/// Size of the key/value store partition (bytes)
+constexpr static const size_t kKvSize{0x10000};
+
+/// Benchmark parameters
+struct Params {
+    /// Flash backing file; if empty, a temporary file is used
+    std::string path;
+    /// Size of the filesystem partition (bytes)
+    size_t fsSize{1024 * 1024};
+    /// Number of files to populate the filesystem with
+    size_t numFiles{64};
+    /// Size of each file (bytes)
+    size_t fileSize{2048};
+    /// Number of operations in each read case
+    size_t ops{1000};
+    /// Number of rewrites in each write case
+    size_t writes{500};
+    /// Number of keys in the key/value cases
+    size_t keys{64};
+    /// Size of each value in the key/value cases (bytes)
+    size_t valueSize{32};
+    /// Factor applied to the flash's typical program and erase times
+    double timeScale{1.};
+};
+
+/// Result of a single benchmark case
+struct Result {
+    /// Name of the case
+    std::string name;
+    /// Configuration the case ran with
+    std::string variant;
+    /// Latency of each operation (µs)
+    std::vector<double> latencies;
+    /// Block cache hits and misses during the case
+    uint32_t hits, misses;
+    /// Bytes read from the flash during the case
+    uint64_t flashBytes;
+    /// Garbage collection runs (or key/value store compactions) inside operations
+    uint32_t foregroundGc;
+    /// Whether all operations succeeded
+    bool ok;
+};
+
+static Params gParams;
+static std::vector<Result> gResults;
+static const Fs::FlashInfo *gInfo{nullptr};
+/// Set if setting up the filesystem failed
+static bool gSetupFailed{false};
+
+/**
+ * @brief Get the name of a test file
+ */
+static std::string GetFileName(const size_t index) {
+    char name[16];
+    snprintf(name, sizeof(name), "bench%04zu", index);
+    return name;
+}
+
+/**
+ * @brief Get the name of the file holding the value of a key
+ */
+static std::string GetValueName(const size_t key) {
+    char name[16];
+    snprintf(name, sizeof(name), "value%04zu", key);
+    return name;
+}
+
+/**
+ * @brief Fill a buffer with the contents of a test file
+ */
+static void FillData(const size_t index, std::vector<uint8_t> &data) {
+    for(size_t j = 0; j < data.size(); j++) {
+        data[j] = static_cast<uint8_t>(index * 31 + j);
+    }
+}
+
+/**
+ * @brief Format (if needed) and mount the filesystem, then mount the key/value store
+ */
+static bool MountFs(Fs::Flash &flash) {
+    static Fs::Superblock gSuper;
+
+    // the filesystem ends where the key/value store starts; there's no log archive
+    gSuper = {};
+    gSuper.fsStart = gInfo->blockSizeBytes();
+    gSuper.kvStart = gSuper.fsStart + gParams.fsSize;
+    gSuper.kvEnd = gSuper.kvStart + kKvSize - 1;
+    gSuper.fsEnd = gSuper.kvStart - 1;
+
+    auto err = Fs::NorFs::Format(&flash, &gSuper);
+    if(!err) {
+        err = Fs::NorFs::Mount(&flash, &gSuper);
+        if(err) {
+            fprintf(stderr, "mount failed: %d\n", err);
+            return false;
+        }
+    } else if(err != Fs::NorFs::Error::AlreadyFormatted) {
+        fprintf(stderr, "format failed: %d\n", err);
+        return false;
+    }
+
+    Fs::KvStore::Init(&flash, gSuper.kvStart, gSuper.kvEnd + 1);
+    if(!Fs::KvStore::IsMounted()) {
+        fprintf(stderr, "key/value store mount failed\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Create (or replace) a file with the given contents
+ */
+static bool WriteFile(spiffs *fs, const std::string &name, std::vector<uint8_t> &data) {
+    const auto fd = SPIFFS_open(fs, name.c_str(),
+            SPIFFS_O_CREAT | SPIFFS_O_TRUNC | SPIFFS_O_RDWR, 0);
+    if(fd < 0) {
+        fprintf(stderr, "create %s failed: %d\n", name.c_str(), fd);
+        return false;
+    }
+
+    const auto written = SPIFFS_write(fs, fd, data.data(), data.size());
+    SPIFFS_close(fs, fd);
+
+    if(written != static_cast<s32_t>(data.size())) {
+        fprintf(stderr, "write %s failed: %d\n", name.c_str(), written);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Create all test files and keys that don't exist yet
+ *
+ * Each key is stored both in the key/value store and in a file of its own.
+ */
+static bool Populate(spiffs *fs) {
+    std::vector<uint8_t> data(gParams.fileSize), value(gParams.valueSize);
+
+    for(size_t i = 0; i < gParams.numFiles; i++) {
+        const auto name = GetFileName(i);
+
+        spiffs_stat stat;
+        if(SPIFFS_stat(fs, name.c_str(), &stat) == SPIFFS_OK && stat.size == data.size()) {
+            continue;
+        }
+
+        FillData(i, data);
+        if(!WriteFile(fs, name, data)) {
+            return false;
+        }
+    }
+
+    for(size_t i = 0; i < gParams.keys; i++) {
+        const auto name = GetValueName(i);
+        FillData(i, value);
+
+        spiffs_stat stat;
+        if(SPIFFS_stat(fs, name.c_str(), &stat) != SPIFFS_OK || stat.size != value.size()) {
+            if(!WriteFile(fs, name, value)) {
+                return false;
+            }
+        }
+
+        std::vector<uint8_t> stored(Fs::KvStore::kMaxValueSize);
+        if(Fs::KvStore::Get(i, stored) != static_cast<int>(value.size())) {
+            const auto err = Fs::KvStore::Put(i, value);
+            if(err) {
+                fprintf(stderr, "put %zu failed: %d\n", i, err);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Run a benchmark case
+ *
+ * @param count Number of operations to perform
+ * @param range Number of files (or keys) to pick from
+ * @param pauseEvery If nonzero, pause for kPause after this many operations
+ * @param op Invoked with the index of a (random) file or key; performs and times one operation,
+ *        and returns whether it succeeded
+ */
+static void Measure(const std::string &name, const std::string &variant, const size_t count,
+        const size_t range, const size_t pauseEvery, std::function<bool(size_t, double &)> op) {
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<size_t> pick(0, range - 1);
+    const auto fs = Fs::NorFs::GetFs();
+
+    Result result{name, variant, {}, 0, 0, 0, 0, true};
+    result.latencies.reserve(count);
+
+    const auto before = Fs::BlockCache::GetStats();
+    const auto flashBefore = NorFlash::GetStats().bytesRead;
+    const auto gcBefore = fs->stats_gc_runs - Fs::Maintenance::GetStats().gcRuns +
+        Fs::KvStore::GetStats().foregroundCompactions;
+
+    for(size_t i = 0; i < count; i++) {
+        if(pauseEvery && i && !(i % pauseEvery)) {
+            vTaskDelay(kPause);
+        }
+
+        double usec{0};
+        if(!op(pick(rng), usec)) {
+            result.ok = false;
+            break;
+        }
+        result.latencies.push_back(usec);
+    }
+
+    const auto after = Fs::BlockCache::GetStats();
+    result.hits = after.hits - before.hits;
+    result.misses = after.misses - before.misses;
+    result.flashBytes = NorFlash::GetStats().bytesRead - flashBefore;
+    result.foregroundGc = (fs->stats_gc_runs - Fs::Maintenance::GetStats().gcRuns +
+            Fs::KvStore::GetStats().foregroundCompactions) - gcBefore;
+
+    gResults.push_back(std::move(result));
+}
+
+/**
+ * @brief Get the time elapsed since the given time, in µs
+ */
+static double Elapsed(const Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Benchmark task
+ *
+ * Set up the filesystem, run all cases and stop the scheduler.
+ */
+static void BenchMain(void *) {
+    Fs::Flash flash(gInfo);
+    spiffs *fs{nullptr};
+
+    if(flash.reset() || !MountFs(flash) || !(fs = Fs::NorFs::GetFs()) || !Populate(fs)) {
+        gSetupFailed = true;
+    } else {
+        std::vector<uint8_t> buffer(gParams.fileSize);
+
+        // the maintenance task only runs in the case that measures it
+        Fs::Maintenance::SetEnabled(false);
+        Fs::Maintenance::Init();
+
+        for(const auto cached : {false, true}) {
+            const std::string variant{cached ? "cache on" : "cache off"};
+            Fs::BlockCache::SetEnabled(cached);
+
+            Measure("open+close", variant, gParams.ops, gParams.numFiles, 0,
+                    [&](auto index, auto &usec) {
+                const auto name = GetFileName(index);
+
+                const auto start = Clock::now();
+                const auto fd = SPIFFS_open(fs, name.c_str(), SPIFFS_O_RDONLY, 0);
+                if(fd >= 0) {
+                    SPIFFS_close(fs, fd);
+                }
+                usec = Elapsed(start);
+
+                return fd >= 0;
+            });
+
+            Measure("stat", variant, gParams.ops, gParams.numFiles, 0, [&](auto index, auto &usec) {
+                const auto name = GetFileName(index);
+                spiffs_stat stat;
+
+                const auto start = Clock::now();
+                const auto err = SPIFFS_stat(fs, name.c_str(), &stat);
+                usec = Elapsed(start);
+
+                return err == SPIFFS_OK && stat.size == gParams.fileSize;
+            });
+
+            Measure("read", variant, gParams.ops, gParams.numFiles, 0, [&](auto index, auto &usec) {
+                const auto name = GetFileName(index);
+                const auto fd = SPIFFS_open(fs, name.c_str(), SPIFFS_O_RDONLY, 0);
+                if(fd < 0) {
+                    return false;
+                }
+
+                const auto start = Clock::now();
+                const auto read = SPIFFS_read(fs, fd, buffer.data(), buffer.size());
+                usec = Elapsed(start);
+
+                SPIFFS_close(fs, fd);
+                return read == static_cast<s32_t>(buffer.size()) &&
+                    buffer[1] == static_cast<uint8_t>(index * 31 + 1);
+            });
+        }
+
+        // rewrite files (with the same contents), which leaves deleted pages to reclaim
+        for(const auto maintain : {false, true}) {
+            Fs::Maintenance::SetEnabled(maintain);
+
+            Measure("rewrite", maintain ? "maint on" : "maint off", gParams.writes,
+                    gParams.numFiles, kPauseEvery, [&](auto index, auto &usec) {
+                const auto name = GetFileName(index);
+                FillData(index, buffer);
+
+                const auto start = Clock::now();
+                const auto fd = SPIFFS_open(fs, name.c_str(), SPIFFS_O_TRUNC | SPIFFS_O_RDWR, 0);
+                if(fd < 0) {
+                    return false;
+                }
+                const auto written = SPIFFS_write(fs, fd, buffer.data(), buffer.size());
+                SPIFFS_close(fs, fd);
+                usec = Elapsed(start);
+
+                return written == static_cast<s32_t>(buffer.size());
+            });
+        }
+
+        // small values: key/value store versus a file per key
+        std::vector<uint8_t> value(gParams.valueSize);
+
+        Measure("get", "kv", gParams.ops, gParams.keys, 0, [&](auto key, auto &usec) {
+            const auto start = Clock::now();
+            const auto length = Fs::KvStore::Get(key, buffer);
+            usec = Elapsed(start);
+
+            return length == static_cast<int>(value.size()) &&
+                buffer[1] == static_cast<uint8_t>(key * 31 + 1);
+        });
+
+        Measure("get", "spiffs", gParams.ops, gParams.keys, 0, [&](auto key, auto &usec) {
+            const auto name = GetValueName(key);
+
+            const auto start = Clock::now();
+            const auto fd = SPIFFS_open(fs, name.c_str(), SPIFFS_O_RDONLY, 0);
+            if(fd < 0) {
+                return false;
+            }
+            const auto read = SPIFFS_read(fs, fd, buffer.data(), value.size());
+            SPIFFS_close(fs, fd);
+            usec = Elapsed(start);
+
+            return read == static_cast<s32_t>(value.size()) &&
+                buffer[1] == static_cast<uint8_t>(key * 31 + 1);
+        });
+
+        Fs::Maintenance::SetEnabled(true);
+
+        Measure("put", "kv", gParams.writes, gParams.keys, kPauseEvery,
+                [&](auto key, auto &usec) {
+            FillData(key, value);
+
+            const auto start = Clock::now();
+            const auto err = Fs::KvStore::Put(key, value);
+            usec = Elapsed(start);
+
+            return !err;
+        });
+
+        Measure("put", "spiffs", gParams.writes, gParams.keys, kPauseEvery,
+                [&](auto key, auto &usec) {
+            const auto name = GetValueName(key);
+            FillData(key, value);
+
+            const auto start = Clock::now();
+            const auto fd = SPIFFS_open(fs, name.c_str(), SPIFFS_O_TRUNC | SPIFFS_O_RDWR, 0);
+            if(fd < 0) {
+                return false;
+            }
+            const auto written = SPIFFS_write(fs, fd, value.data(), value.size());
+            SPIFFS_close(fs, fd);
+            usec = Elapsed(start);
+
+            return written == static_cast<s32_t>(value.size());
+        });
+
+        Fs::Maintenance::SetEnabled(false);
+    }
+
+    Interrupts::Pend([] {
+        vTaskEndScheduler();
+    });
+    vTaskSuspend(nullptr);
+}
+
+static void Usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--file PATH] [--fs-size N] [--files N] [--file-size N] "
+            "[--ops N] [--writes N] [--keys N] [--value-size N] [--time-scale X]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    // parse arguments
+    for(int i = 1; i < argc; i++) {
+        const std::string_view arg{argv[i]};
+
+        if(i + 1 >= argc) {
+            Usage(argv[0]);
+            return 1;
+        }
+        const char *value = argv[++i];
+
+        if(arg == "--file") {
+            gParams.path = value;
+        } else if(arg == "--fs-size") {
+            gParams.fsSize = strtoul(value, nullptr, 0);
+        } else if(arg == "--files") {
+            gParams.numFiles = strtoul(value, nullptr, 0);
+        } else if(arg == "--file-size") {
+            gParams.fileSize = strtoul(value, nullptr, 0);
+        } else if(arg == "--ops") {
+            gParams.ops = strtoul(value, nullptr, 0);
+        } else if(arg == "--writes") {
+            gParams.writes = strtoul(value, nullptr, 0);
+        } else if(arg == "--keys") {
+            gParams.keys = strtoul(value, nullptr, 0);
+        } else if(arg == "--value-size") {
+            gParams.valueSize = strtoul(value, nullptr, 0);
+        } else if(arg == "--time-scale") {
+            gParams.timeScale = strtod(value, nullptr);
+        } else {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if(!gParams.numFiles || !gParams.fileSize || !gParams.ops || !gParams.keys ||
+            gParams.keys > Fs::KvStore::kMaxKeys || gParams.valueSize < 2 ||
+            gParams.valueSize > std::min(gParams.fileSize, Fs::KvStore::kMaxValueSize) ||
+            gParams.timeScale < 0) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    bool isTemporary{false};
+    if(gParams.path.empty()) {
+        char path[]{"/tmp/host-fs-bench.XXXXXX"};
+        const auto fd = mkstemp(path);
+        if(fd == -1) {
+            perror("mkstemp");
+            return 1;
+        }
+        close(fd);
+
+        gParams.path = path;
+        isTemporary = true;
+    }
+
+    // bring up only what the filesystem needs
+    Interrupts::Init();
+    Hw::Clocks::Init();
+    Logger::Init();
+    sl_sleeptimer_init();
+
+    if(!Fs::IdentifyFlash(kJedecId, gInfo)) {
+        fprintf(stderr, "unknown flash\n");
+        return 1;
+    }
+
+    const auto blockSize = gInfo->blockSizeBytes();
+    if(!gParams.fsSize || (gParams.fsSize % blockSize) ||
+            gParams.fsSize + blockSize + kKvSize > gInfo->capacityBytes()) {
+        fprintf(stderr, "filesystem size must be a multiple of %zu bytes, and fit the flash\n",
+                blockSize);
+        return 1;
+    }
+
+    GPIO_PinModeSet(SL_SPIDRV_EUSART_FLASH_CS_PORT, SL_SPIDRV_EUSART_FLASH_CS_PIN,
+            gpioModePushPull, true);
+    if(!NorFlash::Open({
+        .path = gParams.path,
+        .info = gInfo,
+        .jedecId = {kJedecId[0], kJedecId[1], kJedecId[2]},
+        .bitrate = SL_SPIDRV_EUSART_FLASH_BITRATE,
+        .timeScale = gParams.timeScale,
+    })) {
+        fprintf(stderr, "failed to attach simulated flash\n");
+        return 1;
+    }
+
+    // run the benchmark
+    static StaticTask_t gBenchTask;
+    static StackType_t gBenchStack[kStackSize];
+
+    xTaskCreateStatic(BenchMain, "Bench", kStackSize, nullptr, Rtos::TaskPriority::AppLow,
+            gBenchStack, &gBenchTask);
+
+    vTaskStartScheduler();
+
+    const auto wear = NorFlash::GetWear();
+
+    NorFlash::Close();
+    if(isTemporary) {
+        unlink(gParams.path.c_str());
+    }
+
+    if(gSetupFailed) {
+        return 2;
+    }
+
+    // print results
+    bool ok{true};
+    printf("%-12s %-10s %10s %10s %10s %10s %8s %12s %6s\n", "case", "config", "mean us",
+            "p50 us", "p99 us", "max us", "hit rate", "flash B/op", "fg gc");
+
+    for(auto &result : gResults) {
+        auto &lat = result.latencies;
+        std::sort(lat.begin(), lat.end());
+
+        double mean{0};
+        for(const auto value : lat) {
+            mean += value;
+        }
+        mean = lat.empty() ? 0 : (mean / lat.size());
+
+        const auto percentile = [&](const double p) {
+            return lat.empty() ? 0 : lat[std::min(lat.size() - 1,
+                    static_cast<size_t>(p * lat.size()))];
+        };
+
+        const auto lines = result.hits + result.misses;
+        const auto hitRate = lines ? (100. * result.hits / lines) : 0;
+
+        printf("%-12s %-10s %10.1f %10.1f %10.1f %10.1f %7.1f%% %12.0f %6u%s\n",
+                result.name.c_str(), result.variant.c_str(), mean, percentile(.5),
+                percentile(.99), lat.empty() ? 0. : lat.back(), hitRate,
+                lat.empty() ? 0. : (static_cast<double>(result.flashBytes) / lat.size()),
+                result.foregroundGc, result.ok ? "" : " (FAILED)");
+        ok &= result.ok;
+    }
+
+    // wear of the partitions (sector erases)
+    const auto sectorSize = gInfo->sectorSizeBytes();
+    const auto printWear = [&](const char *name, const size_t start, const size_t size) {
+        const auto first = wear.begin() + start / sectorSize;
+        const auto [min, max] = std::minmax_element(first, first + size / sectorSize);
+        printf("%s sector erases: %u max, %u min\n", name, *max, *min);
+    };
+
+    printWear("filesystem", gInfo->blockSizeBytes(), gParams.fsSize);
+    printWear("key/value store", gInfo->blockSizeBytes() + gParams.fsSize, kKvSize);
+
+    return ok ? 0 : 2;
+}
@@ -0,0 +1,179 @@
+#include <BlazeNet/HostIf/Commands.h>
+#include <BlazeNet/Types/Mac.h>
+#include <rail.h>
+
+#include "BlazeNet/Beacon.h"
+#include "BlazeNet/Init.h"
+#include "HostIf/Init.h"
+#include "HostIf/Task.h"
+#include "Hw/Clocks.h"
+#include "Hw/Identity.h"
+#include "Log/Logger.h"
+#include "Packet/Handler.h"
+#include "Rtos/Rtos.h"
+
+#include "Stubs/Fixtures.h"
+#include "Stubs/Spidrv.h"
+
+#include "Harness.h"
+
+using namespace Fuzz;
+using Packet::Handler;
+using Stubs::Spidrv;
+
+/**
+ * @brief Bring up the firmware components under test
+ *
+ * Everything the host interface task touches is initialized, but the radio task is not created
+ * (the stubbed radio never generates events) and the scheduler is never started.
+ */
+void Harness::Init() {
+    Hw::Clocks::Init();
+    Logger::Init();
+    Hw::Identity::Init();
+
+    Handler::Init();
+    BlazeNet::Init();
+    HostIf::Init();
+
+    // what the task does on startup
+    HostIf::Task::ReadCommand();
+}
+
+/**
+ * @brief Run a single input
+ *
+ * @param data Input bytes (see the class description for the format)
+ * @param size Number of input bytes
+ */
+void Harness::Run(const uint8_t *data, const size_t size) {
+    Input input{data, size};
+
+    Preload(input);
+    Process(input);
+
+    CheckInvariants();
+}
+
+/**
+ * @brief Preload received frames
+ *
+ * Inserts frames into the receive queue as the radio task would, so that there is something for
+ * the host to read out.
+ */
+void Harness::Preload(Input &input) {
+    uint8_t numFrames{0};
+    if(!input.take(&numFrames, 1)) {
+        return;
+    }
+
+    for(size_t i = 0; i < (numFrames & 0x07); i++) {
+        uint8_t desc;
+        if(!input.take(&desc, 1)) {
+            return;
+        }
+
+        const Stubs::RxFrame frame(sizeof(BlazeNet::Types::Mac::Header) + (desc & 0x7F),
+                !!(desc & 0x80));
+        Handler::HandleRxPacket(frame.info, frame.details);
+    }
+}
+
+/**
+ * @brief Clock the input through the host interface
+ *
+ * Completes each transfer the task arms in turn, until the input is exhausted. At that point, the
+ * task must be waiting for the next command header.
+ */
+void Harness::Process(Input &input) {
+    while(true) {
+        REQUIRE(Spidrv::IsArmed(), "host interface stalled");
+        const auto &xfer = Spidrv::GetArmed();
+
+        // host reads out the response
+        if(xfer.txBuffer) {
+            Spidrv::Complete(ECODE_EMDRV_SPIDRV_OK, xfer.count);
+        }
+        // host has nothing more to send: the task must be idle, or abandon the payload
+        else if(!input.size) {
+            if(IsReadingCommand()) {
+                break;
+            }
+
+            Spidrv::Complete(ECODE_EMDRV_SPIDRV_ABORTED, 0);
+        }
+        // host clocks in (part of) the requested bytes; a short transfer is cut off by /CS
+        else {
+            const auto count = input.take(xfer.rxBuffer, xfer.count);
+            Spidrv::Complete((count == xfer.count) ? ECODE_EMDRV_SPIDRV_OK :
+                    ECODE_EMDRV_SPIDRV_ABORTED, count);
+        }
+
+        Dispatch();
+    }
+}
+
+/**
+ * @brief Run the task's notification handler
+ *
+ * Consumes the notification bits set by the completion callback, in place of the task waiting
+ * for them.
+ */
+void Harness::Dispatch() {
+    using HostIf::Task;
+
+    const auto note = ulTaskNotifyValueClearIndexed(Task::gTask, Task::kNotificationIndex,
+            Task::TaskNotifyBits::All);
+    REQUIRE(note, "transfer completed without %s", "notification");
+
+    Task::HandleNotifications(note);
+}
+
+/**
+ * @brief Check the packet handler bookkeeping, then release all packets
+ *
+ * Every packet in flight must be accounted for in the pending count, and once all of them have
+ * been released, the only memory left allocated is the beacon frame.
+ */
+void Harness::CheckInvariants() {
+    HostIf::Response::StatusSnapshot state;
+
+    // release received packets
+    Stubs::DrainRx();
+
+    // the pending count covers the queued packets, plus at most the one being transmitted
+    size_t numQueued{0};
+    while(auto packet = Handler::PopTxQueue()) {
+        Handler::DiscardTxPacket(packet);
+        numQueued++;
+    }
+
+    Handler::ReadSnapshot(&state);
+    REQUIRE(state.txQueue.packetsPending <= 1, "%u tx packets pending, %u were queued",
+            state.txQueue.packetsPending + numQueued, numQueued);
+
+    if(state.txQueue.packetsPending) {
+        Handler::DiscardTxPacket(Stubs::GetInFlightTx());
+    }
+
+    // everything released, except for the beacon frame (which is never queued here)
+    const auto beacon = BlazeNet::Beacon::gPacket;
+    const size_t beaconBytes = beacon ? (sizeof(*beacon) + beacon->packetSize) : 0;
+
+    Handler::ReadSnapshot(&state);
+    REQUIRE(!state.rxQueue.packetsPending && !state.rxQueue.bufferSize,
+            "rx leak: %u packets, %u bytes", state.rxQueue.packetsPending,
+            state.rxQueue.bufferSize);
+    REQUIRE(!state.txQueue.packetsPending && state.txQueue.bufferSize == beaconBytes,
+            "tx leak: %u packets, %u bytes (expected %u)", state.txQueue.packetsPending,
+            state.txQueue.bufferSize, beaconBytes);
+}
+
+/**
+ * @brief Is the task waiting for a command header?
+ */
+bool Harness::IsReadingCommand() {
+    const auto &xfer = Spidrv::GetArmed();
+    return Spidrv::IsArmed() &&
+        xfer.rxBuffer == reinterpret_cast<uint8_t *>(&HostIf::Task::gCommandBuffer);
+}
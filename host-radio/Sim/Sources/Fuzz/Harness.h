@@ -0,0 +1,61 @@
+#ifndef FUZZ_HARNESS_H
+#define FUZZ_HARNESS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/// Host-side fuzzing of firmware components
+namespace Fuzz {
+/**
+ * @brief Host interface fuzzing harness
+ *
+ * Feeds a byte stream through the host interface task's SPI state machine, exactly as if the host
+ * had clocked it in: command headers and payloads go through the real dispatch table and command
+ * handlers, and responses are read out (and discarded.) The radio is stubbed out, and the
+ * scheduler is never started; the task's notification handler is invoked directly from the
+ * calling thread after each completed transfer, so runs are fully deterministic.
+ *
+ * Input format:
+ * - 1 byte: number of frames to preload into the receive queue (low 3 bits)
+ * - 1 byte per preloaded frame: payload length beyond the MAC header (low 7 bits); the high bit
+ *   requests an acknowledgement
+ * - Remainder: bytes clocked in by the host. Each receive armed by the firmware consumes as many
+ *   bytes as it requested; a short final transfer is completed as aborted.
+ *
+ * After every input, the packet handler's bookkeeping is checked for leaks and consistency; any
+ * violation panics (and thus aborts.)
+ */
+class Harness {
+    public:
+        static void Init();
+        static void Run(const uint8_t *data, const size_t size);
+
+    private:
+        /// Bytes of input that have not been consumed yet
+        struct Input {
+            const uint8_t *data;
+            size_t size;
+
+            /// Consume up to the given number of bytes, returning how many were consumed
+            size_t take(uint8_t *out, const size_t count) {
+                const auto num = (count < this->size) ? count : this->size;
+
+                memcpy(out, this->data, num);
+                this->data += num;
+                this->size -= num;
+
+                return num;
+            }
+        };
+
+        static void Preload(Input &input);
+        static void Process(Input &input);
+        static void Dispatch();
+        static void CheckInvariants();
+
+        static bool IsReadingCommand();
+};
+}
+
+#endif
@@ -0,0 +1,25 @@
+/**
+ * @file
+ *
+ * @brief Host interface fuzzer
+ *
+ * libFuzzer entry points for the host interface harness (see Fuzz/Harness.h.) Run with a corpus
+ * directory as usual; add `-close_fd_mask=2` to silence the firmware's log output.
+ *
+ * Running the binary with the regression inputs (Sim/Fuzz/Regressions) as arguments replays each
+ * of them once; it exits with an error if any crashes.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Harness.h"
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv) {
+    Fuzz::Harness::Init();
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    Fuzz::Harness::Run(data, size);
+    return 0;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file
+ *
+ * @brief Host interface fuzzer regression replay
+ *
+ * Runs each of the given inputs (or, for a directory, each file in it) once through the host
+ * interface harness (see Fuzz/Harness.h), without libFuzzer. This is how the regression inputs in
+ * Sim/Fuzz/Regressions are run as a test in regular simulator builds; an input that trips the
+ * harness' checks aborts the process.
+ */
+#include <stdint.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "Harness.h"
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Replay a single input file
+ *
+ * @return Whether the file could be read
+ */
+static bool Replay(const fs::path &path) {
+    std::ifstream file(path, std::ios::binary);
+    if(!file) {
+        fprintf(stderr, "failed to open %s\n", path.c_str());
+        return false;
+    }
+
+    const std::vector<uint8_t> data{std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>()};
+
+    fprintf(stderr, "replaying %s (%zu bytes)\n", path.c_str(), data.size());
+    Fuzz::Harness::Run(data.data(), data.size());
+
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if(argc < 2) {
+        fprintf(stderr, "usage: %s <input or directory>...\n", argv[0]);
+        return 1;
+    }
+
+    // collect inputs; directory contents are replayed in name order, for reproducible runs
+    std::vector<fs::path> inputs;
+
+    for(int i = 1; i < argc; i++) {
+        const fs::path path{argv[i]};
+
+        if(fs::is_directory(path)) {
+            std::vector<fs::path> files;
+            for(const auto &entry : fs::directory_iterator(path)) {
+                if(entry.is_regular_file()) {
+                    files.push_back(entry.path());
+                }
+            }
+
+            std::sort(files.begin(), files.end());
+            inputs.insert(inputs.end(), files.begin(), files.end());
+        } else {
+            inputs.push_back(path);
+        }
+    }
+
+    if(inputs.empty()) {
+        fprintf(stderr, "no inputs to replay\n");
+        return 1;
+    }
+
+    Fuzz::Harness::Init();
+
+    for(const auto &path : inputs) {
+        if(!Replay(path)) {
+            return 1;
+        }
+    }
+
+    fprintf(stderr, "replayed %zu inputs\n", inputs.size());
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <BlazeNet/HostIf/Commands.h>
+
+#include "gecko-config/pin_config.h"
+
+#include "Sim/Gpio.h"
+#include "Sim/HostLink.h"
+
+#include "SimTransport.h"
+
+using namespace BlazeNet::Host;
+
+/**
+ * @brief Execute a write command
+ */
+int SimTransport::write(const uint8_t command, std::span<const uint8_t> payload) {
+    int err;
+
+    if(payload.size() > UINT8_MAX) {
+        return Error::InvalidArguments;
+    }
+
+    err = this->sendHeader(command & ~0x80, payload.size());
+    if(err) {
+        return err;
+    }
+
+    if(!payload.empty()) {
+        if(Sim::HostLink::Transfer(payload.data(), nullptr, payload.size()) < 0) {
+            return Error::NoResponse;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Execute a read command
+ *
+ * @remark The radio only transmits as many bytes as the command produced; the remainder of the
+ *         buffer reads as 0xFF.
+ */
+int SimTransport::read(const uint8_t command, std::span<uint8_t> buffer) {
+    int err;
+
+    if(buffer.empty() || buffer.size() > UINT8_MAX) {
+        return Error::InvalidArguments;
+    }
+
+    err = this->sendHeader(command | 0x80, buffer.size());
+    if(err) {
+        return err;
+    }
+
+    if(Sim::HostLink::Transfer(nullptr, buffer.data(), buffer.size()) < 0) {
+        return Error::NoResponse;
+    }
+
+    return buffer.size();
+}
+
+/**
+ * @brief Wait for the interrupt line (active low) to be asserted
+ */
+bool SimTransport::waitForIrq(const std::chrono::microseconds timeout) {
+    return Sim::Gpio::WaitForLevel(HOST_nIRQ_PORT, HOST_nIRQ_PIN, false, timeout);
+}
+
+/**
+ * @brief Clock out a command header
+ *
+ * @param command Command byte (including read bit)
+ * @param length Payload length
+ */
+int SimTransport::sendHeader(const uint8_t command, const uint8_t length) {
+    const HostIf::CommandHeader hdr{
+        .command = command,
+        .payloadLength = length,
+    };
+
+    if(Sim::HostLink::Transfer(reinterpret_cast<const uint8_t *>(&hdr), nullptr,
+                sizeof(hdr)) < 0) {
+        return Error::NoResponse;
+    }
+
+    return 0;
+}
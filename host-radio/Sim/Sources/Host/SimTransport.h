@@ -0,0 +1,40 @@
+#ifndef SIM_HOST_SIMTRANSPORT_H
+#define SIM_HOST_SIMTRANSPORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+
+#include <BlazeNet/Host/Transport.h>
+
+namespace BlazeNet::Host {
+/**
+ * @brief Simulator transport
+ *
+ * Talks to the firmware running in the same process, over the simulated host link; the interrupt
+ * line is the simulated GPIO the firmware drives.
+ *
+ * @remark Must be used from host threads only.
+ */
+class SimTransport: public Transport {
+    public:
+        /// Error codes
+        enum Error: int {
+            /// The radio didn't set up a transfer in time
+            NoResponse                          = -2100,
+            /// Invalid arguments (for example, a payload longer than 255 bytes)
+            InvalidArguments                    = -2101,
+        };
+
+    public:
+        int write(const uint8_t command, std::span<const uint8_t> payload) override;
+        int read(const uint8_t command, std::span<uint8_t> buffer) override;
+        bool waitForIrq(const std::chrono::microseconds timeout) override;
+
+    private:
+        int sendHeader(const uint8_t command, const uint8_t length);
+};
+}
+
+#endif
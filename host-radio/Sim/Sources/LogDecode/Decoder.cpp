@@ -0,0 +1,238 @@
+#include <string.h>
+
+#include <algorithm>
+
+#include "Decoder.h"
+
+using namespace LogDecode;
+
+using Tokenizer = Log::Tokenizer;
+
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#pragma GCC diagnostic ignored "-Wformat-security"
+
+/**
+ * @brief Format a single value with printf
+ */
+template<typename... Args>
+static std::string Printf(const std::string &spec, Args... args) {
+    const int length = snprintf(nullptr, 0, spec.c_str(), args...);
+    if(length <= 0) {
+        return {};
+    }
+
+    std::string out(length, '\0');
+    snprintf(out.data(), out.size() + 1, spec.c_str(), args...);
+    return out;
+}
+
+/**
+ * @brief Format a value, passing any `*` width/precision arguments before it
+ */
+template<typename T>
+static std::string FormatValue(const std::string &spec, const std::vector<int> &stars,
+        const T value) {
+    switch(stars.size()) {
+        case 0:
+            return Printf(spec, value);
+        case 1:
+            return Printf(spec, stars[0], value);
+        default:
+            return Printf(spec, stars[0], stars[1], value);
+    }
+}
+
+/**
+ * @brief Process received log data
+ *
+ * Complete records are decoded and output; a partial record at the end is kept until the rest of
+ * it is received.
+ */
+void Decoder::feed(std::span<const uint8_t> data) {
+    this->pending.insert(this->pending.end(), data.begin(), data.end());
+
+    size_t pos{0};
+    while(pos < this->pending.size()) {
+        // pass through anything that isn't a record
+        if(this->pending[pos] != Tokenizer::kSync) {
+            const auto next = std::find(this->pending.begin() + pos, this->pending.end(),
+                    Tokenizer::kSync);
+            const size_t end = next - this->pending.begin();
+
+            fwrite(this->pending.data() + pos, 1, end - pos, this->out);
+            pos = end;
+            continue;
+        }
+
+        // wait for the entire record
+        if(this->pending.size() - pos < 2) {
+            break;
+        }
+
+        // if it can't be a record, skip the sync byte and try again
+        const size_t length = this->pending[pos + 1];
+        if(length < sizeof(Header)) {
+            pos++;
+            continue;
+        } else if(this->pending.size() - pos < length) {
+            break;
+        }
+
+        this->decodeRecord({this->pending.data() + pos, length});
+        pos += length;
+    }
+
+    this->pending.erase(this->pending.begin(), this->pending.begin() + pos);
+}
+
+/**
+ * @brief Flush any remaining data at the end of the stream
+ *
+ * A partial record can't be decoded, so it's discarded.
+ */
+void Decoder::finish() {
+    if(!this->pending.empty() && this->pending[0] != Tokenizer::kSync) {
+        fwrite(this->pending.data(), 1, this->pending.size(), this->out);
+    }
+    this->pending.clear();
+
+    fflush(this->out);
+}
+
+/**
+ * @brief Decode and output a single record
+ *
+ * Records whose format string isn't in the firmware image are dropped.
+ */
+void Decoder::decodeRecord(std::span<const uint8_t> record) {
+    Header hdr;
+    memcpy(&hdr, record.data(), sizeof(hdr));
+    const auto args = record.subspan(sizeof(hdr));
+
+    std::string message;
+
+    if(!hdr.format) {
+        message.assign(reinterpret_cast<const char *>(args.data()), args.size());
+    } else {
+        const auto fmt = this->elf.getString(hdr.format);
+        if(!fmt) {
+            this->numUnknown++;
+            return;
+        }
+
+        message = this->format(*fmt, args);
+    }
+
+    fprintf(this->out, "[%10u] %s\n", hdr.timestamp, message.c_str());
+    this->numDecoded++;
+}
+
+/**
+ * @brief Format a message from its format string and encoded arguments
+ *
+ * Arguments missing from the record (because it was truncated on the device) are output as `?`.
+ *
+ * @param fmt Format string (must be zero terminated)
+ * @param args Encoded arguments
+ */
+std::string Decoder::format(std::string_view fmt, std::span<const uint8_t> args) {
+    using ArgType = Tokenizer::ArgType;
+
+    std::string out;
+    etl::span<const uint8_t> data{args.data(), args.size()};
+
+    const char *pos = fmt.data();
+    const char *literal = pos;
+    Tokenizer::Conversion conv;
+
+    while(Tokenizer::NextConversion(pos, conv)) {
+        out.append(literal, conv.start);
+        literal = pos;
+
+        // host format spec, without the length modifiers
+        std::string spec;
+        for(size_t i = 0; i + 1 < conv.length; i++) {
+            if(!strchr("hlzjtL", conv.start[i])) {
+                spec.push_back(conv.start[i]);
+            }
+        }
+
+        // read the arguments
+        bool ok{true};
+        uint64_t value{0};
+
+        std::vector<int> stars;
+        for(size_t i = 0; i < conv.stars; i++) {
+            ok &= Tokenizer::ReadVarint(data, value);
+            stars.push_back(Tokenizer::Unzigzag(value));
+        }
+
+        switch(conv.type) {
+            case ArgType::Int:
+            case ArgType::Int64:
+            case ArgType::Uint:
+            case ArgType::Uint64:
+            case ArgType::Pointer:
+                ok &= Tokenizer::ReadVarint(data, value);
+                break;
+            case ArgType::Double:
+                ok &= (data.size() >= sizeof(double));
+                break;
+            case ArgType::String:
+                ok &= !!memchr(data.data(), '\0', data.size());
+                break;
+            case ArgType::None:
+                break;
+        }
+
+        if(!ok) {
+            out.push_back('?');
+            data = {};
+            continue;
+        }
+
+        // format it
+        switch(conv.type) {
+            case ArgType::Int:
+            case ArgType::Int64:
+                out += FormatValue(spec + "ll" + conv.conversion, stars,
+                        static_cast<long long>(Tokenizer::Unzigzag(value)));
+                break;
+            case ArgType::Uint:
+            case ArgType::Uint64:
+                if(conv.conversion == 'c') {
+                    out += FormatValue(spec + conv.conversion, stars, static_cast<int>(value));
+                } else {
+                    out += FormatValue(spec + "ll" + conv.conversion, stars,
+                            static_cast<unsigned long long>(value));
+                }
+                break;
+            case ArgType::Pointer:
+                out += Printf("0x%08llx", static_cast<unsigned long long>(value));
+                break;
+            case ArgType::Double: {
+                double d;
+                memcpy(&d, data.data(), sizeof(d));
+                data = data.subspan(sizeof(d));
+                out += FormatValue(spec + conv.conversion, stars, d);
+                break;
+            }
+            case ArgType::String: {
+                const auto str = reinterpret_cast<const char *>(data.data());
+                data = data.subspan(strlen(str) + 1);
+                out += FormatValue(spec + conv.conversion, stars, str);
+                break;
+            }
+            case ArgType::None:
+                if(conv.conversion == '%') {
+                    out.push_back('%');
+                } else {
+                    out.append(conv.start, conv.length);
+                }
+                break;
+        }
+    }
+
+    out.append(literal);
+    return out;
+}
@@ -0,0 +1,60 @@
+#ifndef LOGDECODE_DECODER_H
+#define LOGDECODE_DECODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Log/Tokenizer.h"
+
+#include "Elf.h"
+
+namespace LogDecode {
+/**
+ * @brief Binary log stream decoder
+ *
+ * Turns a stream of log records (see Log::Tokenizer) back into the text the firmware would have
+ * output, one line per message. Anything between records (for example, output of a bootloader, or
+ * of firmware that logs in text) is passed through unchanged.
+ */
+class Decoder {
+    public:
+        Decoder(const Elf &elf, FILE *out) : elf(elf), out(out) {}
+
+        void feed(std::span<const uint8_t> data);
+        void finish();
+
+        /// Number of records decoded
+        constexpr inline auto getNumDecoded() const {
+            return this->numDecoded;
+        }
+        /// Number of records whose format string wasn't found
+        constexpr inline auto getNumUnknown() const {
+            return this->numUnknown;
+        }
+
+    private:
+        using Header = Log::Tokenizer::Header;
+
+        void decodeRecord(std::span<const uint8_t> record);
+        std::string format(std::string_view fmt, std::span<const uint8_t> args);
+
+    private:
+        /// Firmware image to look up format strings in
+        const Elf &elf;
+        /// Where decoded text is written
+        FILE *out;
+
+        /// Data received but not yet processed
+        std::vector<uint8_t> pending;
+
+        size_t numDecoded{0};
+        size_t numUnknown{0};
+};
+}
+
+#endif
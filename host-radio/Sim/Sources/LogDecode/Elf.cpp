@@ -0,0 +1,88 @@
+#include <elf.h>
+#include <string.h>
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include "Elf.h"
+
+using namespace LogDecode;
+
+/**
+ * @brief Load a firmware image
+ *
+ * @param path ELF file to load
+ *
+ * @throws std::runtime_error If the file can't be read, or is not a 32-bit little endian ELF file
+ */
+Elf::Elf(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if(!file) {
+        throw std::runtime_error("failed to open " + path);
+    }
+
+    const std::vector<uint8_t> contents{std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>()};
+
+    // validate header
+    Elf32_Ehdr hdr;
+    if(contents.size() < sizeof(hdr)) {
+        throw std::runtime_error("not an ELF file: " + path);
+    }
+    memcpy(&hdr, contents.data(), sizeof(hdr));
+
+    if(memcmp(hdr.e_ident, ELFMAG, SELFMAG)) {
+        throw std::runtime_error("not an ELF file: " + path);
+    } else if(hdr.e_ident[EI_CLASS] != ELFCLASS32 || hdr.e_ident[EI_DATA] != ELFDATA2LSB) {
+        throw std::runtime_error("not a 32-bit little endian ELF file: " + path);
+    }
+
+    // load all allocated sections with contents
+    for(size_t i = 0; i < hdr.e_shnum; i++) {
+        const size_t offset = hdr.e_shoff + i * hdr.e_shentsize;
+
+        Elf32_Shdr shdr;
+        if(offset + sizeof(shdr) > contents.size()) {
+            throw std::runtime_error("truncated section header table: " + path);
+        }
+        memcpy(&shdr, contents.data() + offset, sizeof(shdr));
+
+        if(shdr.sh_type != SHT_PROGBITS || !(shdr.sh_flags & SHF_ALLOC)) {
+            continue;
+        } else if(shdr.sh_offset + shdr.sh_size > contents.size()) {
+            throw std::runtime_error("truncated section: " + path);
+        }
+
+        this->sections.push_back({
+            .address = shdr.sh_addr,
+            .data = {contents.begin() + shdr.sh_offset,
+                contents.begin() + shdr.sh_offset + shdr.sh_size},
+        });
+    }
+}
+
+/**
+ * @brief Get the zero terminated string at an address
+ *
+ * @return The string, or nothing if the address isn't in any section (or the string isn't
+ *         terminated within it)
+ */
+std::optional<std::string_view> Elf::getString(const uint32_t address) const {
+    for(const auto &section : this->sections) {
+        if(address < section.address || address >= section.address + section.data.size()) {
+            continue;
+        }
+
+        const auto start = reinterpret_cast<const char *>(section.data.data()) +
+            (address - section.address);
+        const auto length = strnlen(start, section.data.size() - (address - section.address));
+
+        if(address - section.address + length == section.data.size()) {
+            return std::nullopt;
+        }
+        return std::string_view{start, length};
+    }
+
+    return std::nullopt;
+}
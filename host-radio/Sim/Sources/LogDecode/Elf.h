@@ -0,0 +1,40 @@
+#ifndef LOGDECODE_ELF_H
+#define LOGDECODE_ELF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace LogDecode {
+/**
+ * @brief Firmware image
+ *
+ * Loads the allocated sections of a (32-bit, little endian) ELF file, so that strings can be
+ * looked up by their address in the firmware's memory map.
+ */
+class Elf {
+    public:
+        Elf(const std::string &path);
+
+        std::optional<std::string_view> getString(const uint32_t address) const;
+
+    private:
+        /// A section loaded from the file
+        struct Section {
+            /// Load address
+            uint32_t address;
+            /// Section contents
+            std::vector<uint8_t> data;
+        };
+
+    private:
+        /// Allocated sections with contents
+        std::vector<Section> sections;
+};
+}
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * @file
+ *
+ * @brief Binary log decoder
+ *
+ * Decodes the binary (tokenized) log output of the firmware's UART log back into text, using the
+ * firmware's ELF file to look up format strings. The ELF file must be the one for the exact
+ * firmware build that produced the log; records whose format string can't be found in it are
+ * dropped, and counted.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+#include "Decoder.h"
+#include "Elf.h"
+
+static void Usage(const char *argv0) {
+    fprintf(stderr, "usage: %s FIRMWARE.elf [CAPTURE]\n", argv0);
+    fprintf(stderr, "  CAPTURE is raw data received from the log UART; if omitted, data is read "
+            "from stdin (e.g. a serial port)\n");
+}
+
+int main(int argc, char **argv) {
+    if(argc < 2 || argc > 3) {
+        Usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    try {
+        const LogDecode::Elf elf(argv[1]);
+
+        FILE *in = stdin;
+        if(argc == 3) {
+            in = fopen(argv[2], "rb");
+            if(!in) {
+                throw std::runtime_error(std::string("failed to open ") + argv[2]);
+            }
+        }
+
+        // output is line buffered so that it can be followed live
+        setvbuf(stdout, nullptr, _IOLBF, 0);
+
+        LogDecode::Decoder decoder(elf, stdout);
+        uint8_t buffer[512];
+        size_t read;
+
+        while((read = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+            decoder.feed({buffer, read});
+        }
+        decoder.finish();
+
+        if(in != stdin) {
+            fclose(in);
+        }
+
+        fprintf(stderr, "%zu records decoded, %zu with unknown format\n",
+                decoder.getNumDecoded(), decoder.getNumUnknown());
+    } catch(const std::exception &e) {
+        fprintf(stderr, "%s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
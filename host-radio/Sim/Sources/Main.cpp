@@ -0,0 +1,228 @@
+/**
+ * @file
+ *
+ * @brief Host simulator entry point
+ *
+ * Brings up the firmware core the same way as on the device (minus the filesystem), against the
+ * simulated peripherals; then runs a host driver workload against it from a host thread. The
+ * simulated radio loops transmitted frames back, so each packet makes a full round trip through
+ * the host interface, packet handler and radio task.
+ *
+ * Prints throughput and round trip latency once the workload completes, and shuts down.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include <BlazeNet/Host/Device.h>
+#include <BlazeNet/Types/Mac.h>
+
+#include "Host/SimTransport.h"
+#include "Sim/Firmware.h"
+#include "Sim/HostLink.h"
+
+using Clock = std::chrono::steady_clock;
+
+/// Workload parameters
+struct Params {
+    /// Number of packets to send
+    size_t numPackets{2000};
+    /// Size of each packet (bytes, including MAC header)
+    size_t packetSize{32};
+    /// Maximum number of packets in flight
+    size_t window{8};
+    /// Radio channel to use
+    uint16_t channel{1};
+};
+
+/// Offset of the sequence number and timestamp in each packet
+constexpr static const size_t kPayloadOffset{sizeof(BlazeNet::Types::Mac::Header)};
+/// Smallest packet that can hold the MAC header, sequence number and timestamp
+constexpr static const size_t kMinPacketSize{kPayloadOffset + sizeof(uint32_t) +
+    sizeof(Clock::rep)};
+
+/**
+ * @brief Run the host workload
+ *
+ * Configures the radio, then transmits packets (keeping the configured number in flight) and
+ * measures the time until each is received back.
+ *
+ * @return Whether all packets were received
+ */
+static bool RunWorkload(const Params &params) {
+    using namespace BlazeNet::Host;
+
+    Device dev(std::make_shared<SimTransport>(), Device::Config{});
+
+    const auto err = dev.configureRadio({
+        .channel = params.channel,
+        .txPower = 0,
+        .myAddress = 0x1234,
+    }).get();
+    if(err) {
+        fprintf(stderr, "failed to configure radio: %d\n", err);
+        return false;
+    }
+
+    // receive handler: record latency
+    std::mutex lock;
+    std::condition_variable cond;
+    std::vector<double> latencies;
+    size_t received{0}, txErrors{0};
+
+    latencies.reserve(params.numPackets);
+
+    dev.setRxHandler([&](const Device::RxPacket &packet) {
+        Clock::rep sent;
+        if(packet.data.size() < kMinPacketSize) {
+            return;
+        }
+        memcpy(&sent, packet.data.data() + kPayloadOffset + sizeof(uint32_t), sizeof(sent));
+
+        const auto now = Clock::now().time_since_epoch().count();
+
+        std::lock_guard lg(lock);
+        latencies.push_back(static_cast<double>(now - sent) / 1000.);
+        received++;
+        cond.notify_all();
+    });
+
+    // transmit all packets, keeping the configured number in flight
+    std::vector<uint8_t> packet(params.packetSize);
+    std::vector<std::future<int>> pending;
+
+    const auto start = Clock::now();
+
+    for(uint32_t seq = 0; seq < params.numPackets; seq++) {
+        {
+            std::unique_lock lk(lock);
+            if(!cond.wait_for(lk, std::chrono::seconds(5), [&] {
+                return (seq - received - txErrors) < params.window;
+            })) {
+                fprintf(stderr, "timed out waiting for packet %u\n", seq);
+                break;
+            }
+        }
+
+        const BlazeNet::Types::Mac::Header hdr{
+            .flags = BlazeNet::Types::Mac::HeaderFlags::EndpointUserData,
+            .sequence = static_cast<uint8_t>(seq),
+            .source = 0x1234,
+            .destination = BlazeNet::Types::Mac::kBroadcastAddress,
+        };
+        const auto now = Clock::now().time_since_epoch().count();
+
+        memcpy(packet.data(), &hdr, sizeof(hdr));
+        memcpy(packet.data() + kPayloadOffset, &seq, sizeof(seq));
+        memcpy(packet.data() + kPayloadOffset + sizeof(seq), &now, sizeof(now));
+
+        pending.emplace_back(dev.transmit(1, packet));
+
+        // reap completed transmit requests
+        std::erase_if(pending, [&](auto &f) {
+            if(f.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                return false;
+            }
+            if(f.get()) {
+                std::lock_guard lg(lock);
+                txErrors++;
+            }
+            return true;
+        });
+    }
+
+    // wait for the remaining packets
+    {
+        std::unique_lock lk(lock);
+        cond.wait_for(lk, std::chrono::seconds(5), [&] {
+            return received + txErrors >= params.numPackets;
+        });
+    }
+
+    const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    const auto stats = dev.getStats();
+    dev.setRxHandler(nullptr);
+
+    // print results
+    std::lock_guard lg(lock);
+    std::sort(latencies.begin(), latencies.end());
+
+    auto percentile = [&](const double p) -> double {
+        if(latencies.empty()) {
+            return 0;
+        }
+        return latencies[std::min(latencies.size() - 1,
+                static_cast<size_t>(p * latencies.size()))];
+    };
+
+    const double pps = received / seconds;
+
+    printf("%8.0f pkt/s %8.1f kB/s | latency (us) p50 %8.1f p90 %8.1f p99 %8.1f max %8.1f | "
+            "%zu xfers, %zu irqs, %zu tx errors, %zu lost, %zu link bytes lost\n",
+            pps, pps * params.packetSize / 1000., percentile(.5), percentile(.9),
+            percentile(.99), latencies.empty() ? 0 : latencies.back(), stats.transactions,
+            stats.irqs, txErrors, params.numPackets - received - txErrors,
+            Sim::HostLink::GetBytesLost());
+
+    return (received == params.numPackets);
+}
+
+static void Usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--packets N] [--size BYTES] [--window N] [--channel N]\n",
+            argv0);
+}
+
+int main(int argc, char **argv) {
+    Params params;
+
+    // parse arguments
+    for(int i = 1; i < argc; i++) {
+        const std::string_view arg{argv[i]};
+
+        if(i + 1 >= argc) {
+            Usage(argv[0]);
+            return 1;
+        }
+        const auto value = strtoul(argv[++i], nullptr, 0);
+
+        if(arg == "--packets") {
+            params.numPackets = value;
+        } else if(arg == "--size") {
+            params.packetSize = value;
+        } else if(arg == "--window") {
+            params.window = value;
+        } else if(arg == "--channel") {
+            params.channel = value;
+        } else {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if(params.packetSize < kMinPacketSize || params.packetSize > 250 || !params.window) {
+        fprintf(stderr, "packet size must be between %zu and 250 bytes; window must be > 0\n",
+                kMinPacketSize);
+        return 1;
+    }
+
+    // set up the simulated hardware, then the firmware
+    Sim::Firmware::Init({
+        .loopback = true,
+    });
+
+    // run the workload on a host thread; it stops the scheduler when done
+    const bool ok = Sim::Firmware::Run([&] {
+        return RunWorkload(params);
+    });
+
+    return ok ? 0 : 2;
+}
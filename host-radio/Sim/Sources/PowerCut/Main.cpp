@@ -0,0 +1,537 @@
+/**
+ * @file
+ *
+ * @brief Storage power loss test
+ *
+ * Boots the storage stack as the firmware does (Fs::Init: superblock validation, formatting on
+ * the first boot, the SPIFFS mount and the key/value store) on the simulated NOR flash, over and
+ * over, cutting the power at a random program or erase operation in each boot. The firmware can't
+ * be restarted in place, so each boot runs in a child process; the flash contents persist in the
+ * backing file, and a journal of completed updates in memory shared with this process.
+ *
+ * Each boot first checks that every key holds the value of its last completed update (or of the
+ * update that was interrupted), both in the key/value store and in a file of its own. Then it
+ * updates random keys (first the record, then the file) until the power is cut, pausing every so
+ * often so the maintenance task (Fs::Maintenance) gets to reclaim space, and be interrupted too.
+ *
+ * The flash contents are kept in the file given with `--file` (a temporary file by default); an
+ * existing one is reused, and the first boot takes whatever values it holds as the starting point.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include <etl/array.h>
+#include <em_device.h>
+#include <em_gpio.h>
+#include <sl_sleeptimer.h>
+#include <spiffs.h>
+
+#include "sl_spidrv_eusart_flash_config.h"
+
+#include "Fs/FlashInfo.h"
+#include "Fs/Init.h"
+#include "Fs/KvStore.h"
+#include "Fs/NorFs.h"
+#include "Hw/Clocks.h"
+#include "Log/Logger.h"
+#include "Rtos/Rtos.h"
+
+#include "Sim/Interrupts.h"
+#include "Sim/NorFlash.h"
+
+using Sim::Interrupts;
+using Sim::NorFlash;
+
+/// Flash to simulate
+constexpr static const etl::array<uint8_t, 3> kJedecId{{0xef, 0x40, 0x17}};
+/// Stack size for the workload task (words)
+constexpr static const size_t kStackSize{4096};
+/// Maximum number of keys
+constexpr static const size_t kMaxKeys{Fs::KvStore::kMaxKeys};
+/// Pause between batches of updates; long enough for the maintenance task to notice it's quiet
+constexpr static const TickType_t kPause{pdMS_TO_TICKS(600)};
+/// Marks the journal as having no update in progress
+constexpr static const uint32_t kNoKey{UINT32_MAX};
+
+/// Exit status of a boot whose power was cut
+constexpr static const int kPowerCutStatus{4};
+/// Exit status of a boot that found inconsistent data
+constexpr static const int kFailedStatus{2};
+
+/// Test parameters
+struct Params {
+    /// Flash backing file; if empty, a temporary file is used
+    std::string path;
+    /// Number of boots
+    size_t boots{100};
+    /// Number of keys
+    size_t keys{32};
+    /// Maximum number of updates per boot
+    size_t updates{1000};
+    /// Number of updates between pauses (0 to never pause)
+    size_t pauseEvery{100};
+    /// The power is cut at a random program or erase operation up to this one
+    size_t maxCut{2000};
+    /// Factor applied to the flash's typical program and erase times
+    double timeScale{0.};
+    /// Seed for the random numbers
+    uint32_t seed{1};
+};
+
+/**
+ * @brief Value stored for each key
+ */
+struct Value {
+    uint32_t key;
+    /// Generation of the update that wrote the value (never zero)
+    uint32_t generation;
+    /// Check value (see MakeValue())
+    uint32_t check;
+};
+
+/**
+ * @brief Journal of completed updates
+ *
+ * Shared between all boots; as the power is only ever cut inside a flash operation, it's always
+ * consistent.
+ */
+struct Journal {
+    /// Generation of the last completed update of each key's record (0 if never written)
+    uint32_t kvGeneration[kMaxKeys];
+    /// Generation of the last completed update of each key's file (0 if never written)
+    uint32_t fileGeneration[kMaxKeys];
+    /// Key being updated, or kNoKey
+    uint32_t pendingKey;
+    /// Generation being written to the key being updated
+    uint32_t pendingGeneration;
+    /// Most recent generation written
+    uint32_t generation;
+
+    /// Updates completed, over all boots
+    uint64_t updates;
+    /// Erase count of each sector, over all boots
+    uint32_t wear[];
+};
+
+static Params gParams;
+static const Fs::FlashInfo *gInfo{nullptr};
+static Journal *gJournal{nullptr};
+/// Seed of the current boot
+static uint32_t gBootSeed{0};
+/// Set if the current boot found inconsistent data, or failed an update
+static bool gFailed{false};
+/// Whether the current boot takes the values it finds as the starting point, rather than checking
+static bool gAdopt{false};
+
+/**
+ * @brief Build the value for an update
+ */
+static Value MakeValue(const uint32_t key, const uint32_t generation) {
+    return {key, generation, key ^ generation ^ 0x5A5A5A5A};
+}
+
+/**
+ * @brief Get the name of the file holding the value of a key
+ */
+static std::string GetValueName(const size_t key) {
+    char name[16];
+    snprintf(name, sizeof(name), "value%04zu", key);
+    return name;
+}
+
+/**
+ * @brief Add the wear of this boot to the journal
+ */
+static void RecordWear() {
+    const auto &wear = NorFlash::GetWear();
+    for(size_t i = 0; i < wear.size(); i++) {
+        gJournal->wear[i] += wear[i];
+    }
+}
+
+/**
+ * @brief Decode a value read back for a key
+ *
+ * @param length Number of bytes read, or a negative error code
+ * @param outGeneration Generation of the value; 0 if there is none
+ *
+ * @return Whether the value is intact
+ */
+static bool Decode(const uint32_t key, const Value &value, const int length,
+        uint32_t &outGeneration) {
+    outGeneration = 0;
+
+    if(length <= 0) {
+        return true;
+    } else if(length != sizeof(Value)) {
+        return false;
+    }
+
+    const auto expected = MakeValue(key, value.generation);
+    if(value.generation && !memcmp(&value, &expected, sizeof(value))) {
+        outGeneration = value.generation;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Check a key against the journal
+ *
+ * @param store Name of the store it was read from (for display)
+ * @param generation Generation that was read back
+ * @param committed Generation of the last completed update
+ */
+static bool CheckKey(const char *store, const uint32_t key, const uint32_t generation,
+        const uint32_t committed) {
+    if(generation == committed ||
+            (key == gJournal->pendingKey && generation == gJournal->pendingGeneration)) {
+        return true;
+    }
+
+    fprintf(stderr, "boot %08x: key %u %s holds generation %u, expected %u", gBootSeed, key,
+            store, generation, committed);
+    if(key == gJournal->pendingKey) {
+        fprintf(stderr, " or %u", gJournal->pendingGeneration);
+    }
+    fprintf(stderr, "\n");
+    return false;
+}
+
+/**
+ * @brief Verify all keys against the journal
+ *
+ * Afterwards, the journal reflects what the interrupted update (if any) left behind.
+ */
+static bool Verify(spiffs *fs) {
+    bool ok{true};
+
+    for(uint32_t key = 0; key < gParams.keys; key++) {
+        Value value{};
+        uint32_t kvGeneration, fileGeneration;
+
+        // record in the key/value store
+        auto length = Fs::KvStore::Get(key, {reinterpret_cast<uint8_t *>(&value),
+                sizeof(value)});
+        if(length < 0 && length != Fs::KvStore::Error::NotFound) {
+            fprintf(stderr, "boot %08x: key %u record read failed: %d\n", gBootSeed, key, length);
+            return false;
+        } else if(!Decode(key, value, length, kvGeneration)) {
+            fprintf(stderr, "boot %08x: key %u record is damaged\n", gBootSeed, key);
+            return false;
+        }
+
+        if(!gAdopt) {
+            ok &= CheckKey("record", key, kvGeneration, gJournal->kvGeneration[key]);
+        }
+
+        // its file
+        value = {};
+        length = 0;
+
+        const auto name = GetValueName(key);
+        const auto fd = SPIFFS_open(fs, name.c_str(), SPIFFS_O_RDONLY, 0);
+        if(fd >= 0) {
+            length = SPIFFS_read(fs, fd, &value, sizeof(value));
+            SPIFFS_close(fs, fd);
+        }
+
+        if(length < 0 && length != SPIFFS_ERR_END_OF_OBJECT) {
+            fprintf(stderr, "boot %08x: key %u file read failed: %d\n", gBootSeed, key, length);
+            return false;
+        } else if(!Decode(key, value, length, fileGeneration)) {
+            fprintf(stderr, "boot %08x: key %u file is damaged\n", gBootSeed, key);
+            return false;
+        }
+
+        if(!gAdopt) {
+            ok &= CheckKey("file", key, fileGeneration, gJournal->fileGeneration[key]);
+        }
+
+        gJournal->kvGeneration[key] = kvGeneration;
+        gJournal->fileGeneration[key] = fileGeneration;
+        gJournal->generation = std::max({gJournal->generation, kvGeneration, fileGeneration});
+    }
+
+    gJournal->pendingKey = kNoKey;
+    return ok;
+}
+
+/**
+ * @brief Update a key: first its record, then its file
+ */
+static bool Update(spiffs *fs, const uint32_t key) {
+    const auto value = MakeValue(key, ++gJournal->generation);
+
+    gJournal->pendingGeneration = value.generation;
+    gJournal->pendingKey = key;
+
+    const auto err = Fs::KvStore::Put(key, {reinterpret_cast<const uint8_t *>(&value),
+            sizeof(value)});
+    if(err) {
+        fprintf(stderr, "boot %08x: key %u record write failed: %d\n", gBootSeed, key, err);
+        return false;
+    }
+    gJournal->kvGeneration[key] = value.generation;
+
+    // overwrite in place, rather than truncating (which would leave an empty file if cut short)
+    const auto name = GetValueName(key);
+    const auto fd = SPIFFS_open(fs, name.c_str(), SPIFFS_O_CREAT | SPIFFS_O_RDWR, 0);
+    if(fd < 0) {
+        fprintf(stderr, "boot %08x: key %u file open failed: %d\n", gBootSeed, key, fd);
+        return false;
+    }
+
+    auto copy = value;
+    const auto written = SPIFFS_write(fs, fd, &copy, sizeof(copy));
+    const auto closed = SPIFFS_close(fs, fd);
+    if(written != static_cast<s32_t>(sizeof(copy)) || closed) {
+        fprintf(stderr, "boot %08x: key %u file write failed: %d/%d\n", gBootSeed, key,
+                written, closed);
+        return false;
+    }
+    gJournal->fileGeneration[key] = value.generation;
+
+    gJournal->pendingKey = kNoKey;
+    gJournal->updates++;
+    return true;
+}
+
+/**
+ * @brief Workload task
+ *
+ * Verify the keys, then update random ones until the power is cut (or enough were updated) and
+ * stop the scheduler.
+ */
+static void WorkloadMain(void *) {
+    auto fs = Fs::NorFs::GetFs();
+
+    if(!fs || !Fs::KvStore::IsMounted()) {
+        fprintf(stderr, "boot %08x: storage not mounted\n", gBootSeed);
+        gFailed = true;
+    } else if(!Verify(fs)) {
+        gFailed = true;
+    } else {
+        std::mt19937 rng(gBootSeed);
+        std::uniform_int_distribution<uint32_t> pick(0, gParams.keys - 1);
+
+        for(size_t i = 0; i < gParams.updates; i++) {
+            if(gParams.pauseEvery && i && !(i % gParams.pauseEvery)) {
+                vTaskDelay(kPause);
+            }
+
+            if(!Update(fs, pick(rng))) {
+                gFailed = true;
+                break;
+            }
+        }
+    }
+
+    Interrupts::Pend([] {
+        vTaskEndScheduler();
+    });
+    vTaskSuspend(nullptr);
+}
+
+/**
+ * @brief Boot the storage stack and run the workload
+ *
+ * Runs in a child process: it exits when the power is cut, or the firmware resets the system.
+ *
+ * @param cutAfter Program or erase operation during which the power is cut (0 for none)
+ *
+ * @return Exit status
+ */
+static int Boot(const size_t cutAfter) {
+    Interrupts::Init();
+    Hw::Clocks::Init();
+    Logger::Init();
+    sl_sleeptimer_init();
+
+    GPIO_PinModeSet(SL_SPIDRV_EUSART_FLASH_CS_PORT, SL_SPIDRV_EUSART_FLASH_CS_PIN,
+            gpioModePushPull, true);
+    const auto opened = NorFlash::Open({
+        .path = gParams.path,
+        .info = gInfo,
+        .jedecId = {kJedecId[0], kJedecId[1], kJedecId[2]},
+        .bitrate = SL_SPIDRV_EUSART_FLASH_BITRATE,
+        .timeScale = gParams.timeScale,
+        .powerCut = [] {
+            RecordWear();
+            fflush(nullptr);
+            _exit(kPowerCutStatus);
+        },
+    });
+    if(!opened) {
+        return 1;
+    }
+
+    NorFlash::CutPower(cutAfter, gBootSeed);
+
+    // as the firmware does, before starting the scheduler
+    Fs::Init();
+
+    static StaticTask_t gWorkloadTask;
+    static StackType_t gWorkloadStack[kStackSize];
+
+    xTaskCreateStatic(WorkloadMain, "Workload", kStackSize, nullptr, Rtos::TaskPriority::AppLow,
+            gWorkloadStack, &gWorkloadTask);
+
+    vTaskStartScheduler();
+
+    RecordWear();
+    NorFlash::Close();
+
+    return gFailed ? kFailedStatus : 0;
+}
+
+static void Usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--file PATH] [--boots N] [--keys N] [--updates N] "
+            "[--pause-every N] [--max-cut N] [--time-scale X] [--seed N]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    // parse arguments
+    for(int i = 1; i < argc; i++) {
+        const std::string_view arg{argv[i]};
+
+        if(i + 1 >= argc) {
+            Usage(argv[0]);
+            return 1;
+        }
+        const char *value = argv[++i];
+
+        if(arg == "--file") {
+            gParams.path = value;
+        } else if(arg == "--boots") {
+            gParams.boots = strtoul(value, nullptr, 0);
+        } else if(arg == "--keys") {
+            gParams.keys = strtoul(value, nullptr, 0);
+        } else if(arg == "--updates") {
+            gParams.updates = strtoul(value, nullptr, 0);
+        } else if(arg == "--pause-every") {
+            gParams.pauseEvery = strtoul(value, nullptr, 0);
+        } else if(arg == "--max-cut") {
+            gParams.maxCut = strtoul(value, nullptr, 0);
+        } else if(arg == "--time-scale") {
+            gParams.timeScale = strtod(value, nullptr);
+        } else if(arg == "--seed") {
+            gParams.seed = strtoul(value, nullptr, 0);
+        } else {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if(!gParams.boots || !gParams.keys || gParams.keys > kMaxKeys || !gParams.maxCut ||
+            gParams.timeScale < 0) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    bool isTemporary{false};
+    if(gParams.path.empty()) {
+        char path[]{"/tmp/host-fs-powercut.XXXXXX"};
+        const auto fd = mkstemp(path);
+        if(fd == -1) {
+            perror("mkstemp");
+            return 1;
+        }
+        close(fd);
+
+        gParams.path = path;
+        isTemporary = true;
+    }
+
+    if(!Fs::IdentifyFlash(kJedecId, gInfo)) {
+        fprintf(stderr, "unknown flash\n");
+        return 1;
+    }
+
+    // the journal is shared with all boots
+    const auto numSectors = gInfo->capacityBytes() / gInfo->sectorSizeBytes();
+    const auto journalSize = sizeof(Journal) + numSectors * sizeof(uint32_t);
+
+    auto journal = mmap(nullptr, journalSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS,
+            -1, 0);
+    if(journal == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    gJournal = static_cast<Journal *>(journal);
+    gJournal->pendingKey = kNoKey;
+
+    /*
+     * Boot repeatedly; the first boot isn't interrupted, so it can format the flash (and then
+     * reset) if needed. Every other one has its power cut, unless it completes its updates first.
+     */
+    std::mt19937 rng(gParams.seed);
+    std::uniform_int_distribution<size_t> pickCut(1, gParams.maxCut);
+    size_t boots{0}, cuts{0}, resets{0}, completed{0};
+    bool ok{true};
+
+    for(size_t boot = 0; ok && boot < gParams.boots; boot++) {
+        boots++;
+
+        const auto cutAfter = boot ? pickCut(rng) : 0;
+        gBootSeed = rng();
+        gAdopt = !boot;
+
+        fflush(nullptr);
+        const auto pid = fork();
+        if(pid == -1) {
+            perror("fork");
+            return 1;
+        } else if(!pid) {
+            _exit(Boot(cutAfter));
+        }
+
+        int status;
+        if(waitpid(pid, &status, 0) == -1) {
+            perror("waitpid");
+            return 1;
+        }
+
+        if(WIFEXITED(status) && WEXITSTATUS(status) == kPowerCutStatus) {
+            cuts++;
+        } else if(WIFEXITED(status) && WEXITSTATUS(status) == SIM_RESET_EXIT_STATUS) {
+            resets++;
+        } else if(WIFEXITED(status) && !WEXITSTATUS(status)) {
+            completed++;
+        } else {
+            fprintf(stderr, "boot %zu (seed %08x, cut after %zu operations) failed: %s %d\n",
+                    boot, gBootSeed, cutAfter, WIFEXITED(status) ? "status" : "signal",
+                    WIFEXITED(status) ? WEXITSTATUS(status) : WTERMSIG(status));
+            ok = false;
+        }
+    }
+
+    if(isTemporary) {
+        unlink(gParams.path.c_str());
+    }
+
+    // print results
+    const auto wear = std::minmax_element(gJournal->wear, gJournal->wear + numSectors);
+    uint64_t totalWear{0};
+    for(size_t i = 0; i < numSectors; i++) {
+        totalWear += gJournal->wear[i];
+    }
+
+    printf("%zu boots: %zu power cuts, %zu resets, %zu completed\n", boots, cuts, resets,
+            completed);
+    printf("%lu updates completed\n", static_cast<unsigned long>(gJournal->updates));
+    printf("sector erases: %lu total, %u max, %u min\n", static_cast<unsigned long>(totalWear),
+            *wear.second, *wear.first);
+
+    return ok ? 0 : 2;
+}
@@ -0,0 +1,133 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+
+#include "Capture.h"
+
+using namespace Replay;
+
+using Recorder = HostIf::Recorder;
+
+/**
+ * @brief Load a capture from a log file
+ *
+ * @param path Log file containing a transaction dump
+ *
+ * @throws std::runtime_error If the file can't be read, or contains no complete dump
+ */
+Capture::Capture(const std::string &path) {
+    std::ifstream file(path);
+    if(!file) {
+        throw std::runtime_error("failed to open " + path);
+    }
+
+    const std::string tag = std::string(Recorder::kLogTag.data(), Recorder::kLogTag.size()) +
+        ": ";
+
+    std::vector<uint8_t> current, complete;
+    bool inDump{false}, haveDump{false};
+    size_t overwritten{0};
+
+    std::string line;
+    while(std::getline(file, line)) {
+        const auto start = line.find(tag);
+        if(start == std::string::npos) {
+            continue;
+        }
+
+        std::string_view body{line};
+        body.remove_prefix(start + tag.size());
+        while(!body.empty() && (body.back() == '\r' || body.back() == ' ')) {
+            body.remove_suffix(1);
+        }
+
+        if(body.starts_with("begin")) {
+            const auto paren = body.find('(');
+            overwritten = (paren == std::string_view::npos) ? 0 :
+                strtoul(std::string(body.substr(paren + 1)).c_str(), nullptr, 10);
+
+            current.clear();
+            inDump = true;
+        } else if(body == "end") {
+            if(inDump) {
+                complete = std::move(current);
+                this->overwritten = overwritten;
+                haveDump = true;
+            }
+            inDump = false;
+        } else if(inDump) {
+            if(body.size() % 2) {
+                throw std::runtime_error("malformed dump line: " + line);
+            }
+
+            for(size_t i = 0; i < body.size(); i += 2) {
+                char hex[3]{body[i], body[i + 1], '\0'};
+                char *end;
+                const auto value = strtoul(hex, &end, 16);
+                if(*end) {
+                    throw std::runtime_error("malformed dump line: " + line);
+                }
+                current.push_back(value);
+            }
+        }
+    }
+
+    if(!haveDump) {
+        throw std::runtime_error("no complete transaction dump in " + path);
+    }
+
+    this->parse(complete);
+}
+
+/**
+ * @brief Decode the records of a dump
+ *
+ * Record timestamps are in the device's 32-bit microsecond timebase; they're converted to offsets
+ * from the first record (accounting for wraparound.)
+ *
+ * @param data Raw ring contents
+ */
+void Capture::parse(const std::vector<uint8_t> &data) {
+    size_t offset{0};
+    uint32_t lastTimestamp{0};
+    std::chrono::microseconds elapsed{0};
+
+    while(offset < data.size()) {
+        Recorder::Record record;
+        if(data.size() - offset < sizeof(record)) {
+            throw std::runtime_error("truncated record header");
+        }
+        memcpy(&record, data.data() + offset, sizeof(record));
+        offset += sizeof(record);
+
+        Transaction txn{
+            .command = static_cast<uint8_t>(record.command & ~0x80),
+            .isRead = !!(record.command & 0x80),
+            .length = record.length,
+            .status = static_cast<Status>(record.status),
+            .responseBytes = 0,
+        };
+
+        if(txn.isRead) {
+            txn.responseBytes = record.size;
+        } else {
+            if(data.size() - offset < record.size) {
+                throw std::runtime_error("truncated record payload");
+            }
+            txn.payload.assign(data.begin() + offset, data.begin() + offset + record.size);
+            offset += record.size;
+        }
+
+        if(!this->transactions.empty()) {
+            elapsed += std::chrono::microseconds(static_cast<uint32_t>(record.timestamp -
+                        lastTimestamp));
+        }
+        lastTimestamp = record.timestamp;
+        txn.offset = elapsed;
+
+        this->transactions.emplace_back(std::move(txn));
+    }
+}
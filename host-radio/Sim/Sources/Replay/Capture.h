@@ -0,0 +1,67 @@
+#ifndef REPLAY_CAPTURE_H
+#define REPLAY_CAPTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "HostIf/Recorder.h"
+
+/// Replay of recorded host interface traffic
+namespace Replay {
+/**
+ * @brief Host transactions recorded by the firmware
+ *
+ * Parses the transaction ring dumped to the log by HostIf::Recorder. Only the tagged lines are
+ * considered, so a complete log capture (with any other messages) can be used as-is. If the log
+ * contains several dumps, the last complete one is used.
+ */
+class Capture {
+    public:
+        using Status = HostIf::Recorder::Status;
+
+        /// A single host transaction
+        struct Transaction {
+            /// Time since the first transaction in the capture
+            std::chrono::microseconds offset;
+            /// Command id (without the read bit)
+            uint8_t command;
+            /// Whether the host read from the radio
+            bool isRead;
+            /// Payload length from the command header
+            uint8_t length;
+            /// Outcome on the recording device
+            Status status;
+            /// Response bytes sent by the recording device (reads only)
+            size_t responseBytes;
+            /// Payload written by the host (writes only)
+            std::vector<uint8_t> payload;
+        };
+
+    public:
+        Capture(const std::string &path);
+
+        /// Get all transactions, in order
+        constexpr inline auto &getTransactions() const {
+            return this->transactions;
+        }
+        /// Number of records the device dropped from its ring before the dump
+        constexpr inline auto getOverwritten() const {
+            return this->overwritten;
+        }
+
+    private:
+        void parse(const std::vector<uint8_t> &data);
+
+    private:
+        /// Transactions, in the order they were performed
+        std::vector<Transaction> transactions;
+        /// Records that were lost on the device
+        size_t overwritten{0};
+};
+}
+
+#endif
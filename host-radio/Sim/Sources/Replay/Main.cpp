@@ -0,0 +1,169 @@
+/**
+ * @file
+ *
+ * @brief Host transaction replay
+ *
+ * Replays host interface transactions recorded on a device (see HostIf::Recorder) against the
+ * simulated firmware, with the recorded timing, and measures how long each of them takes. Runs
+ * against different firmware versions can be compared by saving the results of one as JSON, and
+ * passing it as the baseline for the other.
+ *
+ * Transactions whose command id was invalid, or whose payload was never received, are skipped:
+ * the host interface can't send them as recorded.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "Host/SimTransport.h"
+#include "Sim/Firmware.h"
+
+#include "Capture.h"
+#include "Results.h"
+
+using Clock = std::chrono::steady_clock;
+
+/// Replay parameters
+struct Params {
+    /// Log containing the recorded transactions
+    std::string capturePath;
+    /// Replay speed, relative to the recording (0 = as fast as possible)
+    double speed{1};
+    /// File to write results to
+    std::string jsonPath;
+    /// Results of a previous run to compare against
+    std::string baselinePath;
+};
+
+/**
+ * @brief Replay all transactions of a capture
+ *
+ * Each transaction is started at its recorded time (scaled by the replay speed), or immediately
+ * if the previous one is still running by then.
+ */
+static void RunReplay(const Replay::Capture &capture, const Params &params,
+        Replay::Results &results) {
+    using Status = Replay::Capture::Status;
+
+    BlazeNet::Host::SimTransport transport;
+    std::vector<uint8_t> buffer;
+
+    const auto start = Clock::now();
+
+    for(const auto &txn : capture.getTransactions()) {
+        if(txn.status == Status::Invalid || txn.status == Status::Aborted) {
+            results.skip();
+            continue;
+        }
+
+        // wait for the transaction's start time
+        auto scheduled = Clock::now();
+        if(params.speed > 0) {
+            scheduled = start + std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double, std::micro>(txn.offset) / params.speed);
+            std::this_thread::sleep_until(scheduled);
+        }
+
+        const auto begin = Clock::now();
+        int ret;
+
+        if(txn.isRead) {
+            buffer.resize(txn.length);
+            ret = transport.read(txn.command, buffer);
+        } else {
+            ret = transport.write(txn.command, txn.payload);
+        }
+
+        const auto end = Clock::now();
+
+        const auto lag = std::max(begin - scheduled, Clock::duration::zero());
+        const size_t bytes = txn.isRead ? std::max(ret, 0) : txn.payload.size();
+
+        results.add(txn.command, txn.isRead, end - begin, lag, bytes, (ret < 0));
+    }
+
+    results.finish(Clock::now() - start);
+}
+
+static void Usage(const char *argv0) {
+    fprintf(stderr, "usage: %s CAPTURE [--speed FACTOR] [--json FILE] [--baseline FILE]\n",
+            argv0);
+    fprintf(stderr, "  CAPTURE is a log containing a transaction dump; --speed 0 replays "
+            "without delays\n");
+}
+
+int main(int argc, char **argv) {
+    Params params;
+
+    // parse arguments
+    for(int i = 1; i < argc; i++) {
+        const std::string_view arg{argv[i]};
+
+        if(!arg.starts_with("--")) {
+            params.capturePath = arg;
+            continue;
+        } else if(i + 1 >= argc) {
+            Usage(argv[0]);
+            return 1;
+        }
+        const char *value = argv[++i];
+
+        if(arg == "--speed") {
+            params.speed = strtod(value, nullptr);
+        } else if(arg == "--json") {
+            params.jsonPath = value;
+        } else if(arg == "--baseline") {
+            params.baselinePath = value;
+        } else {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if(params.capturePath.empty() || params.speed < 0) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        const Replay::Capture capture(params.capturePath);
+        if(capture.getOverwritten()) {
+            fprintf(stderr, "note: %zu records were overwritten on the device before the dump\n",
+                    capture.getOverwritten());
+        }
+
+        // replay against the firmware
+        Replay::Results results;
+
+        Sim::Firmware::Init({
+            .loopback = true,
+        });
+        Sim::Firmware::Run([&] {
+            RunReplay(capture, params, results);
+            return true;
+        });
+
+        // report
+        results.print(stdout);
+
+        if(!params.baselinePath.empty()) {
+            printf("\n");
+            results.compare(params.baselinePath, stdout);
+        }
+        if(!params.jsonPath.empty()) {
+            results.writeJson(params.jsonPath);
+        }
+    } catch(const std::exception &e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,193 @@
+#include <stdlib.h>
+
+#include <algorithm>
+#include <fstream>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+
+#include "Results.h"
+
+using namespace Replay;
+
+/**
+ * @brief Get a percentile of a sorted series
+ */
+static double Percentile(const std::vector<double> &sorted, const double p) {
+    if(sorted.empty()) {
+        return 0;
+    }
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))];
+}
+
+/**
+ * @brief Record a replayed transaction
+ *
+ * @param command Command id (without the read bit)
+ * @param isRead Whether the transaction was a read
+ * @param latency Time taken to complete the transaction
+ * @param lag How late the transaction was started, relative to the recording
+ * @param bytes Payload bytes transferred
+ * @param failed Whether the transport reported an error
+ */
+void Results::add(const uint8_t command, const bool isRead,
+        const std::chrono::nanoseconds latency, const std::chrono::nanoseconds lag,
+        const size_t bytes, const bool failed) {
+    char key[8];
+    snprintf(key, sizeof(key), "%c%02x", isRead ? 'r' : 'w', command);
+
+    const auto us = std::chrono::duration<double, std::micro>(latency).count();
+
+    for(auto cls : {&this->all, &this->commands[key]}) {
+        cls->latencies.push_back(us);
+        cls->bytes += bytes;
+        cls->failed += failed ? 1 : 0;
+    }
+
+    this->lags.push_back(std::chrono::duration<double, std::micro>(lag).count());
+}
+
+/**
+ * @brief Record the end of the replay
+ *
+ * @param elapsed Time from the start of the replay until the last transaction completed
+ */
+void Results::finish(const std::chrono::nanoseconds elapsed) {
+    this->elapsed = elapsed;
+}
+
+/**
+ * @brief Add the metrics of a transaction class
+ *
+ * @param metrics Metrics to add to
+ * @param prefix Prefix for the metric names
+ * @param cls Measurements (copied, so they can be sorted)
+ */
+void Results::AddClassMetrics(Metrics &metrics, const std::string &prefix, Class cls) {
+    std::sort(cls.latencies.begin(), cls.latencies.end());
+
+    metrics[prefix + "transactions"] = cls.latencies.size();
+    metrics[prefix + "failed"] = cls.failed;
+    metrics[prefix + "bytes"] = cls.bytes;
+    metrics[prefix + "latency_p50_us"] = Percentile(cls.latencies, .5);
+    metrics[prefix + "latency_p90_us"] = Percentile(cls.latencies, .9);
+    metrics[prefix + "latency_p99_us"] = Percentile(cls.latencies, .99);
+    metrics[prefix + "latency_max_us"] = cls.latencies.empty() ? 0 : cls.latencies.back();
+}
+
+/**
+ * @brief Get all metrics
+ *
+ * Overall metrics have plain names; per command metrics are prefixed with the command key.
+ */
+Results::Metrics Results::getMetrics() const {
+    Metrics metrics;
+
+    const auto seconds = std::chrono::duration<double>(this->elapsed).count();
+
+    AddClassMetrics(metrics, "", this->all);
+    metrics["skipped"] = this->skipped;
+    metrics["elapsed_s"] = seconds;
+    metrics["transactions_per_s"] = seconds ? (this->all.latencies.size() / seconds) : 0;
+    metrics["bytes_per_s"] = seconds ? (this->all.bytes / seconds) : 0;
+
+    auto lags = this->lags;
+    std::sort(lags.begin(), lags.end());
+    metrics["lag_p99_us"] = Percentile(lags, .99);
+
+    for(const auto &[key, cls] : this->commands) {
+        AddClassMetrics(metrics, key + ".", cls);
+    }
+
+    return metrics;
+}
+
+/**
+ * @brief Print a summary
+ */
+void Results::print(FILE *out) const {
+    const auto m = this->getMetrics();
+
+    fprintf(out, "%.0f transactions (%.0f failed, %.0f skipped) in %.3f s: %.0f txn/s, %.1f kB/s "
+            "| latency (us) p50 %.1f p90 %.1f p99 %.1f max %.1f | start lag p99 %.1f us\n",
+            m.at("transactions"), m.at("failed"), m.at("skipped"), m.at("elapsed_s"),
+            m.at("transactions_per_s"), m.at("bytes_per_s") / 1000., m.at("latency_p50_us"),
+            m.at("latency_p90_us"), m.at("latency_p99_us"), m.at("latency_max_us"),
+            m.at("lag_p99_us"));
+
+    fprintf(out, "%-4s %8s %8s %10s %10s %10s %10s\n", "cmd", "count", "failed", "p50 (us)",
+            "p90 (us)", "p99 (us)", "max (us)");
+    for(const auto &[key, cls] : this->commands) {
+        const auto prefix = key + ".";
+        fprintf(out, "%-4s %8.0f %8.0f %10.1f %10.1f %10.1f %10.1f\n", key.c_str(),
+                m.at(prefix + "transactions"), m.at(prefix + "failed"),
+                m.at(prefix + "latency_p50_us"), m.at(prefix + "latency_p90_us"),
+                m.at(prefix + "latency_p99_us"), m.at(prefix + "latency_max_us"));
+    }
+}
+
+/**
+ * @brief Write all metrics to a file, as a flat JSON object
+ *
+ * @throws std::runtime_error If the file can't be written
+ */
+void Results::writeJson(const std::string &path) const {
+    std::ofstream file(path);
+    if(!file) {
+        throw std::runtime_error("failed to open " + path);
+    }
+
+    const auto metrics = this->getMetrics();
+
+    file << "{\n";
+    for(auto it = metrics.begin(); it != metrics.end(); ++it) {
+        file << "  \"" << it->first << "\": " << it->second;
+        file << (std::next(it) == metrics.end() ? "\n" : ",\n");
+    }
+    file << "}\n";
+}
+
+/**
+ * @brief Print the change of each metric, relative to a previous run
+ *
+ * Only metrics present in both runs are compared.
+ *
+ * @param baselinePath JSON file written by a previous run
+ *
+ * @throws std::runtime_error If the file can't be read
+ */
+void Results::compare(const std::string &baselinePath, FILE *out) const {
+    std::ifstream file(baselinePath);
+    if(!file) {
+        throw std::runtime_error("failed to open " + baselinePath);
+    }
+
+    std::stringstream contents;
+    contents << file.rdbuf();
+    const auto text = contents.str();
+
+    Metrics baseline;
+    const std::regex entry{R"re("([^"]+)"\s*:\s*(-?[0-9.eE+-]+))re"};
+    for(auto it = std::sregex_iterator(text.begin(), text.end(), entry);
+            it != std::sregex_iterator(); ++it) {
+        baseline[(*it)[1].str()] = strtod((*it)[2].str().c_str(), nullptr);
+    }
+
+    const auto current = this->getMetrics();
+
+    fprintf(out, "%-28s %14s %14s %9s\n", "metric", "baseline", "current", "delta");
+    for(const auto &[key, value] : current) {
+        const auto it = baseline.find(key);
+        if(it == baseline.end()) {
+            continue;
+        }
+
+        const auto base = it->second;
+        if(base) {
+            fprintf(out, "%-28s %14.1f %14.1f %+8.1f%%\n", key.c_str(), base, value,
+                    (value - base) * 100. / base);
+        } else {
+            fprintf(out, "%-28s %14.1f %14.1f %9s\n", key.c_str(), base, value, "-");
+        }
+    }
+}
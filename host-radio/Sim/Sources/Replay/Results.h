@@ -0,0 +1,70 @@
+#ifndef REPLAY_RESULTS_H
+#define REPLAY_RESULTS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Replay {
+/**
+ * @brief Replay measurements
+ *
+ * Collects the latency of each replayed transaction (overall, and per command and direction) and
+ * derives throughput and latency percentiles from them. Results are flattened into named metrics,
+ * which can be saved as JSON and compared against those of a previous run (for example, against
+ * a different firmware version.)
+ */
+class Results {
+    public:
+        using Metrics = std::map<std::string, double>;
+
+    public:
+        void add(const uint8_t command, const bool isRead, const std::chrono::nanoseconds latency,
+                const std::chrono::nanoseconds lag, const size_t bytes, const bool failed);
+        void finish(const std::chrono::nanoseconds elapsed);
+
+        /// Count a transaction that couldn't be replayed
+        inline void skip() {
+            this->skipped++;
+        }
+
+        Metrics getMetrics() const;
+
+        void print(FILE *out) const;
+        void writeJson(const std::string &path) const;
+        void compare(const std::string &baselinePath, FILE *out) const;
+
+    private:
+        /// Measurements of a class of transactions
+        struct Class {
+            /// Latency of each transaction (µs)
+            std::vector<double> latencies;
+            /// Payload bytes transferred
+            size_t bytes{0};
+            /// Transactions that failed
+            size_t failed{0};
+        };
+
+        static void AddClassMetrics(Metrics &metrics, const std::string &prefix, Class cls);
+
+    private:
+        /// All transactions
+        Class all;
+        /// Transactions by command, keyed by `r` or `w` and the command id in hex
+        std::map<std::string, Class> commands;
+        /// How late each transaction was started, relative to its recorded time (µs)
+        std::vector<double> lags;
+
+        /// Transactions that were not replayed
+        size_t skipped{0};
+        /// Total replay duration
+        std::chrono::nanoseconds elapsed{0};
+};
+}
+
+#endif
@@ -0,0 +1,214 @@
+#include <math.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "Channel.h"
+
+using namespace RfSim;
+
+/// Convert a power level from dBm to mW
+static inline double ToMilliwatts(const double dBm) {
+    return pow(10., dBm / 10.);
+}
+/// Convert a power level from mW to dBm
+static inline double ToDbm(const double mW) {
+    return 10. * log10(mW);
+}
+
+/**
+ * @brief Add a node to the channel
+ *
+ * @param position Location of the node
+ * @param txPower Transmit power (dBm)
+ *
+ * @return Index of the node
+ */
+size_t Channel::addNode(const Position &position, const double txPower) {
+    const auto index = this->nodes.size();
+
+    this->nodes.push_back(Node{
+        .position = position,
+        .txPower = txPower,
+        .pathLoss = std::vector<double>(index + 1, 0.),
+    });
+
+    // path loss is symmetric
+    for(size_t i = 0; i < index; i++) {
+        auto &other = this->nodes[i];
+
+        const auto distance = std::max(1., hypot(other.position.x - position.x,
+                    other.position.y - position.y));
+        const auto loss = this->phy.pathLossReference +
+            10. * this->phy.pathLossExponent * log10(distance);
+
+        other.pathLoss.push_back(loss);
+        this->nodes[index].pathLoss[i] = loss;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Calculate the time on air for a frame
+ *
+ * @param bytes Payload size, in bytes
+ */
+Time Channel::getAirtime(const size_t bytes) const {
+    const auto bits = static_cast<double>((bytes + this->phy.overheadBytes) * 8);
+    return Time(static_cast<Time::rep>(bits / this->phy.bitrate * 1e9));
+}
+
+/**
+ * @brief Get the energy currently on the channel at a node
+ *
+ * This is what the node's radio measures during clear channel assessment.
+ *
+ * @return Total received power, including the noise floor (dBm)
+ */
+double Channel::getEnergy(const size_t node) const {
+    return ToDbm(ToMilliwatts(this->phy.noiseFloor) + this->getInterference(node, nullptr));
+}
+
+/**
+ * @brief Start transmitting a frame
+ *
+ * The frame goes on the air immediately; once its airtime has elapsed, the reception callback
+ * is invoked for all receivers it's destined to, followed by the `done` callback.
+ *
+ * @param frame Frame to transmit
+ * @param done Invoked when the transmission has completed
+ */
+void Channel::transmit(const Frame &frame, std::function<void()> done) {
+    auto &source = this->nodes[frame.source];
+
+    // a node can't receive while transmitting
+    source.transmitting = true;
+    if(source.locked) {
+        source.locked->results[frame.source] = RxResult::ReceiverBusy;
+        source.locked = nullptr;
+    }
+
+    this->active.push_back(Transmission{
+        .frame = frame,
+        .results = std::vector<RxResult>(this->nodes.size(), RxResult::Collision),
+    });
+    auto it = std::prev(this->active.end());
+    auto &tx = *it;
+
+    // determine what each receiver does with the preamble
+    const auto capture = this->phy.captureThreshold;
+
+    for(size_t i = 0; i < this->nodes.size(); i++) {
+        auto &rx = this->nodes[i];
+        if(i == frame.source) {
+            continue;
+        } else if(rx.transmitting) {
+            tx.results[i] = RxResult::ReceiverBusy;
+            continue;
+        }
+
+        const auto rssi = this->getRssi(frame.source, i);
+        if(rssi < this->phy.sensitivity) {
+            tx.results[i] = RxResult::Weak;
+        }
+        // receiver is idle, or captured by a much stronger frame
+        else if(!rx.locked || rssi >= this->getRssi(rx.locked->frame.source, i) + capture) {
+            if(rx.locked) {
+                rx.locked->results[i] = RxResult::Collision;
+            }
+
+            rx.locked = &tx;
+            rx.minSinr = std::numeric_limits<double>::infinity();
+        }
+        // otherwise, the receiver stays locked on the earlier frame, and this one is lost
+    }
+
+    // the new frame interferes with everything else on the air
+    for(size_t i = 0; i < this->nodes.size(); i++) {
+        this->updateSinr(i);
+    }
+
+    this->events.after(this->getAirtime(frame.bytes), [this, it, done = std::move(done)] {
+        this->finish(it);
+        done();
+    });
+}
+
+/**
+ * @brief Complete a transmission
+ *
+ * Decide the outcome at each receiver, and notify the receivers the frame was destined for.
+ */
+void Channel::finish(std::list<Transmission>::iterator it) {
+    auto &tx = *it;
+    const auto threshold = ToMilliwatts(this->phy.captureThreshold);
+
+    for(size_t i = 0; i < this->nodes.size(); i++) {
+        auto &rx = this->nodes[i];
+        if(rx.locked != &tx) {
+            continue;
+        }
+
+        tx.results[i] = (rx.minSinr >= threshold) ? RxResult::Success : RxResult::Collision;
+        rx.locked = nullptr;
+    }
+
+    this->nodes[tx.frame.source].transmitting = false;
+
+    const auto frame = tx.frame;
+    const auto results = std::move(tx.results);
+    this->active.erase(it);
+
+    if(!this->rxHandler) {
+        return;
+    }
+
+    if(frame.destination == kBroadcast) {
+        for(size_t i = 0; i < this->nodes.size(); i++) {
+            if(i != frame.source) {
+                this->rxHandler(i, frame, results[i], this->getRssi(frame.source, i));
+            }
+        }
+    } else {
+        this->rxHandler(frame.destination, frame, results[frame.destination],
+                this->getRssi(frame.source, frame.destination));
+    }
+}
+
+/**
+ * @brief Update the signal quality of the frame a receiver is locked on
+ */
+void Channel::updateSinr(const size_t receiver) {
+    auto &rx = this->nodes[receiver];
+    if(!rx.locked) {
+        return;
+    }
+
+    const auto signal = ToMilliwatts(this->getRssi(rx.locked->frame.source, receiver));
+    const auto noise = ToMilliwatts(this->phy.noiseFloor) +
+        this->getInterference(receiver, rx.locked);
+
+    rx.minSinr = std::min(rx.minSinr, signal / noise);
+}
+
+/**
+ * @brief Sum the power of all transmissions on the air at a receiver
+ *
+ * @param receiver Node to evaluate at; its own transmission is ignored
+ * @param except Transmission to leave out (the wanted signal)
+ *
+ * @return Total power (mW)
+ */
+double Channel::getInterference(const size_t receiver, const Transmission *except) const {
+    double total{0};
+
+    for(const auto &tx : this->active) {
+        if(&tx == except || tx.frame.source == receiver) {
+            continue;
+        }
+        total += ToMilliwatts(this->getRssi(tx.frame.source, receiver));
+    }
+
+    return total;
+}
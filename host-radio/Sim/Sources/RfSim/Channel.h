@@ -0,0 +1,185 @@
+#ifndef RFSIM_CHANNEL_H
+#define RFSIM_CHANNEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <list>
+#include <vector>
+
+#include "EventQueue.h"
+
+namespace RfSim {
+/**
+ * @brief Physical layer parameters
+ *
+ * Defaults correspond to the 250kbps sub-GHz PHY (4µs/symbol) used by the radio firmware.
+ */
+struct PhyConfig {
+    /// Over-the-air bit rate (bits/sec)
+    double bitrate{250'000};
+    /// Bytes sent in addition to the payload (preamble, sync word, PHY header, CRC)
+    size_t overheadBytes{10};
+    /// Time to switch between receive and transmit
+    Time turnaround{std::chrono::microseconds(100)};
+
+    /// Noise floor (dBm)
+    double noiseFloor{-100};
+    /// Minimum signal strength required to detect a frame (dBm)
+    double sensitivity{-97};
+    /**
+     * @brief Capture threshold (dB)
+     *
+     * A frame is received if its signal to interference plus noise ratio stays above this value
+     * for its entire duration. A receiver also switches to a new frame whose preamble is at least
+     * this much stronger than the frame it's currently receiving.
+     */
+    double captureThreshold{6};
+
+    /// Path loss at the reference distance of 1m (dB; free space at 915MHz)
+    double pathLossReference{31.7};
+    /// Path loss exponent
+    double pathLossExponent{3};
+};
+
+/**
+ * @brief Shared radio channel
+ *
+ * Tracks all frames currently on the air, and decides for each receiver whether it received a
+ * frame, based on the signal strength at its location (log-distance path loss) and interference
+ * from overlapping transmissions. Receivers lock onto the first detectable preamble, but may be
+ * captured by a sufficiently stronger one. Radios are half-duplex: a node that's transmitting
+ * does not receive.
+ *
+ * All nodes share a single RF channel.
+ */
+class Channel {
+    public:
+        /// Broadcast destination
+        static const constexpr size_t kBroadcast{SIZE_MAX};
+
+        /**
+         * @brief Position of a node (in meters)
+         */
+        struct Position {
+            double x{0}, y{0};
+        };
+
+        /**
+         * @brief A frame to be transmitted
+         */
+        struct Frame {
+            /// Source node
+            size_t source;
+            /// Destination node (or kBroadcast)
+            size_t destination;
+            /// Payload size (bytes)
+            size_t bytes;
+            /// Priority it was queued with
+            uint8_t priority;
+            /// Time the frame was queued for transmission
+            Time queued;
+        };
+
+        /**
+         * @brief Outcome of a frame at a receiver
+         */
+        enum class RxResult: uint8_t {
+            /// Frame received successfully
+            Success,
+            /// Interference corrupted the frame, or the receiver was locked on another frame
+            Collision,
+            /// Signal below receiver sensitivity
+            Weak,
+            /// Receiver was transmitting
+            ReceiverBusy,
+        };
+
+        /**
+         * @brief Frame reception callback
+         *
+         * Invoked when a frame ends, for its destination (or every node, for broadcasts) with the
+         * outcome at that node, and the frame's signal strength there.
+         */
+        using RxHandler = std::function<void(size_t receiver, const Frame &, RxResult,
+                double rssi)>;
+
+    public:
+        Channel(EventQueue &events, const PhyConfig &phy) : events(events), phy(phy) {}
+
+        size_t addNode(const Position &position, const double txPower);
+
+        /// Set the callback invoked for frames arriving at a receiver
+        inline void setRxHandler(RxHandler handler) {
+            this->rxHandler = std::move(handler);
+        }
+
+        Time getAirtime(const size_t bytes) const;
+        double getEnergy(const size_t node) const;
+
+        void transmit(const Frame &frame, std::function<void()> done);
+
+        /// Get the PHY configuration
+        constexpr inline auto &getPhy() const {
+            return this->phy;
+        }
+        /// Get the number of nodes on the channel
+        inline size_t getNumNodes() const {
+            return this->nodes.size();
+        }
+        /// Get the received signal strength of `from`'s transmissions at `to` (dBm)
+        inline double getRssi(const size_t from, const size_t to) const {
+            return this->nodes[from].txPower - this->nodes[from].pathLoss[to];
+        }
+
+    private:
+        struct Transmission;
+
+        /**
+         * @brief State of a single node's radio
+         */
+        struct Node {
+            Position position;
+            /// Transmit power (dBm)
+            double txPower;
+            /// Path loss to every other node (dB)
+            std::vector<double> pathLoss;
+
+            /// Whether the node is currently transmitting
+            bool transmitting{false};
+            /// Transmission the receiver is locked onto, if any
+            Transmission *locked{nullptr};
+            /// Lowest SINR (linear) of the locked frame so far
+            double minSinr{0};
+        };
+
+        /**
+         * @brief A frame currently on the air
+         */
+        struct Transmission {
+            Frame frame;
+            /// Outcome at each receiver that isn't locked on this frame
+            std::vector<RxResult> results;
+        };
+
+    private:
+        void updateSinr(const size_t receiver);
+        void finish(std::list<Transmission>::iterator it);
+
+        double getInterference(const size_t receiver, const Transmission *except) const;
+
+    private:
+        EventQueue &events;
+        const PhyConfig phy;
+
+        RxHandler rxHandler;
+
+        /// All nodes on the channel
+        std::vector<Node> nodes;
+        /// Transmissions currently on the air
+        std::list<Transmission> active;
+};
+}
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef RFSIM_EVENTQUEUE_H
+#define RFSIM_EVENTQUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <functional>
+#include <queue>
+#include <vector>
+
+/// Discrete event RF channel simulator
+namespace RfSim {
+/// Simulated time, since the start of the simulation
+using Time = std::chrono::nanoseconds;
+
+/**
+ * @brief Discrete event queue
+ *
+ * Holds all pending events of the simulation, and executes them in order of their (simulated)
+ * time; events scheduled for the same time execute in the order they were scheduled.
+ */
+class EventQueue {
+    public:
+        using Handler = std::function<void()>;
+
+    public:
+        /**
+         * @brief Schedule an event
+         *
+         * @param at Time to execute the event at; must not be in the past
+         * @param handler Function to invoke
+         */
+        inline void schedule(const Time at, Handler handler) {
+            this->events.push(Event{
+                .at = std::max(at, this->current),
+                .sequence = this->nextSequence++,
+                .handler = std::move(handler),
+            });
+        }
+
+        /**
+         * @brief Schedule an event relative to the current time
+         */
+        inline void after(const Time delay, Handler handler) {
+            this->schedule(this->current + delay, std::move(handler));
+        }
+
+        /**
+         * @brief Execute events until the given time
+         *
+         * On return, the current time is `end` (or the time of the last event, if later.)
+         *
+         * @return Number of events executed
+         */
+        size_t runUntil(const Time end) {
+            size_t count{0};
+
+            while(!this->events.empty() && this->events.top().at <= end) {
+                // copy out the event first, as the handler may schedule more events
+                auto event = this->events.top();
+                this->events.pop();
+
+                this->current = event.at;
+                event.handler();
+                count++;
+            }
+
+            this->current = std::max(this->current, end);
+            return count;
+        }
+
+        /// Get the current simulation time
+        constexpr inline Time now() const {
+            return this->current;
+        }
+
+    private:
+        struct Event {
+            /// Time to execute the event
+            Time at;
+            /// Tie breaker for events at the same time
+            uint64_t sequence;
+            /// Function to invoke
+            Handler handler;
+        };
+
+        /// Orders events such that the earliest one is at the top of the heap
+        struct Later {
+            constexpr bool operator()(const Event &a, const Event &b) const {
+                return (a.at > b.at) || (a.at == b.at && a.sequence > b.sequence);
+            }
+        };
+
+    private:
+        /// Pending events
+        std::priority_queue<Event, std::vector<Event>, Later> events;
+        /// Current simulated time
+        Time current{0};
+        /// Sequence number for the next event
+        uint64_t nextSequence{0};
+};
+}
+
+#endif
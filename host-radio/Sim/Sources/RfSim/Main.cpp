@@ -0,0 +1,384 @@
+/**
+ * @file
+ *
+ * @brief Multi-node RF channel simulator
+ *
+ * Places a coordinator and a number of nodes on a plane, and runs a discrete event simulation of
+ * their traffic to the coordinator over a shared channel. Each node models the radio firmware's
+ * transmit queueing and CSMA-CA policy; the channel models airtime, path loss, collisions and
+ * capture. Runs in simulated time, as fast as the host allows.
+ *
+ * Prints throughput, latency percentiles and drop reasons per traffic priority; optionally
+ * writes the final counters of every node (in "Get Counters" format) as JSON.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "Channel.h"
+#include "EventQueue.h"
+#include "Node.h"
+#include "Stats.h"
+
+using namespace RfSim;
+
+/**
+ * @brief Traffic class
+ *
+ * Each node generates packets of this class to the coordinator.
+ */
+struct Traffic {
+    /// Transmit priority (0 = background, 3 = network control)
+    uint8_t priority{1};
+    /// Packets per second, per node
+    double rate{2};
+    /// Payload size, in bytes
+    size_t size{64};
+    /// Send at fixed intervals (with a random phase) rather than a Poisson process
+    bool periodic{false};
+};
+
+/// Simulation parameters
+struct Params {
+    /// Number of nodes (excluding the coordinator)
+    size_t numNodes{100};
+    /// Radius of the area nodes are placed in, around the coordinator (meters)
+    double radius{200};
+    /// Simulated duration (seconds)
+    double duration{60};
+    /// Random seed
+    uint64_t seed{1};
+    /// Transmit power of all nodes (dBm; maximum supported by the radio)
+    double txPower{14};
+    /// Beacon interval of the coordinator (ms; 0 to disable)
+    double beaconInterval{0};
+    /// Size of beacon frames (bytes)
+    size_t beaconSize{24};
+
+    /// Traffic generated by each node
+    std::vector<Traffic> traffic;
+
+    PhyConfig phy;
+    Node::Config node;
+
+    /// File to write per-node counters to
+    const char *jsonPath{nullptr};
+};
+
+/// Index of the coordinator node
+constexpr static const size_t kCoordinator{0};
+
+/**
+ * @brief Get the time until a traffic class generates its next packet
+ */
+static Time GetInterval(const Traffic &traffic, std::mt19937_64 &random) {
+    const auto seconds = traffic.periodic ? (1. / traffic.rate) :
+        std::exponential_distribution<double>(traffic.rate)(random);
+    return Time(static_cast<Time::rep>(seconds * 1e9));
+}
+
+/**
+ * @brief Generate a packet of a traffic class on a node
+ *
+ * Queues the packet for transmission to the coordinator, then schedules the next one.
+ */
+static void GeneratePacket(EventQueue &events, Node &node, Stats &stats, const Traffic &traffic,
+        std::mt19937_64 &random) {
+    stats.offered(traffic.priority);
+    node.queueTxPacket(Channel::Frame{
+        .source = node.getId(),
+        .destination = kCoordinator,
+        .bytes = traffic.size,
+        .priority = traffic.priority,
+        .queued = events.now(),
+    });
+
+    events.after(GetInterval(traffic, random), [&] {
+        GeneratePacket(events, node, stats, traffic, random);
+    });
+}
+
+/**
+ * @brief Send a beacon from the coordinator, and schedule the next one
+ */
+static void SendBeacon(EventQueue &events, Node &coordinator, const Params &params) {
+    coordinator.queueTxPacket(Channel::Frame{
+        .source = kCoordinator,
+        .destination = Channel::kBroadcast,
+        .bytes = params.beaconSize,
+        .priority = 3,
+        .queued = events.now(),
+    });
+
+    events.after(Time(static_cast<Time::rep>(params.beaconInterval * 1e6)), [&] {
+        SendBeacon(events, coordinator, params);
+    });
+}
+
+/**
+ * @brief Print the results of the simulation
+ */
+static void PrintResults(Stats &stats, const Params &params) {
+    constexpr static const char *kNames[Stats::kNumPriorities]{
+        "background", "normal", "realtime", "netcontrol",
+    };
+
+    printf("%zu nodes, %.0f m radius, %.1f s simulated\n", params.numNodes, params.radius,
+            params.duration);
+
+    for(uint8_t prio = 0; prio < Stats::kNumPriorities; prio++) {
+        auto &c = stats.get(prio);
+        if(!c.offered) {
+            continue;
+        }
+
+        size_t dropped{0};
+        for(const auto count : c.drops) {
+            dropped += count;
+        }
+
+        const auto toMs = [&](const double percentile) {
+            return std::chrono::duration<double, std::milli>(
+                    stats.getLatency(prio, percentile)).count();
+        };
+
+        printf("\n[%u %s]\n", prio, kNames[prio]);
+        printf("  offered %zu, delivered %zu (%.1f%%), dropped %zu, in flight %zu\n", c.offered,
+                c.delivered, 100. * c.delivered / c.offered, dropped,
+                c.offered - c.delivered - dropped);
+        printf("  throughput %.1f pkt/s, %.2f kbit/s\n", c.delivered / params.duration,
+                (c.deliveredBytes * 8.) / params.duration / 1000.);
+        printf("  latency ms: p50 %.2f  p90 %.2f  p99 %.2f  max %.2f\n", toMs(50), toMs(90),
+                toMs(99), toMs(100));
+
+        printf("  drops:");
+        for(size_t i = 0; i < Stats::kNumDropReasons; i++) {
+            printf(" %s %zu%s", Stats::GetName(static_cast<Stats::Drop>(i)), c.drops[i],
+                    (i + 1 < Stats::kNumDropReasons) ? "," : "\n");
+        }
+    }
+}
+
+/**
+ * @brief Write the counters of all nodes as JSON
+ *
+ * @return Whether the file was written
+ */
+static bool WriteCounters(const char *path, const std::vector<std::unique_ptr<Node>> &nodes) {
+    auto fp = fopen(path, "w");
+    if(!fp) {
+        perror("fopen");
+        return false;
+    }
+
+    fprintf(fp, "[\n");
+    for(size_t i = 0; i < nodes.size(); i++) {
+        const auto c = nodes[i]->getCounters();
+
+        fprintf(fp, "  {\"node\": %zu, \"currentTicks\": %u,\n", i, c.currentTicks);
+        fprintf(fp, "   \"txQueue\": {\"packetsPending\": %u, \"bufferSize\": %u, "
+                "\"bufferDiscards\": %u, \"bufferAllocFails\": %u, \"queueDiscards\": %u},\n",
+                c.txQueue.packetsPending, c.txQueue.bufferSize, c.txQueue.bufferDiscards,
+                c.txQueue.bufferAllocFails, c.txQueue.queueDiscards);
+        fprintf(fp, "   \"txRadio\": {\"fifoDrops\": %u, \"ccaFails\": %u, \"goodFrames\": %u},\n",
+                c.txRadio.fifoDrops, c.txRadio.ccaFails, c.txRadio.goodFrames);
+        fprintf(fp, "   \"rxRadio\": {\"fifoOverflows\": %u, \"frameErrors\": %u, "
+                "\"goodFrames\": %u}}%s\n", c.rxRadio.fifoOverflows, c.rxRadio.frameErrors,
+                c.rxRadio.goodFrames, (i + 1 < nodes.size()) ? "," : "");
+    }
+    fprintf(fp, "]\n");
+
+    fclose(fp);
+    return true;
+}
+
+/**
+ * @brief Parse a traffic class specification
+ *
+ * Format is `priority:rate:size[:periodic]`.
+ */
+static bool ParseTraffic(const char *spec, Traffic &out) {
+    unsigned int priority;
+    double rate;
+    size_t size;
+    char mode[16]{};
+
+    const auto count = sscanf(spec, "%u:%lf:%zu:%15s", &priority, &rate, &size, mode);
+    if(count < 3 || priority >= Stats::kNumPriorities || rate <= 0 || !size || size > 250) {
+        return false;
+    }
+
+    out = Traffic{
+        .priority = static_cast<uint8_t>(priority),
+        .rate = rate,
+        .size = size,
+        .periodic = (count == 4 && !strcmp(mode, "periodic")),
+    };
+    return true;
+}
+
+static void Usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--nodes N] [--radius M] [--duration S] [--seed N]\n"
+            "\t[--traffic PRIO:RATE:SIZE[:periodic]]... [--beacon-interval MS]\n"
+            "\t[--tx-power DBM] [--bitrate BPS] [--cca-threshold DBM] [--csma-min-be N]\n"
+            "\t[--csma-max-be N] [--csma-tries N] [--max-csma-fails N] [--tx-queue-size N]\n"
+            "\t[--tx-buffer-size BYTES] [--json FILE]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    Params params;
+
+    // parse arguments
+    for(int i = 1; i < argc; i++) {
+        const std::string_view arg{argv[i]};
+
+        if(i + 1 >= argc) {
+            Usage(argv[0]);
+            return 1;
+        }
+        const char *value = argv[++i];
+        const auto number = strtod(value, nullptr);
+
+        if(arg == "--nodes") {
+            params.numNodes = number;
+        } else if(arg == "--radius") {
+            params.radius = number;
+        } else if(arg == "--duration") {
+            params.duration = number;
+        } else if(arg == "--seed") {
+            params.seed = strtoull(value, nullptr, 0);
+        } else if(arg == "--traffic") {
+            Traffic traffic;
+            if(!ParseTraffic(value, traffic)) {
+                fprintf(stderr, "invalid traffic spec '%s'\n", value);
+                return 1;
+            }
+            params.traffic.push_back(traffic);
+        } else if(arg == "--beacon-interval") {
+            params.beaconInterval = number;
+        } else if(arg == "--tx-power") {
+            params.txPower = number;
+        } else if(arg == "--bitrate") {
+            params.phy.bitrate = number;
+        } else if(arg == "--cca-threshold") {
+            params.node.csma.ccaThreshold = number;
+        } else if(arg == "--csma-min-be") {
+            params.node.csma.csmaMinBoExp = number;
+        } else if(arg == "--csma-max-be") {
+            params.node.csma.csmaMaxBoExp = number;
+        } else if(arg == "--csma-tries") {
+            params.node.csma.csmaTries = number;
+        } else if(arg == "--max-csma-fails") {
+            params.node.maxCsmaFails = number;
+        } else if(arg == "--tx-queue-size") {
+            params.node.maxTxQueueSize = number;
+        } else if(arg == "--tx-buffer-size") {
+            params.node.maxTxBufferSize = number;
+        } else if(arg == "--json") {
+            params.jsonPath = value;
+        } else {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if(params.traffic.empty()) {
+        params.traffic.emplace_back();
+    }
+    if(!params.numNodes || params.duration <= 0 || params.phy.bitrate <= 0 ||
+            params.node.csma.csmaMinBoExp > params.node.csma.csmaMaxBoExp ||
+            params.node.csma.csmaMaxBoExp > 16) {
+        fprintf(stderr, "invalid parameters\n");
+        return 1;
+    }
+
+    // set up the channel and nodes: coordinator in the center, nodes spread evenly around it
+    EventQueue events;
+    Channel channel(events, params.phy);
+    Stats stats;
+
+    std::mt19937_64 random(params.seed);
+    std::vector<std::unique_ptr<Node>> nodes;
+
+    for(size_t i = 0; i <= params.numNodes; i++) {
+        Channel::Position position;
+
+        if(i != kCoordinator) {
+            const auto r = params.radius * sqrt(std::uniform_real_distribution<>(0, 1)(random));
+            const auto theta = std::uniform_real_distribution<>(0, 2 * M_PI)(random);
+            position = {.x = r * cos(theta), .y = r * sin(theta)};
+        }
+
+        const auto id = channel.addNode(position, params.txPower);
+        nodes.emplace_back(std::make_unique<Node>(events, channel, stats, id, params.node,
+                    params.seed + id));
+    }
+
+    channel.setRxHandler([&](size_t receiver, const Channel::Frame &frame,
+                Channel::RxResult result, double) {
+        nodes[receiver]->handleRxPacket(frame, result);
+
+        if(frame.destination == Channel::kBroadcast) {
+            return;
+        }
+
+        switch(result) {
+            case Channel::RxResult::Success:
+                stats.delivered(frame.priority, frame.bytes, events.now() - frame.queued);
+                break;
+            case Channel::RxResult::Collision:
+                stats.dropped(frame.priority, Stats::Drop::Collision);
+                break;
+            case Channel::RxResult::Weak:
+                stats.dropped(frame.priority, Stats::Drop::Weak);
+                break;
+            case Channel::RxResult::ReceiverBusy:
+                stats.dropped(frame.priority, Stats::Drop::ReceiverBusy);
+                break;
+        }
+    });
+
+    // start traffic, then run
+    for(size_t i = 0; i < nodes.size(); i++) {
+        if(i == kCoordinator) {
+            continue;
+        }
+
+        // random phase, so periodic nodes aren't synchronized
+        for(const auto &traffic : params.traffic) {
+            const auto phase = std::uniform_real_distribution<>(0, 1e9 / traffic.rate)(random);
+
+            events.after(Time(static_cast<Time::rep>(phase)), [&, &node = *nodes[i]] {
+                GeneratePacket(events, node, stats, traffic, random);
+            });
+        }
+    }
+
+    if(params.beaconInterval > 0) {
+        events.schedule(Time(0), [&] {
+            SendBeacon(events, *nodes[kCoordinator], params);
+        });
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    const auto numEvents = events.runUntil(Time(static_cast<Time::rep>(params.duration * 1e9)));
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+
+    PrintResults(stats, params);
+    printf("\n%zu events in %.2f s (%.0f events/s)\n", numEvents, elapsed.count(),
+            numEvents / elapsed.count());
+
+    if(params.jsonPath && !WriteCounters(params.jsonPath, nodes)) {
+        return 2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,197 @@
+#include <algorithm>
+
+#include "Node.h"
+
+using namespace RfSim;
+
+/**
+ * @brief Queue a packet for transmission
+ *
+ * Mirrors Packet::Handler::QueueTxPacket(): the queue for the packet's priority must have space,
+ * and the packet must fit into the transmit buffer budget. If nothing is pending, the packet is
+ * sent right away, bypassing the queue.
+ *
+ * @return Whether the packet was accepted
+ */
+bool Node::queueTxPacket(const Channel::Frame &frame) {
+    auto &queue = this->txQueues[frame.priority];
+
+    if(queue.size() >= this->config.maxTxQueueSize) {
+        this->counters.txQueue.queueDiscards++;
+        this->drop(frame, Stats::Drop::QueueFull);
+        return false;
+    }
+
+    const auto bytes = this->getBufferSize(frame);
+    if(this->txAllocBytes + bytes > this->config.maxTxBufferSize) {
+        this->counters.txQueue.bufferDiscards++;
+        this->drop(frame, Stats::Drop::BufferFull);
+        return false;
+    }
+    this->txAllocBytes += bytes;
+
+    if(!this->txPacketsPending++) {
+        this->currentTx = Packet{.frame = frame};
+        this->txPacketImmediate();
+    } else {
+        queue.push_back(Packet{.frame = frame});
+    }
+
+    return true;
+}
+
+/**
+ * @brief Handle the outcome of a frame at this node's receiver
+ *
+ * Frames that were corrupted count as frame errors; the radio doesn't see frames it couldn't
+ * detect at all.
+ */
+void Node::handleRxPacket(const Channel::Frame &frame, const Channel::RxResult result) {
+    switch(result) {
+        case Channel::RxResult::Success:
+            this->counters.rxRadio.goodFrames++;
+            break;
+        case Channel::RxResult::Collision:
+            this->counters.rxRadio.frameErrors++;
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Get the node's counters
+ *
+ * Equivalent to the response of the "Get Counters" command at the current simulation time.
+ */
+Node::Counters Node::getCounters() const {
+    auto counters = this->counters;
+
+    // firmware ticks at 250Hz
+    counters.currentTicks = static_cast<uint32_t>(this->events.now() /
+            std::chrono::milliseconds(4));
+    counters.txQueue.packetsPending = this->txPacketsPending;
+    counters.txQueue.bufferSize = this->txAllocBytes;
+
+    return counters;
+}
+
+/**
+ * @brief Begin transmitting the current packet
+ *
+ * Equivalent to Radio::Task::TxPacketImmediate(): starts a CSMA-CA transmission.
+ */
+void Node::txPacketImmediate() {
+    this->csmaAttempt(0, this->events.now());
+}
+
+/**
+ * @brief Perform one CSMA-CA backoff
+ *
+ * Wait for a random number of backoff periods (the range doubling with each attempt, up to the
+ * maximum backoff exponent) then assess the channel.
+ *
+ * @param attempt Number of attempts already made
+ * @param started Time the CSMA-CA procedure started (for the overall timeout)
+ */
+void Node::csmaAttempt(const uint8_t attempt, const Time started) {
+    const auto &csma = this->config.csma;
+
+    const auto exponent = std::min<unsigned int>(csma.csmaMinBoExp + attempt, csma.csmaMaxBoExp);
+    std::uniform_int_distribution<unsigned int> dist(0, (1U << exponent) - 1);
+    const auto backoff = std::chrono::microseconds(dist(this->random) * csma.ccaBackoff);
+
+    this->events.after(backoff, [this, attempt, started] {
+        this->clearChannelAssessment(attempt, started);
+    });
+}
+
+/**
+ * @brief Assess whether the channel is clear
+ *
+ * The channel must be below the CCA threshold at the start and end of the listening period. If
+ * so, the frame is transmitted (after switching to transmit mode); otherwise, back off again,
+ * unless the number of tries or overall timeout is exceeded.
+ */
+void Node::clearChannelAssessment(const uint8_t attempt, const Time started) {
+    const auto &csma = this->config.csma;
+    const auto threshold = static_cast<double>(csma.ccaThreshold);
+
+    const bool busyAtStart = this->channel.getEnergy(this->id) >= threshold;
+
+    this->events.after(std::chrono::microseconds(csma.ccaDuration),
+            [this, attempt, started, busyAtStart, threshold] {
+        const auto &csma = this->config.csma;
+
+        if(!busyAtStart && this->channel.getEnergy(this->id) < threshold) {
+            this->events.after(this->channel.getPhy().turnaround, [this] {
+                this->channel.transmit(this->currentTx->frame, [this] {
+                    this->counters.txRadio.goodFrames++;
+
+                    this->events.after(this->config.taskLatency, [this] {
+                        this->handleTxComplete(true);
+                    });
+                });
+            });
+            return;
+        }
+
+        const auto next = attempt + 1;
+        const auto elapsed = this->events.now() - started;
+
+        if(next >= csma.csmaTries || elapsed >= std::chrono::microseconds(csma.csmaTimeout)) {
+            this->events.after(this->config.taskLatency, [this] {
+                this->handleTxChannelBusy();
+            });
+        } else {
+            this->csmaAttempt(next, started);
+        }
+    });
+}
+
+/**
+ * @brief Handle a CSMA-CA failure
+ *
+ * Mirrors Radio::Task: retry the packet until it's failed too many times, then drop it.
+ */
+void Node::handleTxChannelBusy() {
+    this->counters.txRadio.ccaFails++;
+
+    if(++this->currentTx->csmaFailCount < this->config.maxCsmaFails) {
+        this->txPacketImmediate();
+    } else {
+        this->drop(this->currentTx->frame, Stats::Drop::CsmaFail);
+        this->handleTxComplete(false);
+    }
+}
+
+/**
+ * @brief Handle completion of the current packet
+ *
+ * Release the packet, then start transmitting the highest priority packet queued, if any.
+ */
+void Node::handleTxComplete(const bool success) {
+    this->discardTxPacket();
+
+    for(auto it = this->txQueues.rbegin(); it != this->txQueues.rend(); ++it) {
+        if(it->empty()) {
+            continue;
+        }
+
+        this->currentTx = std::move(it->front());
+        it->pop_front();
+
+        this->txPacketImmediate();
+        return;
+    }
+}
+
+/**
+ * @brief Release the packet currently being transmitted
+ */
+void Node::discardTxPacket() {
+    this->txAllocBytes -= this->getBufferSize(this->currentTx->frame);
+    this->txPacketsPending--;
+
+    this->currentTx.reset();
+}
@@ -0,0 +1,141 @@
+#ifndef RFSIM_NODE_H
+#define RFSIM_NODE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <deque>
+#include <optional>
+#include <random>
+
+#include <BlazeNet/HostIf/Commands.h>
+#include <rail_types.h>
+
+#include "Packet/Handler.h"
+
+#include "Channel.h"
+#include "EventQueue.h"
+#include "Stats.h"
+
+namespace RfSim {
+/**
+ * @brief Simulated radio node
+ *
+ * Models the transmit path of the radio firmware: the per-priority transmit queues and buffer
+ * budget of Packet::Handler, the CSMA retry policy of Radio::Task, and the CSMA-CA procedure
+ * the radio performs for each attempt. Defaults are the firmware's constants; the transmit queue
+ * limits are taken from Packet::Handler directly.
+ *
+ * Counters are kept in the same format as returned by the firmware's "Get Counters" command.
+ */
+class Node {
+    public:
+        /**
+         * @brief Node configuration
+         */
+        struct Config {
+            /// CSMA-CA parameters for each transmit attempt (Radio::Task::gCsmaConfig)
+            RAIL_CsmaConfig_t csma{
+                .csmaMinBoExp   = 3,
+                .csmaMaxBoExp   = 5,
+                .csmaTries      = 6,
+                .ccaThreshold   = -75,
+                .ccaBackoff     = 200,
+                .ccaDuration    = 40,
+                .csmaTimeout    = 10'000,
+            };
+            /// Transmit attempts before a packet is dropped (Radio::Task::kMaxCsmaFails)
+            size_t maxCsmaFails{5};
+
+            /// Maximum packets in each transmit queue
+            size_t maxTxQueueSize{::Packet::Handler::kMaxTxQueueSize};
+            /// Transmit buffer budget, in bytes
+            size_t maxTxBufferSize{::Packet::Handler::kMaxTxBufferSize};
+            /// Per packet buffer overhead
+            size_t txBufferOverhead{sizeof(::Packet::Handler::TxPacketBuffer)};
+
+            /// Delay between a radio event and the radio task handling it
+            Time taskLatency{std::chrono::microseconds(50)};
+        };
+
+        using Counters = HostIf::Response::GetCounters;
+
+    public:
+        Node(EventQueue &events, Channel &channel, Stats &stats, const size_t id,
+                const Config &config, const uint64_t seed) : events(events), channel(channel),
+            stats(stats), id(id), config(config), random(seed) {}
+
+        bool queueTxPacket(const Channel::Frame &frame);
+        void handleRxPacket(const Channel::Frame &frame, const Channel::RxResult result);
+
+        Counters getCounters() const;
+
+        /// Get the node's index on the channel
+        constexpr inline size_t getId() const {
+            return this->id;
+        }
+
+    private:
+        /**
+         * @brief A packet buffered for transmission
+         */
+        struct Packet {
+            Channel::Frame frame;
+            /// Number of transmit attempts that failed CSMA
+            uint8_t csmaFailCount{0};
+        };
+
+    private:
+        void txPacketImmediate();
+        void csmaAttempt(const uint8_t attempt, const Time started);
+        void clearChannelAssessment(const uint8_t attempt, const Time started);
+
+        void handleTxChannelBusy();
+        void handleTxComplete(const bool success);
+        void discardTxPacket();
+
+        /**
+         * @brief Record a packet that was dropped before it got on the air
+         *
+         * Broadcasts (beacons) are not part of the offered traffic, so they aren't recorded.
+         */
+        inline void drop(const Channel::Frame &frame, const Stats::Drop reason) {
+            if(frame.destination != Channel::kBroadcast) {
+                this->stats.dropped(frame.priority, reason);
+            }
+        }
+
+        /// Bytes of transmit buffer used by a packet
+        constexpr inline size_t getBufferSize(const Channel::Frame &frame) const {
+            return this->config.txBufferOverhead + frame.bytes;
+        }
+
+    private:
+        EventQueue &events;
+        Channel &channel;
+        Stats &stats;
+
+        /// Index of this node on the channel
+        const size_t id;
+        const Config config;
+
+        /// Random source for CSMA backoffs
+        std::mt19937_64 random;
+
+        /// Transmit queues, indexed by priority
+        std::array<std::deque<Packet>, Stats::kNumPriorities> txQueues;
+        /// Packet currently being transmitted
+        std::optional<Packet> currentTx;
+
+        /// Packets pending transmission (queued plus in flight)
+        size_t txPacketsPending{0};
+        /// Bytes of transmit buffer in use
+        size_t txAllocBytes{0};
+
+        /// Counters, as returned by the "Get Counters" command
+        Counters counters{};
+};
+}
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef RFSIM_STATS_H
+#define RFSIM_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "EventQueue.h"
+
+namespace RfSim {
+/**
+ * @brief Simulation results
+ *
+ * Collects the fate of every packet offered to the network, broken down by transmit priority.
+ */
+class Stats {
+    public:
+        /// Number of transmit priorities (matches Packet::Handler::TxPacketPriority)
+        static const constexpr size_t kNumPriorities{4};
+
+        /**
+         * @brief Reasons a packet was lost
+         */
+        enum class Drop: uint8_t {
+            /// Transmit queue for the packet's priority was full
+            QueueFull,
+            /// Transmit buffer budget exhausted
+            BufferFull,
+            /// Channel was busy for too many CSMA attempts
+            CsmaFail,
+            /// Corrupted by overlapping transmissions (or lost to an earlier one)
+            Collision,
+            /// Too weak to be detected at the receiver
+            Weak,
+            /// Receiver was transmitting at the time
+            ReceiverBusy,
+
+            /// Total number of drop reasons
+            NumReasons,
+        };
+        static const constexpr size_t kNumDropReasons{static_cast<size_t>(Drop::NumReasons)};
+
+        /**
+         * @brief Per priority statistics
+         */
+        struct Class {
+            /// Packets offered to the transmit queue
+            size_t offered{0};
+            /// Packets received at their destination
+            size_t delivered{0};
+            /// Payload bytes received at their destination
+            size_t deliveredBytes{0};
+            /// Lost packets, by reason
+            std::array<size_t, kNumDropReasons> drops{};
+
+            /// Latency (queued until received) of every delivered packet
+            std::vector<Time> latencies;
+        };
+
+    public:
+        /// Record a packet offered for transmission
+        inline void offered(const uint8_t priority) {
+            this->classes[priority].offered++;
+        }
+
+        /// Record a packet that was received at its destination
+        inline void delivered(const uint8_t priority, const size_t bytes, const Time latency) {
+            auto &c = this->classes[priority];
+            c.delivered++;
+            c.deliveredBytes += bytes;
+            c.latencies.push_back(latency);
+        }
+
+        /// Record a packet that was lost
+        inline void dropped(const uint8_t priority, const Drop reason) {
+            this->classes[priority].drops[static_cast<size_t>(reason)]++;
+        }
+
+        /// Get the statistics for a priority
+        inline Class &get(const uint8_t priority) {
+            return this->classes[priority];
+        }
+
+        /**
+         * @brief Get a latency percentile
+         *
+         * @param priority Priority to get the latency for
+         * @param percentile Percentile, in [0, 100]
+         *
+         * @remark Sorts the latency samples in place.
+         */
+        Time getLatency(const uint8_t priority, const double percentile) {
+            auto &samples = this->classes[priority].latencies;
+            if(samples.empty()) {
+                return Time(0);
+            }
+
+            std::sort(samples.begin(), samples.end());
+            const auto index = static_cast<size_t>(percentile / 100. * (samples.size() - 1));
+            return samples[std::min(index, samples.size() - 1)];
+        }
+
+        /// Get a human-readable name for a drop reason
+        static constexpr const char *GetName(const Drop reason) {
+            switch(reason) {
+                case Drop::QueueFull:
+                    return "queue full";
+                case Drop::BufferFull:
+                    return "buffer full";
+                case Drop::CsmaFail:
+                    return "csma fail";
+                case Drop::Collision:
+                    return "collision";
+                case Drop::Weak:
+                    return "weak signal";
+                case Drop::ReceiverBusy:
+                    return "receiver busy";
+                default:
+                    return "?";
+            }
+        }
+
+    private:
+        std::array<Class, kNumPriorities> classes;
+};
+}
+
+#endif
@@ -0,0 +1,35 @@
+/**
+ * @file
+ *
+ * @brief Device (CMSIS) shim
+ */
+#include <stdio.h>
+#include <unistd.h>
+
+#include <em_device.h>
+
+#include "Sim/Interrupts.h"
+
+/// Device information page; EUI-64 from the locally administered range
+DEVINFO_TypeDef sim_devinfo{
+    .EUI64L = 0x00000001,
+    .EUI64H = 0x02005A11,
+};
+
+/// Same core clock as the device (HFXO via DPLL)
+uint32_t SystemCoreClock{78'000'000};
+
+extern "C" void sim_wait_for_interrupt(void) {
+    Sim::Interrupts::WaitForInterrupt();
+}
+
+/**
+ * @brief Reset the system
+ *
+ * The process exits right away, like the device stops; a supervisor (such as the power loss
+ * test) can then start it again. Simulated flash contents are already in their backing file.
+ */
+extern "C" void sim_system_reset(void) {
+    fflush(nullptr);
+    _exit(SIM_RESET_EXIT_STATUS);
+}
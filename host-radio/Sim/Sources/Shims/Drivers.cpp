@@ -0,0 +1,47 @@
+/**
+ * @file
+ *
+ * @brief Driver instances
+ *
+ * Provides the driver instances that are generated by the SDK on the device.
+ */
+#include "Drivers/sl_spidrv_instances.h"
+#include "Drivers/sl_uartdrv_instances.h"
+
+static SPIDRV_HandleData_t gHostSpi{
+    .type = spidrvSlave,
+    .name = "host",
+};
+static SPIDRV_HandleData_t gFlashSpi{
+    .type = spidrvMaster,
+    .name = "flash",
+};
+static UARTDRV_HandleData_t gTtyUart{
+    .name = "tty",
+};
+static UARTDRV_Handle_t gDefaultUart{&gTtyUart};
+
+extern "C" {
+SPIDRV_Handle_t sl_spidrv_eusart_host_handle{&gHostSpi};
+SPIDRV_Handle_t sl_spidrv_eusart_flash_handle{&gFlashSpi};
+UARTDRV_Handle_t sl_uartdrv_eusart_tty_handle{&gTtyUart};
+
+void sl_spidrv_init_instances(void) {
+}
+
+void sl_uartdrv_init_instances(void) {
+}
+
+sl_status_t sl_uartdrv_set_default(UARTDRV_Handle_t handle) {
+    if(!handle) {
+        return SL_STATUS_INVALID_PARAMETER;
+    }
+
+    gDefaultUart = handle;
+    return SL_STATUS_OK;
+}
+
+UARTDRV_Handle_t sl_uartdrv_get_default(void) {
+    return gDefaultUart;
+}
+}
@@ -0,0 +1,40 @@
+/**
+ * @file
+ *
+ * @brief GPIO (emlib) shim
+ *
+ * Forwards pin accesses to the simulated GPIO block.
+ */
+#include <em_gpio.h>
+
+#include "Sim/Gpio.h"
+
+using Sim::Gpio;
+
+extern "C" {
+void GPIO_PinModeSet(unsigned int port, unsigned int pin, GPIO_Mode_TypeDef mode,
+        unsigned int out) {
+    Gpio::SetMode(static_cast<GPIO_Port_TypeDef>(port), pin, mode, !!out);
+}
+
+void GPIO_PinOutSet(unsigned int port, unsigned int pin) {
+    Gpio::SetOutput(static_cast<GPIO_Port_TypeDef>(port), pin, true);
+}
+
+void GPIO_PinOutClear(unsigned int port, unsigned int pin) {
+    Gpio::SetOutput(static_cast<GPIO_Port_TypeDef>(port), pin, false);
+}
+
+void GPIO_PinOutToggle(unsigned int port, unsigned int pin) {
+    Gpio::ToggleOutput(static_cast<GPIO_Port_TypeDef>(port), pin);
+}
+
+unsigned int GPIO_PinOutGet(unsigned int port, unsigned int pin) {
+    return Gpio::GetOutput(static_cast<GPIO_Port_TypeDef>(port), pin);
+}
+
+// inputs aren't driven externally: they read back the output state
+unsigned int GPIO_PinInGet(unsigned int port, unsigned int pin) {
+    return Gpio::GetOutput(static_cast<GPIO_Port_TypeDef>(port), pin);
+}
+}
@@ -0,0 +1,91 @@
+/**
+ * @file
+ *
+ * @brief Heap shim
+ *
+ * The firmware allocates from the C library heap, whose lock is a regular mutex. A task that is
+ * switched out while holding that lock would deadlock any other task that tries to allocate, so
+ * the allocator (wrapped at link time) is only entered inside a critical section.
+ *
+ * Host threads use the same allocator; they simply contend for the heap lock as usual, and must
+ * not touch the scheduler's critical section state.
+ *
+ * The host heap has no fixed size, so a nominal heap size is reported to the firmware instead.
+ */
+#include <signal.h>
+#include <stddef.h>
+
+#include "Rtos/Heap.h"
+#include "Rtos/Rtos.h"
+
+/// Nominal heap size reported to the firmware (bytes)
+constexpr static const size_t kHeapSize{32 * 1024};
+
+/**
+ * @brief Critical section guard for allocator calls
+ *
+ * A critical section is entered only if the tick signal can currently be delivered to the calling
+ * thread. Otherwise, this is either a host thread (which always has all signals blocked) or a
+ * task that's already in a critical section; in both cases, there's nothing to do.
+ */
+class AllocatorGuard {
+    public:
+        AllocatorGuard() {
+            sigset_t mask;
+            pthread_sigmask(SIG_BLOCK, nullptr, &mask);
+
+            this->critical = !sigismember(&mask, SIGALRM);
+            if(this->critical) {
+                taskENTER_CRITICAL();
+            }
+        }
+
+        ~AllocatorGuard() {
+            if(this->critical) {
+                taskEXIT_CRITICAL();
+            }
+        }
+
+    private:
+        /// Whether a critical section was entered
+        bool critical;
+};
+
+extern "C" {
+void *__real_malloc(size_t size);
+void __real_free(void *ptr);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    AllocatorGuard guard;
+    return __real_malloc(size);
+}
+
+void __wrap_free(void *ptr) {
+    AllocatorGuard guard;
+    __real_free(ptr);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    AllocatorGuard guard;
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    AllocatorGuard guard;
+    return __real_realloc(ptr, size);
+}
+}
+
+/**
+ * @brief Get the state of the (simulated) system heap
+ *
+ * Free space is the reported heap size, less the firmware's own allocations; it's never
+ * fragmented.
+ */
+void Rtos::Heap::GetSystemStats(SystemStats &out) {
+    out.size = kHeapSize;
+    out.free = (gBytes < kHeapSize) ? (kHeapSize - gBytes) : 0;
+    out.largestFree = out.free;
+}
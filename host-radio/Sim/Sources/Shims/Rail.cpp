@@ -0,0 +1,169 @@
+/**
+ * @file
+ *
+ * @brief RAIL shim
+ *
+ * Implements the subset of the RAIL API used by the firmware on top of the simulated radio. The
+ * RAIL utility init plugin is replaced as well, so that the radio comes up the same way as on the
+ * device.
+ */
+#include <string.h>
+
+#include <etl/algorithm.h>
+#include <rail.h>
+
+#include "Radio/sl_rail_util_init.h"
+
+#include "Sim/Radio.h"
+
+using Sim::Radio;
+
+/// Lowest transmit power supported (in ⅒ dBm)
+constexpr static const RAIL_TxPower_t kMinTxPower{-300};
+/// Transmit power per raw power level step (in ⅒ dBm)
+constexpr static const RAIL_TxPower_t kTxPowerStep{5};
+/// Highest raw power level
+constexpr static const RAIL_TxPowerLevel_t kMaxTxPowerLevel{100};
+
+extern "C" {
+void sl_rail_util_init(void) {
+    sl_rail_util_on_rf_ready(Radio::GetHandle());
+}
+
+RAIL_Handle_t sl_rail_util_get_handle(sl_rail_util_handle_type_t handle) {
+    return (handle == SL_RAIL_UTIL_HANDLE_INST0) ? Radio::GetHandle() : nullptr;
+}
+
+
+
+RAIL_Time_t RAIL_GetTime(void) {
+    return Radio::GetTime();
+}
+
+RAIL_Status_t RAIL_StartRx(RAIL_Handle_t handle, uint16_t channel,
+        const RAIL_SchedulerInfo_t *schedulerInfo) {
+    return Radio::StartRx(channel);
+}
+
+RAIL_Status_t RAIL_StartTx(RAIL_Handle_t handle, uint16_t channel, RAIL_TxOptions_t options,
+        const RAIL_SchedulerInfo_t *schedulerInfo) {
+    return Radio::StartTx(channel);
+}
+
+// the simulated channel is always clear
+RAIL_Status_t RAIL_StartCcaCsmaTx(RAIL_Handle_t handle, uint16_t channel,
+        RAIL_TxOptions_t options, const RAIL_CsmaConfig_t *csmaConfig,
+        const RAIL_SchedulerInfo_t *schedulerInfo) {
+    return Radio::StartTx(channel);
+}
+
+uint16_t RAIL_WriteTxFifo(RAIL_Handle_t handle, const uint8_t *dataPtr, uint16_t writeLength,
+        bool reset) {
+    return Radio::WriteTxFifo(dataPtr, writeLength, reset);
+}
+
+void RAIL_ResetFifo(RAIL_Handle_t handle, bool txFifo, bool rxFifo) {
+    Radio::ResetFifo(txFifo, rxFifo);
+}
+
+
+
+RAIL_RxPacketHandle_t RAIL_HoldRxPacket(RAIL_Handle_t handle) {
+    return Radio::HoldRxPacket();
+}
+
+RAIL_RxPacketHandle_t RAIL_GetRxPacketInfo(RAIL_Handle_t handle,
+        RAIL_RxPacketHandle_t packetHandle, RAIL_RxPacketInfo_t *pPacketInfo) {
+    return Radio::GetRxPacketInfo(packetHandle, pPacketInfo);
+}
+
+RAIL_Status_t RAIL_GetRxPacketDetails(RAIL_Handle_t handle, RAIL_RxPacketHandle_t packetHandle,
+        RAIL_RxPacketDetails_t *pPacketDetails) {
+    return Radio::GetRxPacketDetails(packetHandle, pPacketDetails);
+}
+
+RAIL_Status_t RAIL_ReleaseRxPacket(RAIL_Handle_t handle, RAIL_RxPacketHandle_t packetHandle) {
+    return Radio::ReleaseRxPacket(packetHandle);
+}
+
+// frames are always stored contiguously
+void RAIL_CopyRxPacket(uint8_t *pDest, const RAIL_RxPacketInfo_t *pPacketInfo) {
+    memcpy(pDest, pPacketInfo->firstPortionData, pPacketInfo->firstPortionBytes);
+}
+
+
+
+RAIL_Status_t RAIL_IsValidChannel(RAIL_Handle_t handle, uint16_t channel) {
+    return Radio::IsValidChannel(channel) ? RAIL_STATUS_NO_ERROR : RAIL_STATUS_INVALID_PARAMETER;
+}
+
+RAIL_Status_t RAIL_GetChannel(RAIL_Handle_t handle, uint16_t *channel) {
+    const auto current = Radio::GetChannel();
+    if(!current) {
+        return RAIL_STATUS_INVALID_CALL;
+    }
+
+    *channel = *current;
+    return RAIL_STATUS_NO_ERROR;
+}
+
+RAIL_RadioState_t RAIL_GetRadioState(RAIL_Handle_t handle) {
+    return Radio::GetState();
+}
+
+
+
+// power levels map linearly onto [-30, +20] dBm
+RAIL_TxPowerLevel_t RAIL_ConvertDbmToRaw(RAIL_Handle_t handle, RAIL_TxPowerMode_t mode,
+        RAIL_TxPower_t power) {
+    const int level = (power - kMinTxPower) / kTxPowerStep;
+    return etl::clamp<int>(level, 0, kMaxTxPowerLevel);
+}
+
+RAIL_TxPower_t RAIL_ConvertRawToDbm(RAIL_Handle_t handle, RAIL_TxPowerMode_t mode,
+        RAIL_TxPowerLevel_t powerLevel) {
+    return (powerLevel * kTxPowerStep) + kMinTxPower;
+}
+
+RAIL_Status_t RAIL_SetTxPower(RAIL_Handle_t handle, RAIL_TxPowerLevel_t powerLevel) {
+    if(powerLevel > kMaxTxPowerLevel) {
+        return RAIL_STATUS_INVALID_PARAMETER;
+    }
+
+    Radio::SetTxPower(powerLevel);
+    return RAIL_STATUS_NO_ERROR;
+}
+
+RAIL_TxPowerLevel_t RAIL_GetTxPower(RAIL_Handle_t handle) {
+    return Radio::GetTxPower();
+}
+
+
+
+// auto-ack and calibration are no-ops
+RAIL_Status_t RAIL_ConfigAutoAck(RAIL_Handle_t handle, const RAIL_AutoAckConfig_t *config) {
+    return RAIL_STATUS_NO_ERROR;
+}
+
+RAIL_Status_t RAIL_WriteAutoAckFifo(RAIL_Handle_t handle, const uint8_t *ackData,
+        uint8_t ackDataLen) {
+    return RAIL_STATUS_NO_ERROR;
+}
+
+void RAIL_EnablePaCal(bool enable) {
+}
+
+RAIL_Status_t RAIL_CalibrateIr(RAIL_Handle_t handle, uint32_t *imageRejection) {
+    *imageRejection = 0;
+    return RAIL_STATUS_NO_ERROR;
+}
+
+RAIL_Status_t RAIL_Calibrate(RAIL_Handle_t handle, RAIL_CalValues_t *calValues,
+        RAIL_CalMask_t calForce) {
+    return RAIL_STATUS_NO_ERROR;
+}
+
+RAIL_CalMask_t RAIL_GetPendingCal(RAIL_Handle_t handle) {
+    return 0;
+}
+}
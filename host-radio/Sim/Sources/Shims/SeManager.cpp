@@ -0,0 +1,18 @@
+/**
+ * @file
+ *
+ * @brief Secure engine manager shim
+ *
+ * There is no secure engine; only its initialization is supported.
+ */
+#include <sl_se_manager.h>
+
+extern "C" {
+sl_status_t sl_se_init(void) {
+    return SL_STATUS_OK;
+}
+
+sl_status_t sl_se_deinit(void) {
+    return SL_STATUS_OK;
+}
+}
@@ -0,0 +1,38 @@
+/**
+ * @file
+ *
+ * @brief Sleeptimer shim
+ *
+ * Forwards to the simulated low frequency timer.
+ */
+#include <sl_sleeptimer.h>
+
+#include "Sim/Sleeptimer.h"
+
+using Sim::Sleeptimer;
+
+extern "C" {
+sl_status_t sl_sleeptimer_init(void) {
+    Sleeptimer::Init();
+    return SL_STATUS_OK;
+}
+
+uint32_t sl_sleeptimer_get_timer_frequency(void) {
+    return Sleeptimer::kFrequency;
+}
+
+uint32_t sl_sleeptimer_get_tick_count(void) {
+    return static_cast<uint32_t>(Sleeptimer::GetTicks());
+}
+
+// all timers are one-shot, and there's no priority between them
+sl_status_t sl_sleeptimer_start_timer(sl_sleeptimer_timer_handle_t *handle, uint32_t timeout,
+        sl_sleeptimer_timer_callback_t callback, void *callback_data, uint8_t priority,
+        uint16_t option_flags) {
+    return Sleeptimer::Start(handle, timeout, callback, callback_data);
+}
+
+sl_status_t sl_sleeptimer_stop_timer(sl_sleeptimer_timer_handle_t *handle) {
+    return Sleeptimer::Stop(handle);
+}
+}
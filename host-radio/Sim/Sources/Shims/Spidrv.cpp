@@ -0,0 +1,50 @@
+/**
+ * @file
+ *
+ * @brief SPI driver shim
+ *
+ * Slave transfers are carried out over the simulated host link. Master transfers go to the
+ * simulated NOR flash (see Shims/SpidrvMaster.cpp), which also handles aborting them.
+ */
+#include <spidrv.h>
+
+#include "Sim/HostLink.h"
+#include "Sim/NorFlash.h"
+
+using Sim::HostLink;
+using Sim::NorFlash;
+
+extern "C" {
+// timeouts are not supported (the firmware doesn't use them)
+Ecode_t SPIDRV_SReceive(SPIDRV_Handle_t handle, void *buffer, int count,
+        SPIDRV_Callback_t callback, int timeoutMs) {
+    if(!handle) {
+        return ECODE_EMDRV_SPIDRV_ILLEGAL_HANDLE;
+    } else if(handle->type != spidrvSlave || count <= 0 || timeoutMs) {
+        return ECODE_EMDRV_SPIDRV_PARAM_ERROR;
+    }
+
+    return HostLink::Arm(handle, static_cast<uint8_t *>(buffer), nullptr, count, callback);
+}
+
+Ecode_t SPIDRV_STransmit(SPIDRV_Handle_t handle, const void *buffer, int count,
+        SPIDRV_Callback_t callback, int timeoutMs) {
+    if(!handle) {
+        return ECODE_EMDRV_SPIDRV_ILLEGAL_HANDLE;
+    } else if(handle->type != spidrvSlave || count <= 0 || timeoutMs) {
+        return ECODE_EMDRV_SPIDRV_PARAM_ERROR;
+    }
+
+    return HostLink::Arm(handle, nullptr, static_cast<const uint8_t *>(buffer), count, callback);
+}
+
+Ecode_t SPIDRV_AbortTransfer(SPIDRV_Handle_t handle) {
+    if(!handle) {
+        return ECODE_EMDRV_SPIDRV_ILLEGAL_HANDLE;
+    } else if(handle->type == spidrvMaster) {
+        return NorFlash::Abort(handle);
+    }
+
+    return HostLink::Abort(handle);
+}
+}
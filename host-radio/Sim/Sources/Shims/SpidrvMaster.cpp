@@ -0,0 +1,69 @@
+/**
+ * @file
+ *
+ * @brief SPI driver shim (master transfers)
+ *
+ * Master transfers are carried out against the simulated NOR flash, which is the only device on
+ * the master bus. Transfers are rejected if it isn't attached.
+ */
+#include <spidrv.h>
+
+#include "Sim/NorFlash.h"
+
+using Sim::NorFlash;
+
+extern "C" {
+Ecode_t SPIDRV_MTransmitB(SPIDRV_Handle_t handle, const void *buffer, int count) {
+    if(!handle) {
+        return ECODE_EMDRV_SPIDRV_ILLEGAL_HANDLE;
+    } else if(handle->type != spidrvMaster || count <= 0) {
+        return ECODE_EMDRV_SPIDRV_PARAM_ERROR;
+    }
+
+    return NorFlash::Transfer(handle, static_cast<const uint8_t *>(buffer), nullptr, count,
+            nullptr);
+}
+
+Ecode_t SPIDRV_MReceiveB(SPIDRV_Handle_t handle, void *buffer, int count) {
+    if(!handle) {
+        return ECODE_EMDRV_SPIDRV_ILLEGAL_HANDLE;
+    } else if(handle->type != spidrvMaster || count <= 0) {
+        return ECODE_EMDRV_SPIDRV_PARAM_ERROR;
+    }
+
+    return NorFlash::Transfer(handle, nullptr, static_cast<uint8_t *>(buffer), count, nullptr);
+}
+
+Ecode_t SPIDRV_MTransmit(SPIDRV_Handle_t handle, const void *buffer, int count,
+        SPIDRV_Callback_t callback) {
+    if(!handle) {
+        return ECODE_EMDRV_SPIDRV_ILLEGAL_HANDLE;
+    } else if(handle->type != spidrvMaster || count <= 0 || !callback) {
+        return ECODE_EMDRV_SPIDRV_PARAM_ERROR;
+    }
+
+    return NorFlash::Transfer(handle, static_cast<const uint8_t *>(buffer), nullptr, count,
+            callback);
+}
+
+Ecode_t SPIDRV_MReceive(SPIDRV_Handle_t handle, void *buffer, int count,
+        SPIDRV_Callback_t callback) {
+    if(!handle) {
+        return ECODE_EMDRV_SPIDRV_ILLEGAL_HANDLE;
+    } else if(handle->type != spidrvMaster || count <= 0 || !callback) {
+        return ECODE_EMDRV_SPIDRV_PARAM_ERROR;
+    }
+
+    return NorFlash::Transfer(handle, nullptr, static_cast<uint8_t *>(buffer), count, callback);
+}
+
+Ecode_t SPIDRV_SetBitrate(SPIDRV_Handle_t handle, uint32_t bitRate) {
+    if(!handle) {
+        return ECODE_EMDRV_SPIDRV_ILLEGAL_HANDLE;
+    } else if(handle->type != spidrvMaster || !bitRate) {
+        return ECODE_EMDRV_SPIDRV_PARAM_ERROR;
+    }
+
+    return NorFlash::SetBitrate(bitRate);
+}
+}
@@ -0,0 +1,55 @@
+/**
+ * @file
+ *
+ * @brief UART driver shim
+ *
+ * All UART output goes to the simulator's standard error. Buffered transmissions complete
+ * immediately, but their callback is still invoked from the simulated interrupt context.
+ */
+#include <stdio.h>
+
+#include <uartdrv.h>
+
+#include "Rtos/Rtos.h"
+#include "Sim/Interrupts.h"
+
+using Sim::Interrupts;
+
+/**
+ * @brief Write data to standard error
+ *
+ * Inside a critical section, so no task can be switched out while holding the stdio lock.
+ */
+static void Output(const uint8_t *data, const UARTDRV_Count_t count) {
+    taskENTER_CRITICAL();
+    fwrite(data, 1, count, stderr);
+    taskEXIT_CRITICAL();
+}
+
+extern "C" {
+Ecode_t UARTDRV_Transmit(UARTDRV_Handle_t handle, uint8_t *data, UARTDRV_Count_t count,
+        UARTDRV_Callback_t callback) {
+    if(!handle) {
+        return ECODE_EMDRV_UARTDRV_ILLEGAL_HANDLE;
+    }
+
+    Output(data, count);
+
+    if(callback) {
+        Interrupts::Pend([handle, data, count, callback] {
+            callback(handle, ECODE_EMDRV_UARTDRV_OK, data, count);
+        });
+    }
+
+    return ECODE_EMDRV_UARTDRV_OK;
+}
+
+Ecode_t UARTDRV_ForceTransmit(UARTDRV_Handle_t handle, uint8_t *data, UARTDRV_Count_t count) {
+    if(!handle) {
+        return ECODE_EMDRV_UARTDRV_ILLEGAL_HANDLE;
+    }
+
+    Output(data, count);
+    return ECODE_EMDRV_UARTDRV_OK;
+}
+}
@@ -0,0 +1,44 @@
+#ifndef SIM_CRITICALLOCK_H
+#define SIM_CRITICALLOCK_H
+
+#include <mutex>
+
+#include "Rtos/Rtos.h"
+
+namespace Sim {
+/**
+ * @brief Lock state shared between firmware tasks and host threads
+ *
+ * Simulator state is accessed both from firmware tasks (through the driver stand-ins) and from
+ * host threads (the simulated host, radio, etc.) so it's protected by a regular mutex. A firmware
+ * task must not be switched out while holding such a mutex: another task (that the scheduler
+ * would then keep running) could block on it forever. So from firmware context, the mutex is
+ * only ever taken inside a critical section.
+ *
+ * Host threads just take the mutex directly; they must never wait on firmware while holding it.
+ *
+ * @remark Use only from firmware context (tasks, the simulated interrupt context, or before the
+ *         scheduler is started).
+ */
+class CriticalLock {
+    public:
+        explicit CriticalLock(std::mutex &lock) : lock(lock) {
+            taskENTER_CRITICAL();
+            this->lock.lock();
+        }
+
+        ~CriticalLock() {
+            this->lock.unlock();
+            taskEXIT_CRITICAL();
+        }
+
+        CriticalLock(const CriticalLock &) = delete;
+        CriticalLock &operator=(const CriticalLock &) = delete;
+
+    private:
+        /// Mutex held for the lifetime of this object
+        std::mutex &lock;
+};
+}
+
+#endif
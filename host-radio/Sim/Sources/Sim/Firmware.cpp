@@ -0,0 +1,110 @@
+#include "em_device.h"
+#include "gpiointerrupt.h"
+#include "sl_sleeptimer.h"
+#include "Drivers/sl_spidrv_instances.h"
+#include "Drivers/sl_uartdrv_instances.h"
+
+#include "BuildInfo.h"
+#include "BlazeNet/Init.h"
+#include "Crypto/Init.h"
+#include "Debug/Probes.h"
+#include "HostIf/Init.h"
+#include "Hw/Clocks.h"
+#include "Hw/Identity.h"
+#include "Hw/Indicators.h"
+#include "Log/Logger.h"
+#include "Packet/Handler.h"
+#include "Radio/Init.h"
+#include "Rtos/Rtos.h"
+
+#include "Firmware.h"
+#include "Interrupts.h"
+#include "Radio.h"
+
+using namespace Sim;
+
+/**
+ * @brief Initialize the simulated hardware and the firmware
+ *
+ * The firmware tasks are created, but don't run until Run() starts the scheduler.
+ *
+ * @param radio Simulated radio configuration
+ */
+void Firmware::Init(const Radio::Config &radio) {
+    Interrupts::Init();
+    Radio::Init(radio);
+
+    EarlyInit();
+    HwInit();
+    SwInit();
+}
+
+/**
+ * @brief Run a host workload against the firmware
+ *
+ * The workload is executed on a host thread, while the scheduler runs on the calling thread; it's
+ * stopped once the workload returns.
+ *
+ * @param workload Host workload to execute
+ *
+ * @return Value returned by the workload
+ */
+bool Firmware::Run(std::function<bool()> workload) {
+    bool ok{false};
+    auto host = Interrupts::StartHostThread([&] {
+        ok = workload();
+        Interrupts::EndScheduler();
+    });
+
+    Logger::Debug("Starting scheduler");
+    vTaskStartScheduler();
+
+    host.join();
+    Radio::Shutdown();
+
+    return ok;
+}
+
+/**
+ * @brief Perform early initialization
+ */
+void Firmware::EarlyInit() {
+    Hw::Clocks::Init();
+    Debug::Probes::Init();
+    Logger::Init();
+    Hw::Identity::Init();
+}
+
+/**
+ * @brief Initialize hardware and drivers
+ */
+void Firmware::HwInit() {
+    Hw::Indicators::Init();
+
+    GPIOINT_Init();
+
+    sl_sleeptimer_init();
+    NVIC_SetPriority(SYSRTC_APP_IRQn, configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1);
+
+    sl_spidrv_init_instances();
+    sl_uartdrv_init_instances();
+}
+
+/**
+ * @brief Initialize firmware components
+ *
+ * Same as on the device, except that there is no external flash (and thus no filesystem.)
+ */
+void Firmware::SwInit() {
+    Logger::Notice("blazenet-rf host-sim (%s-%s/%s) built on %s", gBuildInfo.gitBranch,
+            gBuildInfo.gitHash, gBuildInfo.buildType, gBuildInfo.buildDate);
+
+    Crypto::Init();
+
+    Packet::Handler::Init();
+    ::Radio::Init();
+
+    BlazeNet::Init();
+
+    HostIf::Init();
+}
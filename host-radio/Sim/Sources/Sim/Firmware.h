@@ -0,0 +1,27 @@
+#ifndef SIM_FIRMWARE_H
+#define SIM_FIRMWARE_H
+
+#include <functional>
+
+#include "Radio.h"
+
+namespace Sim {
+/**
+ * @brief Simulated device
+ *
+ * Brings up the simulated hardware and the firmware on top of it, the same way as on the device
+ * (minus the filesystem), then runs a host workload against it.
+ */
+class Firmware {
+    public:
+        static void Init(const Radio::Config &radio);
+        static bool Run(std::function<bool()> workload);
+
+    private:
+        static void EarlyInit();
+        static void HwInit();
+        static void SwInit();
+};
+}
+
+#endif
@@ -0,0 +1,127 @@
+#include "Log/Logger.h"
+
+#include "CriticalLock.h"
+#include "Gpio.h"
+
+using namespace Sim;
+
+std::mutex Gpio::gLock;
+std::condition_variable Gpio::gChanged;
+std::array<uint16_t, Gpio::kNumPorts> Gpio::gOutputs{};
+std::vector<std::tuple<GPIO_Port_TypeDef, unsigned int, Gpio::Watcher>> Gpio::gWatchers;
+
+/**
+ * @brief Watch a pin
+ *
+ * The watcher is invoked every time the firmware drives the pin (even if its level doesn't
+ * change), after the new level has taken effect.
+ *
+ * @remark Only call this before the scheduler is started.
+ */
+void Gpio::Watch(const GPIO_Port_TypeDef port, const unsigned int pin, Watcher watcher) {
+    REQUIRE(port < kNumPorts && pin < kPinsPerPort, "invalid pin %u.%u", port, pin);
+    gWatchers.emplace_back(port, pin, std::move(watcher));
+}
+
+/**
+ * @brief Configure a pin
+ *
+ * Only the initial output level is of interest; the mode is ignored.
+ *
+ * @remark Firmware context only
+ */
+void Gpio::SetMode(const GPIO_Port_TypeDef port, const unsigned int pin,
+        const GPIO_Mode_TypeDef mode, const bool out) {
+    SetOutput(port, pin, out);
+}
+
+/**
+ * @brief Drive a pin to the given level
+ *
+ * @remark Firmware context only
+ */
+void Gpio::SetOutput(const GPIO_Port_TypeDef port, const unsigned int pin, const bool level) {
+    REQUIRE(port < kNumPorts && pin < kPinsPerPort, "invalid pin %u.%u", port, pin);
+
+    {
+        CriticalLock lg(gLock);
+        if(level) {
+            gOutputs[port] |= (1U << pin);
+        } else {
+            gOutputs[port] &= ~(1U << pin);
+        }
+    }
+
+    gChanged.notify_all();
+    NotifyWatchers(port, pin, level);
+}
+
+/**
+ * @brief Invert the level of a pin
+ *
+ * @remark Firmware context only
+ */
+void Gpio::ToggleOutput(const GPIO_Port_TypeDef port, const unsigned int pin) {
+    REQUIRE(port < kNumPorts && pin < kPinsPerPort, "invalid pin %u.%u", port, pin);
+
+    bool level;
+
+    {
+        CriticalLock lg(gLock);
+        gOutputs[port] ^= (1U << pin);
+        level = gOutputs[port] & (1U << pin);
+    }
+
+    gChanged.notify_all();
+    NotifyWatchers(port, pin, level);
+}
+
+/**
+ * @brief Get the level a pin is driven to
+ *
+ * @remark Firmware context only
+ */
+bool Gpio::GetOutput(const GPIO_Port_TypeDef port, const unsigned int pin) {
+    CriticalLock lg(gLock);
+    return gOutputs[port] & (1U << pin);
+}
+
+/**
+ * @brief Read the level of a pin
+ *
+ * @remark Host threads only
+ */
+bool Gpio::Read(const GPIO_Port_TypeDef port, const unsigned int pin) {
+    std::lock_guard lg(gLock);
+    return gOutputs[port] & (1U << pin);
+}
+
+/**
+ * @brief Wait for a pin to be driven to a particular level
+ *
+ * @param level Level to wait for
+ * @param timeout Maximum time to wait
+ *
+ * @return Whether the pin is at the requested level
+ *
+ * @remark Host threads only
+ */
+bool Gpio::WaitForLevel(const GPIO_Port_TypeDef port, const unsigned int pin, const bool level,
+        const std::chrono::microseconds timeout) {
+    std::unique_lock lk(gLock);
+    return gChanged.wait_for(lk, timeout, [&] {
+        return !!(gOutputs[port] & (1U << pin)) == level;
+    });
+}
+
+/**
+ * @brief Invoke the watchers of a pin that was just driven
+ */
+void Gpio::NotifyWatchers(const GPIO_Port_TypeDef port, const unsigned int pin,
+        const bool level) {
+    for(const auto &[watchedPort, watchedPin, watcher] : gWatchers) {
+        if(watchedPort == port && watchedPin == pin) {
+            watcher(level);
+        }
+    }
+}
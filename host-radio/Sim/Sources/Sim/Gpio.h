@@ -0,0 +1,68 @@
+#ifndef SIM_GPIO_H
+#define SIM_GPIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <tuple>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <em_gpio.h>
+
+namespace Sim {
+/**
+ * @brief Simulated GPIO ports
+ *
+ * Keeps track of the output level of each pin, as driven by the firmware through the GPIO
+ * stand-in, so that host threads can observe (and wait for changes of) signals such as the host
+ * interrupt line. Other stand-ins can watch individual pins (such as a chip select) to be told
+ * synchronously whenever the firmware drives them.
+ */
+class Gpio {
+    private:
+        /// Number of ports
+        constexpr static const size_t kNumPorts{4};
+        /// Pins per port
+        constexpr static const size_t kPinsPerPort{16};
+
+    public:
+        /// Invoked (in firmware context) with the new level whenever a watched pin is driven
+        using Watcher = std::function<void(bool level)>;
+
+    public:
+        static void Watch(const GPIO_Port_TypeDef port, const unsigned int pin, Watcher watcher);
+
+        static void SetMode(const GPIO_Port_TypeDef port, const unsigned int pin,
+                const GPIO_Mode_TypeDef mode, const bool out);
+        static void SetOutput(const GPIO_Port_TypeDef port, const unsigned int pin,
+                const bool level);
+        static void ToggleOutput(const GPIO_Port_TypeDef port, const unsigned int pin);
+        static bool GetOutput(const GPIO_Port_TypeDef port, const unsigned int pin);
+
+        static bool Read(const GPIO_Port_TypeDef port, const unsigned int pin);
+        static bool WaitForLevel(const GPIO_Port_TypeDef port, const unsigned int pin,
+                const bool level, const std::chrono::microseconds timeout);
+
+    private:
+        static void NotifyWatchers(const GPIO_Port_TypeDef port, const unsigned int pin,
+                const bool level);
+
+    private:
+        /// Lock protecting pin state
+        static std::mutex gLock;
+        /// Signalled when any output changes
+        static std::condition_variable gChanged;
+        /// Output state of each port (one bit per pin)
+        static std::array<uint16_t, kNumPorts> gOutputs;
+
+        /// Pins being watched, and their watchers
+        static std::vector<std::tuple<GPIO_Port_TypeDef, unsigned int, Watcher>> gWatchers;
+};
+}
+
+#endif
@@ -0,0 +1,140 @@
+#include <string.h>
+
+#include <algorithm>
+
+#include "CriticalLock.h"
+#include "HostLink.h"
+#include "Interrupts.h"
+
+using namespace Sim;
+
+std::mutex HostLink::gLock;
+std::condition_variable HostLink::gArmed;
+std::optional<HostLink::PendingTransfer> HostLink::gPending;
+size_t HostLink::gBytesLost{0};
+
+/**
+ * @brief Arm a slave transfer
+ *
+ * Exactly one of the buffers must be specified.
+ *
+ * @param handle Driver instance
+ * @param rxBuffer Buffer to receive data from the host
+ * @param txBuffer Buffer holding data to send to the host
+ * @param count Number of bytes to transfer
+ * @param callback Invoked (from interrupt context) when the transfer completes
+ *
+ * @return ECODE_EMDRV_SPIDRV_OK on success, or an error if a transfer is already armed
+ *
+ * @remark Firmware context only
+ */
+Ecode_t HostLink::Arm(SPIDRV_Handle_t handle, uint8_t *rxBuffer, const uint8_t *txBuffer,
+        const size_t count, SPIDRV_Callback_t callback) {
+    if(!count || (!rxBuffer == !txBuffer)) {
+        return ECODE_EMDRV_SPIDRV_PARAM_ERROR;
+    }
+
+    {
+        CriticalLock lg(gLock);
+        if(gPending) {
+            return ECODE_EMDRV_SPIDRV_BUSY;
+        }
+
+        gPending = PendingTransfer{
+            .handle = handle,
+            .rxBuffer = rxBuffer,
+            .txBuffer = txBuffer,
+            .count = count,
+            .callback = callback,
+        };
+    }
+
+    gArmed.notify_all();
+    return ECODE_EMDRV_SPIDRV_OK;
+}
+
+/**
+ * @brief Abort the armed transfer, if any
+ *
+ * The transfer's callback is invoked with an "aborted" status.
+ *
+ * @remark Firmware context only
+ */
+Ecode_t HostLink::Abort(SPIDRV_Handle_t handle) {
+    std::optional<PendingTransfer> aborted;
+
+    {
+        CriticalLock lg(gLock);
+        aborted.swap(gPending);
+    }
+
+    if(aborted && aborted->callback) {
+        Interrupts::Pend([xfer = *aborted] {
+            xfer.callback(xfer.handle, ECODE_EMDRV_SPIDRV_ABORTED, xfer.done);
+        });
+    }
+
+    return ECODE_EMDRV_SPIDRV_OK;
+}
+
+/**
+ * @brief Clock bytes on the link, from the host side
+ *
+ * Data is exchanged with the armed transfer; if it completes, its callback is raised and any
+ * remaining bytes are lost.
+ *
+ * @param txBuffer Data sent by the host (if `nullptr`, zeros are sent)
+ * @param rxBuffer Buffer to receive data from the radio (may be `nullptr`)
+ * @param length Number of bytes to clock
+ * @param armTimeout How long to wait for the firmware to arm a transfer
+ *
+ * @return Number of bytes accepted by the firmware, or -1 if no transfer was armed in time
+ *
+ * @remark Host threads only
+ */
+int HostLink::Transfer(const uint8_t *txBuffer, uint8_t *rxBuffer, const size_t length,
+        const std::chrono::microseconds armTimeout) {
+    std::optional<PendingTransfer> completed;
+    size_t accepted{0};
+
+    if(rxBuffer) {
+        memset(rxBuffer, 0xFF, length);
+    }
+
+    {
+        std::unique_lock lk(gLock);
+        if(!gArmed.wait_for(lk, armTimeout, [] { return gPending.has_value(); })) {
+            gBytesLost += length;
+            return -1;
+        }
+
+        auto &xfer = *gPending;
+        accepted = std::min(length, xfer.count - xfer.done);
+
+        if(xfer.rxBuffer) {
+            if(txBuffer) {
+                memcpy(xfer.rxBuffer + xfer.done, txBuffer, accepted);
+            } else {
+                memset(xfer.rxBuffer + xfer.done, 0, accepted);
+            }
+        } else if(rxBuffer) {
+            memcpy(rxBuffer, xfer.txBuffer + xfer.done, accepted);
+        }
+
+        xfer.done += accepted;
+        gBytesLost += (length - accepted);
+
+        if(xfer.done == xfer.count) {
+            completed.swap(gPending);
+        }
+    }
+
+    // notify the firmware
+    if(completed && completed->callback) {
+        Interrupts::Raise([xfer = *completed] {
+            xfer.callback(xfer.handle, ECODE_EMDRV_SPIDRV_OK, xfer.count);
+        });
+    }
+
+    return accepted;
+}
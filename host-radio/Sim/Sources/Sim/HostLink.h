@@ -0,0 +1,80 @@
+#ifndef SIM_HOSTLINK_H
+#define SIM_HOSTLINK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+
+#include <spidrv.h>
+
+namespace Sim {
+/**
+ * @brief Simulated SPI link to the host
+ *
+ * Models the host interface SPI bus with the radio as slave: the firmware arms a transfer (through
+ * the SPIDRV stand-in) and the host clocks bytes against it. Once the number of bytes requested by
+ * the firmware has been transferred, the transfer completes and its callback is invoked from the
+ * simulated interrupt context.
+ *
+ * As on the real bus, bytes clocked while no transfer is armed are lost (and read back as 0xFF);
+ * a host transfer waits a limited time for the firmware to arm one, which stands in for the
+ * command turnaround delay a real host observes.
+ */
+class HostLink {
+    public:
+        /// Default time to wait for the firmware to arm a transfer
+        constexpr static const std::chrono::milliseconds kDefaultArmTimeout{250};
+
+    public:
+        static Ecode_t Arm(SPIDRV_Handle_t handle, uint8_t *rxBuffer, const uint8_t *txBuffer,
+                const size_t count, SPIDRV_Callback_t callback);
+        static Ecode_t Abort(SPIDRV_Handle_t handle);
+
+        static int Transfer(const uint8_t *txBuffer, uint8_t *rxBuffer, const size_t length,
+                const std::chrono::microseconds armTimeout = kDefaultArmTimeout);
+
+        /**
+         * @brief Get the number of bytes lost because no transfer was armed
+         */
+        static inline size_t GetBytesLost() {
+            std::lock_guard lg(gLock);
+            return gBytesLost;
+        }
+
+    private:
+        /**
+         * @brief A slave transfer armed by the firmware
+         */
+        struct PendingTransfer {
+            /// Driver instance that armed the transfer
+            SPIDRV_Handle_t handle;
+            /// Receive buffer (firmware receives from host)
+            uint8_t *rxBuffer;
+            /// Transmit buffer (firmware transmits to host)
+            const uint8_t *txBuffer;
+            /// Total bytes to transfer
+            size_t count;
+            /// Bytes transferred so far
+            size_t done{0};
+            /// Completion callback
+            SPIDRV_Callback_t callback;
+        };
+
+    private:
+        /// Lock protecting the link state
+        static std::mutex gLock;
+        /// Signalled when a transfer is armed
+        static std::condition_variable gArmed;
+
+        /// Currently armed transfer, if any
+        static std::optional<PendingTransfer> gPending;
+        /// Bytes clocked by the host while no transfer was armed
+        static size_t gBytesLost;
+};
+}
+
+#endif
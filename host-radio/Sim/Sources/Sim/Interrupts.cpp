@@ -0,0 +1,190 @@
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "Log/Logger.h"
+#include "Rtos/Rtos.h"
+
+#include "CriticalLock.h"
+#include "Interrupts.h"
+
+using namespace Sim;
+
+TaskHandle_t Interrupts::gTask{nullptr};
+
+std::mutex Interrupts::gLock;
+std::deque<Interrupts::Handler> Interrupts::gPending;
+
+int Interrupts::gWakeFd{-1};
+std::atomic_bool Interrupts::gRaised{false};
+
+/**
+ * @brief Initialize the interrupt controller
+ *
+ * Create the interrupt task; it starts executing handlers once the scheduler is started.
+ */
+void Interrupts::Init() {
+    static StaticTask_t gTaskStorage;
+    static StackType_t gStack[kStackSize];
+
+    gWakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    REQUIRE(gWakeFd != -1, "%s failed: %d", "eventfd", errno);
+
+    gTask = xTaskCreateStatic([](auto param) {
+        Interrupts::Main();
+    }, kName.data(), kStackSize, nullptr, kPriority, gStack, &gTaskStorage);
+    REQUIRE(!!gTask, "failed to initialize %s", "sim interrupt task");
+}
+
+/**
+ * @brief Raise an interrupt from a host thread
+ *
+ * The handler is executed in the simulated interrupt context as soon as possible.
+ *
+ * @param handler Interrupt handler to invoke
+ */
+void Interrupts::Raise(Handler handler) {
+    {
+        std::lock_guard lg(gLock);
+        gPending.emplace_back(std::move(handler));
+    }
+
+    // wake the idle task, if it's waiting
+    const uint64_t value{1};
+    write(gWakeFd, &value, sizeof(value));
+
+    gRaised.store(true, std::memory_order_release);
+}
+
+/**
+ * @brief Pend an interrupt from firmware context
+ *
+ * Used by driver stand-ins that complete an operation immediately, but must still invoke their
+ * completion callback from interrupt context.
+ *
+ * @param handler Interrupt handler to invoke
+ */
+void Interrupts::Pend(Handler handler) {
+    {
+        CriticalLock lg(gLock);
+        gPending.emplace_back(std::move(handler));
+    }
+
+    if(gTask && xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) {
+        xTaskNotifyGive(gTask);
+    }
+}
+
+/**
+ * @brief Wait for an interrupt
+ *
+ * Invoked by the idle task in place of the WFI instruction. Blocks until an interrupt is raised
+ * by a host thread, or the next tick; if an interrupt was raised, wake the interrupt task.
+ *
+ * @remark This blocks the idle task's thread without holding any locks, so it's safe for the
+ *         scheduler to switch away from it at any time.
+ */
+void Interrupts::WaitForInterrupt() {
+    struct pollfd pfd{
+        .fd = gWakeFd,
+        .events = POLLIN,
+        .revents = 0,
+    };
+
+    const auto ok = poll(&pfd, 1, portTICK_PERIOD_MS);
+    if(ok <= 0) {
+        return;
+    }
+
+    uint64_t value;
+    read(gWakeFd, &value, sizeof(value));
+
+    xTaskNotifyGive(gTask);
+}
+
+/**
+ * @brief Service interrupts raised by host threads
+ *
+ * Wakes the interrupt task (which preempts the caller) if an interrupt was raised since the last
+ * call. This is cheap enough to call on every iteration of a busy loop.
+ *
+ * @remark Task context only
+ */
+void Interrupts::Poll() {
+    if(gRaised.load(std::memory_order_relaxed) &&
+            gRaised.exchange(false, std::memory_order_acquire)) {
+        xTaskNotifyGive(gTask);
+    }
+}
+
+/**
+ * @brief Start a host thread
+ *
+ * Host threads (and any threads they create) must not receive the signals the FreeRTOS POSIX port
+ * uses to drive the scheduler, so all signals are blocked in the new thread. Threads created by a
+ * host thread inherit this signal mask.
+ *
+ * @param entry Thread entry point
+ */
+std::thread Interrupts::StartHostThread(std::function<void()> entry) {
+    sigset_t all, old;
+    sigfillset(&all);
+
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    std::thread thread(std::move(entry));
+    pthread_sigmask(SIG_SETMASK, &old, nullptr);
+
+    return thread;
+}
+
+/**
+ * @brief Stop the scheduler
+ *
+ * May be called from a host thread; the scheduler is stopped from the interrupt task, after which
+ * vTaskStartScheduler() returns on the main thread.
+ */
+void Interrupts::EndScheduler() {
+    Raise([] {
+        vTaskEndScheduler();
+    });
+}
+
+/**
+ * @brief Interrupt task main loop
+ *
+ * Execute pending interrupt handlers whenever woken; poll once per tick in case an interrupt was
+ * raised while the idle task wasn't waiting.
+ */
+void Interrupts::Main() {
+    while(true) {
+        ulTaskNotifyTake(pdTRUE, 1);
+
+        while(DispatchOne()) {}
+    }
+}
+
+/**
+ * @brief Execute the oldest pending interrupt handler
+ *
+ * @return Whether a handler was executed
+ */
+bool Interrupts::DispatchOne() {
+    Handler handler;
+
+    {
+        CriticalLock lg(gLock);
+        if(gPending.empty()) {
+            return false;
+        }
+
+        handler = std::move(gPending.front());
+        gPending.pop_front();
+    }
+
+    // nothing can preempt the interrupt task, so the handler runs to completion
+    handler();
+    return true;
+}
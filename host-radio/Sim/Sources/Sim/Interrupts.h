@@ -0,0 +1,76 @@
+#ifndef SIM_INTERRUPTS_H
+#define SIM_INTERRUPTS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include <etl/string_view.h>
+
+#include "Rtos/Rtos.h"
+
+/// Host simulation of the firmware
+namespace Sim {
+/**
+ * @brief Simulated interrupt controller
+ *
+ * Driver stand-ins complete their work on host threads, which may not call into FreeRTOS. Instead,
+ * they raise an "interrupt": a handler that's queued here, and executed by a dedicated task at the
+ * highest priority. Handlers may thus use the ISR-safe FreeRTOS API, exactly like the driver
+ * callbacks they stand in for, and preempt all firmware tasks.
+ *
+ * While the system is idle, the idle task blocks in WaitForInterrupt(), and wakes the interrupt
+ * task as soon as an interrupt is raised; otherwise, pending interrupts are serviced at the next
+ * tick at the latest. Simulated workloads that keep a task busy can call Poll() in their loop to
+ * have interrupts preempt them as soon as they're raised, as they would on the device.
+ */
+class Interrupts {
+    public:
+        using Handler = std::function<void()>;
+
+    private:
+        /// Runtime priority level (above all firmware tasks)
+        static const constexpr uint8_t kPriority{configMAX_PRIORITIES - 1};
+        /// Size of the task's stack, in words
+        static const constexpr size_t kStackSize{512};
+        /// Task name (for display purposes)
+        static const constexpr etl::string_view kName{"SimIrq"};
+
+    public:
+        static void Init();
+
+        static void Raise(Handler handler);
+        static void Pend(Handler handler);
+
+        static void WaitForInterrupt();
+        static void Poll();
+
+        static std::thread StartHostThread(std::function<void()> entry);
+        static void EndScheduler();
+
+    private:
+        static void Main();
+        static bool DispatchOne();
+
+    private:
+        /// Interrupt task handle
+        static TaskHandle_t gTask;
+
+        /// Lock protecting the pending interrupt queue
+        static std::mutex gLock;
+        /// Interrupt handlers waiting to be executed
+        static std::deque<Handler> gPending;
+
+        /// Event descriptor signalled when an interrupt is raised by a host thread
+        static int gWakeFd;
+        /// Set when an interrupt is raised by a host thread; cleared by Poll()
+        static std::atomic_bool gRaised;
+};
+}
+
+#endif
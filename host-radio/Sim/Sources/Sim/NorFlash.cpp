@@ -0,0 +1,572 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+
+#include "sl_spidrv_eusart_flash_config.h"
+
+#include "Fs/FlashInfo.h"
+#include "Log/Logger.h"
+
+#include "CriticalLock.h"
+#include "Gpio.h"
+#include "Interrupts.h"
+#include "NorFlash.h"
+
+using namespace Sim;
+
+/// JEDEC identify command (not part of the flash information structure)
+constexpr static const uint8_t kCmdIdentify{0x9F};
+/// Status register bit for the write enable latch
+constexpr static const uint8_t kStatusWriteEnabled{(1U << 1)};
+
+NorFlash::Config NorFlash::gConfig{};
+uint8_t *NorFlash::gData{nullptr};
+size_t NorFlash::gSize{0};
+NorFlash::Stats NorFlash::gStats{};
+std::vector<uint32_t> NorFlash::gWear;
+uint32_t NorFlash::gBitrate{0};
+
+bool NorFlash::gSelected{false};
+size_t NorFlash::gClocked{0};
+uint8_t NorFlash::gCommand{0};
+bool NorFlash::gIgnored{false};
+uint32_t NorFlash::gAddress{0};
+bool NorFlash::gWriteEnabled{false};
+bool NorFlash::gFourByteAddress{false};
+std::chrono::steady_clock::time_point NorFlash::gBusyUntil{};
+
+std::vector<uint8_t> NorFlash::gProgramData;
+size_t NorFlash::gProgramCount{0};
+
+bool NorFlash::gPowered{false};
+size_t NorFlash::gCutAfter{0};
+std::minstd_rand NorFlash::gCutRandom;
+
+std::mutex NorFlash::gDmaLock;
+std::condition_variable NorFlash::gDmaStarted;
+std::optional<NorFlash::PendingTransfer> NorFlash::gDmaPending;
+bool NorFlash::gDmaStop{false};
+std::thread NorFlash::gDmaThread;
+
+/**
+ * @brief Attach the flash
+ *
+ * Map the backing file; if it's shorter than the flash (or doesn't exist yet) it's extended, and
+ * the remainder is erased.
+ *
+ * @return Whether the flash was attached
+ *
+ * @remark Call before the scheduler is started.
+ */
+bool NorFlash::Open(const Config &config) {
+    static bool gWatching{false};
+
+    REQUIRE(!!config.info && config.bitrate, "invalid %s config", "NOR flash");
+
+    const size_t capacity = config.info->capacityBytes();
+
+    // map the backing file, extending it as needed
+    const auto fd = open(config.path.c_str(), O_RDWR | O_CREAT, 0644);
+    if(fd == -1) {
+        Logger::Warning("NOR flash: failed to open %s (%d)", config.path.c_str(), errno);
+        return false;
+    }
+
+    struct stat st;
+    if(fstat(fd, &st) || (static_cast<size_t>(st.st_size) < capacity &&
+                ftruncate(fd, capacity))) {
+        Logger::Warning("NOR flash: failed to size %s (%d)", config.path.c_str(), errno);
+        close(fd);
+        return false;
+    }
+
+    auto data = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if(data == MAP_FAILED) {
+        Logger::Warning("NOR flash: failed to map %s (%d)", config.path.c_str(), errno);
+        return false;
+    }
+
+    gData = static_cast<uint8_t *>(data);
+    gSize = capacity;
+
+    const size_t existing = std::min(static_cast<size_t>(st.st_size), capacity);
+    memset(gData + existing, 0xFF, capacity - existing);
+
+    Logger::Notice("NOR flash: mapped %s (%u bytes, %u existing)", config.path.c_str(), capacity,
+            existing);
+
+    gConfig = config;
+    gStats = {};
+    gWear.assign(capacity / config.info->sectorSizeBytes(), 0);
+    gBitrate = config.bitrate;
+    gWriteEnabled = gFourByteAddress = false;
+    gBusyUntil = {};
+    gProgramData.assign(config.info->pageSizeBytes(), 0xFF);
+    gProgramCount = 0;
+    gPowered = true;
+    gCutAfter = 0;
+
+    if(!gWatching) {
+        Gpio::Watch(SL_SPIDRV_EUSART_FLASH_CS_PORT, SL_SPIDRV_EUSART_FLASH_CS_PIN,
+                [](auto level) {
+            Select(!level);
+        });
+        gWatching = true;
+    }
+
+    gDmaStop = false;
+    gDmaThread = Interrupts::StartHostThread(DmaMain);
+
+    return true;
+}
+
+/**
+ * @brief Detach the flash
+ *
+ * Any asynchronous transfer still in progress is dropped (without invoking its callback) and the
+ * flash contents are synced to the backing file.
+ *
+ * @remark Call after the scheduler was stopped.
+ */
+void NorFlash::Close() {
+    if(!gDmaThread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard lg(gDmaLock);
+        gDmaStop = true;
+        gDmaPending.reset();
+    }
+    gDmaStarted.notify_all();
+    gDmaThread.join();
+
+    if(msync(gData, gSize, MS_SYNC)) {
+        Logger::Warning("NOR flash: failed to write %s (%d)", gConfig.path.c_str(), errno);
+    }
+    munmap(gData, gSize);
+
+    gData = nullptr;
+    gSize = 0;
+}
+
+/**
+ * @brief Clock bytes on the bus
+ *
+ * Data is exchanged with the flash immediately; the transfer then takes as long as it would on
+ * the bus. Blocking transfers wait for it here, while asynchronous transfers complete later.
+ *
+ * @param txBuffer Data to send to the flash (if `nullptr`, 0xFF is sent)
+ * @param rxBuffer Buffer to receive data from the flash (may be `nullptr`)
+ * @param count Number of bytes to clock
+ * @param callback Completion callback for asynchronous transfers; `nullptr` for blocking ones
+ *
+ * @remark Firmware context only
+ */
+Ecode_t NorFlash::Transfer(SPIDRV_Handle_t handle, const uint8_t *txBuffer, uint8_t *rxBuffer,
+        const size_t count, SPIDRV_Callback_t callback) {
+    if(!gData) {
+        // nothing is attached to the bus
+        return ECODE_EMDRV_SPIDRV_PARAM_ERROR;
+    }
+
+    {
+        CriticalLock lg(gDmaLock);
+        if(gDmaPending) {
+            return ECODE_EMDRV_SPIDRV_BUSY;
+        }
+    }
+
+    for(size_t i = 0; i < count; i++) {
+        const auto miso = Clock(txBuffer ? txBuffer[i] : 0xFF);
+        if(rxBuffer) {
+            rxBuffer[i] = miso;
+        }
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + GetBusTime(count);
+
+    if(!callback) {
+        while(std::chrono::steady_clock::now() < deadline) {}
+        return ECODE_EMDRV_SPIDRV_OK;
+    }
+
+    {
+        CriticalLock lg(gDmaLock);
+        gDmaPending = PendingTransfer{
+            .handle = handle,
+            .count = count,
+            .callback = callback,
+            .deadline = deadline,
+        };
+    }
+    gDmaStarted.notify_all();
+
+    return ECODE_EMDRV_SPIDRV_OK;
+}
+
+/**
+ * @brief Abort the asynchronous transfer in progress, if any
+ *
+ * The transfer's callback is invoked with an "aborted" status.
+ *
+ * @remark Firmware context only
+ */
+Ecode_t NorFlash::Abort(SPIDRV_Handle_t handle) {
+    std::optional<PendingTransfer> aborted;
+
+    {
+        CriticalLock lg(gDmaLock);
+        aborted.swap(gDmaPending);
+    }
+
+    if(aborted) {
+        Interrupts::Pend([xfer = *aborted] {
+            xfer.callback(xfer.handle, ECODE_EMDRV_SPIDRV_ABORTED, 0);
+        });
+    }
+
+    return ECODE_EMDRV_SPIDRV_OK;
+}
+
+/**
+ * @brief Change the bus bit rate
+ *
+ * @remark Firmware context only
+ */
+Ecode_t NorFlash::SetBitrate(const uint32_t bitrate) {
+    CriticalLock lg(gDmaLock);
+    if(gDmaPending) {
+        return ECODE_EMDRV_SPIDRV_BUSY;
+    }
+
+    gBitrate = bitrate;
+    return ECODE_EMDRV_SPIDRV_OK;
+}
+
+/**
+ * @brief Cut the power during a later operation
+ *
+ * The given program or erase operation (counting from the next one) is torn: a page program
+ * takes effect on only a prefix of its bytes, and an erase only completes for a prefix of its
+ * range, while the rest of it has random bits set. Then the configured callback is invoked; if
+ * there's none (or it returns) the chip stops responding, until it's attached again.
+ *
+ * @param operations Number of the program or erase operation to tear (1 is the next one); 0
+ *        cancels a pending power cut
+ * @param seed Seed for the amount of the operation that takes effect
+ */
+void NorFlash::CutPower(const size_t operations, const uint32_t seed) {
+    gCutAfter = operations;
+    gCutRandom.seed(seed);
+}
+
+/**
+ * @brief Handle a change of the chip select
+ *
+ * Asserting it starts a new command; deasserting it executes commands that take effect then.
+ */
+void NorFlash::Select(const bool isSelected) {
+    if(isSelected == gSelected) {
+        return;
+    }
+
+    gSelected = isSelected;
+
+    if(isSelected) {
+        gClocked = 0;
+        gCommand = 0;
+        gIgnored = false;
+        gAddress = 0;
+        gProgramCount = 0;
+    } else if(gClocked) {
+        Deselect();
+    }
+}
+
+/**
+ * @brief Clock a single byte
+ *
+ * @param mosi Byte sent by the firmware
+ *
+ * @return Byte sent by the flash
+ */
+uint8_t NorFlash::Clock(const uint8_t mosi) {
+    if(!gSelected || !gPowered) {
+        return 0xFF;
+    }
+
+    const auto info = gConfig.info;
+    const auto index = gClocked++;
+
+    // first byte is the command, then (for most commands) the address
+    if(!index) {
+        gCommand = mosi;
+        gIgnored = (mosi != info->cmdReadStatus) && IsBusy();
+
+        const auto maxClock = (mosi == info->cmdRead) ? info->maxReadClock : info->maxClock;
+        if(gBitrate > maxClock) {
+            gStats.clockViolations++;
+        }
+        return 0xFF;
+    } else if(gIgnored) {
+        return 0xFF;
+    } else if(gCommand == kCmdIdentify) {
+        return (index <= gConfig.jedecId.size()) ? gConfig.jedecId[index - 1] : 0xFF;
+    } else if(gCommand == info->cmdReadStatus) {
+        return (gWriteEnabled ? kStatusWriteEnabled : 0) | (IsBusy() ? info->statusBusyBit : 0);
+    } else if(!IsAddressed(gCommand)) {
+        return 0xFF;
+    } else if(index <= GetAddressBytes()) {
+        gAddress = (gAddress << 8) | mosi;
+        return 0xFF;
+    }
+
+    // payload (fast reads have one dummy byte first)
+    size_t offset = index - 1 - GetAddressBytes();
+
+    if(gCommand == info->cmdFastRead) {
+        if(!offset) {
+            return 0xFF;
+        }
+        offset--;
+    }
+
+    if(gCommand == info->cmdRead || gCommand == info->cmdFastRead) {
+        gStats.bytesRead++;
+        return gData[(gAddress + offset) & (gSize - 1)];
+    } else if(gCommand == info->cmdProgramPage && gWriteEnabled) {
+        // latched until the chip select is deasserted; wraps around within the page
+        const auto pageMask = info->pageSizeBytes() - 1;
+
+        gProgramData[(gAddress + offset) & pageMask] &= mosi;
+        gProgramCount++;
+        gStats.bytesProgrammed++;
+    }
+
+    return 0xFF;
+}
+
+/**
+ * @brief Complete the current command, when the chip select is deasserted
+ */
+void NorFlash::Deselect() {
+    const auto info = gConfig.info;
+    const auto hasAddress = (gClocked > GetAddressBytes());
+
+    if(gIgnored || !gPowered) {
+        return;
+    }
+
+    if(gCommand == info->cmdWriteEnable) {
+        gWriteEnabled = true;
+        return;
+    } else if(gCommand == info->cmdWriteDisable) {
+        gWriteEnabled = false;
+        return;
+    } else if(gCommand == info->cmdReset) {
+        gWriteEnabled = gFourByteAddress = false;
+        return;
+    } else if(info->cmdEnter4ByteAddress && gCommand == info->cmdEnter4ByteAddress) {
+        gFourByteAddress = true;
+        return;
+    }
+
+    if(!gWriteEnabled) {
+        return;
+    }
+
+    if(gCommand == info->cmdEraseSector && hasAddress) {
+        Erase(gAddress, info->sectorSizeBytes(), info->typicalSectorErase);
+        gStats.sectorErases++;
+    } else if(gCommand == info->cmdEraseBlock && hasAddress) {
+        Erase(gAddress, info->blockSizeBytes(), info->typicalBlockErase);
+        gStats.blockErases++;
+    } else if(gCommand == info->cmdEraseChip) {
+        Erase(0, gSize, info->typicalChipErase);
+        gStats.chipErases++;
+    } else if(gCommand == info->cmdProgramPage && hasAddress) {
+        Program();
+        gStats.pagePrograms++;
+    } else {
+        return;
+    }
+
+    // the write enable latch is cleared by every program or erase command
+    gWriteEnabled = false;
+}
+
+/**
+ * @brief Program the data latched for the current page program
+ *
+ * Bits can only be cleared: a byte is ANDed with the data programmed to it.
+ */
+void NorFlash::Program() {
+    const auto pageSize = gConfig.info->pageSizeBytes();
+    const auto page = gAddress & ~(pageSize - 1) & (gSize - 1);
+    const auto count = std::min(gProgramCount, pageSize);
+
+    // a torn program only takes effect for some bytes (the last one of those partially)
+    size_t done{count};
+    uint8_t partial{0};
+
+    const bool torn = Tear();
+    if(torn) {
+        done = gCutRandom() % (count + 1);
+        partial = static_cast<uint8_t>(gCutRandom());
+    }
+
+    for(size_t i = 0; i < count; i++) {
+        const auto offset = (gAddress + i) & (pageSize - 1);
+        auto &byte = gData[page + offset];
+
+        if(i < done) {
+            byte &= gProgramData[offset];
+        } else if(i == done && torn) {
+            byte &= gProgramData[offset] | partial;
+        }
+        gProgramData[offset] = 0xFF;
+    }
+
+    SetBusy(gConfig.info->typicalPageProgram);
+
+    if(torn) {
+        gPowered = false;
+        if(gConfig.powerCut) {
+            gConfig.powerCut();
+        }
+    }
+}
+
+/**
+ * @brief Erase a range of the flash
+ *
+ * @param address Address in the range; it's rounded down to the erase size
+ * @param size Erase size (a power of two)
+ * @param usec Time the erase takes (µsec)
+ */
+void NorFlash::Erase(const uint32_t address, const size_t size, const uint32_t usec) {
+    const auto sectorSize = gConfig.info->sectorSizeBytes();
+    const auto start = address & (gSize - 1) & ~(size - 1);
+
+    if(address & (size - 1)) {
+        gStats.unalignedErases++;
+    }
+
+    // a torn erase completes only for a prefix of the range; the rest has random bits set
+    size_t done{size};
+    const bool torn = Tear();
+    if(torn) {
+        done = gCutRandom() % size;
+    }
+
+    memset(gData + start, 0xFF, done);
+    for(size_t i = done; i < size; i++) {
+        gData[start + i] |= static_cast<uint8_t>(gCutRandom());
+    }
+
+    for(size_t i = start / sectorSize; i < (start + size) / sectorSize; i++) {
+        gWear[i]++;
+    }
+
+    SetBusy(usec);
+
+    if(torn) {
+        gPowered = false;
+        if(gConfig.powerCut) {
+            gConfig.powerCut();
+        }
+    }
+}
+
+/**
+ * @brief Count a program or erase operation towards a pending power cut
+ *
+ * @return Whether the power is cut during this operation
+ */
+bool NorFlash::Tear() {
+    return gCutAfter && !--gCutAfter;
+}
+
+/**
+ * @brief Start a program or erase operation
+ *
+ * @param usec Typical time the operation takes (µsec); it's scaled as configured
+ */
+void NorFlash::SetBusy(const uint32_t usec) {
+    gBusyUntil = std::chrono::steady_clock::now() +
+        std::chrono::microseconds(static_cast<int64_t>(usec * gConfig.timeScale));
+}
+
+/**
+ * @brief Determine whether a program or erase operation is in progress
+ */
+bool NorFlash::IsBusy() {
+    return std::chrono::steady_clock::now() < gBusyUntil;
+}
+
+/**
+ * @brief Determine whether a command is followed by an address
+ */
+bool NorFlash::IsAddressed(const uint8_t cmd) {
+    const auto info = gConfig.info;
+    return cmd == info->cmdRead || cmd == info->cmdFastRead || cmd == info->cmdProgramPage ||
+        cmd == info->cmdEraseSector || cmd == info->cmdEraseBlock;
+}
+
+/**
+ * @brief Get the number of address bytes following a command
+ *
+ * Chips larger than 16 MiB start out with 3-byte addresses, until switched to 4-byte ones.
+ */
+size_t NorFlash::GetAddressBytes() {
+    return (gConfig.info->addressBytes() == 4 && gFourByteAddress) ? 4 : 3;
+}
+
+/**
+ * @brief Get the time it takes to clock the given number of bytes on the bus
+ */
+std::chrono::nanoseconds NorFlash::GetBusTime(const size_t count) {
+    return std::chrono::nanoseconds((count * 8ULL * 1'000'000'000ULL) / gBitrate);
+}
+
+/**
+ * @brief DMA thread main loop
+ *
+ * Wait for asynchronous transfers to be started, then raise their completion interrupt once their
+ * bus time has passed.
+ */
+void NorFlash::DmaMain() {
+    std::unique_lock lk(gDmaLock);
+
+    while(true) {
+        gDmaStarted.wait(lk, [] { return gDmaStop || gDmaPending.has_value(); });
+        if(gDmaStop) {
+            break;
+        }
+
+        // wait for the transfer to finish; it may be aborted (or replaced) in the meantime
+        const auto deadline = gDmaPending->deadline;
+        if(std::chrono::steady_clock::now() < deadline) {
+            gDmaStarted.wait_until(lk, deadline);
+            continue;
+        }
+
+        const auto xfer = *gDmaPending;
+        gDmaPending.reset();
+
+        lk.unlock();
+        Interrupts::Raise([xfer] {
+            xfer.callback(xfer.handle, ECODE_EMDRV_SPIDRV_OK, static_cast<int>(xfer.count));
+        });
+        lk.lock();
+    }
+}
@@ -0,0 +1,205 @@
+#ifndef SIM_NORFLASH_H
+#define SIM_NORFLASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <spidrv.h>
+
+namespace Fs {
+struct FlashInfo;
+}
+
+namespace Sim {
+/**
+ * @brief Simulated SPI NOR flash
+ *
+ * A command level model of the NOR flash on the flash SPI bus: bytes clocked by the firmware
+ * (through the SPIDRV master stand-in) between assertions of the flash chip select are decoded
+ * according to the command set of a flash information structure (see Fs::FlashInfo.) The
+ * contents are a shared memory mapping of a file, so they persist as soon as they're changed, even
+ * if the process exits abruptly.
+ *
+ * Like the real chip, programming can only clear bits (bits that are already clear stay so), takes
+ * effect once the chip select is deasserted, and wraps around within the page; erases clear whole
+ * sectors or blocks, regardless of the low address bits. Each erase of a sector is counted, to
+ * track wear.
+ *
+ * Bus time is modelled from the current bit rate: blocking transfers spin the calling task for
+ * the duration of the transfer, like polled I/O would, while asynchronous (DMA) transfers complete
+ * from the simulated interrupt context once that time has passed. Commands clocked faster than the
+ * chip supports are counted (they'd return garbage on a real chip.) Program and erase operations
+ * keep the chip busy for their typical duration (optionally scaled); meanwhile, it only responds to
+ * status reads.
+ *
+ * For power loss testing, CutPower() tears a later program or erase operation: only part of it
+ * takes effect, and the chip then stops responding.
+ */
+class NorFlash {
+    public:
+        /// Flash configuration
+        struct Config {
+            /// Backing file; it's created (erased) if it doesn't exist
+            std::string path;
+            /// Flash chip to model
+            const Fs::FlashInfo *info;
+            /// Response to the JEDEC identify command
+            std::array<uint8_t, 3> jedecId;
+            /// Initial bus bit rate (Hz)
+            uint32_t bitrate;
+            /// Factor applied to the typical program and erase times (0 completes them at once)
+            double timeScale{1.};
+            /**
+             * @brief Invoked when the power is cut (see CutPower())
+             *
+             * It's called from the firmware context, in the middle of a flash transfer, and need
+             * not return; if it does, the chip stops responding.
+             */
+            std::function<void()> powerCut;
+        };
+
+        /// Operation counters
+        struct Stats {
+            /// Payload bytes read
+            uint64_t bytesRead{0};
+            /// Payload bytes programmed
+            uint64_t bytesProgrammed{0};
+            /// Number of page programs
+            size_t pagePrograms{0};
+            /// Number of sector erases
+            size_t sectorErases{0};
+            /// Number of block erases
+            size_t blockErases{0};
+            /// Number of chip erases
+            size_t chipErases{0};
+            /// Number of commands clocked faster than the chip supports
+            size_t clockViolations{0};
+            /// Number of erase commands with an address not aligned to the erase size
+            size_t unalignedErases{0};
+        };
+
+    public:
+        static bool Open(const Config &config);
+        static void Close();
+
+        static Ecode_t Transfer(SPIDRV_Handle_t handle, const uint8_t *txBuffer,
+                uint8_t *rxBuffer, const size_t count, SPIDRV_Callback_t callback);
+        static Ecode_t Abort(SPIDRV_Handle_t handle);
+        static Ecode_t SetBitrate(const uint32_t bitrate);
+
+        static void CutPower(const size_t operations, const uint32_t seed);
+
+        /**
+         * @brief Get the operation counters
+         */
+        static inline Stats GetStats() {
+            return gStats;
+        }
+        /**
+         * @brief Get the number of times each sector was erased (since the flash was attached)
+         */
+        static inline const std::vector<uint32_t> &GetWear() {
+            return gWear;
+        }
+
+    private:
+        /**
+         * @brief An asynchronous transfer in progress
+         */
+        struct PendingTransfer {
+            /// Driver instance that started the transfer
+            SPIDRV_Handle_t handle;
+            /// Number of bytes being transferred
+            size_t count;
+            /// Completion callback
+            SPIDRV_Callback_t callback;
+            /// Time at which the transfer completes
+            std::chrono::steady_clock::time_point deadline;
+        };
+
+        static void Select(const bool isSelected);
+        static uint8_t Clock(const uint8_t mosi);
+        static void Deselect();
+
+        static void Program();
+        static void Erase(const uint32_t address, const size_t size, const uint32_t usec);
+        static bool Tear();
+
+        static void SetBusy(const uint32_t usec);
+        static bool IsBusy();
+
+        static bool IsAddressed(const uint8_t cmd);
+        static size_t GetAddressBytes();
+
+        static std::chrono::nanoseconds GetBusTime(const size_t count);
+
+        static void DmaMain();
+
+    private:
+        /// Current configuration
+        static Config gConfig;
+        /// Flash contents (mapping of the backing file), or `nullptr` if not attached
+        static uint8_t *gData;
+        /// Size of the flash (bytes)
+        static size_t gSize;
+        /// Operation counters
+        static Stats gStats;
+        /// Erase count of each sector
+        static std::vector<uint32_t> gWear;
+        /// Current bus bit rate (Hz)
+        static uint32_t gBitrate;
+
+        /// Whether the chip select is asserted
+        static bool gSelected;
+        /// Bytes clocked since the chip select was asserted
+        static size_t gClocked;
+        /// Current command
+        static uint8_t gCommand;
+        /// Whether the current command is ignored (because the chip is busy)
+        static bool gIgnored;
+        /// Address received with the current command
+        static uint32_t gAddress;
+        /// Write enable latch
+        static bool gWriteEnabled;
+        /// Whether 4-byte addresses are enabled
+        static bool gFourByteAddress;
+        /// Time until which a program or erase operation is in progress
+        static std::chrono::steady_clock::time_point gBusyUntil;
+
+        /// Data clocked in for the current page program, indexed by offset into the page
+        static std::vector<uint8_t> gProgramData;
+        /// Number of bytes clocked in for the current page program
+        static size_t gProgramCount;
+
+        /// Whether the chip is powered
+        static bool gPowered;
+        /// Program or erase operations until the power is cut (0 if it isn't)
+        static size_t gCutAfter;
+        /// Decides how much of the torn operation takes effect
+        static std::minstd_rand gCutRandom;
+
+        /// Lock protecting the asynchronous transfer state
+        static std::mutex gDmaLock;
+        /// Signalled when an asynchronous transfer is started, or the DMA thread should exit
+        static std::condition_variable gDmaStarted;
+        /// Asynchronous transfer in progress, if any
+        static std::optional<PendingTransfer> gDmaPending;
+        /// Set to stop the DMA thread
+        static bool gDmaStop;
+        /// Completes asynchronous transfers
+        static std::thread gDmaThread;
+};
+}
+
+#endif
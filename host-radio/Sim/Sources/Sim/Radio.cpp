@@ -0,0 +1,433 @@
+#include <string.h>
+
+#include <algorithm>
+
+#include "CriticalLock.h"
+#include "Interrupts.h"
+#include "Radio.h"
+
+using namespace Sim;
+
+extern "C" void sl_rail_util_on_event(RAIL_Handle_t handle, RAIL_Events_t events);
+
+Radio::Config Radio::gConfig;
+std::chrono::steady_clock::time_point Radio::gStartTime;
+
+std::mutex Radio::gLock;
+std::condition_variable Radio::gTxStart;
+std::thread Radio::gThread;
+bool Radio::gShutdown{false};
+
+std::optional<uint16_t> Radio::gRxChannel;
+std::deque<Radio::Frame> Radio::gRxFifo;
+size_t Radio::gRxFifoBytes{0};
+
+std::vector<uint8_t> Radio::gTxFifo;
+std::optional<Radio::Frame> Radio::gTxFrame;
+RAIL_TxPowerLevel_t Radio::gTxPower{0};
+
+Radio::TxHandler Radio::gTxHandler;
+
+/**
+ * @brief Initialize the simulated radio
+ *
+ * Starts the radio thread; this must be called before the radio is initialized by firmware.
+ *
+ * @param config Physical layer configuration
+ */
+void Radio::Init(const Config &config) {
+    gConfig = config;
+    gStartTime = std::chrono::steady_clock::now();
+
+    gTxFifo.reserve(kTxFifoSize);
+
+    gThread = Interrupts::StartHostThread(&Radio::Main);
+}
+
+/**
+ * @brief Stop the radio thread
+ *
+ * Any transmission in progress is abandoned.
+ */
+void Radio::Shutdown() {
+    {
+        std::lock_guard lg(gLock);
+        gShutdown = true;
+    }
+    gTxStart.notify_all();
+
+    if(gThread.joinable()) {
+        gThread.join();
+    }
+}
+
+/**
+ * @brief Install a handler to observe transmitted frames
+ *
+ * @remark The handler is invoked from the radio thread, and may inject frames.
+ */
+void Radio::SetTxHandler(TxHandler handler) {
+    std::lock_guard lg(gLock);
+    gTxHandler = std::move(handler);
+}
+
+/**
+ * @brief Receive a frame
+ *
+ * The frame is received only if the receiver is tuned to the given channel, and the radio isn't
+ * busy transmitting; it's dropped (and an overflow reported) if the receive FIFO is full.
+ *
+ * @param channel Channel the frame was sent on
+ * @param data Frame data
+ * @param rssi Received signal strength (dBm)
+ *
+ * @return Whether the frame was placed into the receive FIFO
+ *
+ * @remark Host threads only
+ */
+bool Radio::Inject(const uint16_t channel, std::span<const uint8_t> data, const int8_t rssi) {
+    {
+        std::lock_guard lg(gLock);
+
+        if(gRxChannel != channel || gTxFrame) {
+            return false;
+        }
+
+        if(gRxFifoBytes + data.size() > kRxFifoSize) {
+            RaiseEvents(RAIL_EVENT_RX_FIFO_OVERFLOW);
+            return false;
+        }
+
+        gRxFifo.push_back(Frame{
+            .channel = channel,
+            .rssi = rssi,
+            .timestamp = GetTime(),
+            .data = {data.begin(), data.end()},
+        });
+        gRxFifoBytes += data.size();
+    }
+
+    RaiseEvents(RAIL_EVENT_RX_PACKET_RECEIVED);
+    return true;
+}
+
+/**
+ * @brief Get the current radio time
+ *
+ * @return Microseconds since the radio was initialized (wraps around)
+ */
+RAIL_Time_t Radio::GetTime() {
+    const auto elapsed = std::chrono::steady_clock::now() - gStartTime;
+    return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+/**
+ * @brief Enable the receiver on the given channel
+ */
+RAIL_Status_t Radio::StartRx(const uint16_t channel) {
+    if(!IsValidChannel(channel)) {
+        return RAIL_STATUS_INVALID_PARAMETER;
+    }
+
+    CriticalLock lg(gLock);
+    gRxChannel = channel;
+    return RAIL_STATUS_NO_ERROR;
+}
+
+/**
+ * @brief Transmit the contents of the transmit FIFO
+ *
+ * The transmit FIFO is emptied; completion is reported by the `TX_PACKET_SENT` event once the
+ * frame's airtime has elapsed.
+ */
+RAIL_Status_t Radio::StartTx(const uint16_t channel) {
+    if(!IsValidChannel(channel)) {
+        return RAIL_STATUS_INVALID_PARAMETER;
+    }
+
+    {
+        CriticalLock lg(gLock);
+        if(gTxFrame || gTxFifo.empty()) {
+            return RAIL_STATUS_INVALID_STATE;
+        }
+
+        gTxFrame = Frame{
+            .channel = channel,
+            .rssi = 0,
+            .timestamp = GetTime(),
+            .data = std::move(gTxFifo),
+        };
+
+        gTxFifo.clear();
+        gTxFifo.reserve(kTxFifoSize);
+    }
+
+    gTxStart.notify_all();
+    return RAIL_STATUS_NO_ERROR;
+}
+
+/**
+ * @brief Write data into the transmit FIFO
+ *
+ * @return Number of bytes written (may be less than requested if the FIFO is full)
+ */
+uint16_t Radio::WriteTxFifo(const uint8_t *data, const uint16_t length, const bool reset) {
+    CriticalLock lg(gLock);
+
+    if(reset) {
+        gTxFifo.clear();
+    }
+
+    const auto toWrite = std::min<size_t>(length, kTxFifoSize - gTxFifo.size());
+    gTxFifo.insert(gTxFifo.end(), data, data + toWrite);
+
+    return toWrite;
+}
+
+/**
+ * @brief Discard the contents of the transmit and/or receive FIFOs
+ *
+ * Held receive frames are not discarded; they remain valid until released.
+ */
+void Radio::ResetFifo(const bool tx, const bool rx) {
+    CriticalLock lg(gLock);
+
+    if(tx) {
+        gTxFifo.clear();
+    }
+
+    if(rx) {
+        std::erase_if(gRxFifo, [](const auto &frame) {
+            if(!frame.held) {
+                gRxFifoBytes -= frame.data.size();
+                return true;
+            }
+            return false;
+        });
+    }
+}
+
+/**
+ * @brief Hold the most recently received frame
+ *
+ * @return Handle of the held frame, or RAIL_RX_PACKET_HANDLE_INVALID
+ */
+RAIL_RxPacketHandle_t Radio::HoldRxPacket() {
+    CriticalLock lg(gLock);
+
+    if(gRxFifo.empty()) {
+        return RAIL_RX_PACKET_HANDLE_INVALID;
+    }
+
+    auto &frame = gRxFifo.back();
+    frame.held = true;
+    return &frame;
+}
+
+/**
+ * @brief Get information about a received frame
+ *
+ * @param which Handle of a frame, or one of the `RAIL_RX_PACKET_HANDLE_OLDEST`,
+ *        `RAIL_RX_PACKET_HANDLE_OLDEST_COMPLETE` or `RAIL_RX_PACKET_HANDLE_NEWEST` aliases
+ * @param outInfo Receives the frame information; the frame data is contiguous
+ *
+ * @return Handle of the frame, or RAIL_RX_PACKET_HANDLE_INVALID
+ */
+RAIL_RxPacketHandle_t Radio::GetRxPacketInfo(RAIL_RxPacketHandle_t which,
+        RAIL_RxPacketInfo_t *outInfo) {
+    CriticalLock lg(gLock);
+
+    auto frame = FindRxFrame(which);
+    if(!frame) {
+        outInfo->packetStatus = RAIL_RX_PACKET_NONE;
+        return RAIL_RX_PACKET_HANDLE_INVALID;
+    }
+
+    outInfo->packetStatus = RAIL_RX_PACKET_READY_SUCCESS;
+    outInfo->packetBytes = frame->data.size();
+    outInfo->firstPortionBytes = frame->data.size();
+    outInfo->firstPortionData = frame->data.data();
+    outInfo->lastPortionData = nullptr;
+
+    return frame;
+}
+
+/**
+ * @brief Get the reception details of a received frame
+ */
+RAIL_Status_t Radio::GetRxPacketDetails(RAIL_RxPacketHandle_t which,
+        RAIL_RxPacketDetails_t *outDetails) {
+    CriticalLock lg(gLock);
+
+    auto frame = FindRxFrame(which);
+    if(!frame) {
+        return RAIL_STATUS_INVALID_PARAMETER;
+    }
+
+    memset(outDetails, 0, sizeof(*outDetails));
+    outDetails->timeReceived.packetTime = frame->timestamp;
+    outDetails->crcPassed = true;
+    outDetails->rssi = frame->rssi;
+    outDetails->lqi = 255;
+    outDetails->channel = frame->channel;
+
+    return RAIL_STATUS_NO_ERROR;
+}
+
+/**
+ * @brief Release a received frame, removing it from the receive FIFO
+ */
+RAIL_Status_t Radio::ReleaseRxPacket(RAIL_RxPacketHandle_t which) {
+    CriticalLock lg(gLock);
+
+    auto frame = FindRxFrame(which);
+    if(!frame) {
+        return RAIL_STATUS_INVALID_PARAMETER;
+    }
+
+    auto it = std::find_if(gRxFifo.begin(), gRxFifo.end(), [frame](const auto &candidate) {
+        return &candidate == frame;
+    });
+
+    gRxFifoBytes -= it->data.size();
+    gRxFifo.erase(it);
+
+    return RAIL_STATUS_NO_ERROR;
+}
+
+/**
+ * @brief Check whether a channel number is valid
+ */
+bool Radio::IsValidChannel(const uint16_t channel) {
+    return channel < gConfig.numChannels;
+}
+
+/**
+ * @brief Get the channel the receiver is tuned to
+ */
+std::optional<uint16_t> Radio::GetChannel() {
+    CriticalLock lg(gLock);
+    return gRxChannel;
+}
+
+/**
+ * @brief Get the current radio state
+ */
+RAIL_RadioState_t Radio::GetState() {
+    CriticalLock lg(gLock);
+
+    if(gTxFrame) {
+        return static_cast<RAIL_RadioState_t>(RAIL_RF_STATE_ACTIVE | RAIL_RF_STATE_TX);
+    } else if(gRxChannel) {
+        return static_cast<RAIL_RadioState_t>(RAIL_RF_STATE_ACTIVE | RAIL_RF_STATE_RX);
+    }
+
+    return RAIL_RF_STATE_IDLE;
+}
+
+/**
+ * @brief Set the transmit power level
+ */
+void Radio::SetTxPower(const RAIL_TxPowerLevel_t level) {
+    CriticalLock lg(gLock);
+    gTxPower = level;
+}
+
+/**
+ * @brief Get the transmit power level
+ */
+RAIL_TxPowerLevel_t Radio::GetTxPower() {
+    CriticalLock lg(gLock);
+    return gTxPower;
+}
+
+
+
+/**
+ * @brief Radio thread main loop
+ *
+ * Waits for a transmission to start, then completes it after the frame's airtime.
+ */
+void Radio::Main() {
+    std::unique_lock lk(gLock);
+
+    while(true) {
+        gTxStart.wait(lk, [] { return gShutdown || gTxFrame; });
+        if(gShutdown) {
+            break;
+        }
+
+        const auto airtime = GetAirtime(gTxFrame->data.size());
+
+        lk.unlock();
+        std::this_thread::sleep_for(airtime);
+        lk.lock();
+
+        if(gShutdown) {
+            break;
+        }
+
+        auto frame = std::move(*gTxFrame);
+        gTxFrame.reset();
+        auto handler = gTxHandler;
+
+        lk.unlock();
+
+        if(handler) {
+            handler(frame);
+        }
+        if(gConfig.loopback) {
+            Inject(frame.channel, frame.data, gConfig.loopbackRssi);
+        }
+
+        RaiseEvents(RAIL_EVENT_TX_PACKET_SENT);
+
+        lk.lock();
+    }
+}
+
+/**
+ * @brief Calculate the airtime of a frame
+ *
+ * @param length Frame length (not including physical layer overhead)
+ */
+std::chrono::microseconds Radio::GetAirtime(const size_t length) {
+    const uint64_t bits = (length + gConfig.overheadBytes) * 8;
+    return std::chrono::microseconds((bits * 1'000'000) / gConfig.bitrate);
+}
+
+/**
+ * @brief Resolve a receive packet handle to a frame in the receive FIFO
+ *
+ * @remark The radio lock must be held.
+ */
+Radio::Frame *Radio::FindRxFrame(RAIL_RxPacketHandle_t which) {
+    if(gRxFifo.empty() || which == RAIL_RX_PACKET_HANDLE_INVALID) {
+        return nullptr;
+    }
+
+    if(which == RAIL_RX_PACKET_HANDLE_OLDEST || which == RAIL_RX_PACKET_HANDLE_OLDEST_COMPLETE) {
+        return &gRxFifo.front();
+    } else if(which == RAIL_RX_PACKET_HANDLE_NEWEST) {
+        return &gRxFifo.back();
+    }
+
+    for(auto &frame : gRxFifo) {
+        if(&frame == which) {
+            return &frame;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Deliver radio events to the firmware
+ *
+ * The event callback is invoked from the simulated interrupt context.
+ */
+void Radio::RaiseEvents(const RAIL_Events_t events) {
+    Interrupts::Raise([events] {
+        sl_rail_util_on_event(GetHandle(), events);
+    });
+}
@@ -0,0 +1,151 @@
+#ifndef SIM_RADIO_H
+#define SIM_RADIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <rail_types.h>
+
+namespace Sim {
+/**
+ * @brief Simulated radio
+ *
+ * Stands in for the radio hardware and RAIL: the firmware drives it through the RAIL shim, while
+ * the simulation injects received frames and observes transmitted ones.
+ *
+ * Transmissions are completed by a host thread after the frame's airtime (as derived from the
+ * configured bit rate) elapses; the channel is always clear. Received frames are held in a FIFO
+ * of limited size, like the radio's receive buffer, until the firmware releases them.
+ */
+class Radio {
+    public:
+        /// Size of the receive FIFO, in bytes
+        constexpr static const size_t kRxFifoSize{512};
+        /// Size of the transmit FIFO, in bytes
+        constexpr static const size_t kTxFifoSize{512};
+
+        /**
+         * @brief Physical layer configuration
+         */
+        struct Config {
+            /// Over-the-air bit rate (bits/sec)
+            uint32_t bitrate{250'000};
+            /// Per-frame overhead (preamble, sync word, length, CRC) in bytes
+            size_t overheadBytes{10};
+            /// Number of valid channels
+            uint16_t numChannels{21};
+            /// Whether transmitted frames are received back (if RX is enabled on the channel)
+            bool loopback{false};
+            /// RSSI reported for looped back frames
+            int8_t loopbackRssi{-40};
+        };
+
+        /**
+         * @brief A frame on the air
+         */
+        struct Frame {
+            /// Channel the frame was sent on
+            uint16_t channel;
+            /// Received signal strength (dBm)
+            int8_t rssi;
+            /// Time the frame was received (µs, radio time base)
+            RAIL_Time_t timestamp;
+            /// Whether the firmware has held the frame
+            bool held{false};
+            /// Frame data (MAC header and payload)
+            std::vector<uint8_t> data;
+        };
+
+        /**
+         * @brief Callback invoked for each transmitted frame, from the radio thread
+         */
+        using TxHandler = std::function<void(const Frame &)>;
+
+    public:
+        static void Init(const Config &config);
+        static void Shutdown();
+
+        /// Get the RAIL handle representing the radio
+        static inline RAIL_Handle_t GetHandle() {
+            return &gConfig;
+        }
+
+        // host side
+        static void SetTxHandler(TxHandler handler);
+        static bool Inject(const uint16_t channel, std::span<const uint8_t> data,
+                const int8_t rssi = -40);
+
+        // firmware side (RAIL shim)
+        static RAIL_Time_t GetTime();
+
+        static RAIL_Status_t StartRx(const uint16_t channel);
+        static RAIL_Status_t StartTx(const uint16_t channel);
+        static uint16_t WriteTxFifo(const uint8_t *data, const uint16_t length, const bool reset);
+        static void ResetFifo(const bool tx, const bool rx);
+
+        static RAIL_RxPacketHandle_t HoldRxPacket();
+        static RAIL_RxPacketHandle_t GetRxPacketInfo(RAIL_RxPacketHandle_t which,
+                RAIL_RxPacketInfo_t *outInfo);
+        static RAIL_Status_t GetRxPacketDetails(RAIL_RxPacketHandle_t which,
+                RAIL_RxPacketDetails_t *outDetails);
+        static RAIL_Status_t ReleaseRxPacket(RAIL_RxPacketHandle_t which);
+
+        static bool IsValidChannel(const uint16_t channel);
+        static std::optional<uint16_t> GetChannel();
+        static RAIL_RadioState_t GetState();
+
+        static void SetTxPower(const RAIL_TxPowerLevel_t level);
+        static RAIL_TxPowerLevel_t GetTxPower();
+
+    private:
+        static void Main();
+        static std::chrono::microseconds GetAirtime(const size_t length);
+
+        static Frame *FindRxFrame(RAIL_RxPacketHandle_t which);
+        static void RaiseEvents(const RAIL_Events_t events);
+
+    private:
+        /// Physical layer configuration
+        static Config gConfig;
+        /// Time base for radio timestamps
+        static std::chrono::steady_clock::time_point gStartTime;
+
+        /// Lock protecting the radio state
+        static std::mutex gLock;
+        /// Signalled when a transmission is started, or on shutdown
+        static std::condition_variable gTxStart;
+        /// Radio thread (completes transmissions)
+        static std::thread gThread;
+        /// Set to stop the radio thread
+        static bool gShutdown;
+
+        /// Channel the receiver is tuned to, if enabled
+        static std::optional<uint16_t> gRxChannel;
+        /// Receive FIFO
+        static std::deque<Frame> gRxFifo;
+        /// Bytes in the receive FIFO
+        static size_t gRxFifoBytes;
+
+        /// Transmit FIFO
+        static std::vector<uint8_t> gTxFifo;
+        /// Frame currently being transmitted
+        static std::optional<Frame> gTxFrame;
+        /// Transmit power level (raw)
+        static RAIL_TxPowerLevel_t gTxPower;
+
+        /// Observer for transmitted frames
+        static TxHandler gTxHandler;
+};
+}
+
+#endif
@@ -0,0 +1,133 @@
+#include <algorithm>
+
+#include "CriticalLock.h"
+#include "Interrupts.h"
+#include "Sleeptimer.h"
+
+using namespace Sim;
+
+std::chrono::steady_clock::time_point Sleeptimer::gEpoch{std::chrono::steady_clock::now()};
+
+std::mutex Sleeptimer::gLock;
+std::condition_variable Sleeptimer::gChanged;
+std::vector<sl_sleeptimer_timer_handle_t *> Sleeptimer::gRunning;
+std::thread Sleeptimer::gThread;
+
+/**
+ * @brief Start the timer thread
+ *
+ * It's never stopped: it only ever waits for timers to expire, so it's detached and simply goes
+ * away with the process.
+ *
+ * @remark Safe to call multiple times
+ */
+void Sleeptimer::Init() {
+    static std::once_flag gStarted;
+
+    std::call_once(gStarted, [] {
+        gThread = Interrupts::StartHostThread(Main);
+        gThread.detach();
+    });
+}
+
+/**
+ * @brief Get the current counter value
+ */
+uint64_t Sleeptimer::GetTicks() {
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - gEpoch).count();
+    return (static_cast<uint64_t>(elapsed) * kFrequency) / 1'000'000'000ULL;
+}
+
+/**
+ * @brief Start a one-shot timer
+ *
+ * @param timeout Number of ticks until the timer expires
+ *
+ * @remark Firmware context only
+ */
+sl_status_t Sleeptimer::Start(sl_sleeptimer_timer_handle_t *handle, const uint32_t timeout,
+        sl_sleeptimer_timer_callback_t callback, void *callbackData) {
+    if(!handle || !callback) {
+        return SL_STATUS_INVALID_PARAMETER;
+    }
+
+    Init();
+
+    {
+        CriticalLock lg(gLock);
+        if(handle->running) {
+            return SL_STATUS_NOT_READY;
+        }
+
+        handle->callback = callback;
+        handle->callback_data = callbackData;
+        handle->expiry = GetTicks() + timeout;
+        handle->running = true;
+
+        gRunning.push_back(handle);
+    }
+    gChanged.notify_all();
+
+    return SL_STATUS_OK;
+}
+
+/**
+ * @brief Stop a running timer
+ *
+ * @remark Firmware context only
+ */
+sl_status_t Sleeptimer::Stop(sl_sleeptimer_timer_handle_t *handle) {
+    CriticalLock lg(gLock);
+
+    if(!handle || !handle->running) {
+        return SL_STATUS_INVALID_STATE;
+    }
+
+    handle->running = false;
+    gRunning.erase(std::remove(gRunning.begin(), gRunning.end(), handle), gRunning.end());
+
+    return SL_STATUS_OK;
+}
+
+/**
+ * @brief Timer thread main loop
+ *
+ * Sleep until the earliest running timer expires (or the set of timers changes) and raise the
+ * callbacks of all expired timers.
+ */
+void Sleeptimer::Main() {
+    std::unique_lock lk(gLock);
+
+    while(true) {
+        if(gRunning.empty()) {
+            gChanged.wait(lk);
+            continue;
+        }
+
+        const auto next = *std::min_element(gRunning.begin(), gRunning.end(),
+                [](auto a, auto b) {
+            return a->expiry < b->expiry;
+        });
+
+        const auto now = GetTicks();
+        if(now < next->expiry) {
+            const auto delay = std::chrono::nanoseconds(
+                    ((next->expiry - now) * 1'000'000'000ULL + kFrequency - 1) / kFrequency);
+            gChanged.wait_for(lk, delay);
+            continue;
+        }
+
+        gRunning.erase(std::remove(gRunning.begin(), gRunning.end(), next), gRunning.end());
+        next->running = false;
+
+        const auto callback = next->callback;
+        const auto data = next->callback_data;
+
+        lk.unlock();
+        Interrupts::Raise([next, callback, data] {
+            callback(next, data);
+        });
+        lk.lock();
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef SIM_SLEEPTIMER_H
+#define SIM_SLEEPTIMER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sl_sleeptimer.h>
+
+namespace Sim {
+/**
+ * @brief Simulated low frequency timer
+ *
+ * Stands in for the sleeptimer service on top of the SYSRTC: a free running counter at 32.768 kHz
+ * (derived from the host's monotonic clock) with any number of one-shot timers. Expired timers
+ * invoke their callback in the simulated interrupt context, from a host thread that's started on
+ * first use.
+ */
+class Sleeptimer {
+    public:
+        /// Counter frequency (Hz)
+        constexpr static const uint32_t kFrequency{32'768};
+
+    public:
+        static void Init();
+
+        static uint64_t GetTicks();
+
+        static sl_status_t Start(sl_sleeptimer_timer_handle_t *handle, const uint32_t timeout,
+                sl_sleeptimer_timer_callback_t callback, void *callbackData);
+        static sl_status_t Stop(sl_sleeptimer_timer_handle_t *handle);
+
+    private:
+        static void Main();
+
+    private:
+        /// Host time at which the counter was zero
+        static std::chrono::steady_clock::time_point gEpoch;
+
+        /// Lock protecting the running timers
+        static std::mutex gLock;
+        /// Signalled when the set of running timers changes
+        static std::condition_variable gChanged;
+        /// Running timers
+        static std::vector<sl_sleeptimer_timer_handle_t *> gRunning;
+        /// Thread that expires timers
+        static std::thread gThread;
+};
+}
+
+#endif
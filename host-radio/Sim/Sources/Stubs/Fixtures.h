@@ -0,0 +1,96 @@
+#ifndef STUBS_FIXTURES_H
+#define STUBS_FIXTURES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include <BlazeNet/Types/Mac.h>
+#include <rail.h>
+
+#include "Packet/Handler.h"
+
+#include "Rail.h"
+
+namespace Stubs {
+/**
+ * @brief A received frame, as it would be handed over by the radio
+ */
+struct RxFrame {
+    std::vector<uint8_t> data;
+    RAIL_RxPacketInfo_t info{};
+    RAIL_RxPacketDetails_t details{};
+
+    /**
+     * @brief Build a frame
+     *
+     * @param size Total frame size (bytes, at least the size of the MAC header)
+     * @param ackRequest Whether the frame requests an acknowledgement from the radio
+     */
+    explicit RxFrame(const size_t size, const bool ackRequest = false) : data(size, 0xA5) {
+        using namespace BlazeNet::Types::Mac;
+
+        Header hdr{
+            .flags = static_cast<uint8_t>(HeaderFlags::EndpointUserData |
+                    (ackRequest ? HeaderFlags::AckRequest : 0)),
+            .sequence = 0x42,
+            .source = 0x1234,
+            // the radio's address is 0 until configured
+            .destination = 0x0000,
+        };
+        memcpy(this->data.data(), &hdr, sizeof(hdr));
+
+        this->info.packetStatus = RAIL_RX_PACKET_READY_SUCCESS;
+        this->info.packetBytes = size;
+        this->info.firstPortionBytes = size;
+        this->info.firstPortionData = this->data.data();
+
+        this->details.crcPassed = true;
+        this->details.rssi = -60;
+        this->details.lqi = 200;
+    }
+};
+
+/**
+ * @brief Release all receive packets
+ */
+static inline void DrainRx() {
+    while(!Packet::Handler::GetRxEmptyFlag()) {
+        Packet::Handler::DiscardRxPacket(Packet::Handler::PopRxQueue(), false);
+    }
+}
+
+/**
+ * @brief Get the packet the radio task is currently transmitting
+ *
+ * This is the packet most recently written to the (stubbed) transmit FIFO.
+ */
+static inline Packet::Handler::TxPacketBuffer *GetInFlightTx() {
+    using Packet::Handler;
+
+    auto data = const_cast<uint8_t *>(Rail::GetLastTxData());
+    return reinterpret_cast<Handler::TxPacketBuffer *>(data -
+            offsetof(Handler::TxPacketBuffer, data));
+}
+
+/**
+ * @brief Release all transmit packets
+ *
+ * Discards every queued packet, then the one the radio task is transmitting.
+ */
+static inline void DrainTx() {
+    using Packet::Handler;
+
+    while(auto packet = Handler::PopTxQueue()) {
+        Handler::DiscardTxPacket(packet);
+    }
+
+    if(!Handler::GetTxEmptyFlag()) {
+        Handler::DiscardTxPacket(GetInFlightTx());
+    }
+}
+}
+
+#endif
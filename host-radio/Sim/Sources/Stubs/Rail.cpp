@@ -0,0 +1,147 @@
+/**
+ * @file
+ *
+ * @brief RAIL stub for benchmarks and fuzzers
+ *
+ * Implements the RAIL API used by the firmware without any radio behind it, so benchmarks measure
+ * only the firmware's own code, and fuzzers exercise it deterministically.
+ */
+#include <string.h>
+
+#include <rail.h>
+
+#include "Radio/sl_rail_util_init.h"
+
+#include "Rail.h"
+
+using namespace Stubs;
+
+const uint8_t *Rail::gLastTxData{nullptr};
+
+extern "C" {
+void sl_rail_util_init(void) {
+}
+
+RAIL_Handle_t sl_rail_util_get_handle(sl_rail_util_handle_type_t handle) {
+    return nullptr;
+}
+
+
+
+RAIL_Time_t RAIL_GetTime(void) {
+    return 0;
+}
+
+RAIL_Status_t RAIL_StartRx(RAIL_Handle_t handle, uint16_t channel,
+        const RAIL_SchedulerInfo_t *schedulerInfo) {
+    return RAIL_STATUS_NO_ERROR;
+}
+
+RAIL_Status_t RAIL_StartTx(RAIL_Handle_t handle, uint16_t channel, RAIL_TxOptions_t options,
+        const RAIL_SchedulerInfo_t *schedulerInfo) {
+    return RAIL_STATUS_NO_ERROR;
+}
+
+RAIL_Status_t RAIL_StartCcaCsmaTx(RAIL_Handle_t handle, uint16_t channel,
+        RAIL_TxOptions_t options, const RAIL_CsmaConfig_t *csmaConfig,
+        const RAIL_SchedulerInfo_t *schedulerInfo) {
+    return RAIL_STATUS_NO_ERROR;
+}
+
+// the whole frame always fits
+uint16_t RAIL_WriteTxFifo(RAIL_Handle_t handle, const uint8_t *dataPtr, uint16_t writeLength,
+        bool reset) {
+    Rail::gLastTxData = dataPtr;
+    return writeLength;
+}
+
+void RAIL_ResetFifo(RAIL_Handle_t handle, bool txFifo, bool rxFifo) {
+}
+
+
+
+RAIL_RxPacketHandle_t RAIL_HoldRxPacket(RAIL_Handle_t handle) {
+    return RAIL_RX_PACKET_HANDLE_INVALID;
+}
+
+RAIL_RxPacketHandle_t RAIL_GetRxPacketInfo(RAIL_Handle_t handle,
+        RAIL_RxPacketHandle_t packetHandle, RAIL_RxPacketInfo_t *pPacketInfo) {
+    return RAIL_RX_PACKET_HANDLE_INVALID;
+}
+
+RAIL_Status_t RAIL_GetRxPacketDetails(RAIL_Handle_t handle, RAIL_RxPacketHandle_t packetHandle,
+        RAIL_RxPacketDetails_t *pPacketDetails) {
+    return RAIL_STATUS_INVALID_PARAMETER;
+}
+
+RAIL_Status_t RAIL_ReleaseRxPacket(RAIL_Handle_t handle, RAIL_RxPacketHandle_t packetHandle) {
+    return RAIL_STATUS_NO_ERROR;
+}
+
+// benchmarks always provide contiguous frames
+void RAIL_CopyRxPacket(uint8_t *pDest, const RAIL_RxPacketInfo_t *pPacketInfo) {
+    memcpy(pDest, pPacketInfo->firstPortionData, pPacketInfo->firstPortionBytes);
+}
+
+
+
+RAIL_Status_t RAIL_IsValidChannel(RAIL_Handle_t handle, uint16_t channel) {
+    return RAIL_STATUS_NO_ERROR;
+}
+
+RAIL_Status_t RAIL_GetChannel(RAIL_Handle_t handle, uint16_t *channel) {
+    return RAIL_STATUS_INVALID_CALL;
+}
+
+RAIL_RadioState_t RAIL_GetRadioState(RAIL_Handle_t handle) {
+    return RAIL_RF_STATE_IDLE;
+}
+
+
+
+RAIL_TxPowerLevel_t RAIL_ConvertDbmToRaw(RAIL_Handle_t handle, RAIL_TxPowerMode_t mode,
+        RAIL_TxPower_t power) {
+    return 0;
+}
+
+RAIL_TxPower_t RAIL_ConvertRawToDbm(RAIL_Handle_t handle, RAIL_TxPowerMode_t mode,
+        RAIL_TxPowerLevel_t powerLevel) {
+    return 0;
+}
+
+RAIL_Status_t RAIL_SetTxPower(RAIL_Handle_t handle, RAIL_TxPowerLevel_t powerLevel) {
+    return RAIL_STATUS_NO_ERROR;
+}
+
+RAIL_TxPowerLevel_t RAIL_GetTxPower(RAIL_Handle_t handle) {
+    return 0;
+}
+
+
+
+RAIL_Status_t RAIL_ConfigAutoAck(RAIL_Handle_t handle, const RAIL_AutoAckConfig_t *config) {
+    return RAIL_STATUS_NO_ERROR;
+}
+
+RAIL_Status_t RAIL_WriteAutoAckFifo(RAIL_Handle_t handle, const uint8_t *ackData,
+        uint8_t ackDataLen) {
+    return RAIL_STATUS_NO_ERROR;
+}
+
+void RAIL_EnablePaCal(bool enable) {
+}
+
+RAIL_Status_t RAIL_CalibrateIr(RAIL_Handle_t handle, uint32_t *imageRejection) {
+    *imageRejection = 0;
+    return RAIL_STATUS_NO_ERROR;
+}
+
+RAIL_Status_t RAIL_Calibrate(RAIL_Handle_t handle, RAIL_CalValues_t *calValues,
+        RAIL_CalMask_t calForce) {
+    return RAIL_STATUS_NO_ERROR;
+}
+
+RAIL_CalMask_t RAIL_GetPendingCal(RAIL_Handle_t handle) {
+    return 0;
+}
+}
@@ -0,0 +1,32 @@
+#ifndef STUBS_RAIL_H
+#define STUBS_RAIL_H
+
+#include <stdint.h>
+
+#include <rail.h>
+
+/// Null peripheral implementations, for driving firmware code directly from host tools
+namespace Stubs {
+/**
+ * @brief Null RAIL implementation
+ *
+ * Takes the place of the simulated radio for benchmarks and fuzzers: every call succeeds
+ * immediately, and no radio events are ever generated. Transmissions are recorded, so that the
+ * packet the radio task considers in flight can be released again.
+ */
+class Rail {
+    public:
+        /// Get the payload most recently written to the transmit FIFO
+        static inline const uint8_t *GetLastTxData() {
+            return gLastTxData;
+        }
+
+    private:
+        friend uint16_t (::RAIL_WriteTxFifo)(RAIL_Handle_t, const uint8_t *, uint16_t, bool);
+
+        /// Payload most recently written to the transmit FIFO
+        static const uint8_t *gLastTxData;
+};
+}
+
+#endif
@@ -0,0 +1,107 @@
+/**
+ * @file
+ *
+ * @brief SPI driver stub
+ *
+ * Slave transfers are only recorded; the harness driving the firmware completes them. Argument
+ * validation matches the host link backed shim, so the firmware sees the same errors. Master
+ * transfers go to the simulated NOR flash, as in the simulator.
+ */
+#include <spidrv.h>
+
+#include "Log/Logger.h"
+#include "Sim/NorFlash.h"
+
+#include "Spidrv.h"
+
+using namespace Stubs;
+
+bool Spidrv::gArmed{false};
+Spidrv::Transfer Spidrv::gTransfer{};
+
+/**
+ * @brief Record an armed transfer
+ *
+ * @return ECODE_EMDRV_SPIDRV_BUSY if a transfer is already armed
+ */
+Ecode_t Spidrv::Arm(const Transfer &transfer) {
+    if(gArmed) {
+        return ECODE_EMDRV_SPIDRV_BUSY;
+    }
+
+    gTransfer = transfer;
+    gArmed = true;
+
+    return ECODE_EMDRV_SPIDRV_OK;
+}
+
+/**
+ * @brief Complete the armed transfer
+ *
+ * The transfer is disarmed before the callback is invoked, so that it may arm the next one.
+ *
+ * @param status Transfer status to report
+ * @param count Number of bytes transferred; for receives, these must already be in the buffer
+ */
+void Spidrv::Complete(const Ecode_t status, const size_t count) {
+    REQUIRE(gArmed, "no %s transfer armed", "SPI");
+    REQUIRE(count <= gTransfer.count, "invalid transfer length: %u", count);
+
+    gArmed = false;
+    gTransfer.callback(gTransfer.handle, status, static_cast<int>(count));
+}
+
+/**
+ * @brief Forget the armed transfer, without invoking its callback
+ */
+void Spidrv::Reset() {
+    gArmed = false;
+    gTransfer = {};
+}
+
+extern "C" {
+Ecode_t SPIDRV_SReceive(SPIDRV_Handle_t handle, void *buffer, int count,
+        SPIDRV_Callback_t callback, int timeoutMs) {
+    if(!handle) {
+        return ECODE_EMDRV_SPIDRV_ILLEGAL_HANDLE;
+    } else if(handle->type != spidrvSlave || count <= 0 || timeoutMs) {
+        return ECODE_EMDRV_SPIDRV_PARAM_ERROR;
+    }
+
+    return Spidrv::Arm({
+        .rxBuffer = static_cast<uint8_t *>(buffer),
+        .txBuffer = nullptr,
+        .count = static_cast<size_t>(count),
+        .callback = callback,
+        .handle = handle,
+    });
+}
+
+Ecode_t SPIDRV_STransmit(SPIDRV_Handle_t handle, const void *buffer, int count,
+        SPIDRV_Callback_t callback, int timeoutMs) {
+    if(!handle) {
+        return ECODE_EMDRV_SPIDRV_ILLEGAL_HANDLE;
+    } else if(handle->type != spidrvSlave || count <= 0 || timeoutMs) {
+        return ECODE_EMDRV_SPIDRV_PARAM_ERROR;
+    }
+
+    return Spidrv::Arm({
+        .rxBuffer = nullptr,
+        .txBuffer = static_cast<const uint8_t *>(buffer),
+        .count = static_cast<size_t>(count),
+        .callback = callback,
+        .handle = handle,
+    });
+}
+
+Ecode_t SPIDRV_AbortTransfer(SPIDRV_Handle_t handle) {
+    if(!handle) {
+        return ECODE_EMDRV_SPIDRV_ILLEGAL_HANDLE;
+    } else if(handle->type == spidrvMaster) {
+        return Sim::NorFlash::Abort(handle);
+    }
+
+    Spidrv::Reset();
+    return ECODE_EMDRV_SPIDRV_OK;
+}
+}
@@ -0,0 +1,64 @@
+#ifndef STUBS_SPIDRV_H
+#define STUBS_SPIDRV_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <spidrv.h>
+
+namespace Stubs {
+/**
+ * @brief Manually driven SPI driver
+ *
+ * Records the slave transfer the firmware most recently armed, instead of carrying it out. The
+ * caller then completes it (with whatever status and byte count it likes) via Complete(), which
+ * invokes the firmware's completion callback synchronously.
+ *
+ * Only a single transfer may be armed at a time, as with the real driver.
+ */
+class Spidrv {
+    public:
+        /// A transfer armed by the firmware
+        struct Transfer {
+            /// Buffer to receive into (for receives)
+            uint8_t *rxBuffer;
+            /// Buffer to transmit from (for transmits)
+            const uint8_t *txBuffer;
+            /// Number of bytes requested
+            size_t count;
+            /// Completion callback
+            SPIDRV_Callback_t callback;
+            /// Driver handle the transfer was armed on
+            SPIDRV_Handle_t handle;
+        };
+
+    public:
+        /// Is a transfer armed?
+        static inline bool IsArmed() {
+            return gArmed;
+        }
+        /// Get the armed transfer
+        static inline const Transfer &GetArmed() {
+            return gTransfer;
+        }
+
+        static void Complete(const Ecode_t status, const size_t count);
+        static void Reset();
+
+    private:
+        friend Ecode_t (::SPIDRV_SReceive)(SPIDRV_Handle_t, void *, int, SPIDRV_Callback_t, int);
+        friend Ecode_t (::SPIDRV_STransmit)(SPIDRV_Handle_t, const void *, int, SPIDRV_Callback_t,
+                int);
+        friend Ecode_t (::SPIDRV_AbortTransfer)(SPIDRV_Handle_t);
+
+        static Ecode_t Arm(const Transfer &transfer);
+
+    private:
+        /// Whether a transfer is armed
+        static bool gArmed;
+        /// The currently armed transfer
+        static Transfer gTransfer;
+};
+}
+
+#endif
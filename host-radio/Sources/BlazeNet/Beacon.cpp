@@ -82,6 +82,8 @@ void Beacon::SetEnabled(const bool isEnabled) {
  * @param interval Beaconing interval, in msec
  */
 void Beacon::SetInterval(const uintptr_t interval) {
+    REQUIRE(pdMS_TO_TICKS(interval), "invalid beacon interval: %u", interval);
+
     xTimerChangePeriod(gTimer, pdMS_TO_TICKS(interval), portMAX_DELAY);
 
     if(gEnabled) {
@@ -108,9 +110,9 @@ int Beacon::SetPayload(etl::span<const uint8_t> payload) {
     ok = xSemaphoreTake(gPacketLock, portMAX_DELAY);
     REQUIRE(ok == pdTRUE, "failed to acquire %s", "beacon packet lock");
 
-    // release the old packet
+    // release the old packet (it's not queued, so it doesn't count as pending)
     if(gPacket) {
-        Packet::Handler::DiscardTxPacket(gPacket, true);
+        Packet::Handler::FreeTxPacket(gPacket);
         gPacket = nullptr;
     }
 
@@ -8,6 +8,12 @@
 #include "Packet/Handler.h"
 #include "Rtos/Rtos.h"
 
+#ifdef HOST_SIM_FUZZ_HARNESS
+namespace Fuzz {
+class Harness;
+}
+#endif
+
 namespace BlazeNet {
 /**
  * @brief Beacon handler
@@ -17,6 +23,10 @@ namespace BlazeNet {
  * feature is enabled.
  */
 class Beacon {
+#ifdef HOST_SIM_FUZZ_HARNESS
+    friend class Fuzz::Harness;
+#endif
+
     private:
         /// Maximum size of a beacon frame (bytes)
         constexpr static const size_t kMaxBeaconSize{192};
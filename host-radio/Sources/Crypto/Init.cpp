@@ -15,7 +15,7 @@ using namespace Crypto;
  * crypto operations.
  */
 void Crypto::Init() {
-    Logger::Notice("%s: init", "crypto");
+    Logger::Notice(Logger::Module::Crypto, "%s: init", "crypto");
 
     // enable clocks
     CMU_ClockEnable(cmuClock_SEMAILBOX, true);
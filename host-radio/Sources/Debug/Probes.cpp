@@ -0,0 +1,76 @@
+#include <string.h>
+
+#include "Rtos/Rtos.h"
+
+#include "Probes.h"
+
+using namespace Debug;
+
+HostIf::Response::Probe Probes::gProbes[kNumProbes];
+
+/**
+ * @brief Initialize the probe timer
+ *
+ * Enables the DWT cycle counter. This should be called as early as possible, since probes hit
+ * before are measured as taking no time.
+ */
+void Probes::Init() {
+    if constexpr(kEnabled) {
+#if defined(__arm__)
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    }
+
+    Reset();
+}
+
+/**
+ * @brief Add a measurement to a probe
+ *
+ * @param id Probe to update
+ * @param elapsed Measured duration (timer ticks)
+ */
+void Probes::Update(const Id id, const uint32_t elapsed) {
+    auto &probe = gProbes[id];
+
+    const auto irq = taskENTER_CRITICAL_FROM_ISR();
+
+    if(!probe.count || elapsed < probe.min) {
+        probe.min = elapsed;
+    }
+    if(elapsed > probe.max) {
+        probe.max = elapsed;
+    }
+    probe.total += elapsed;
+    probe.count++;
+
+    taskEXIT_CRITICAL_FROM_ISR(irq);
+}
+
+/**
+ * @brief Copy out the probe table
+ *
+ * @param out Response to fill in
+ */
+void Probes::Read(HostIf::Response::ReadProbes &out) {
+    memset(&out, 0, sizeof(out));
+
+    out.timerFrequency = GetFrequency();
+    out.enabled = kEnabled ? 1 : 0;
+    out.numProbes = kNumProbes;
+
+    const auto irq = taskENTER_CRITICAL_FROM_ISR();
+    memcpy(out.probes, gProbes, sizeof(gProbes));
+    taskEXIT_CRITICAL_FROM_ISR(irq);
+}
+
+/**
+ * @brief Clear all probes
+ */
+void Probes::Reset() {
+    const auto irq = taskENTER_CRITICAL_FROM_ISR();
+    memset(gProbes, 0, sizeof(gProbes));
+    taskEXIT_CRITICAL_FROM_ISR(irq);
+}
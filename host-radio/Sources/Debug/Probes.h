@@ -0,0 +1,133 @@
+#ifndef DEBUG_PROBES_H
+#define DEBUG_PROBES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__arm__)
+#include <em_device.h>
+#else
+#include <time.h>
+#endif
+
+#include <BlazeNet/HostIf/Commands.h>
+
+/**
+ * @brief Start timing a probe
+ *
+ * Must be paired with PROBE_END() for the same probe, in the same scope.
+ *
+ * @param id Probe name (an `HostIf::Response::ReadProbes::Id` value, without the prefix)
+ */
+#define PROBE_BEGIN(id) \
+    const uint32_t _probeStart_##id = ::Debug::Probes::Now()
+/**
+ * @brief Finish timing a probe, and account the time since the matching PROBE_BEGIN()
+ */
+#define PROBE_END(id) \
+    ::Debug::Probes::Record(::HostIf::Response::ReadProbes::id, _probeStart_##id)
+/**
+ * @brief Time a probe until the end of the enclosing scope
+ *
+ * Use this instead of PROBE_BEGIN()/PROBE_END() in functions with several return paths.
+ */
+#define PROBE_SCOPE(id) \
+    const ::Debug::Probes::Scope _probeScope_##id{::HostIf::Response::ReadProbes::id}
+
+namespace Debug {
+/**
+ * @brief Lightweight profiling probes
+ *
+ * Measures the time spent in the firmware's hot paths, using the Cortex-M33 cycle counter (or, in
+ * host builds, the monotonic clock.) Each probe accumulates the number of measurements, and their
+ * total, minimum and maximum duration into a static table, which the host reads out with the
+ * ReadProbes command.
+ *
+ * Probes are identified by the `HostIf::Response::ReadProbes::Id` enum, and placed with the
+ * PROBE_BEGIN()/PROBE_END() or PROBE_SCOPE() macros. They are disabled by default; when disabled,
+ * they compile to nothing.
+ *
+ * @remark Probes may be used from any task or interrupt context.
+ */
+class Probes {
+    public:
+        using Id = HostIf::Response::ReadProbes::Id;
+
+        /// Whether probes are compiled in
+        constexpr static const bool kEnabled{false};
+        /// Number of probes
+        constexpr static const size_t kNumProbes{Id::NumProbes};
+
+        /**
+         * @brief Probe that measures until the end of its scope
+         */
+        class Scope {
+            public:
+                inline Scope(const Id id) : id(id), start(Now()) {}
+                inline ~Scope() {
+                    Record(this->id, this->start);
+                }
+
+            private:
+                const Id id;
+                const uint32_t start;
+        };
+
+    public:
+        static void Init();
+
+        /**
+         * @brief Get the current probe timer value
+         *
+         * Always returns zero if probes are disabled.
+         */
+        static inline uint32_t Now() {
+            if constexpr(kEnabled) {
+#if defined(__arm__)
+                return DWT->CYCCNT;
+#else
+                struct timespec ts;
+                clock_gettime(CLOCK_MONOTONIC, &ts);
+                return static_cast<uint32_t>(ts.tv_sec * 1'000'000'000ULL + ts.tv_nsec);
+#endif
+            } else {
+                return 0;
+            }
+        }
+
+        /**
+         * @brief Get the probe timer's frequency (Hz)
+         */
+        static inline uint32_t GetFrequency() {
+#if defined(__arm__)
+            return SystemCoreClock;
+#else
+            return 1'000'000'000;
+#endif
+        }
+
+        /**
+         * @brief Account a measurement
+         *
+         * @param id Probe to update
+         * @param start Timer value at the start of the measurement
+         */
+        static inline void Record(const Id id, const uint32_t start) {
+            if constexpr(kEnabled) {
+                Update(id, Now() - start);
+            }
+        }
+
+        static void Read(HostIf::Response::ReadProbes &out);
+        static void Reset();
+
+    private:
+        static void Update(const Id id, const uint32_t elapsed);
+
+    private:
+        /// Accumulated measurements, indexed by probe id
+        static HostIf::Response::Probe gProbes[kNumProbes];
+};
+}
+
+#endif
@@ -0,0 +1,226 @@
+#include <string.h>
+
+#include <etl/algorithm.h>
+
+#include "Log/Logger.h"
+#include "Rtos/Heap.h"
+
+#include "BlockCache.h"
+#include "Flash.h"
+#include "FlashInfo.h"
+
+using namespace Fs;
+
+Flash *BlockCache::gFlash{nullptr};
+
+etl::array<BlockCache::Line, BlockCache::kNumLines> BlockCache::gLines{};
+uint8_t *BlockCache::gData{nullptr};
+uint32_t BlockCache::gAccessStamp{0};
+bool BlockCache::gEnabled{true};
+
+BlockCache::Stats BlockCache::gStats{};
+
+/**
+ * @brief Initialize the cache
+ *
+ * Allocate the line memory; if that fails, the filesystem works uncached.
+ *
+ * @param flash Flash the filesystem lives on
+ */
+void BlockCache::Init(Flash *flash) {
+    gFlash = flash;
+
+    if constexpr(!kNumLines) {
+        return;
+    }
+
+    REQUIRE(kLineSize <= flash->getInfo()->pageSizeBytes(), "invalid %s config", "block cache");
+
+    if(!gData) {
+        gData = reinterpret_cast<uint8_t *>(Rtos::Heap::Alloc(Rtos::Heap::Class::FsCache,
+                    kNumLines * kLineSize));
+        if(!gData) {
+            Logger::Warning(Logger::Module::Fs, "FS: couldn't alloc %u bytes block cache",
+                    kNumLines * kLineSize);
+        }
+    }
+
+    Invalidate();
+}
+
+/**
+ * @brief Read from the flash, through the cache
+ *
+ * Each cache line covered by the read is either copied from the cache, or read from the flash
+ * into the least recently used line first.
+ *
+ * @param address Flash address to start reading at
+ * @param buffer Buffer to receive the data
+ */
+int BlockCache::Read(const uintptr_t address, etl::span<uint8_t> buffer) {
+    int err;
+
+    if(!gData || !gEnabled || buffer.size() >= kBypassSize) {
+        gStats.bypassed++;
+        return gFlash->read(address, buffer);
+    }
+
+    size_t offset{0};
+    while(offset < buffer.size()) {
+        const auto start = address + offset;
+        const auto lineAddress = start & ~(kLineSize - 1);
+        const auto numBytes = etl::min(kLineSize - (start - lineAddress),
+                buffer.size() - offset);
+
+        bool hit;
+        auto &line = Lookup(lineAddress, hit);
+
+        if(hit) {
+            gStats.hits++;
+        } else {
+            gStats.misses++;
+
+            err = gFlash->read(lineAddress, {GetData(line), kLineSize});
+            if(err) {
+                return err;
+            }
+
+            line.address = lineAddress;
+            line.valid = true;
+        }
+
+        memcpy(buffer.data() + offset, GetData(line) + (start - lineAddress), numBytes);
+        offset += numBytes;
+    }
+
+    return Flash::Error::NoError;
+}
+
+/**
+ * @brief Program the flash, updating cached lines
+ *
+ * Programming can only clear bits, so cached data is combined with the written data the same way.
+ * If programming fails, the state of the flash is unknown, so the lines are dropped instead.
+ */
+int BlockCache::Write(const uintptr_t address, etl::span<const uint8_t> data) {
+    const auto err = gFlash->write(address, data);
+
+    ForEachOverlap(address, data.size(), [&](auto &line, auto lineOffset, auto dataOffset,
+                auto numBytes) {
+        if(err) {
+            line.valid = false;
+            return;
+        }
+
+        auto lineData = GetData(line) + lineOffset;
+        for(size_t i = 0; i < numBytes; i++) {
+            lineData[i] &= data[dataOffset + i];
+        }
+    });
+
+    return err;
+}
+
+/**
+ * @brief Erase the flash, updating cached lines
+ *
+ * Cached lines in the erased area are set to the erased state, or dropped if the erase fails.
+ */
+int BlockCache::Erase(const uintptr_t address, const size_t length) {
+    const auto err = gFlash->erase(address, length);
+
+    ForEachOverlap(address, length, [&](auto &line, auto lineOffset, auto, auto numBytes) {
+        if(err) {
+            line.valid = false;
+            return;
+        }
+
+        memset(GetData(line) + lineOffset, 0xFF, numBytes);
+    });
+
+    return err;
+}
+
+/**
+ * @brief Enable or disable the cache
+ *
+ * While disabled, reads go straight to the flash; cached lines are still kept up to date by
+ * writes and erases, but dropped when the cache is enabled again.
+ */
+void BlockCache::SetEnabled(const bool enabled) {
+    if(enabled && !gEnabled) {
+        Invalidate();
+    }
+
+    gEnabled = enabled;
+}
+
+/**
+ * @brief Drop all cached data
+ */
+void BlockCache::Invalidate() {
+    for(auto &line : gLines) {
+        line.valid = false;
+    }
+}
+
+/**
+ * @brief Find the cache line for an address
+ *
+ * If the address isn't cached, the least recently used (or an invalid) line is returned; the
+ * caller must fill it. In either case, the line is marked as most recently used.
+ *
+ * @param address Line aligned flash address
+ * @param outHit Set if the line holds the address
+ */
+BlockCache::Line &BlockCache::Lookup(const uintptr_t address, bool &outHit) {
+    const auto stamp = ++gAccessStamp;
+    Line *victim{&gLines[0]};
+
+    for(auto &line : gLines) {
+        if(line.valid && line.address == address) {
+            outHit = true;
+            line.lastUse = stamp;
+            return line;
+        }
+
+        // prefer invalid lines, then the one unused for the longest time (wrap-around safe)
+        if(!victim->valid) {
+            continue;
+        } else if(!line.valid || (stamp - line.lastUse) > (stamp - victim->lastUse)) {
+            victim = &line;
+        }
+    }
+
+    outHit = false;
+    victim->valid = false;
+    victim->lastUse = stamp;
+    return *victim;
+}
+
+/**
+ * @brief Invoke a function for each valid cache line that overlaps an area of flash
+ *
+ * @param func Invoked with the line, the offset of the overlap into the line and into the area,
+ *        and the number of bytes overlapping
+ */
+template<typename Func>
+void BlockCache::ForEachOverlap(const uintptr_t address, const size_t length, Func func) {
+    if(!gData) {
+        return;
+    }
+
+    for(auto &line : gLines) {
+        if(!line.valid) {
+            continue;
+        }
+
+        const auto start = etl::max(address, line.address);
+        const auto end = etl::min(address + length, line.address + kLineSize);
+        if(start >= end) {
+            continue;
+        }
+
+        func(line, start - line.address, start - address, end - start);
+    }
+}
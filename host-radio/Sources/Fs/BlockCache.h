@@ -0,0 +1,114 @@
+#ifndef FS_BLOCKCACHE_H
+#define FS_BLOCKCACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <etl/array.h>
+#include <etl/span.h>
+
+namespace Fs {
+class Flash;
+
+/**
+ * @brief Read cache for the filesystem
+ *
+ * Sits between SPIFFS and the flash driver: SPIFFS looks up objects by scanning the object lookup
+ * pages with many small reads, each of which would otherwise be a separate flash command. Reads
+ * are served from (and fill) a set of page sized cache lines, evicting the least recently used
+ * one on a miss. Large reads bypass the cache, so that streaming file data doesn't evict the
+ * lookup pages.
+ *
+ * Writes and erases go to the flash immediately (write-through) and update any cached lines they
+ * cover the same way they change the flash, so lines never need to be written back.
+ *
+ * Line memory is allocated from the filesystem cache heap class when initialized; if that fails,
+ * or the cache is disabled (kNumLines = 0), all accesses go straight to the flash.
+ *
+ * @remark Only the filesystem may access its region of the flash while the cache is in use, and
+ *         (like the flash driver) callers must serialize accesses.
+ */
+class BlockCache {
+    public:
+        /// Number of cache lines; set to 0 to disable the cache
+        constexpr static const size_t kNumLines{16};
+        /// Size of each cache line (bytes); a power of two no larger than a flash page
+        constexpr static const size_t kLineSize{256};
+        /// Reads of at least this many bytes bypass the cache
+        constexpr static const size_t kBypassSize{4 * kLineSize};
+
+        /// Access counters
+        struct Stats {
+            /// Cache lines read from the cache
+            uint32_t hits;
+            /// Cache lines read from the flash (and added to the cache)
+            uint32_t misses;
+            /// Reads that bypassed the cache
+            uint32_t bypassed;
+        };
+
+    public:
+        static void Init(Flash *flash);
+
+        static int Read(const uintptr_t address, etl::span<uint8_t> buffer);
+        static int Write(const uintptr_t address, etl::span<const uint8_t> data);
+        static int Erase(const uintptr_t address, const size_t length);
+
+        static void SetEnabled(const bool enabled);
+        static void Invalidate();
+
+        /**
+         * @brief Get the access counters
+         */
+        static inline const Stats &GetStats() {
+            return gStats;
+        }
+
+        /**
+         * @brief Get the number of cache lines in use
+         */
+        static inline size_t GetNumLines() {
+            return gData ? kNumLines : 0;
+        }
+
+    private:
+        /// Cache line bookkeeping
+        struct Line {
+            /// Flash address of the line's first byte
+            uintptr_t address;
+            /// Access stamp of the most recent use
+            uint32_t lastUse;
+            /// Whether the line holds data
+            bool valid;
+        };
+
+        static Line &Lookup(const uintptr_t address, bool &outHit);
+        template<typename Func>
+        static void ForEachOverlap(const uintptr_t address, const size_t length, Func func);
+
+        /**
+         * @brief Get the data of a cache line
+         */
+        static inline uint8_t *GetData(const Line &line) {
+            return gData + (&line - gLines.data()) * kLineSize;
+        }
+
+    private:
+        /// Flash the filesystem lives on
+        static Flash *gFlash;
+
+        /// Cache lines
+        static etl::array<Line, kNumLines> gLines;
+        /// Line data (kNumLines × kLineSize bytes); `nullptr` if there is no cache
+        static uint8_t *gData;
+        /// Incremented with every line accessed
+        static uint32_t gAccessStamp;
+        /// Whether the cache is used
+        static bool gEnabled;
+
+        /// Access counters
+        static Stats gStats;
+};
+}
+
+#endif
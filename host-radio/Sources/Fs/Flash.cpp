@@ -1,6 +1,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <etl/algorithm.h>
+
 #include "Drivers/sl_spidrv_instances.h"
 #include "Log/Logger.h"
 
@@ -9,13 +11,46 @@
 
 using namespace Fs;
 
+TaskHandle_t Flash::gWaitingTask{nullptr};
+volatile Ecode_t Flash::gTransferStatus{ECODE_EMDRV_SPIDRV_OK};
+sl_sleeptimer_timer_handle_t Flash::gPollTimer{};
+SemaphoreHandle_t Flash::gLock{nullptr};
+uint32_t Flash::gBitrate{SL_SPIDRV_EUSART_FLASH_BITRATE};
+bool Flash::gPanicMode{false};
+
 /**
  * @brief Initialize the flash wrapper instance
  *
+ * Select the read command, then raise the bus clock to the highest one the chip supports.
+ *
  * @param info Flash information descriptor
  */
 Flash::Flash(const FlashInfo *info) : info(info) {
-    // TODO: is there anything to do here?
+    uint32_t maxClock = info->maxClock;
+
+    if(!gLock) {
+        static StaticSemaphore_t gLockStorage;
+        gLock = xSemaphoreCreateMutexStatic(&gLockStorage);
+        REQUIRE(!!gLock, "failed to initialize %s", "flash lock");
+    }
+
+    if(info->cmdFastRead) {
+        this->readCmd = info->cmdFastRead;
+        this->readDummyBytes = 1;
+    } else {
+        this->readCmd = info->cmdRead;
+        this->readDummyBytes = 0;
+        maxClock = etl::min(maxClock, info->maxReadClock);
+    }
+
+    const auto bitrate = etl::min(maxClock, kMaxBitrate);
+
+    const auto err = SPIDRV_SetBitrate(sl_spidrv_eusart_flash_handle, bitrate);
+    if(err != ECODE_EMDRV_SPIDRV_OK) {
+        Logger::Warning(Logger::Module::Fs, "failed to set flash bitrate %u: %d", bitrate, err);
+    } else {
+        gBitrate = bitrate;
+    }
 }
 
 /**
@@ -25,20 +60,18 @@ Flash::Flash(const FlashInfo *info) : info(info) {
  *
  * @param address Memory address to begin reading at
  * @param buffer Memory region to receive the read data
+ * @param async Whether the calling task may block while the data is transferred
  */
-int Flash::read(const uintptr_t address, etl::span<uint8_t> buffer) {
+int Flash::read(const uintptr_t address, etl::span<uint8_t> buffer, const bool async) {
     // validate inputs
     if(buffer.empty()) {
         return Error::InvalidArguments;
     }
 
     // perform the read
-    etl::array<uint8_t, 4> cmd{{
-        this->info->cmdRead, static_cast<uint8_t>((address & 0xFF0000) >> 16),
-            static_cast<uint8_t>((address & 0x00FF00) >> 8),
-            static_cast<uint8_t>((address & 0x0000FF)),
-    }};
-    return ExecCmdRead(cmd, buffer);
+    CommandBuffer cmd;
+    return ExecCmdRead(this->encodeCommand(cmd, this->readCmd, address, this->readDummyBytes),
+            buffer, async);
 }
 
 /**
@@ -62,11 +95,15 @@ int Flash::writeEnable() {
  * Read the status register of the flash device, and inspect the busy bit. Repeat this process
  * until the chip is either no longer busy or we time out.
  *
- * @remark The timeout does not function while the scheduler is not yet started.
+ * The first poll happens once the operation's typical duration has passed; if it's still busy,
+ * polls are repeated at increasing intervals (starting at an eighth of the typical duration, and
+ * doubling each time) so that fast operations are picked up soon after they complete, without
+ * polling long ones excessively.
  *
+ * @param typicalUsec Typical duration of the operation, in µsec
  * @param timeoutMsec Maximum time for the operation, in msec, before aborting
  */
-int Flash::waitForCompletion(const uint32_t timeoutMsec) {
+int Flash::waitForCompletion(const uint32_t typicalUsec, const uint32_t timeoutMsec) {
     int err;
 
     // command for reading status register
@@ -75,12 +112,21 @@ int Flash::waitForCompletion(const uint32_t timeoutMsec) {
     }};
     etl::array<uint8_t, 1> status{{0xff}};
 
-    // TODO: how does this handle wrap-around?
-    const auto now = xTaskGetTickCount();
-    const auto expires = now + pdMS_TO_TICKS(timeoutMsec);
-    const bool withDelay = !(xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED);
+    // the tick count wraps around, but the elapsed time (as an unsigned difference) doesn't
+    const auto frequency = sl_sleeptimer_get_timer_frequency();
+    const auto start = sl_sleeptimer_get_tick_count();
+    const uint64_t timeoutTicks = (static_cast<uint64_t>(timeoutMsec) * frequency) / 1000;
+
+    uint32_t delay{typicalUsec};
+    uint32_t interval = etl::clamp(typicalUsec / 8, kMinPollInterval, kMaxPollInterval);
 
     while(true) {
+        // wait, though not beyond the timeout
+        const uint32_t elapsed = sl_sleeptimer_get_tick_count() - start;
+        const uint64_t remaining = (elapsed < timeoutTicks) ? (timeoutTicks - elapsed) : 0;
+
+        Delay(etl::min<uint64_t>(delay, (remaining * 1'000'000) / frequency));
+
         // check if no longer busy
         err = ExecCmdRead(cmd, status);
         if(err) {
@@ -92,19 +138,14 @@ int Flash::waitForCompletion(const uint32_t timeoutMsec) {
             return Error::NoError;
         }
 
-        // check for timeout
-        if(xTaskGetTickCount() > expires) {
+        // check for timeout (having polled at least once after it expired)
+        if(!remaining) {
             return Error::Timeout;
         }
 
-        // wait some time before trying again
-        if(withDelay) {
-            // TODO: use the smaller of 10ms or the remaining timeout
-            vTaskDelay(pdMS_TO_TICKS(10));
-        } else {
-            volatile unsigned int blah{420'690};
-            while(blah--) {}
-        }
+        // back off
+        delay = interval;
+        interval = etl::min(interval * 2, kMaxPollInterval);
     }
 }
 
@@ -113,13 +154,14 @@ int Flash::waitForCompletion(const uint32_t timeoutMsec) {
  *
  * Break the specified continuous program operation into one or more page sized program operations
  * that the flash can execute natively.
+ *
+ * @param async Whether the calling task may block while the data is transferred
  */
-int Flash::write(const uintptr_t address, etl::span<const uint8_t> data) {
+int Flash::write(const uintptr_t address, etl::span<const uint8_t> data, const bool async) {
     int err;
 
-    if(kLogWrites) {
-        Logger::Notice("Write(%06x): %u bytes from %p", address, data.size(), data.data());
-    }
+    Logger::Trace(Logger::Module::Fs, "Write(%06x): %u bytes from %p", address, data.size(),
+            data.data());
 
     // validate inputs
     if(data.empty()) {
@@ -136,7 +178,7 @@ int Flash::write(const uintptr_t address, etl::span<const uint8_t> data) {
         const auto numBytes = etl::min(pageSize - (start & (pageSize - 1)), totalBytes);
 
         // do the write
-        err = this->writePage(start, { data.data() + offset, numBytes });
+        err = this->writePage(start, { data.data() + offset, numBytes }, async);
         if(err) {
             return err;
         }
@@ -161,13 +203,13 @@ int Flash::write(const uintptr_t address, etl::span<const uint8_t> data) {
  *
  * @param address Page address to begin writing at
  * @param data Data to write to the page (up to page size)
+ * @param async Whether the calling task may block while the data is transferred
  */
-int Flash::writePage(const uintptr_t address, etl::span<const uint8_t> data) {
+int Flash::writePage(const uintptr_t address, etl::span<const uint8_t> data, const bool async) {
     int err;
 
-    if(kLogWrites) {
-        Logger::Notice("PageWrite(%06x): %u bytes from %p", address, data.size(), data.data());
-    }
+    Logger::Trace(Logger::Module::Fs, "PageWrite(%06x): %u bytes from %p", address, data.size(),
+            data.data());
 
     // validate inputs
     if(data.empty()) {
@@ -187,19 +229,16 @@ int Flash::writePage(const uintptr_t address, etl::span<const uint8_t> data) {
     }
 
     // …then do the actual write
-    etl::array<uint8_t, 4> cmdBuf{{
-        this->info->cmdProgramPage, static_cast<uint8_t>((address & 0xFF0000) >> 16),
-        static_cast<uint8_t>((address & 0x00FF00) >> 8),
-        static_cast<uint8_t>((address & 0x0000FF)),
-    }};
-
-    err = ExecCmdWrite(cmdBuf, data);
+    CommandBuffer cmdBuf;
+    err = ExecCmdWrite(this->encodeCommand(cmdBuf, this->info->cmdProgramPage, address), data,
+            async);
     if(err) {
         return err;
     }
 
     // and wait for the program operation to complete
-    return this->waitForCompletion(this->info->timeoutPageProgram);
+    return this->waitForCompletion(this->info->typicalPageProgram,
+            this->info->timeoutPageProgram);
 }
 
 /**
@@ -212,9 +251,7 @@ int Flash::writePage(const uintptr_t address, etl::span<const uint8_t> data) {
 int Flash::erase(const uintptr_t address, const size_t length) {
     int err;
 
-    if(kLogErase) {
-        Logger::Notice("Erase(%06x) %u bytes", address, length);
-    }
+    Logger::Trace(Logger::Module::Fs, "Erase(%06x) %u bytes", address, length);
 
     // ensure everything is aligned to a sector boundary
     if(address & (this->info->sectorSizeBytes() - 1)) {
@@ -266,9 +303,7 @@ int Flash::erase(const uintptr_t address, const size_t length) {
  * @param address Sector base address; must be aligned to sector size
  */
 int Flash::eraseSector(const uintptr_t address) {
-    if(kLogErase) {
-        Logger::Notice("SectorErase(%06x)", address);
-    }
+    Logger::Trace(Logger::Module::Fs, "SectorErase(%06x)", address);
 
     // validate address
     if(address & (this->info->sectorSizeBytes() - 1)) {
@@ -277,7 +312,7 @@ int Flash::eraseSector(const uintptr_t address) {
 
     // do erase
     return this->eraseWithAddress(this->info->cmdEraseSector, address,
-            this->info->timeoutSectorErase);
+            this->info->typicalSectorErase, this->info->timeoutSectorErase);
 }
 
 /**
@@ -288,9 +323,7 @@ int Flash::eraseSector(const uintptr_t address) {
  * @param address Block base address; must be aligned to block size
  */
 int Flash::eraseBlock(const uintptr_t address) {
-    if(kLogErase) {
-        Logger::Notice("BlockErase(%06x)", address);
-    }
+    Logger::Trace(Logger::Module::Fs, "BlockErase(%06x)", address);
 
     // validate address
     if(address & (this->info->blockSizeBytes() - 1)) {
@@ -299,7 +332,7 @@ int Flash::eraseBlock(const uintptr_t address) {
 
     // do erase
     return this->eraseWithAddress(this->info->cmdEraseBlock, address,
-            this->info->timeoutBlockErase);
+            this->info->typicalBlockErase, this->info->timeoutBlockErase);
 }
 
 /**
@@ -311,9 +344,7 @@ int Flash::eraseBlock(const uintptr_t address) {
 int Flash::eraseChip() {
     int err;
 
-    if(kLogErase) {
-        Logger::Notice("ChipErase");
-    }
+    Logger::Trace(Logger::Module::Fs, "ChipErase");
 
     // enable writing
     err = this->writeEnable();
@@ -331,7 +362,7 @@ int Flash::eraseChip() {
     }
 
     // wait for the erase to complete
-    return this->waitForCompletion(this->info->timeoutChipErase);
+    return this->waitForCompletion(this->info->typicalChipErase, this->info->timeoutChipErase);
 }
 
 /**
@@ -358,7 +389,102 @@ int Flash::reset() {
     etl::array<uint8_t, 1> cmd{{
         this->info->cmdReset
     }};
-    return ExecCmd(cmd);
+    err = ExecCmd(cmd);
+    if(err) {
+        return err;
+    }
+
+    // the chip doesn't accept commands (so it reads as busy) until it's done resetting
+    err = this->waitForCompletion(kResetTime, kResetTimeout);
+    if(err) {
+        return err;
+    }
+
+    // it's back to 3-byte addresses now
+    if(this->info->addressBytes() == 4 && this->info->cmdEnter4ByteAddress) {
+        etl::array<uint8_t, 1> modeCmd{{
+            this->info->cmdEnter4ByteAddress
+        }};
+        return ExecCmd(modeCmd);
+    }
+
+    return Error::NoError;
+}
+
+/**
+ * @brief Acquire the flash bus lock
+ *
+ * The filesystem, the log archive and the filesystem maintenance task run in different tasks, so
+ * they take this lock around their flash accesses. Before the scheduler is started, there's only
+ * one caller and nothing is locked.
+ *
+ * In panic mode, the lock isn't taken (the caller may not be a task); this only checks that nobody
+ * else holds it, i.e. that the panic didn't interrupt a flash access.
+ *
+ * @param timeout Maximum time to wait for the lock
+ *
+ * @return Whether the lock was acquired
+ */
+bool Flash::Lock(const TickType_t timeout) {
+    const auto state = xTaskGetSchedulerState();
+
+    if(gPanicMode && state != taskSCHEDULER_NOT_STARTED) {
+        return !xSemaphoreGetMutexHolderFromISR(gLock);
+    } else if(state != taskSCHEDULER_RUNNING) {
+        return true;
+    }
+
+    return xSemaphoreTake(gLock, timeout) == pdTRUE;
+}
+
+/**
+ * @brief Release the flash bus lock
+ */
+void Flash::Unlock() {
+    if(gPanicMode || xTaskGetSchedulerState() != taskSCHEDULER_RUNNING) {
+        return;
+    }
+
+    xSemaphoreGive(gLock);
+}
+
+/**
+ * @brief Switch to polled operation for a panic
+ *
+ * The panic handler may run in interrupt context or a critical section (with interrupts disabled)
+ * so from now on, all transfers are synchronous and all waits spin rather than blocking on the
+ * RTOS. There's no way back.
+ */
+void Flash::EnterPanicMode() {
+    gPanicMode = true;
+}
+
+/**
+ * @brief Build a command with an address
+ *
+ * The address is encoded with as many bytes as the chip requires, most significant first; then
+ * the specified number of dummy bytes are appended.
+ *
+ * @param buffer Buffer to build the command in
+ * @param cmd Command opcode
+ * @param address Address to encode
+ * @param numDummy Number of dummy bytes to append
+ *
+ * @return The encoded command (part of the provided buffer)
+ */
+etl::span<const uint8_t> Flash::encodeCommand(CommandBuffer &buffer, const uint8_t cmd,
+        const uintptr_t address, const size_t numDummy) const {
+    const auto addressBytes = this->info->addressBytes();
+
+    buffer[0] = cmd;
+    for(size_t i = 0; i < addressBytes; i++) {
+        buffer[1 + i] = static_cast<uint8_t>(address >> (8 * (addressBytes - 1 - i)));
+    }
+    for(size_t i = 0; i < numDummy; i++) {
+        buffer[1 + addressBytes + i] = 0xFF;
+    }
+
+    return {buffer.data(), 1 + addressBytes + numDummy};
 }
 
 
@@ -430,3 +556,201 @@ done:;
     SetCsAsserted(false);
     return ret;
 }
+
+/**
+ * @brief Execute a command and read payload asynchronously
+ *
+ * The (short) command is sent synchronously; then the payload is received by DMA, while the
+ * calling task blocks.
+ */
+int Flash::ExecCmdReadAsync(etl::span<const uint8_t> cmd, etl::span<uint8_t> data) {
+    Ecode_t err;
+    int ret;
+
+    // assert /CS and output command
+    SetCsAsserted(true);
+
+    err = SPIDRV_MTransmitB(sl_spidrv_eusart_flash_handle, cmd.data(), cmd.size());
+    if(err != ECODE_EMDRV_SPIDRV_OK) {
+        ret = Error::IoCommand;
+        goto done;
+    }
+
+    // receive payload
+    PrepareTransfer();
+    err = SPIDRV_MReceive(sl_spidrv_eusart_flash_handle, data.data(), data.size(),
+            TransferCallback);
+    ret = CompleteTransfer(err, data.size());
+
+done:;
+    // de-assert CS
+    SetCsAsserted(false);
+    return ret;
+}
+
+/**
+ * @brief Execute a command and write payload asynchronously
+ *
+ * The (short) command is sent synchronously; then the payload is transmitted by DMA, while the
+ * calling task blocks.
+ */
+int Flash::ExecCmdWriteAsync(etl::span<const uint8_t> cmd, etl::span<const uint8_t> data) {
+    Ecode_t err;
+    int ret;
+
+    // assert /CS and output command
+    SetCsAsserted(true);
+
+    err = SPIDRV_MTransmitB(sl_spidrv_eusart_flash_handle, cmd.data(), cmd.size());
+    if(err != ECODE_EMDRV_SPIDRV_OK) {
+        ret = Error::IoCommand;
+        goto done;
+    }
+
+    // transmit payload
+    PrepareTransfer();
+    err = SPIDRV_MTransmit(sl_spidrv_eusart_flash_handle, data.data(), data.size(),
+            TransferCallback);
+    ret = CompleteTransfer(err, data.size());
+
+done:;
+    // de-assert CS
+    SetCsAsserted(false);
+    return ret;
+}
+
+/**
+ * @brief Prepare for an asynchronous transfer
+ *
+ * Record the calling task as the one to be notified on completion, and discard any stale
+ * completion notification (from an earlier, aborted transfer.)
+ */
+void Flash::PrepareTransfer() {
+    gWaitingTask = xTaskGetCurrentTaskHandle();
+    ulTaskNotifyValueClearIndexed(nullptr, Rtos::TaskNotifyIndex::DriverPrivate, kNotifyBit);
+}
+
+/**
+ * @brief Wait for an asynchronous transfer to complete
+ *
+ * Blocks the calling task until the transfer completion callback fires. If that doesn't happen
+ * within the transfer's expected duration (plus some slack) it's aborted.
+ *
+ * @param err Status returned when starting the transfer
+ * @param numBytes Number of bytes being transferred
+ *
+ * @return 0 on success, or an error code
+ */
+int Flash::CompleteTransfer(const Ecode_t err, const size_t numBytes) {
+    if(err != ECODE_EMDRV_SPIDRV_OK) {
+        return Error::IoPayload;
+    }
+
+    // wait for the completion bit; other driver bits may wake us in the meantime
+    const auto busMsec = (numBytes * 8 * 1000) / gBitrate;
+    TickType_t remaining = pdMS_TO_TICKS(busMsec + kTransferTimeoutSlack);
+
+    TimeOut_t timeout;
+    vTaskSetTimeOutState(&timeout);
+
+    while(true) {
+        uint32_t note{0};
+        xTaskNotifyWaitIndexed(Rtos::TaskNotifyIndex::DriverPrivate, 0, kNotifyBit, &note,
+                remaining);
+        if(note & kNotifyBit) {
+            break;
+        }
+
+        if(xTaskCheckForTimeOut(&timeout, &remaining) == pdTRUE) {
+            SPIDRV_AbortTransfer(sl_spidrv_eusart_flash_handle);
+            Logger::Warning(Logger::Module::Fs, "flash transfer timed out (%u bytes)", numBytes);
+            return Error::IoPayload;
+        }
+    }
+
+    return (gTransferStatus == ECODE_EMDRV_SPIDRV_OK) ? Error::NoError : Error::IoPayload;
+}
+
+/**
+ * @brief Asynchronous transfer completion callback
+ *
+ * Invoked from interrupt context; wakes the task waiting for the transfer.
+ */
+void Flash::TransferCallback(SPIDRV_Handle_t, Ecode_t status, int) {
+    gTransferStatus = status;
+
+    BaseType_t woken{pdFALSE};
+    xTaskNotifyIndexedFromISR(gWaitingTask, Rtos::TaskNotifyIndex::DriverPrivate, kNotifyBit,
+            eSetBits, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+
+
+/**
+ * @brief Wait for the given time
+ *
+ * Once the scheduler is running, the calling task blocks until the poll timer fires; before then
+ * (or in panic mode) this spins on the timer's counter instead.
+ *
+ * @param usec Time to wait (µsec); it's rounded up to the timer's resolution
+ */
+void Flash::Delay(const uint32_t usec) {
+    const auto frequency = sl_sleeptimer_get_timer_frequency();
+    const auto ticks = static_cast<uint32_t>(
+            ((static_cast<uint64_t>(usec) * frequency) + 999'999) / 1'000'000);
+    if(!ticks) {
+        return;
+    }
+
+    if(!CanBlock()) {
+        const auto start = sl_sleeptimer_get_tick_count();
+        while((sl_sleeptimer_get_tick_count() - start) < ticks) {}
+        return;
+    }
+
+    // discard a stale notification (from a timer that fired after we stopped waiting for it)
+    ulTaskNotifyValueClearIndexed(nullptr, Rtos::TaskNotifyIndex::DriverPrivate, kPollNotifyBit);
+
+    const auto err = sl_sleeptimer_start_timer(&gPollTimer, ticks, PollTimerCallback,
+            xTaskGetCurrentTaskHandle(), 0, 0);
+    if(err != SL_STATUS_OK) {
+        Logger::Warning(Logger::Module::Fs, "failed to start poll timer: %d", err);
+        vTaskDelay(pdMS_TO_TICKS(usec / 1000) + 1);
+        return;
+    }
+
+    // wait for the timer; other driver bits may wake us in the meantime
+    TickType_t remaining = pdMS_TO_TICKS(usec / 1000) + kPollTimerSlack;
+
+    TimeOut_t timeout;
+    vTaskSetTimeOutState(&timeout);
+
+    while(true) {
+        uint32_t note{0};
+        xTaskNotifyWaitIndexed(Rtos::TaskNotifyIndex::DriverPrivate, 0, kPollNotifyBit, &note,
+                remaining);
+        if(note & kPollNotifyBit) {
+            return;
+        }
+
+        if(xTaskCheckForTimeOut(&timeout, &remaining) == pdTRUE) {
+            sl_sleeptimer_stop_timer(&gPollTimer);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Poll timer callback
+ *
+ * Invoked from interrupt context; wakes the task waiting for the timer.
+ *
+ * @param data Handle of the task to wake
+ */
+void Flash::PollTimerCallback(sl_sleeptimer_timer_handle_t *, void *data) {
+    BaseType_t woken{pdFALSE};
+    xTaskNotifyIndexedFromISR(static_cast<TaskHandle_t>(data),
+            Rtos::TaskNotifyIndex::DriverPrivate, kPollNotifyBit, eSetBits, &woken);
+    portYIELD_FROM_ISR(woken);
+}
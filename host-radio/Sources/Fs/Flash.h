@@ -5,7 +5,11 @@
 
 #include <etl/array.h>
 #include <etl/span.h>
+#include <em_gpio.h>
+#include <sl_sleeptimer.h>
 
+#include "Drivers/sl_spidrv_instances.h"
+#include "Rtos/Rtos.h"
 #include "sl_spidrv_eusart_flash_config.h"
 
 namespace Fs {
@@ -16,14 +20,25 @@ struct FlashInfo;
  *
  * Provides a simple command based interface to an SPI NOR flash, based on its information
  * structure which defines all of the commands.
+ *
+ * Reads use the fast read command (with its dummy byte) when the chip supports it, as the regular
+ * read command is often limited to a lower clock; the bus is then run at the highest clock that
+ * the chip supports for all commands used, up to kMaxBitrate. Chips larger than 16 MiB are
+ * switched to 4-byte addresses when reset.
+ *
+ * Once the scheduler is running, payloads of at least kMinAsyncBytes are transferred by DMA: the
+ * calling task blocks until the transfer completes, rather than spinning on the SPI peripheral.
+ *
+ * Program and erase operations are polled for completion on the sleeptimer, rather than the
+ * (much coarser) RTOS tick: the first poll is after the operation's typical duration, then at
+ * exponentially increasing intervals. The timeouts are tracked on the sleeptimer as well, so they
+ * work before the scheduler is started.
+ *
+ * @remark The driver doesn't lock on its own: callers must serialize all accesses to the flash
+ *         (across all instances) by holding the bus lock (Lock()) around each sequence of
+ *         operations that must not be interleaved with others.
  */
 class Flash {
-    private:
-        /// Should flash writes be logged?
-        constexpr static const bool kLogWrites{false};
-        /// Should flash erases be logged?
-        constexpr static const bool kLogErase{false};
-
     public:
         enum Error: int {
             NoError                             = 0,
@@ -45,15 +60,54 @@ class Flash {
             InvalidArguments                    = -1006,
         };
 
+    private:
+        /**
+         * @brief Minimum payload size for asynchronous transfers (bytes)
+         *
+         * Below this, the DMA setup, interrupt and two context switches cost more than the
+         * transfer itself.
+         */
+        constexpr static const size_t kMinAsyncBytes{32};
+        /// Notification bit (at the DriverPrivate index) signalled on transfer completion
+        constexpr static const uint32_t kNotifyBit{(1U << 2)};
+        /// Fixed allowance for an asynchronous transfer to complete, on top of its bus time (msec)
+        constexpr static const uint32_t kTransferTimeoutSlack{20};
+
+        /// Notification bit (at the DriverPrivate index) signalled when a completion poll is due
+        constexpr static const uint32_t kPollNotifyBit{(1U << 3)};
+        /// Shortest interval between completion polls (µsec)
+        constexpr static const uint32_t kMinPollInterval{50};
+        /// Longest interval between completion polls (µsec)
+        constexpr static const uint32_t kMaxPollInterval{16'000};
+        /// Allowance for the poll timer to fire late, before waiting for it is abandoned (ticks)
+        constexpr static const TickType_t kPollTimerSlack{2};
+
+        /**
+         * @brief Highest clock for the flash bus (Hz)
+         *
+         * The EUSART divides its clock (from the 78 MHz DPLL) by at least two.
+         */
+        constexpr static const uint32_t kMaxBitrate{39'000'000};
+        /// Typical time for the chip to complete a software reset (µsec)
+        constexpr static const uint32_t kResetTime{30};
+        /// Time for the chip to complete a software reset (msec)
+        constexpr static const uint32_t kResetTimeout{1};
+
+        /// Buffer for a command: opcode, up to four address bytes and a dummy byte
+        using CommandBuffer = etl::array<uint8_t, 6>;
+
+    public:
         Flash(const FlashInfo *info);
 
-        int read(const uintptr_t address, etl::span<uint8_t> buffer);
+        int read(const uintptr_t address, etl::span<uint8_t> buffer, const bool async = true);
 
         int writeEnable();
-        int waitForCompletion(const uint32_t timeoutMsec);
+        int waitForCompletion(const uint32_t typicalUsec, const uint32_t timeoutMsec);
 
-        int write(const uintptr_t address, etl::span<const uint8_t> data);
-        int writePage(const uintptr_t address, etl::span<const uint8_t> data);
+        int write(const uintptr_t address, etl::span<const uint8_t> data,
+                const bool async = true);
+        int writePage(const uintptr_t address, etl::span<const uint8_t> data,
+                const bool async = true);
 
         int erase(const uintptr_t address, const size_t length);
         int eraseSector(const uintptr_t address);
@@ -62,6 +116,11 @@ class Flash {
 
         int reset();
 
+        static bool Lock(const TickType_t timeout = portMAX_DELAY);
+        static void Unlock();
+
+        static void EnterPanicMode();
+
         /**
          * @brief Get the flash information structure
          */
@@ -69,6 +128,13 @@ class Flash {
             return this->info;
         }
 
+        /**
+         * @brief Get the bus clock used for the flash (Hz)
+         */
+        inline auto getBitrate() const {
+            return gBitrate;
+        }
+
         /**
          * @brief Execute the "JEDEC Identify" command
          *
@@ -86,7 +152,7 @@ class Flash {
          * Execute the given erase command, and wait for the command to complete.
          */
         inline int eraseWithAddress(const uint8_t cmd, const uintptr_t address,
-                const uint32_t timeoutMsec) {
+                const uint32_t typicalUsec, const uint32_t timeoutMsec) {
             int err;
 
             // enable the chip for writing
@@ -96,20 +162,19 @@ class Flash {
             }
 
             // send the command
-            etl::array<uint8_t, 4> cmdBuf{{
-                cmd, static_cast<uint8_t>((address & 0xFF0000) >> 16),
-                static_cast<uint8_t>((address & 0x00FF00) >> 8),
-                static_cast<uint8_t>((address & 0x0000FF)),
-            }};
-            err = ExecCmd(cmdBuf);
+            CommandBuffer cmdBuf;
+            err = ExecCmd(this->encodeCommand(cmdBuf, cmd, address));
             if(err) {
                 return err;
             }
 
             // wait for completion
-            return this->waitForCompletion(timeoutMsec);
+            return this->waitForCompletion(typicalUsec, timeoutMsec);
         }
 
+        etl::span<const uint8_t> encodeCommand(CommandBuffer &buffer, const uint8_t cmd,
+                const uintptr_t address, const size_t numDummy = 0) const;
+
     private:
         /**
          * @brief Set whether flash chip select is asserted
@@ -130,6 +195,24 @@ class Flash {
             return ExecCmdRead(cmd, none);
         }
 
+        /**
+         * @brief Determine whether the caller may block on the RTOS while waiting
+         *
+         * That's not the case before the scheduler starts, or once a panic is in progress.
+         */
+        static inline bool CanBlock() {
+            return !gPanicMode && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING;
+        }
+
+        /**
+         * @brief Determine whether a payload should be transferred asynchronously
+         *
+         * That's the case for large enough payloads, as long as the calling task can block.
+         */
+        static inline bool UseAsync(const bool async, const size_t numBytes) {
+            return async && numBytes >= kMinAsyncBytes && CanBlock();
+        }
+
         /**
          * @brief Execute a command, then read payload
          *
@@ -138,9 +221,13 @@ class Flash {
          */
         static inline int ExecCmdRead(etl::span<const uint8_t> cmd, etl::span<uint8_t> data,
                 const bool async = true) {
+            if(UseAsync(async, data.size())) {
+                return ExecCmdReadAsync(cmd, data);
+            }
             return ExecCmdReadBlocking(cmd, data);
         }
         static int ExecCmdReadBlocking(etl::span<const uint8_t>, etl::span<uint8_t>);
+        static int ExecCmdReadAsync(etl::span<const uint8_t>, etl::span<uint8_t>);
 
         /**
          * @brief Execute a command, then write payload
@@ -150,13 +237,42 @@ class Flash {
          */
         static inline int ExecCmdWrite(etl::span<const uint8_t> cmd, etl::span<const uint8_t> data,
                 const bool async = true) {
+            if(UseAsync(async, data.size())) {
+                return ExecCmdWriteAsync(cmd, data);
+            }
             return ExecCmdWriteBlocking(cmd, data);
         }
         static int ExecCmdWriteBlocking(etl::span<const uint8_t>, etl::span<const uint8_t>);
+        static int ExecCmdWriteAsync(etl::span<const uint8_t>, etl::span<const uint8_t>);
+
+        static void PrepareTransfer();
+        static int CompleteTransfer(const Ecode_t err, const size_t numBytes);
+        static void TransferCallback(SPIDRV_Handle_t, Ecode_t, int);
+
+        static void Delay(const uint32_t usec);
+        static void PollTimerCallback(sl_sleeptimer_timer_handle_t *, void *);
 
     private:
         /// Flash information structure
         const FlashInfo *info;
+
+        /// Command used for reads
+        uint8_t readCmd;
+        /// Number of dummy bytes following the read command's address
+        uint8_t readDummyBytes;
+
+        /// Task waiting for the current asynchronous transfer
+        static TaskHandle_t gWaitingTask;
+        /// Status of the most recently completed asynchronous transfer
+        static volatile Ecode_t gTransferStatus;
+        /// Timer that wakes a task waiting for a program or erase operation to complete
+        static sl_sleeptimer_timer_handle_t gPollTimer;
+        /// Bus lock, shared by all users of the flash
+        static SemaphoreHandle_t gLock;
+        /// Bus clock the SPI driver is configured for (Hz)
+        static uint32_t gBitrate;
+        /// Set once a panic is in progress: all transfers and waits are polled
+        static bool gPanicMode;
 };
 }
 
@@ -48,11 +48,20 @@ bool Fs::IdentifyFlash(etl::span<const uint8_t, 3> jdecId, const FlashInfo* &out
                 .cmdWakeUp              = 0xAB,
                 .cmdResetEnable         = 0x66,
                 .cmdReset               = 0x99,
+                .cmdEnter4ByteAddress   = 0x00,
 
                 .timeoutPageProgram     = 3,
                 .timeoutSectorErase     = 400,
                 .timeoutBlockErase      = 2000,
                 .timeoutChipErase       = (100 * 1000),
+
+                .typicalPageProgram     = 400,
+                .typicalSectorErase     = (45 * 1000),
+                .typicalBlockErase      = (150 * 1000),
+                .typicalChipErase       = (20 * 1000 * 1000),
+
+                .maxClock               = 133'000'000,
+                .maxReadClock           = 50'000'000,
             };
             outInfo = &info;
 
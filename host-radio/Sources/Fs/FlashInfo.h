@@ -55,7 +55,7 @@ struct FlashInfo {
 
     /// Command to perform a regular (low speed) read
     uint8_t cmdRead;
-    /// Command to perform a fast (high-speed, with dummy cycle) read
+    /// Command to perform a fast (high-speed, with dummy cycle) read; 0 if not supported
     uint8_t cmdFastRead;
     /// Command to program a page
     uint8_t cmdProgramPage;
@@ -76,6 +76,9 @@ struct FlashInfo {
     /// Command to reset the device
     uint8_t cmdReset;
 
+    /// Command to switch to 4-byte addresses (for chips larger than 16 MiB)
+    uint8_t cmdEnter4ByteAddress;
+
     /// Page program timeout (msec)
     uint32_t timeoutPageProgram;
     /// Sector erase timeout (msec)
@@ -85,6 +88,20 @@ struct FlashInfo {
     /// Chip erase timeout (msec)
     uint32_t timeoutChipErase;
 
+    /// Typical page program time (µsec)
+    uint32_t typicalPageProgram;
+    /// Typical sector erase time (µsec)
+    uint32_t typicalSectorErase;
+    /// Typical block erase time (µsec)
+    uint32_t typicalBlockErase;
+    /// Typical chip erase time (µsec)
+    uint32_t typicalChipErase;
+
+    /// Maximum SPI clock for all commands, except the regular read (Hz)
+    uint32_t maxClock;
+    /// Maximum SPI clock for the regular read command (Hz)
+    uint32_t maxReadClock;
+
 
     /**
      * @brief Get the capacity, in bytes
@@ -113,6 +130,15 @@ struct FlashInfo {
     constexpr inline size_t blockSizeBytes() const {
         return (1ULL << this->blockSize);
     }
+
+    /**
+     * @brief Get the number of address bytes sent with commands
+     *
+     * Chips larger than 16 MiB need 4-byte addresses.
+     */
+    constexpr inline size_t addressBytes() const {
+        return (this->capacity > 24) ? 4 : 3;
+    }
 };
 
 bool IdentifyFlash(etl::span<const uint8_t, 3> jdecId, const FlashInfo* &outInfo);
@@ -1,6 +1,8 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <etl/algorithm.h>
 #include <etl/array.h>
 #include <Util/Crc32.h>
 #include <em_device.h>
@@ -9,10 +11,14 @@
 #include "Drivers/sl_spidrv_instances.h"
 #include "sl_spidrv_eusart_flash_config.h"
 
+#include "Log/Archive.h"
 #include "Log/Logger.h"
+#include "Rtos/Heap.h"
 
 #include "Flash.h"
 #include "FlashInfo.h"
+#include "KvStore.h"
+#include "Maintenance.h"
 #include "NorFs.h"
 #include "Init.h"
 
@@ -25,11 +31,37 @@ using namespace Fs;
  */
 constexpr static const uintptr_t kSuperblockAddress{0x000000};
 
+/**
+ * @brief Size of the log archive partition (bytes)
+ *
+ * It's placed at the very end of the flash.
+ */
+constexpr static const uint32_t kLogPartitionSize{0x10000};
+
+/**
+ * @brief Size of the key/value store partition (bytes)
+ *
+ * It's placed right before the log archive.
+ */
+constexpr static const uint32_t kKvPartitionSize{0x10000};
+
+/**
+ * @brief Lengths of superblocks of earlier versions
+ *
+ * These end (with the CRC) right before the fields added by later versions: version 0x00000100
+ * after the filesystem extents, and version 0x00000200 after the log archive extents.
+ */
+constexpr static const etl::array<uint32_t, 2> kLegacySuperblockLengths{
+    offsetof(Superblock, logStart) + sizeof(Superblock::crc),
+    offsetof(Superblock, kvStart) + sizeof(Superblock::crc),
+};
+
 /**
  * @brief Initialize the contents of a superblock
  *
- * This is used during formatting to set up the filesystem. The superblock is initialized and all
- * remaining space in the filesystem is reserved for the filesystem use.
+ * This is used during formatting to set up the filesystem. The superblock is initialized, the end
+ * of the flash is reserved for the log archive, preceded by the key/value store, and all remaining
+ * space is reserved for the filesystem use.
  */
 static void InitSuperblock(Flash *flash, Superblock *superblock) {
     // start with the constants
@@ -40,8 +72,16 @@ static void InitSuperblock(Flash *flash, Superblock *superblock) {
     // partitioning for SPIFFS
     superblock->fsType = Superblock::FsType::SPIFFS;
 
+    const auto capacity = flash->getInfo()->capacityBytes();
+
+    superblock->logStart = capacity - kLogPartitionSize;
+    superblock->logEnd = capacity - 1;
+
+    superblock->kvStart = superblock->logStart - kKvPartitionSize;
+    superblock->kvEnd = superblock->logStart - 1;
+
     superblock->fsStart = flash->getInfo()->sectorSizeBytes();
-    superblock->fsEnd = flash->getInfo()->capacityBytes() - 1 - superblock->fsStart;
+    superblock->fsEnd = superblock->kvStart - 1;
 
     // calculate CRC
     etl::span<const uint8_t, sizeof(Superblock)> superblockBytes{
@@ -61,7 +101,7 @@ static void FormatNor(Flash *flash, Superblock *superblock) {
     int err{0};
 
     // erase the entire chip
-    Logger::Notice("Erasing NOR!");
+    Logger::Notice(Logger::Module::Fs, "Erasing NOR!");
     err = flash->eraseChip();
     REQUIRE(!err, "%s failed: %d", "erase NOR", err);
 
@@ -69,7 +109,7 @@ static void FormatNor(Flash *flash, Superblock *superblock) {
     InitSuperblock(flash, superblock);
 
     // then write the superblock
-    Logger::Notice("Writing superblock!");
+    Logger::Notice(Logger::Module::Fs, "Writing superblock!");
     etl::span<const uint8_t, sizeof(Superblock)> superblockBytes{
         reinterpret_cast<const uint8_t *>(superblock), sizeof(Superblock)};
 
@@ -77,7 +117,7 @@ static void FormatNor(Flash *flash, Superblock *superblock) {
     REQUIRE(!err, "%s failed: %d", "write superblock", err);
 
     // initialize filesystem
-    Logger::Notice("Formatting fs");
+    Logger::Notice(Logger::Module::Fs, "Formatting fs");
     err = NorFs::Format(flash, superblock);
 
     REQUIRE(!err, "%s failed: %d", "format fs", err);
@@ -87,10 +127,10 @@ static void FormatNor(Flash *flash, Superblock *superblock) {
  * @brief Wrapper around formatting to reset the system after
  */
 [[noreturn]] static inline void Format(Flash *flash, Superblock *superblock) {
-    Logger::Warning("NOR is empty, formatting");
+    Logger::Warning(Logger::Module::Fs, "NOR is empty, formatting");
     FormatNor(flash, superblock);
 
-    Logger::Notice("Format complete, resetting");
+    Logger::Notice(Logger::Module::Fs, "Format complete, resetting");
     NVIC_SystemReset();
 }
 
@@ -123,7 +163,8 @@ void Fs::Init() {
     }
     REQUIRE(!!info, "failed to identify flash");
 
-    Logger::Debug("NOR flash: %s %s %u bytes (%u byte pages, %u byte sectors, %u byte blocks)",
+    Logger::Debug(Logger::Module::Fs,
+            "NOR flash: %s %s %u bytes (%u byte pages, %u byte sectors, %u byte blocks)",
             info->manufacturerName.data(), info->partNumber.data(), info->capacityBytes(),
             info->pageSizeBytes(), info->sectorSizeBytes(), info->blockSizeBytes());
 
@@ -145,7 +186,8 @@ void Fs::Init() {
      * against 0xFF. If that's the case, we go immediately to format (and then reset) to handle the
      * first boot case.
      */
-    auto superblock = reinterpret_cast<Superblock *>(malloc(sizeof(Superblock)));
+    auto superblock = reinterpret_cast<Superblock *>(Rtos::Heap::Alloc(Rtos::Heap::Class::Other,
+                sizeof(Superblock)));
     REQUIRE(!!superblock, "failed to alloc %s", "flash superblock");
 
     err = flash->read(kSuperblockAddress,
@@ -176,24 +218,37 @@ void Fs::Init() {
      * become corrupted.
      */
     bool superblockValid{false};
-    // calculate the CRC over the read bytes (assuming the struct version matches what we've got)
-    etl::span<const uint8_t, sizeof(Superblock)> superblockBytes{
-        reinterpret_cast<const uint8_t *>(superblock), sizeof(Superblock)};
-    const auto superblockCrcBytes = superblockBytes.subspan<0, offsetof(Superblock, crc)>();
+    const bool isLegacy = etl::find(kLegacySuperblockLengths.begin(),
+            kLegacySuperblockLengths.end(), superblock->totalLength) !=
+        kLegacySuperblockLengths.end();
+
+    /*
+     * Calculate the CRC over the read bytes. Legacy superblocks are shorter, so their CRC is
+     * stored where the newer fields are now: move it into place, and clear the fields they lack
+     * (so there's no log archive and/or key/value store.)
+     */
+    const size_t length = isLegacy ? superblock->totalLength : sizeof(Superblock);
+    const size_t crcOffset = length - sizeof(Superblock::crc);
 
-    const auto computedCrc = Util::Crc32(superblockCrcBytes);
+    etl::span<uint8_t> superblockBytes{reinterpret_cast<uint8_t *>(superblock), length};
+    const auto computedCrc = Util::Crc32(superblockBytes.first(crcOffset));
+
+    if(isLegacy) {
+        memcpy(&superblock->crc, superblockBytes.data() + crcOffset, sizeof(Superblock::crc));
+        memset(superblockBytes.data() + crcOffset, 0, offsetof(Superblock, crc) - crcOffset);
+    }
 
     // before accessing it, ensure the size is sensible
-    if(superblock->totalLength < sizeof(Superblock)) {
-        Logger::Warning("invalid superblock %s: %08x (expected %08x)", "size",
+    if(superblock->totalLength != sizeof(Superblock) && !isLegacy) {
+        Logger::Warning(Logger::Module::Fs, "invalid superblock %s: %08x (expected %08x)", "size",
                 superblock->totalLength, sizeof(Superblock));
     }
     else if(superblock->magic != Superblock::kMagic) {
-        Logger::Warning("invalid superblock %s: %08x (expected %08x)", "magic", superblock->magic,
-                Superblock::kMagic);
+        Logger::Warning(Logger::Module::Fs, "invalid superblock %s: %08x (expected %08x)", "magic",
+                superblock->magic, Superblock::kMagic);
     } else if(superblock->crc != computedCrc) {
-        Logger::Warning("invalid superblock %s: %08x (expected %08x)", "CRC", superblock->crc,
-                computedCrc);
+        Logger::Warning(Logger::Module::Fs, "invalid superblock %s: %08x (expected %08x)", "CRC",
+                superblock->crc, computedCrc);
     } else {
         // otherwise, it passed all the tests
         superblockValid = true;
@@ -201,7 +256,7 @@ void Fs::Init() {
 
     REQUIRE(superblockValid, "flash superblock is invalid!");
 
-    Logger::Notice("FS: Superblock (version %08x)", superblock->version);
+    Logger::Notice(Logger::Module::Fs, "FS: Superblock (version %08x)", superblock->version);
 
     /*
      * The superblock is valid, so initialize the filesystem. This ensures the filesystem type is
@@ -209,10 +264,23 @@ void Fs::Init() {
      */
     REQUIRE(superblock->fsType == Superblock::FsType::SPIFFS, "unsupported filesystem: %08x",
             superblock->fsType);
-    Logger::Notice("FS: Mounting filesystem (type %08x)", superblock->fsType);
+    Logger::Notice(Logger::Module::Fs, "FS: Mounting filesystem (type %08x)", superblock->fsType);
 
     err = NorFs::Mount(flash, superblock);
     REQUIRE(!err, "%s failed: %d", "mount fs", err);
 
-    free(superblock);
+    // reclaim space in the background, rather than in writes
+    Maintenance::Init();
+
+    // start the log archive, if the flash was formatted with one
+    if(superblock->logStart) {
+        Log::Archive::Init(flash, superblock->logStart, superblock->logEnd + 1);
+    }
+
+    // and likewise, the key/value store
+    if(superblock->kvStart) {
+        KvStore::Init(flash, superblock->kvStart, superblock->kvEnd + 1);
+    }
+
+    Rtos::Heap::Free(Rtos::Heap::Class::Other, superblock);
 }
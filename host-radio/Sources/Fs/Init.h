@@ -21,7 +21,7 @@ struct Superblock {
     /// Header magic value
     constexpr static const uint32_t kMagic{0x424C415A};
     /// Current superblock version
-    constexpr static const uint32_t kVersion{0x00000100};
+    constexpr static const uint32_t kVersion{0x00000300};
 
     /**
      * @brief Superblock magic value
@@ -66,6 +66,38 @@ struct Superblock {
      */
     uint32_t fsEnd;
 
+    /**
+     * @brief Starting byte address of the log archive partition
+     *
+     * The log archive (see Log::Archive) is written directly to this area, bypassing the
+     * filesystem. If zero, there's no log archive.
+     *
+     * @remark Added in version 0x00000200; superblocks of earlier versions end before this field,
+     *         and have no log archive.
+     */
+    uint32_t logStart;
+
+    /**
+     * @brief Ending byte address of the log archive partition
+     */
+    uint32_t logEnd;
+
+    /**
+     * @brief Starting byte address of the key/value store partition
+     *
+     * Small records (such as configuration and key material) are stored here by Fs::KvStore,
+     * bypassing the filesystem. If zero, there's no key/value store.
+     *
+     * @remark Added in version 0x00000300; superblocks of earlier versions end before this field,
+     *         and have no key/value store.
+     */
+    uint32_t kvStart;
+
+    /**
+     * @brief Ending byte address of the key/value store partition
+     */
+    uint32_t kvEnd;
+
     /**
      * @brief CRC32 over superblock contents
      *
@@ -0,0 +1,809 @@
+#include <string.h>
+
+#include <etl/algorithm.h>
+#include <Util/Crc32.h>
+
+#include "Log/Logger.h"
+
+#include "Flash.h"
+#include "FlashInfo.h"
+#include "KvStore.h"
+
+using namespace Fs;
+
+Flash *KvStore::gFlash{nullptr};
+uint32_t KvStore::gStart{0};
+uint32_t KvStore::gSectorSize{0};
+size_t KvStore::gNumSectors{0};
+
+etl::array<KvStore::Sector, KvStore::kMaxSectors> KvStore::gSectors;
+size_t KvStore::gCurrent{0};
+uint32_t KvStore::gSequence{0};
+
+etl::array<KvStore::IndexEntry, KvStore::kIndexSlots> KvStore::gIndex;
+size_t KvStore::gNumKeys{0};
+
+etl::array<uint8_t, sizeof(KvStore::RecordHeader) + KvStore::kMaxValueSize> KvStore::gBuffer;
+
+KvStore::Stats KvStore::gStats{};
+
+/**
+ * @brief Mount the key/value store
+ *
+ * Read all sector headers, then replay the sectors (oldest first) to build the index. Appending
+ * continues in the most recent sector; if it's full or damaged, or there are no sectors yet, a
+ * new one is started. A sector started by an interrupted compaction is discarded first.
+ *
+ * @param flash Flash the partition lives on
+ * @param start Start address of the partition (sector aligned)
+ * @param end End address of the partition (exclusive)
+ */
+void KvStore::Init(Flash *flash, const uint32_t start, const uint32_t end) {
+    int err{0};
+
+    gSectorSize = flash->getInfo()->sectorSizeBytes();
+    gStart = start;
+    gNumSectors = etl::min(static_cast<size_t>((end - start) / gSectorSize), kMaxSectors);
+
+    REQUIRE(!(start & (gSectorSize - 1)), "kv store unaligned: %08x", start);
+    if(gNumSectors < kReserveSectors + 2 || (gNumSectors * gSectorSize) > 0x10000) {
+        Logger::Warning(Logger::Module::Fs, "kv store: unsupported size (%u x %u bytes)",
+                gNumSectors, gSectorSize);
+        return;
+    }
+
+    gFlash = flash;
+
+    for(auto &entry : gIndex) {
+        entry.key = kNoKey;
+    }
+    gNumKeys = 0;
+
+    // read sector headers
+    for(size_t i = 0; i < gNumSectors; i++) {
+        SectorHeader hdr;
+        err = flash->read(SectorAddress(i), {reinterpret_cast<uint8_t *>(&hdr), sizeof(hdr)});
+        if(err) {
+            goto fail;
+        }
+
+        if(hdr.magic == kSectorMagic && hdr.check == ~hdr.sequence && hdr.sequence != kInvalid) {
+            gSectors[i] = {hdr.sequence, sizeof(SectorHeader), 0, false};
+        } else {
+            gSectors[i] = {kInvalid, 0, 0, false};
+        }
+    }
+
+    // find the most recent sector; it becomes the current sector
+    while(true) {
+        gCurrent = gNumSectors;
+        for(size_t i = 0; i < gNumSectors; i++) {
+            const auto sequence = gSectors[i].sequence;
+            if(sequence != kInvalid && (gCurrent == gNumSectors ||
+                        IsNewer(sequence, gSectors[gCurrent].sequence))) {
+                gCurrent = i;
+            }
+        }
+
+        /*
+         * A compaction that was interrupted after taking a sector from the reserve leaves fewer
+         * free sectors than that. That sector only holds copies of records still in the sector
+         * being compacted, so discard it; the compaction is then redone when space is needed.
+         * Otherwise, with the reserve gone, there may be nowhere left to compact into.
+         */
+        if(gCurrent == gNumSectors || GetFreeSectors() >= kReserveSectors) {
+            break;
+        }
+
+        err = Retire(gCurrent);
+        if(err) {
+            goto fail;
+        }
+    }
+
+    if(gCurrent == gNumSectors) {
+        gCurrent = 0;
+        gSequence = 0;
+        err = NextSector(false);
+    }
+    // replay the sectors oldest first; their age is relative to it, as sequence numbers wrap
+    else {
+        gSequence = gSectors[gCurrent].sequence;
+
+        bool found{false};
+        uint32_t lastAge{0};
+
+        while(true) {
+            size_t next{gNumSectors};
+            uint32_t nextAge{0};
+
+            for(size_t i = 0; i < gNumSectors; i++) {
+                const auto sequence = gSectors[i].sequence;
+                const uint32_t age = gSequence - sequence;
+
+                if(sequence == kInvalid || (found && age >= lastAge)) {
+                    continue;
+                } else if(next == gNumSectors || age > nextAge) {
+                    next = i;
+                    nextAge = age;
+                }
+            }
+
+            if(next == gNumSectors) {
+                break;
+            }
+
+            Replay(next);
+
+            found = true;
+            lastAge = nextAge;
+        }
+
+        if(gSectors[gCurrent].used + RecordSize(0) > gSectorSize) {
+            err = NextSector(false);
+        }
+    }
+
+    if(err) {
+        goto fail;
+    }
+
+    Logger::Notice(Logger::Module::Fs, "kv store: %u sectors at $%06x, %u keys, current %u "
+            "(seq %u)", gNumSectors, start, gNumKeys, gCurrent, gSequence);
+    return;
+
+fail:;
+    gFlash = nullptr;
+    Logger::Warning(Logger::Module::Fs, "kv store disabled: flash error %d", err);
+}
+
+/**
+ * @brief Read the value of a key
+ *
+ * @param key Key to look up
+ * @param buffer Buffer to receive the value
+ *
+ * @return Length of the value, or a negative error code
+ */
+int KvStore::Get(const uint32_t key, etl::span<uint8_t> buffer) {
+    int err;
+
+    if(!gFlash) {
+        return Error::NotMounted;
+    }
+
+    Flash::Lock();
+
+    const auto entry = Lookup(key);
+    if(!entry) {
+        err = Error::NotFound;
+    } else if(buffer.size() < entry->length) {
+        err = Error::InvalidSize;
+    } else {
+        err = ReadRecord(entry->offset, entry->length);
+        if(!err) {
+            memcpy(buffer.data(), gBuffer.data() + sizeof(RecordHeader), entry->length);
+            err = entry->length;
+        } else if(err == Error::Corrupt) {
+            gStats.corruptRecords++;
+            Logger::Warning(Logger::Module::Fs, "kv store: damaged record %08x", key);
+        }
+    }
+
+    Flash::Unlock();
+    return err;
+}
+
+/**
+ * @brief Store a value for a key
+ *
+ * A record with the new value is appended; the previous one (if any) becomes garbage, to be
+ * reclaimed by compaction.
+ *
+ * @param key Key to store the value under
+ * @param value Value to store, up to kMaxValueSize bytes
+ */
+int KvStore::Put(const uint32_t key, etl::span<const uint8_t> value) {
+    int err;
+
+    if(!gFlash) {
+        return Error::NotMounted;
+    } else if(key == kNoKey) {
+        return Error::InvalidKey;
+    } else if(value.size() > kMaxValueSize) {
+        return Error::InvalidSize;
+    }
+
+    Flash::Lock();
+
+    if(!Lookup(key) && gNumKeys >= kMaxKeys) {
+        err = Error::Full;
+    } else {
+        uint16_t offset;
+        err = Append(key, 0, value, offset);
+
+        // compaction may have moved the previous record, but not the index entry
+        if(!err) {
+            auto entry = Lookup(key);
+            if(entry) {
+                Release(*entry);
+            } else {
+                entry = Insert(key);
+            }
+
+            entry->offset = offset;
+            entry->length = value.size();
+            gSectors[offset / gSectorSize].live += RecordSize(value.size());
+        }
+    }
+
+    Flash::Unlock();
+    return err;
+}
+
+/**
+ * @brief Remove a key
+ *
+ * A tombstone record is appended, so the key stays removed after its previous records are
+ * replayed at the next mount.
+ */
+int KvStore::Remove(const uint32_t key) {
+    int err;
+
+    if(!gFlash) {
+        return Error::NotMounted;
+    }
+
+    Flash::Lock();
+
+    if(!Lookup(key)) {
+        err = Error::NotFound;
+    } else {
+        uint16_t offset;
+        err = Append(key, RecordHeader::Flags::Tombstone, {}, offset);
+
+        if(!err) {
+            auto entry = Lookup(key);
+            Release(*entry);
+            Erase(entry);
+        }
+    }
+
+    Flash::Unlock();
+    return err;
+}
+
+/**
+ * @brief Perform idle time maintenance
+ *
+ * Once free sectors are running low, compact the oldest sector; otherwise, make sure free sectors
+ * are erased. At most one sector is compacted or erased per call.
+ *
+ * @return Whether any work was done (so there may be more to do)
+ */
+bool KvStore::Maintain() {
+    int err{0};
+    bool worked{false};
+
+    if(!gFlash) {
+        return false;
+    }
+
+    Flash::Lock();
+
+    if(GetFreeSectors() <= kIdleFreeSectors && CanCompact()) {
+        err = Compact();
+        if(!err) {
+            gStats.idleCompactions++;
+            worked = true;
+        }
+    } else {
+        for(size_t i = 0; i < gNumSectors; i++) {
+            auto &sector = gSectors[i];
+            if(sector.sequence != kInvalid || sector.erased) {
+                continue;
+            }
+
+            err = Retire(i);
+            worked = !err;
+            break;
+        }
+    }
+
+    Flash::Unlock();
+
+    if(err) {
+        Logger::Warning(Logger::Module::Fs, "kv store: maintenance failed: %d", err);
+    }
+    return worked;
+}
+
+/**
+ * @brief Get the number of free sectors
+ */
+size_t KvStore::GetFreeSectors() {
+    size_t free{0};
+
+    for(size_t i = 0; i < gNumSectors; i++) {
+        if(gSectors[i].sequence == kInvalid) {
+            free++;
+        }
+    }
+
+    return free;
+}
+
+/**
+ * @brief Replay the records of a sector
+ *
+ * Update the index with each record in turn, stopping at the end of the records or the first
+ * damaged one. In the latter case, the sector is considered full.
+ */
+void KvStore::Replay(const size_t sector) {
+    auto &state = gSectors[sector];
+    uint32_t offset{sizeof(SectorHeader)};
+
+    while(offset + sizeof(RecordHeader) <= gSectorSize) {
+        const uint16_t recordOffset = sector * gSectorSize + offset;
+
+        RecordHeader hdr;
+        if(gFlash->read(gStart + recordOffset, {reinterpret_cast<uint8_t *>(&hdr),
+                    sizeof(hdr)})) {
+            goto damaged;
+        }
+
+        // reached erased space; the rest of the sector must be erased too, to append there
+        if(hdr.crc == UINT32_MAX && hdr.key == kNoKey && hdr.length == UINT16_MAX) {
+            bool blank;
+            if(CheckBlank(SectorAddress(sector) + offset, gSectorSize - offset, blank) ||
+                    !blank) {
+                goto damaged;
+            }
+
+            state.used = offset;
+            return;
+        }
+
+        if(hdr.length > kMaxValueSize || offset + RecordSize(hdr.length) > gSectorSize ||
+                ReadRecord(recordOffset, hdr.length)) {
+            goto damaged;
+        }
+
+        // apply it: it supersedes any previous record of the key (flags are stored inverted)
+        auto entry = Lookup(hdr.key);
+        if(entry) {
+            Release(*entry);
+        }
+
+        if(!(hdr.flags & RecordHeader::Flags::Tombstone)) {
+            if(entry) {
+                Erase(entry);
+            }
+        } else {
+            if(!entry) {
+                entry = Insert(hdr.key);
+            }
+
+            if(entry) {
+                entry->offset = recordOffset;
+                entry->length = hdr.length;
+                state.live += RecordSize(hdr.length);
+            } else {
+                Logger::Warning(Logger::Module::Fs, "kv store: too many keys, dropped %08x",
+                        hdr.key);
+            }
+        }
+
+        offset += RecordSize(hdr.length);
+    }
+
+    state.used = gSectorSize;
+    return;
+
+damaged:;
+    gStats.corruptRecords++;
+    Logger::Warning(Logger::Module::Fs, "kv store: damaged record at $%06x",
+            SectorAddress(sector) + offset);
+
+    state.used = gSectorSize;
+}
+
+/**
+ * @brief Append a record to the current sector
+ *
+ * If the record doesn't fit, a new sector is started first; this may compact the oldest sector.
+ *
+ * @param flags Record flags (see RecordHeader::Flags)
+ * @param outOffset Offset of the record into the partition
+ */
+int KvStore::Append(const uint32_t key, const uint8_t flags, etl::span<const uint8_t> value,
+        uint16_t &outOffset) {
+    int err;
+    const auto size = RecordSize(value.size());
+
+    // make space first, as compaction uses the record buffer
+    if(gSectors[gCurrent].used + size > gSectorSize) {
+        err = NextSector(false);
+        if(err) {
+            return err;
+        }
+    }
+
+    // build the record
+    auto hdr = reinterpret_cast<RecordHeader *>(gBuffer.data());
+    hdr->key = key;
+    hdr->length = value.size();
+    hdr->flags = static_cast<uint8_t>(~flags);
+    hdr->reserved = 0xFF;
+
+    if(!value.empty()) {
+        memcpy(gBuffer.data() + sizeof(RecordHeader), value.data(), value.size());
+    }
+
+    hdr->crc = Util::Crc32({gBuffer.data() + sizeof(hdr->crc), size - sizeof(hdr->crc)});
+
+    return AppendRaw({gBuffer.data(), size}, outOffset);
+}
+
+/**
+ * @brief Write a complete record at the end of the current sector
+ *
+ * It must fit in the current sector; if the write fails, nothing more is appended to the sector.
+ */
+int KvStore::AppendRaw(etl::span<const uint8_t> record, uint16_t &outOffset) {
+    auto &sector = gSectors[gCurrent];
+
+    const auto err = gFlash->write(SectorAddress(gCurrent) + sector.used, record);
+    if(err) {
+        sector.used = gSectorSize;
+        return err;
+    }
+
+    outOffset = gCurrent * gSectorSize + sector.used;
+    sector.used += record.size();
+    gStats.recordsWritten++;
+
+    return Error::NoError;
+}
+
+/**
+ * @brief Start a new sector
+ *
+ * Take the next free sector (erasing it, if needed) and write its header. Unless invoked during
+ * compaction, the reserve sectors are left alone: if only those are free, the oldest sector is
+ * compacted first.
+ *
+ * @param forCompaction Whether the sector is needed by compaction
+ */
+int KvStore::NextSector(const bool forCompaction) {
+    int err;
+
+    // keep the reserve sectors for compaction
+    if(!forCompaction) {
+        for(size_t tries{0}; GetFreeSectors() <= kReserveSectors; tries++) {
+            if(tries == gNumSectors || !CanCompact()) {
+                return Error::Full;
+            }
+
+            err = Compact();
+            if(err) {
+                return err;
+            }
+            gStats.foregroundCompactions++;
+        }
+    }
+
+    // find a free sector, continuing around the ring
+    size_t next{gNumSectors};
+    for(size_t i = 1; i <= gNumSectors; i++) {
+        const auto sector = (gCurrent + i) % gNumSectors;
+        if(gSectors[sector].sequence == kInvalid) {
+            next = sector;
+            break;
+        }
+    }
+
+    if(next == gNumSectors) {
+        return Error::Full;
+    }
+
+    // erase it, if needed, then write its header
+    if(!gSectors[next].erased) {
+        err = Retire(next);
+        if(err) {
+            return err;
+        }
+    }
+
+    gSectors[next].erased = false;
+
+    // kInvalid marks free sectors, so it's skipped when the sequence number wraps around
+    auto sequence = gSequence + 1;
+    if(sequence == kInvalid) {
+        sequence++;
+    }
+
+    const SectorHeader hdr{
+        .magic = kSectorMagic,
+        .sequence = sequence,
+        .check = ~sequence,
+    };
+    constexpr static const size_t kSequenceOffset{offsetof(SectorHeader, sequence)};
+
+    // the magic value goes last: the header is valid only once the rest is completely written
+    err = gFlash->write(SectorAddress(next) + kSequenceOffset,
+            {reinterpret_cast<const uint8_t *>(&hdr) + kSequenceOffset,
+            sizeof(hdr) - kSequenceOffset});
+    if(err) {
+        return err;
+    }
+
+    err = gFlash->write(SectorAddress(next), {reinterpret_cast<const uint8_t *>(&hdr.magic),
+            sizeof(hdr.magic)});
+    if(err) {
+        return err;
+    }
+
+    gSectors[next] = {hdr.sequence, sizeof(SectorHeader), 0, false};
+    gSequence = hdr.sequence;
+    gCurrent = next;
+
+    return Error::NoError;
+}
+
+/**
+ * @brief Compact the oldest sector
+ *
+ * Its live records are copied to the current sector (which may start a new one, from the reserve)
+ * and it's then erased. Records that can't be read back intact are lost.
+ */
+int KvStore::Compact() {
+    int err;
+
+    // find the oldest sector (it's never the current one, unless that's the only one in use)
+    size_t oldest{gNumSectors};
+    for(size_t i = 0; i < gNumSectors; i++) {
+        const auto sequence = gSectors[i].sequence;
+        if(i == gCurrent || sequence == kInvalid) {
+            continue;
+        } else if(oldest == gNumSectors || IsNewer(gSectors[oldest].sequence, sequence)) {
+            oldest = i;
+        }
+    }
+
+    if(oldest == gNumSectors) {
+        return Error::Full;
+    }
+
+    // copy its live records
+    const auto inOldest = [oldest](const IndexEntry &entry) {
+        return entry.key != kNoKey && (entry.offset / gSectorSize) == oldest;
+    };
+
+    for(auto &entry : gIndex) {
+        if(!inOldest(entry)) {
+            continue;
+        }
+
+        err = ReadRecord(entry.offset, entry.length);
+        if(err == Error::Corrupt) {
+            continue;
+        } else if(err) {
+            return err;
+        }
+
+        const auto size = RecordSize(entry.length);
+        if(gSectors[gCurrent].used + size > gSectorSize) {
+            err = NextSector(true);
+            if(err) {
+                return err;
+            }
+        }
+
+        uint16_t offset;
+        err = AppendRaw({gBuffer.data(), size}, offset);
+        if(err) {
+            return err;
+        }
+
+        Release(entry);
+        entry.offset = offset;
+        gSectors[gCurrent].live += size;
+    }
+
+    // whatever is left couldn't be read
+    for(size_t i = 0; i < kIndexSlots; ) {
+        if(!inOldest(gIndex[i])) {
+            i++;
+            continue;
+        }
+
+        gStats.corruptRecords++;
+        Logger::Warning(Logger::Module::Fs, "kv store: damaged record %08x", gIndex[i].key);
+
+        Release(gIndex[i]);
+        Erase(&gIndex[i]);
+    }
+
+    return Retire(oldest);
+}
+
+/**
+ * @brief Determine whether compaction can free up a sector
+ *
+ * That's the case if the sectors in use hold at least a sector's worth of space that isn't taken
+ * up by live records, including the unused space in the current one: compacting them in turn
+ * then packs the live records into one sector less. (Once compaction starts a new sector, the
+ * current one becomes eligible for compaction too.)
+ */
+bool KvStore::CanCompact() {
+    size_t reclaimable{0};
+
+    for(size_t i = 0; i < gNumSectors; i++) {
+        const auto &sector = gSectors[i];
+        if(sector.sequence == kInvalid) {
+            continue;
+        }
+
+        reclaimable += gSectorSize - sizeof(SectorHeader) - sector.live;
+    }
+
+    return reclaimable >= (gSectorSize - sizeof(SectorHeader));
+}
+
+/**
+ * @brief Erase a sector, making it free
+ *
+ * The magic value of a sector in use is cleared first, so it's not replayed if the erase is
+ * interrupted. Free sectors that read as erased already are left alone.
+ */
+int KvStore::Retire(const size_t sector) {
+    int err;
+    auto &state = gSectors[sector];
+
+    if(state.sequence != kInvalid) {
+        const uint32_t zero{0};
+        err = gFlash->write(SectorAddress(sector), {reinterpret_cast<const uint8_t *>(&zero),
+                sizeof(zero)});
+        if(err) {
+            return err;
+        }
+    } else {
+        bool blank;
+        err = CheckBlank(SectorAddress(sector), gSectorSize, blank);
+        if(err) {
+            return err;
+        }
+
+        if(blank) {
+            state = {kInvalid, 0, 0, true};
+            return Error::NoError;
+        }
+    }
+
+    state = {kInvalid, 0, 0, false};
+
+    err = gFlash->eraseSector(SectorAddress(sector));
+    if(err) {
+        return err;
+    }
+
+    state.erased = true;
+    return Error::NoError;
+}
+
+/**
+ * @brief Check whether a region of flash is erased
+ *
+ * @param address Flash address to start checking at
+ * @param length Number of bytes to check
+ * @param outBlank Set to whether all bytes read as erased
+ */
+int KvStore::CheckBlank(const uint32_t address, const uint32_t length, bool &outBlank) {
+    etl::array<uint8_t, 64> chunk;
+
+    outBlank = true;
+
+    for(uint32_t offset = 0; outBlank && offset < length; offset += chunk.size()) {
+        const auto num = etl::min(static_cast<uint32_t>(chunk.size()), length - offset);
+
+        const auto err = gFlash->read(address + offset, {chunk.data(), num});
+        if(err) {
+            return err;
+        }
+
+        outBlank = etl::all_of(chunk.begin(), chunk.begin() + num, [](auto byte) {
+            return byte == 0xFF;
+        });
+    }
+
+    return Error::NoError;
+}
+
+/**
+ * @brief Read a record into the record buffer and verify its CRC
+ *
+ * @param offset Offset of the record into the partition
+ * @param length Length of the record's value
+ */
+int KvStore::ReadRecord(const uint16_t offset, const size_t length) {
+    const auto size = RecordSize(length);
+
+    const auto err = gFlash->read(gStart + offset, {gBuffer.data(), size});
+    if(err) {
+        return err;
+    }
+
+    const auto hdr = reinterpret_cast<const RecordHeader *>(gBuffer.data());
+    const auto crc = Util::Crc32({gBuffer.data() + sizeof(hdr->crc), size - sizeof(hdr->crc)});
+
+    return (crc == hdr->crc && hdr->length == length) ? Error::NoError : Error::Corrupt;
+}
+
+
+
+/**
+ * @brief Find the index entry of a key
+ *
+ * @return The entry, or `nullptr` if the key isn't in the index
+ */
+KvStore::IndexEntry *KvStore::Lookup(const uint32_t key) {
+    for(size_t i = Hash(key), n = 0; n < kIndexSlots; i = (i + 1) & (kIndexSlots - 1), n++) {
+        if(gIndex[i].key == key) {
+            return &gIndex[i];
+        } else if(gIndex[i].key == kNoKey) {
+            break;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Add a key to the index
+ *
+ * @return The (new) entry, or `nullptr` if the index is full
+ */
+KvStore::IndexEntry *KvStore::Insert(const uint32_t key) {
+    if(gNumKeys >= kMaxKeys) {
+        return nullptr;
+    }
+
+    for(size_t i = Hash(key); ; i = (i + 1) & (kIndexSlots - 1)) {
+        if(gIndex[i].key == kNoKey) {
+            gIndex[i] = {key, 0, 0};
+            gNumKeys++;
+            return &gIndex[i];
+        }
+    }
+}
+
+/**
+ * @brief Remove an entry from the index
+ *
+ * Following entries of the same probe sequence are moved back to fill the hole (backward shift
+ * deletion), so lookups never need to skip over removed entries.
+ */
+void KvStore::Erase(IndexEntry *entry) {
+    constexpr static const size_t kMask{kIndexSlots - 1};
+    size_t hole = entry - gIndex.data();
+
+    for(size_t i = (hole + 1) & kMask; gIndex[i].key != kNoKey; i = (i + 1) & kMask) {
+        // move it, unless its home slot is (cyclically) after the hole
+        const auto home = Hash(gIndex[i].key);
+        if(((i - home) & kMask) >= ((i - hole) & kMask)) {
+            gIndex[hole] = gIndex[i];
+            hole = i;
+        }
+    }
+
+    gIndex[hole].key = kNoKey;
+    gNumKeys--;
+}
+
+/**
+ * @brief Account for the record an index entry refers to becoming garbage
+ */
+void KvStore::Release(const IndexEntry &entry) {
+    gSectors[entry.offset / gSectorSize].live -= RecordSize(entry.length);
+}
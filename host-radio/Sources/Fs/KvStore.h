@@ -0,0 +1,252 @@
+#ifndef FS_KVSTORE_H
+#define FS_KVSTORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <etl/array.h>
+#include <etl/span.h>
+
+namespace Fs {
+class Flash;
+
+/**
+ * @brief Key/value store on the external flash
+ *
+ * Holds small records (radio configuration, neighbor tables, key material) identified by a 32-bit
+ * key, in a partition reserved for it by the superblock. Like the log archive, it bypasses the
+ * filesystem: the partition is a ring of sectors, each starting with a small header, and records
+ * are only ever appended to the current sector. Updating a key appends a new record; removing it
+ * appends a tombstone.
+ *
+ * Each record has a CRC32 over its key, length and value. At mount, the sectors are replayed
+ * oldest first to rebuild an in-memory hash index of the most recent record for each key, so a
+ * lookup is a single flash read. Replay of a sector stops at the first damaged record (such as
+ * one torn by a power loss), and nothing more is appended to that sector.
+ *
+ * Space is reclaimed by compacting the oldest sector: its live records are copied to the current
+ * sector, then it's erased. Since it's always the oldest sector, any older records of a key
+ * removed by one of its tombstones are gone too, so tombstones are dropped as well. One sector is
+ * kept in reserve, as a destination for compaction; when writes need it, they compact first.
+ * The filesystem maintenance task (Fs::Maintenance) compacts during idle time, so that writes
+ * rarely have to.
+ *
+ * @remark All operations hold the flash bus lock (Fs::Flash::Lock()).
+ */
+class KvStore {
+    public:
+        /// Error codes from the key/value store
+        enum Error: int {
+            NoError                             = 0,
+            Success                             = NoError,
+
+            /// The store isn't available
+            NotMounted                          = -1200,
+            /// There is no record with the given key
+            NotFound                            = -1201,
+            /// The value is too large for a record, or the buffer too small for the value
+            InvalidSize                         = -1202,
+            /// The key is reserved
+            InvalidKey                          = -1203,
+            /// There is no more space (or index capacity) for records
+            Full                                = -1204,
+            /// A record failed its CRC check
+            Corrupt                             = -1205,
+        };
+
+        /// Largest value a record may hold (bytes)
+        constexpr static const size_t kMaxValueSize{240};
+        /// Maximum number of keys
+        constexpr static const size_t kMaxKeys{96};
+
+        /// Counters
+        struct Stats {
+            /// Records written (including tombstones and those copied by compaction)
+            uint32_t recordsWritten;
+            /// Sectors compacted by writes that needed space
+            uint32_t foregroundCompactions;
+            /// Sectors compacted during idle time
+            uint32_t idleCompactions;
+            /// Damaged records found (at mount, or when read)
+            uint32_t corruptRecords;
+        };
+
+    private:
+        /// Maximum number of sectors in the partition
+        constexpr static const size_t kMaxSectors{16};
+        /// Number of free sectors kept as a destination for compaction
+        constexpr static const size_t kReserveSectors{1};
+        /// Idle compaction is done while there are no more than this many free sectors
+        constexpr static const size_t kIdleFreeSectors{3};
+        /// Number of hash index slots (a power of two)
+        constexpr static const size_t kIndexSlots{128};
+
+        /// Sector header magic value ("BKVS")
+        constexpr static const uint32_t kSectorMagic{0x424B5653};
+        /// Sequence number of a sector that's not in use
+        constexpr static const uint32_t kInvalid{UINT32_MAX};
+        /// Key of an unused index slot, and thus reserved
+        constexpr static const uint32_t kNoKey{UINT32_MAX};
+
+        /**
+         * @brief Header at the start of each sector
+         *
+         * The sequence number (and its check value) are programmed before the magic value, so a
+         * sector whose header write was interrupted isn't mistaken for a valid one; the check
+         * value rejects headers that were damaged otherwise. The magic value is cleared
+         * (programmed to zero) before a compacted sector is erased, so a sector whose erase was
+         * interrupted isn't either.
+         */
+        struct SectorHeader {
+            /// Always kSectorMagic
+            uint32_t magic;
+            /// Sequence number, increments (wrapping around, but skipping kInvalid) with each
+            /// sector started
+            uint32_t sequence;
+            /// Complement of the sequence number
+            uint32_t check;
+        };
+
+        /**
+         * @brief Header of each record, followed by its value
+         */
+        struct RecordHeader {
+            /// Record flags
+            enum Flags: uint8_t {
+                /// The key was removed; there's no value
+                Tombstone                       = (1 << 0),
+            };
+
+            /// CRC32 over the rest of the header and the value
+            uint32_t crc;
+            /// Key
+            uint32_t key;
+            /// Length of the value (bytes); all ones past the last record in a sector
+            uint16_t length;
+            /// Record flags (inverted: programmed bits are set)
+            uint8_t flags;
+            /// Reserved, always all ones
+            uint8_t reserved;
+        } __attribute__((packed));
+
+        /**
+         * @brief In memory state of a sector
+         */
+        struct Sector {
+            /// Sequence number, or kInvalid if the sector is free
+            uint32_t sequence;
+            /// Write offset (bytes, from the start of the sector); sector size if full
+            uint16_t used;
+            /// Bytes of live records (those the index refers to)
+            uint16_t live;
+            /// Whether a free sector is known to be erased
+            bool erased;
+        };
+
+        /**
+         * @brief Hash index slot
+         */
+        struct IndexEntry {
+            /// Key, or kNoKey if the slot is unused
+            uint32_t key;
+            /// Offset of the record into the partition
+            uint16_t offset;
+            /// Length of the record's value
+            uint16_t length;
+        };
+
+    public:
+        static void Init(Flash *flash, const uint32_t start, const uint32_t end);
+
+        /**
+         * @brief Whether the store is available
+         */
+        static inline bool IsMounted() {
+            return !!gFlash;
+        }
+
+        static int Get(const uint32_t key, etl::span<uint8_t> buffer);
+        static int Put(const uint32_t key, etl::span<const uint8_t> value);
+        static int Remove(const uint32_t key);
+
+        static bool Maintain();
+
+        /**
+         * @brief Get the counters
+         */
+        static inline const Stats &GetStats() {
+            return gStats;
+        }
+        /**
+         * @brief Get the number of keys stored
+         */
+        static inline size_t GetNumKeys() {
+            return gNumKeys;
+        }
+        static size_t GetFreeSectors();
+
+    private:
+        static void Replay(const size_t sector);
+        static int Append(const uint32_t key, const uint8_t flags,
+                etl::span<const uint8_t> value, uint16_t &outOffset);
+        static int AppendRaw(etl::span<const uint8_t> record, uint16_t &outOffset);
+        static int NextSector(const bool forCompaction);
+        static int Compact();
+        static bool CanCompact();
+        static int Retire(const size_t sector);
+        static int ReadRecord(const uint16_t offset, const size_t length);
+        static int CheckBlank(const uint32_t address, const uint32_t length, bool &outBlank);
+
+        static IndexEntry *Lookup(const uint32_t key);
+        static IndexEntry *Insert(const uint32_t key);
+        static void Erase(IndexEntry *entry);
+        static void Release(const IndexEntry &entry);
+
+        /// Get the address of a sector
+        static inline uint32_t SectorAddress(const size_t sector) {
+            return gStart + sector * gSectorSize;
+        }
+        /// Get the total size of a record with a value of the given length
+        static constexpr inline size_t RecordSize(const size_t length) {
+            return sizeof(RecordHeader) + length;
+        }
+        /// Whether sequence number `a` is more recent than `b` (they wrap around)
+        static constexpr inline bool IsNewer(const uint32_t a, const uint32_t b) {
+            return static_cast<int32_t>(a - b) > 0;
+        }
+        /// Get the index slot for a key (Fibonacci hashing)
+        static constexpr inline size_t Hash(const uint32_t key) {
+            return (key * 2654435769U) >> (32 - __builtin_ctz(kIndexSlots));
+        }
+
+    private:
+        /// Flash the partition lives on, or `nullptr` if there's no store
+        static Flash *gFlash;
+        /// Start address of the partition
+        static uint32_t gStart;
+        /// Size of a sector (bytes)
+        static uint32_t gSectorSize;
+        /// Number of sectors in the partition
+        static size_t gNumSectors;
+
+        /// State of each sector
+        static etl::array<Sector, kMaxSectors> gSectors;
+        /// Sector currently being written
+        static size_t gCurrent;
+        /// Sequence number of the current sector
+        static uint32_t gSequence;
+
+        /// Hash index (open addressing, linear probing)
+        static etl::array<IndexEntry, kIndexSlots> gIndex;
+        /// Number of keys in the index
+        static size_t gNumKeys;
+
+        /// Buffer for a whole record
+        static etl::array<uint8_t, sizeof(RecordHeader) + kMaxValueSize> gBuffer;
+
+        /// Counters
+        static Stats gStats;
+};
+}
+
+#endif
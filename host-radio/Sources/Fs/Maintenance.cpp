@@ -0,0 +1,115 @@
+#include <spiffs.h>
+
+#include "HostIf/Task.h"
+#include "Log/Logger.h"
+#include "Radio/Task.h"
+
+#include "KvStore.h"
+#include "Maintenance.h"
+#include "NorFs.h"
+
+using namespace Fs;
+
+TaskHandle_t Maintenance::gTask{nullptr};
+bool Maintenance::gEnabled{true};
+
+Maintenance::Stats Maintenance::gStats{};
+
+/**
+ * @brief Start the maintenance task
+ *
+ * It does nothing until the filesystem is mounted.
+ */
+void Maintenance::Init() {
+    static StaticTask_t gTaskStorage;
+    static StackType_t gStack[kStackSize];
+
+    gTask = xTaskCreateStatic([](auto param) {
+        Maintenance::Main();
+    }, kName.data(), kStackSize, nullptr, kPriority, gStack, &gTaskStorage);
+    REQUIRE(!!gTask, "failed to initialize %s", "fs maintenance task");
+}
+
+/**
+ * @brief Enable or disable maintenance work
+ *
+ * While disabled, all space is reclaimed by the writes that need it.
+ */
+void Maintenance::SetEnabled(const bool enabled) {
+    gEnabled = enabled;
+}
+
+/**
+ * @brief Task main loop
+ *
+ * Periodically check whether it's quiet, and if so, work until there's nothing left to do or it
+ * no longer is.
+ */
+void Maintenance::Main() {
+    while(true) {
+        vTaskDelay(kCheckInterval);
+
+        auto fs = NorFs::GetFs();
+        if(!fs) {
+            continue;
+        }
+
+        while(gEnabled && IsQuiet() && (DoWork(fs) || KvStore::Maintain())) {
+            // keep going
+        }
+    }
+}
+
+/**
+ * @brief Determine whether the radio and host interface are quiet
+ *
+ * That's the case if neither task has handled an event for at least kQuietTime.
+ */
+bool Maintenance::IsQuiet() {
+    const auto now = xTaskGetTickCount();
+
+    return (now - Radio::Task::GetLastActivity()) >= kQuietTime &&
+        (now - HostIf::Task::GetLastActivity()) >= kQuietTime;
+}
+
+/**
+ * @brief Perform one unit of maintenance work
+ *
+ * Erase one block that holds only deleted pages; if there are none, and writes would have to
+ * collect garbage, collect it now.
+ *
+ * @return Whether any work was done (so there may be more to do)
+ */
+bool Maintenance::DoWork(struct spiffs_t *fs) {
+    int err;
+
+    // erase a block that holds nothing but deleted pages
+    err = SPIFFS_gc_quick(fs, 0);
+    if(err == SPIFFS_OK) {
+        gStats.blocksErased++;
+        return true;
+    } else if(err != SPIFFS_ERR_NO_DELETED_BLOCKS) {
+        gStats.errors++;
+        Logger::Warning(Logger::Module::Fs, "FS: %s failed: %d", "SPIFFS_gc_quick", err);
+        return false;
+    }
+
+    // otherwise, collect garbage (moving pages) if a write would
+    const auto freeBlocks = fs->free_blocks;
+    if(freeBlocks > kGcFreeBlocks) {
+        return false;
+    }
+
+    const auto runs = fs->stats_gc_runs;
+    err = SPIFFS_gc(fs, fs->cfg.log_page_size);
+    gStats.gcRuns += fs->stats_gc_runs - runs;
+
+    // a full filesystem can't be helped
+    if(err && err != SPIFFS_ERR_FULL) {
+        gStats.errors++;
+        Logger::Warning(Logger::Module::Fs, "FS: %s failed: %d", "SPIFFS_gc", err);
+        return false;
+    }
+
+    return fs->free_blocks > freeBlocks;
+}
@@ -0,0 +1,91 @@
+#ifndef FS_MAINTENANCE_H
+#define FS_MAINTENANCE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <etl/string_view.h>
+
+#include "Rtos/Rtos.h"
+
+struct spiffs_t;
+
+namespace Fs {
+/**
+ * @brief Filesystem maintenance task
+ *
+ * SPIFFS only reclaims space when a write runs out of free (erased) blocks: it then collects
+ * garbage, moving pages and erasing blocks, inside that write, which stalls the caller for one or
+ * more block erases. This task does that work ahead of time, at the lowest priority and only while
+ * the radio and host interface have been quiet for a while:
+ *
+ * - Blocks that hold only deleted pages are erased (SPIFFS_gc_quick), one at a time.
+ * - Once free blocks run as low as the point at which writes would collect garbage, a regular
+ *   collection is run.
+ * - Once the filesystem needs no more work, the key/value store (Fs::KvStore) compacts or erases
+ *   one of its sectors at a time.
+ *
+ * The quiet check is repeated after each block, so the task holds the flash for at most one block
+ * erase (plus moving the block's remaining pages) at a time.
+ */
+class Maintenance {
+    public:
+        /// Work counters
+        struct Stats {
+            /// Blocks erased ahead of time, because they held only deleted pages
+            uint32_t blocksErased;
+            /// Garbage collection runs (in SPIFFS) started by the task
+            uint32_t gcRuns;
+            /// Failed maintenance operations
+            uint32_t errors;
+        };
+
+    private:
+        /// Runtime priority level
+        static const constexpr uint8_t kPriority{Rtos::TaskPriority::Background};
+        /// Size of the task's stack, in words
+        static const constexpr size_t kStackSize{420};
+        /// Task name (for display purposes)
+        static const constexpr etl::string_view kName{"FsMaint"};
+
+        /// Interval between checks for work
+        static const constexpr TickType_t kCheckInterval{pdMS_TO_TICKS(250)};
+        /// Time without radio or host interface activity before work is done
+        static const constexpr TickType_t kQuietTime{pdMS_TO_TICKS(500)};
+        /**
+         * @brief Number of free blocks at which to collect garbage
+         *
+         * SPIFFS collects garbage in writes once there are no more than this many free blocks.
+         */
+        static const constexpr uint32_t kGcFreeBlocks{3};
+
+    public:
+        static void Init();
+
+        static void SetEnabled(const bool enabled);
+
+        /**
+         * @brief Get the work counters
+         */
+        static inline const Stats &GetStats() {
+            return gStats;
+        }
+
+    private:
+        static void Main();
+
+        static bool IsQuiet();
+        static bool DoWork(struct spiffs_t *fs);
+
+    private:
+        /// FreeRTOS Task handle
+        static TaskHandle_t gTask;
+        /// Whether maintenance work is done
+        static bool gEnabled;
+
+        /// Work counters
+        static Stats gStats;
+};
+}
+
+#endif
@@ -1,11 +1,16 @@
 #include <string.h>
 #include <spiffs.h>
 
+#include "Debug/Probes.h"
 #include "Log/Logger.h"
+#include "Rtos/Heap.h"
 
+#include "BlockCache.h"
 #include "Flash.h"
 #include "FlashInfo.h"
 #include "Init.h"
+#include "KvStore.h"
+#include "Maintenance.h"
 #include "NorFs.h"
 
 using namespace Fs;
@@ -22,6 +27,11 @@ Flash *NorFs::gFlash{nullptr};
  */
 struct spiffs_t NorFs::gFs;
 
+/**
+ * @brief Whether the filesystem is mounted
+ */
+bool NorFs::gMounted{false};
+
 /**
  * @brief SPIFFs configuration
  *
@@ -69,28 +79,32 @@ int NorFs::Mount(Flash *flash, Superblock *super) {
 
     // update config and allocate buffers
     InitFsConfig(flash, super);
+    BlockCache::Init(flash);
 
-    work = reinterpret_cast<uint8_t *>(malloc(2 * gFsConfig.log_page_size));
+    work = reinterpret_cast<uint8_t *>(Rtos::Heap::Alloc(Rtos::Heap::Class::FsCache,
+                2 * gFsConfig.log_page_size));
     if(!work) {
         goto outofmem;
     }
 
     cacheSize = (gFsConfig.log_page_size + 32) * 4;
-    cache = reinterpret_cast<uint8_t *>(malloc(cacheSize));
+    cache = reinterpret_cast<uint8_t *>(Rtos::Heap::Alloc(Rtos::Heap::Class::FsCache,
+                cacheSize));
     if(!cache) {
-        Logger::Warning("FS: couldn't alloc %u bytes fs cache", cacheSize);
+        Logger::Warning(Logger::Module::Fs, "FS: couldn't alloc %u bytes fs cache", cacheSize);
         cacheSize = 0;
     }
 
     // attempt to mount fs
     err = SPIFFS_mount(&gFs, &gFsConfig, work, fds.data(), fds.size(), cache, cacheSize, nullptr);
     if(err) {
-        free(work);
-        free(cache);
+        Rtos::Heap::Free(Rtos::Heap::Class::FsCache, work);
+        Rtos::Heap::Free(Rtos::Heap::Class::FsCache, cache);
     }
 
     // ensure filesystem consistency
     if(err == SPIFFS_OK) {
+        gMounted = true;
         CheckSpiffsConsistency();
     }
 
@@ -98,13 +112,52 @@ int NorFs::Mount(Flash *flash, Superblock *super) {
 
     // jump here if out of memory
 outofmem:;
-    if(work) {
-        free(work);
+    Rtos::Heap::Free(Rtos::Heap::Class::FsCache, work);
+    Rtos::Heap::Free(Rtos::Heap::Class::FsCache, cache);
+    return Error::OutOfMemory;
+}
+
+/**
+ * @brief Read out filesystem statistics
+ *
+ * @param out Response to fill in
+ */
+void NorFs::ReadStats(HostIf::Response::GetFsStats &out) {
+    const auto &cache = BlockCache::GetStats();
+    const auto &maintenance = Maintenance::GetStats();
+    const auto &kv = KvStore::GetStats();
+
+    out = {};
+    out.mounted = gMounted;
+
+    out.cacheLines = BlockCache::GetNumLines();
+    out.cacheLineSize = BlockCache::kLineSize;
+    out.cacheHits = cache.hits;
+    out.cacheMisses = cache.misses;
+    out.cacheBypassed = cache.bypassed;
+
+    out.maintenanceGcRuns = maintenance.gcRuns;
+    out.maintenanceErases = maintenance.blocksErased;
+    out.maintenanceErrors = maintenance.errors;
+
+    if(KvStore::IsMounted()) {
+        out.kvKeys = KvStore::GetNumKeys();
+        out.kvFreeSectors = KvStore::GetFreeSectors();
     }
-    if(cache) {
-        free(cache);
+    out.kvRecordsWritten = kv.recordsWritten;
+    out.kvForegroundCompactions = kv.foregroundCompactions;
+    out.kvIdleCompactions = kv.idleCompactions;
+    out.kvCorruptRecords = kv.corruptRecords;
+
+    if(gMounted) {
+        out.spiffsCacheHits = gFs.cache_hits;
+        out.spiffsCacheMisses = gFs.cache_misses;
+
+        out.blocks = gFs.block_count;
+        out.freeBlocks = gFs.free_blocks;
+        out.deletedPages = gFs.stats_p_deleted;
+        out.gcRuns = gFs.stats_gc_runs;
     }
-    return Error::OutOfMemory;
 }
 
 /**
@@ -120,13 +173,13 @@ void NorFs::CheckSpiffsConsistency() {
     err = SPIFFS_info(&gFs, &total, &used);
     REQUIRE(err == SPIFFS_OK, "%s failed: %d", "SPIFFS_info", err);
 
-    Logger::Notice("FS: used %u of %u bytes", used, total);
+    Logger::Notice(Logger::Module::Fs, "FS: used %u of %u bytes", used, total);
 
     if(total < used) {
-        Logger::Warning("FS: inconsistency detected, running check!");
+        Logger::Warning(Logger::Module::Fs, "FS: inconsistency detected, running check!");
 
         err = SPIFFS_check(&gFs);
-        Logger::Warning("FS: %s returned %d", "SPIFFS_check", err);
+        Logger::Warning(Logger::Module::Fs, "FS: %s returned %d", "SPIFFS_check", err);
     }
 }
 
@@ -148,7 +201,14 @@ void NorFs::InitFsConfig(Flash *flash, Superblock *block) {
     gFlash = flash;
 
     // flash geometry
-    gFsConfig.phys_size = flash->getInfo()->capacityBytes() - block->fsStart;
+    // the filesystem extends to the key/value store, log archive, or the end of the flash
+    auto end = flash->getInfo()->capacityBytes();
+    if(block->kvStart) {
+        end = block->kvStart;
+    } else if(block->logStart) {
+        end = block->logStart;
+    }
+    gFsConfig.phys_size = end - block->fsStart;
     gFsConfig.phys_addr = block->fsStart;
     gFsConfig.phys_erase_block = flash->getInfo()->blockSizeBytes();
 
@@ -156,23 +216,41 @@ void NorFs::InitFsConfig(Flash *flash, Superblock *block) {
     gFsConfig.log_block_size = flash->getInfo()->blockSizeBytes();
     gFsConfig.log_page_size = flash->getInfo()->pageSizeBytes();
 
-    // define IO routines
+    // define IO routines; they go through the block cache
     gFsConfig.hal_read_f = [](auto addr, auto size, auto buf) -> int {
-        if(kLogFsOps) {
-            Logger::Notice("FS read: %u bytes from $%06x (%p)", size, addr, buf);
-        }
-        return gFlash->read(addr, {buf, size});
+        Logger::Trace(Logger::Module::Fs, "FS read: %u bytes from $%06x (%p)", size, addr, buf);
+        PROBE_SCOPE(FsRead);
+        return BlockCache::Read(addr, {buf, size});
     };
     gFsConfig.hal_write_f = [](auto addr, auto size, auto buf) -> int {
-        if(kLogFsOps) {
-            Logger::Notice("FS write: %u bytes to $%06x (%p)", size, addr, buf);
-        }
-        return gFlash->write(addr, {buf, size});
+        Logger::Trace(Logger::Module::Fs, "FS write: %u bytes to $%06x (%p)", size, addr, buf);
+        PROBE_SCOPE(FsWrite);
+        return BlockCache::Write(addr, {buf, size});
     };
     gFsConfig.hal_erase_f = [](auto addr, auto size) -> int {
-        if(kLogFsOps) {
-            Logger::Notice("FS erase: %u bytes from $%06x", size, addr);
-        }
-        return gFlash->erase(addr, size);
+        Logger::Trace(Logger::Module::Fs, "FS erase: %u bytes from $%06x", size, addr);
+        PROBE_SCOPE(FsErase);
+        return BlockCache::Erase(addr, size);
     };
 }
+
+
+
+/**
+ * @brief Lock the filesystem
+ *
+ * Invoked by SPIFFS on entry to each API call; takes the flash bus lock, so that filesystem
+ * operations don't interleave with each other, or other users of the flash.
+ */
+extern "C" void fs_lock(struct spiffs_t *) {
+    Fs::Flash::Lock();
+}
+
+/**
+ * @brief Unlock the filesystem
+ *
+ * Invoked by SPIFFS before returning from each API call.
+ */
+extern "C" void fs_unlock(struct spiffs_t *) {
+    Fs::Flash::Unlock();
+}
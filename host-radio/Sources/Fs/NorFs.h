@@ -1,6 +1,8 @@
 #ifndef FS_SPIFFS_H
 #define FS_SPIFFS_H
 
+#include <BlazeNet/HostIf/Commands.h>
+
 namespace Fs {
 class Flash;
 struct Superblock;
@@ -23,14 +25,21 @@ class NorFs {
             AlreadyFormatted                    = -1101,
         };
 
-    private:
-        /// Should filesystem ops be logged?
-        constexpr static const bool kLogFsOps{false};
-
     public:
         static int Mount(Flash *flash, Superblock *super);
         static int Format(Flash *flash, Superblock *super);
 
+        static void ReadStats(HostIf::Response::GetFsStats &out);
+
+        /**
+         * @brief Get the SPIFFS instance
+         *
+         * @return The instance, or `nullptr` if the filesystem isn't mounted
+         */
+        static inline struct spiffs_t *GetFs() {
+            return gMounted ? &gFs : nullptr;
+        }
+
     private:
         static void InitFsConfig(Flash *flash, Superblock *block);
         static void CheckSpiffsConsistency();
@@ -38,6 +47,7 @@ class NorFs {
     private:
         static Flash *gFlash;
         static struct spiffs_t gFs;
+        static bool gMounted;
 };
 }
 
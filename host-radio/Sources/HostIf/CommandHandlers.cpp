@@ -8,6 +8,7 @@
 #ifndef HOSTIF_COMMANDHANDLER_H
 #define HOSTIF_COMMANDHANDLER_H
 
+#include "Handlers/Batch.h"
 #include "Handlers/GetInfo.h"
 #include "Handlers/RadioConfig.h"
 #include "Handlers/GetStatus.h"
@@ -18,6 +19,15 @@
 #include "Handlers/BeaconConfig.h"
 #include "Handlers/GetCounters.h"
 #include "Handlers/IrqStatus.h"
+#include "Handlers/StatusSnapshot.h"
+#include "Handlers/ReadEvents.h"
+#include "Handlers/ReadProbes.h"
+#include "Handlers/GetTaskStats.h"
+#include "Handlers/GetHeapStats.h"
+#include "Handlers/LogLevels.h"
+#include "Handlers/ReadLogArchive.h"
+#include "Handlers/ReadLogs.h"
+#include "Handlers/GetFsStats.h"
 
 #include "Task.h"
 
@@ -102,6 +112,79 @@ const etl::array<const Task::CommandHandler, Task::kMaxCommandId> Task::gHandler
         .readComplete   = nullptr,
         .write          = Handlers::IrqStatus::DoWrite,
     },
+    // 0x0B: StatusSnapshot
+    {
+        .flags          = (HandlerFlags::SupportsRead | HandlerFlags::WantsPostRead |
+                HandlerFlags::SupportsWrite),
+        .read           = Handlers::StatusSnapshot::DoRead,
+        .readComplete   = Handlers::StatusSnapshot::PostRead,
+        .write          = Handlers::StatusSnapshot::DoWrite,
+    },
+    // 0x0C: Batch
+    {
+        .flags          = (HandlerFlags::SupportsRead | HandlerFlags::WantsPostRead |
+                HandlerFlags::SupportsWrite),
+        .read           = Handlers::Batch::DoRead,
+        .readComplete   = Handlers::Batch::PostRead,
+        .write          = Handlers::Batch::DoWrite,
+    },
+    // 0x0D: ReadEvents
+    {
+        .flags          = (HandlerFlags::SupportsRead | HandlerFlags::WantsPostRead),
+        .read           = Handlers::ReadEvents::DoRead,
+        .readComplete   = Handlers::ReadEvents::PostRead,
+        .write          = nullptr,
+    },
+    // 0x0E: ReadProbes
+    {
+        .flags          = (HandlerFlags::SupportsRead | HandlerFlags::WantsPostRead),
+        .read           = Handlers::ReadProbes::DoRead,
+        .readComplete   = Handlers::ReadProbes::PostRead,
+        .write          = nullptr,
+    },
+    // 0x0F: GetTaskStats
+    {
+        .flags          = (HandlerFlags::SupportsRead | HandlerFlags::WantsPostRead),
+        .read           = Handlers::GetTaskStats::DoRead,
+        .readComplete   = Handlers::GetTaskStats::PostRead,
+        .write          = nullptr,
+    },
+    // 0x10: GetHeapStats
+    {
+        .flags          = HandlerFlags::SupportsRead,
+        .read           = Handlers::GetHeapStats::DoRead,
+        .readComplete   = nullptr,
+        .write          = nullptr,
+    },
+    // 0x11: LogLevels
+    {
+        .flags          = (HandlerFlags::SupportsRead | HandlerFlags::SupportsWrite),
+        .read           = Handlers::LogLevels::DoRead,
+        .readComplete   = nullptr,
+        .write          = Handlers::LogLevels::DoWrite,
+    },
+    // 0x12: ReadLogArchive
+    {
+        .flags          = (HandlerFlags::SupportsRead | HandlerFlags::SupportsWrite |
+                HandlerFlags::WantsPostRead),
+        .read           = Handlers::ReadLogArchive::DoRead,
+        .readComplete   = Handlers::ReadLogArchive::PostRead,
+        .write          = Handlers::ReadLogArchive::DoWrite,
+    },
+    // 0x13: ReadLogs
+    {
+        .flags          = (HandlerFlags::SupportsRead | HandlerFlags::WantsPostRead),
+        .read           = Handlers::ReadLogs::DoRead,
+        .readComplete   = Handlers::ReadLogs::PostRead,
+        .write          = nullptr,
+    },
+    // 0x14: GetFsStats
+    {
+        .flags          = HandlerFlags::SupportsRead,
+        .read           = Handlers::GetFsStats::DoRead,
+        .readComplete   = nullptr,
+        .write          = nullptr,
+    },
 }};
 
 #endif
@@ -0,0 +1,99 @@
+#include <rail.h>
+
+#include <etl/algorithm.h>
+
+#include "Log/Logger.h"
+#include "Rtos/Rtos.h"
+
+#include "EventRing.h"
+#include "IrqManager.h"
+
+using namespace HostIf;
+
+etl::circular_buffer<Response::Event, EventRing::kCapacity> EventRing::gEvents;
+uint16_t EventRing::gSequence{0};
+uint16_t EventRing::gLost{0};
+
+/**
+ * @brief Record an event
+ *
+ * Assign the event a sequence number and timestamp, then insert it into the ring. If the ring is
+ * full, the event is dropped and counted instead.
+ *
+ * @param event Event to record (type and data must be filled in)
+ */
+void EventRing::Record(Response::Event &event) {
+    bool dropped{false};
+
+    taskENTER_CRITICAL();
+
+    event.sequence = gSequence++;
+    event.timestamp = RAIL_GetTime();
+
+    if(gEvents.full()) {
+        if(gLost != UINT16_MAX) {
+            gLost++;
+        }
+        dropped = true;
+    } else {
+        gEvents.push(event);
+    }
+
+    taskEXIT_CRITICAL();
+
+    IrqManager::Assert(Interrupt::EventPending);
+
+    Logger::Trace(Logger::Module::HostIf, "%s: %u (seq %u, ts %u)", "Event", event.type,
+            event.sequence, event.timestamp);
+    if(dropped) {
+        Logger::Warning(Logger::Module::HostIf, "%s: ring full, dropped %u (seq %u)", "Event",
+                event.type, event.sequence);
+    }
+}
+
+/**
+ * @brief Copy out the oldest events, without removing them
+ *
+ * @param outEvents Buffer to receive events
+ * @param outLost Variable to receive the number of events lost since the last read
+ *
+ * @return Number of events copied
+ */
+size_t EventRing::Peek(etl::span<Response::Event> outEvents, uint16_t &outLost) {
+    taskENTER_CRITICAL();
+
+    const auto num = etl::min(outEvents.size(), gEvents.size());
+    for(size_t i = 0; i < num; i++) {
+        outEvents[i] = gEvents[i];
+    }
+    outLost = gLost;
+
+    taskEXIT_CRITICAL();
+
+    return num;
+}
+
+/**
+ * @brief Remove events that were read by the host
+ *
+ * The event pending interrupt is deasserted once the ring is empty and all lost events have been
+ * reported.
+ *
+ * @param numEvents Number of events (from the head of the ring) to remove
+ * @param lostReported Number of lost events the host was told about
+ */
+void EventRing::Consume(const size_t numEvents, const uint16_t lostReported) {
+    taskENTER_CRITICAL();
+
+    for(size_t i = 0; i < numEvents && !gEvents.empty(); i++) {
+        gEvents.pop();
+    }
+    gLost -= etl::min(gLost, lostReported);
+
+    // still inside the critical section, so a concurrently recorded event can't be missed
+    if(gEvents.empty() && !gLost) {
+        IrqManager::Deassert(Interrupt::EventPending);
+    }
+
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,145 @@
+#ifndef HOSTIF_EVENTRING_H
+#define HOSTIF_EVENTRING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <etl/circular_buffer.h>
+#include <etl/span.h>
+
+#include <BlazeNet/HostIf/Commands.h>
+
+namespace HostIf {
+/**
+ * @brief Ordered, timestamped event log for the host
+ *
+ * Components record events (received frames, transmit completions, queue watermarks, and so on)
+ * here as they happen, rather than just setting a sticky interrupt bit. The host reads them out
+ * in order, many at a time, with the ReadEvents command. The EventPending interrupt is asserted
+ * as long as the ring is not empty.
+ *
+ * When the ring is full, new events are dropped (not overwritten) and counted; the count is
+ * reported to the host with the next read. Each event still consumes a sequence number, so the
+ * host can tell where events were lost.
+ *
+ * @remark Events may be recorded from any task context, but not from interrupts.
+ */
+class EventRing {
+    public:
+        /// Maximum number of events buffered
+        constexpr static const size_t kCapacity{64};
+
+    public:
+        /**
+         * @brief Record a received frame
+         *
+         * @param size Frame size (bytes)
+         * @param rssi Receive signal strength
+         * @param lqi Link quality indicator
+         * @param queued Whether the frame was placed in the receive queue
+         */
+        static inline void FrameReceived(const uint16_t size, const int8_t rssi, const uint8_t lqi,
+                const bool queued) {
+            Response::Event event{.type = Response::Event::FrameReceived};
+            event.data.frameReceived.size = size;
+            event.data.frameReceived.rssi = rssi;
+            event.data.frameReceived.lqi = lqi;
+            event.data.frameReceived.queued = queued ? 1 : 0;
+
+            Record(event);
+        }
+
+        /**
+         * @brief Record completion of a transmission
+         *
+         * @param size Frame size (bytes)
+         * @param status Completion status
+         */
+        static inline void TxComplete(const uint16_t size, const Response::Event::TxStatus status) {
+            Response::Event event{.type = Response::Event::TxComplete};
+            event.data.txComplete.size = size;
+            event.data.txComplete.status = status;
+
+            Record(event);
+        }
+
+        /**
+         * @brief Record a packet queue crossing one of its watermarks
+         *
+         * @param queue Queue whose state changed
+         * @param high Whether usage rose above the high watermark (otherwise, it dropped below the
+         *        low watermark)
+         * @param bufferSize Bytes currently allocated for the queue
+         * @param packetsPending Number of packets in the queue
+         */
+        static inline void QueueWatermark(const Response::Event::Queue queue, const bool high,
+                const size_t bufferSize, const size_t packetsPending) {
+            Response::Event event{.type = Response::Event::QueueWatermark};
+            event.data.queueWatermark.queue = queue;
+            event.data.queueWatermark.high = high ? 1 : 0;
+            event.data.queueWatermark.bufferSize = bufferSize;
+            event.data.queueWatermark.packetsPending = packetsPending;
+
+            Record(event);
+        }
+
+        /**
+         * @brief Record the start of radio calibration
+         *
+         * @param pending Calibrations about to be performed
+         */
+        static inline void CalibrationStarted(const uint32_t pending) {
+            Response::Event event{.type = Response::Event::CalibrationStarted};
+            event.data.calibrationStarted.pending = pending;
+
+            Record(event);
+        }
+
+        /**
+         * @brief Record the completion of radio calibration
+         *
+         * @param status Calibration status code
+         */
+        static inline void CalibrationFinished(const int32_t status) {
+            Response::Event event{.type = Response::Event::CalibrationFinished};
+            event.data.calibrationFinished.status = status;
+
+            Record(event);
+        }
+
+        /**
+         * @brief Record a change in the host communications state
+         *
+         * @param lost Whether communication was lost
+         */
+        static inline void CommsStateChanged(const bool lost) {
+            Response::Event event{.type = Response::Event::CommsStateChanged};
+            event.data.commsState.lost = lost ? 1 : 0;
+
+            Record(event);
+        }
+
+        static size_t Peek(etl::span<Response::Event> outEvents, uint16_t &outLost);
+        static void Consume(const size_t numEvents, const uint16_t lostReported);
+
+        /**
+         * @brief Get the number of events in the ring
+         */
+        static inline size_t GetPending() {
+            return gEvents.size();
+        }
+
+    private:
+        static void Record(Response::Event &event);
+
+    private:
+        /// Pending events
+        static etl::circular_buffer<Response::Event, kCapacity> gEvents;
+        /// Sequence number for the next event
+        static uint16_t gSequence;
+        /// Events dropped since the last successful read
+        static uint16_t gLost;
+};
+}
+
+#endif
@@ -0,0 +1,203 @@
+#ifndef HOSTIF_HANDLERS_BATCH_H
+#define HOSTIF_HANDLERS_BATCH_H
+
+#include <string.h>
+#include <etl/array.h>
+#include <etl/circular_buffer.h>
+#include <etl/span.h>
+
+#include <BlazeNet/HostIf/Commands.h>
+
+#include "HostIf/Task.h"
+#include "Log/Logger.h"
+#include "Rtos/Rtos.h"
+
+namespace HostIf::Handlers {
+/**
+ * @brief Process a "Batch" command
+ *
+ * Writing executes a sequence of commands back to back, without the host having to wait for the
+ * task to re-arm the SPI receive between each of them. Responses are collected in a ring buffer,
+ * which is drained by reading the command.
+ */
+struct Batch {
+    /// Size of the response ring (bytes)
+    constexpr static const size_t kResponseRingSize{1024};
+    /// Size of the batch response header (bytes)
+    constexpr static const size_t kHeaderSize{offsetof(Response::Batch, records)};
+    /// Size of a response record header (bytes)
+    constexpr static const size_t kRecordHeaderSize{offsetof(Response::BatchRecord, data)};
+    /**
+     * @brief Maximum response payload of a single command (bytes)
+     *
+     * A record must be able to be drained by a single read of the command, which is limited to
+     * the maximum payload size of the host interface.
+     */
+    constexpr static const size_t kMaxRecordPayload{etl::min(
+            Task::kMaxPayloadSize - kHeaderSize - kRecordHeaderSize,
+            static_cast<size_t>(UINT8_MAX))};
+
+    /// Responses of executed commands (a sequence of BatchRecord)
+    static etl::circular_buffer<uint8_t, kResponseRingSize> gResponses;
+    /// Scratch buffer for commands producing a response
+    static etl::array<uint8_t, Task::kMaxPayloadSize> gScratch;
+    /// Number of bytes (from the head of the response ring) returned by the last read
+    static size_t gNumRead;
+
+    /**
+     * @brief Get the number of bytes pending in the response ring
+     */
+    static inline size_t GetPendingBytes() {
+        return gResponses.size();
+    }
+
+    /**
+     * @brief Handle a read by the host
+     *
+     * Copy out as many complete records from the response ring as fit in the requested length.
+     * They're only removed from the ring once the host has read the whole response.
+     */
+    static int DoRead(const uint8_t, const size_t requested, etl::span<uint8_t> outBuffer) {
+        // validate
+        const auto toReply = etl::min(requested, outBuffer.size());
+        if(toReply < kHeaderSize) {
+            return -1;
+        }
+
+        memset(outBuffer.data(), 0, toReply);
+
+        // copy whole records
+        size_t offset{kHeaderSize}, numBytes{0};
+        uint8_t numRecords{0};
+
+        taskENTER_CRITICAL();
+        while(numBytes < gResponses.size() && numRecords < UINT8_MAX) {
+            const size_t recordSize = kRecordHeaderSize + gResponses[numBytes + 2];
+            if(offset + recordSize > toReply) {
+                break;
+            }
+
+            for(size_t i = 0; i < recordSize; i++) {
+                outBuffer[offset++] = gResponses[numBytes++];
+            }
+
+            numRecords++;
+        }
+
+        // fill in the header
+        Response::Batch hdr{
+            .bytesRemaining = static_cast<uint16_t>(gResponses.size() - numBytes),
+            .numRecords = numRecords,
+        };
+        taskEXIT_CRITICAL();
+
+        memcpy(outBuffer.data(), &hdr, kHeaderSize);
+
+        // remember what was read, to remove it later
+        gNumRead = numBytes;
+
+        return toReply;
+    }
+
+    /**
+     * @brief Remove records read by the host
+     *
+     * If the read failed, the records remain in the ring, and will be returned again.
+     */
+    static void PostRead(const uint8_t, const bool success) {
+        if(success) {
+            taskENTER_CRITICAL();
+            for(size_t i = 0; i < gNumRead && !gResponses.empty(); i++) {
+                gResponses.pop();
+            }
+            taskEXIT_CRITICAL();
+        }
+
+        gNumRead = 0;
+    }
+
+    /**
+     * @brief Handle a write from the host
+     *
+     * Parse the batch and execute each of the contained commands in sequence.
+     *
+     * @return 0 on success, -1 if the batch is malformed, -2 if the response ring overflowed, or
+     *         -3 if any of the contained commands failed.
+     */
+    static int DoWrite(const uint8_t, etl::span<const uint8_t> payload) {
+        size_t offset{0}, numCommands{0};
+        bool anyFailed{false};
+
+        while(offset < payload.size()) {
+            // read the command header
+            if(payload.size() - offset < sizeof(CommandHeader)) {
+                Logger::Warning(Logger::Module::HostIf, "%s: truncated %s at %u", "Batch", "header",
+                        offset);
+                return -1;
+            }
+
+            CommandHeader hdr;
+            memcpy(&hdr, payload.data() + offset, sizeof(hdr));
+            offset += sizeof(hdr);
+
+            const bool isRead = (hdr.command & 0x80);
+            const uint8_t cmd = (hdr.command & ~0x80);
+
+            // get the payload (writes) or response length (reads)
+            etl::span<const uint8_t> cmdPayload;
+            size_t responseBytes{0};
+
+            if(isRead) {
+                responseBytes = etl::min(static_cast<size_t>(hdr.payloadLength),
+                        kMaxRecordPayload);
+            } else {
+                if(payload.size() - offset < hdr.payloadLength) {
+                    Logger::Warning(Logger::Module::HostIf, "%s: truncated %s at %u", "Batch",
+                            "payload", offset);
+                    return -1;
+                }
+
+                cmdPayload = payload.subspan(offset, hdr.payloadLength);
+                offset += hdr.payloadLength;
+            }
+
+            // ensure the response fits before executing (commands may have side effects)
+            if(gResponses.available() < kRecordHeaderSize + responseBytes) {
+                Logger::Warning(Logger::Module::HostIf,
+                        "%s: response ring full (%u commands executed)", "Batch", numCommands);
+                return -2;
+            }
+
+            const auto ret = Task::ExecuteInline(cmd, isRead, cmdPayload,
+                    {gScratch.data(), responseBytes});
+            const auto resultBytes = (ret > 0) ? static_cast<size_t>(ret) : 0;
+
+            anyFailed |= (ret < 0);
+            numCommands++;
+
+            // store the response record
+            taskENTER_CRITICAL();
+            gResponses.push(hdr.command);
+            gResponses.push(static_cast<uint8_t>((ret < 0) ?
+                        etl::max(ret, static_cast<int>(INT8_MIN)) : 0));
+            gResponses.push(static_cast<uint8_t>(resultBytes));
+
+            for(size_t i = 0; i < resultBytes; i++) {
+                gResponses.push(gScratch[i]);
+            }
+            taskEXIT_CRITICAL();
+        }
+
+        Logger::Trace(Logger::Module::HostIf, "%s: executed %u commands, %u bytes pending", "Batch",
+                numCommands, gResponses.size());
+
+        return anyFailed ? -3 : 0;
+    }
+};
+
+inline etl::circular_buffer<uint8_t, Batch::kResponseRingSize> Batch::gResponses;
+inline etl::array<uint8_t, Task::kMaxPayloadSize> Batch::gScratch;
+inline size_t Batch::gNumRead{0};
+}
+
+#endif
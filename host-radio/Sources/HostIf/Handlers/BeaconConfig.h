@@ -3,8 +3,9 @@
 
 #include <etl/span.h>
 
+#include <BlazeNet/HostIf/Commands.h>
+
 #include "BlazeNet/Beacon.h"
-#include "HostIf/Commands.h"
 
 namespace HostIf::Handlers {
 /**
@@ -31,11 +32,16 @@ struct BeaconConfig {
 
         // update general variables
         if(req->updateConfig) {
+            // the timer can't expire more often than every tick
+            if(!pdMS_TO_TICKS(req->interval)) {
+                return -1;
+            }
+
             BlazeNet::Beacon::SetEnabled(!!req->enabled);
             BlazeNet::Beacon::SetInterval(req->interval);
 
-            Logger::Notice("%s: %s, interval=%u ms", "BeaconConfig", req->enabled ? "on" : "off",
-                    req->interval);
+            Logger::Notice(Logger::Module::Beacon, "%s: %s, interval=%u ms", "BeaconConfig",
+                    req->enabled ? "on" : "off", req->interval);
         }
 
         // update the packet payload if specified
@@ -44,9 +50,10 @@ struct BeaconConfig {
             err = BlazeNet::Beacon::SetPayload(packetPayload);
 
             if(err) {
-                Logger::Warning("%s failed: %u", "Beacon::SetPayload", err);
+                Logger::Warning(Logger::Module::Beacon, "%s failed: %u", "Beacon::SetPayload", err);
             } else {
-                Logger::Notice("%s: payloadLength=%u", "BeaconConfig", packetPayload.size());
+                Logger::Notice(Logger::Module::Beacon, "%s: payloadLength=%u", "BeaconConfig",
+                        packetPayload.size());
             }
         }
 
@@ -0,0 +1,34 @@
+#ifndef HOSTIF_HANDLERS_GETFSSTATS_H
+#define HOSTIF_HANDLERS_GETFSSTATS_H
+
+#include <etl/span.h>
+
+#include <BlazeNet/HostIf/Commands.h>
+
+#include "Fs/NorFs.h"
+
+namespace HostIf::Handlers {
+/**
+ * @brief Process a "GetFsStats" command
+ *
+ * Read out the filesystem's cache counters.
+ */
+struct GetFsStats {
+    /**
+     * @brief Handle a read by the host
+     */
+    static int DoRead(const uint8_t, const size_t requested, etl::span<uint8_t> outBuffer) {
+        // validate
+        if(requested < sizeof(Response::GetFsStats)) {
+            return -1;
+        }
+
+        auto res = reinterpret_cast<Response::GetFsStats *>(outBuffer.data());
+        Fs::NorFs::ReadStats(*res);
+
+        return requested;
+    }
+};
+}
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef HOSTIF_HANDLERS_GETHEAPSTATS_H
+#define HOSTIF_HANDLERS_GETHEAPSTATS_H
+
+#include <etl/span.h>
+
+#include <BlazeNet/HostIf/Commands.h>
+
+#include "Rtos/Heap.h"
+
+namespace HostIf::Handlers {
+/**
+ * @brief Process a "GetHeapStats" command
+ *
+ * Read out heap usage, fragmentation and per class allocation counters.
+ */
+struct GetHeapStats {
+    /**
+     * @brief Handle a read by the host
+     */
+    static int DoRead(const uint8_t, const size_t requested, etl::span<uint8_t> outBuffer) {
+        // validate
+        if(requested < sizeof(Response::GetHeapStats)) {
+            return -1;
+        }
+
+        auto res = reinterpret_cast<Response::GetHeapStats *>(outBuffer.data());
+        Rtos::Heap::Read(*res);
+
+        return requested;
+    }
+};
+}
+
+#endif
@@ -5,8 +5,9 @@
 #include <etl/span.h>
 #include <etl/utility.h>
 
+#include <BlazeNet/HostIf/Commands.h>
+
 #include "BuildInfo.h"
-#include "HostIf/Commands.h"
 #include "Hw/Identity.h"
 
 namespace HostIf::Handlers {
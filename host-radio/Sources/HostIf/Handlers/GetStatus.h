@@ -4,7 +4,8 @@
 #include <string.h>
 #include <etl/span.h>
 
-#include "HostIf/Commands.h"
+#include <BlazeNet/HostIf/Commands.h>
+
 #include "HostIf/IrqManager.h"
 #include "HostIf/Task.h"
 #include "Packet/Handler.h"
@@ -0,0 +1,66 @@
+#ifndef HOSTIF_HANDLERS_GETTASKSTATS_H
+#define HOSTIF_HANDLERS_GETTASKSTATS_H
+
+#include <string.h>
+#include <etl/algorithm.h>
+#include <etl/array.h>
+#include <etl/span.h>
+
+#include <BlazeNet/HostIf/Commands.h>
+
+#include "Rtos/TaskStats.h"
+
+namespace HostIf::Handlers {
+/**
+ * @brief Process a "GetTaskStats" command
+ *
+ * Report each task's CPU time since the last successful read, as well as its priority and stack
+ * usage.
+ */
+struct GetTaskStats {
+    /// Header size of the response
+    constexpr static const size_t kHeaderSize{offsetof(Response::GetTaskStats, tasks)};
+    /// Maximum number of tasks returned in one read
+    constexpr static const size_t kMaxTasks{etl::min((UINT8_MAX - kHeaderSize) /
+        sizeof(Response::TaskInfo), Rtos::TaskStats::kMaxTasks)};
+
+    /**
+     * @brief Handle a read by the host
+     */
+    static int DoRead(const uint8_t, const size_t requested, etl::span<uint8_t> outBuffer) {
+        etl::array<Response::TaskInfo, kMaxTasks> tasks;
+
+        // validate
+        const auto toReply = etl::min(requested, outBuffer.size());
+        if(toReply < kHeaderSize) {
+            return -1;
+        }
+
+        memset(outBuffer.data(), 0, toReply);
+
+        // take report
+        const auto maxTasks = etl::min((toReply - kHeaderSize) / sizeof(Response::TaskInfo),
+                tasks.size());
+
+        Response::GetTaskStats hdr{};
+        const auto numTasks = Rtos::TaskStats::Read(hdr, {tasks.data(), maxTasks});
+
+        memcpy(outBuffer.data(), &hdr, kHeaderSize);
+        memcpy(outBuffer.data() + kHeaderSize, tasks.data(),
+                numTasks * sizeof(Response::TaskInfo));
+
+        return toReply;
+    }
+
+    /**
+     * @brief Start a new interval once the host has read the report
+     */
+    static void PostRead(const uint8_t, const bool success) {
+        if(success) {
+            Rtos::TaskStats::Commit();
+        }
+    }
+};
+}
+
+#endif
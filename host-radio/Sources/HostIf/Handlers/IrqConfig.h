@@ -3,7 +3,8 @@
 
 #include <etl/span.h>
 
-#include "HostIf/Commands.h"
+#include <BlazeNet/HostIf/Commands.h>
+
 #include "HostIf/IrqManager.h"
 
 namespace HostIf::Handlers {
@@ -34,6 +35,8 @@ struct IrqConfig {
         res->rxQueueNotEmpty = TestFlags(mask & Interrupt::PacketReceived);
         res->txPacket = TestFlags(mask & Interrupt::PacketTransmitted);
         res->txQueueEmpty = TestFlags(mask & Interrupt::TxQueueEmpty);
+        res->eventPending = TestFlags(mask & Interrupt::EventPending);
+        res->logPending = TestFlags(mask & Interrupt::LogPending);
 
         // success
         return sizeof(*res);
@@ -67,8 +70,15 @@ struct IrqConfig {
         if(req->txQueueEmpty) {
             newMask |= Interrupt::TxQueueEmpty;
         }
+        if(req->eventPending) {
+            newMask |= Interrupt::EventPending;
+        }
+        if(req->logPending) {
+            newMask |= Interrupt::LogPending;
+        }
 
-        Logger::Notice("IrqConfig: mask=%08x", static_cast<uintptr_t>(newMask));
+        Logger::Notice(Logger::Module::HostIf, "IrqConfig: mask=%08x",
+                static_cast<uintptr_t>(newMask));
 
         // update it
         IrqManager::SetMask(newMask);
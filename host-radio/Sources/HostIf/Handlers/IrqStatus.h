@@ -3,7 +3,8 @@
 
 #include <etl/span.h>
 
-#include "HostIf/Commands.h"
+#include <BlazeNet/HostIf/Commands.h>
+
 #include "HostIf/IrqManager.h"
 #include "Rtos/Rtos.h"
 
@@ -39,6 +40,8 @@ struct IrqStatus {
         temp.rxQueueNotEmpty = TestFlags(pending & Interrupt::PacketReceived);
         temp.txPacket = TestFlags(pending & Interrupt::PacketTransmitted);
         temp.txQueueEmpty = TestFlags(pending & Interrupt::TxQueueEmpty);
+        temp.eventPending = TestFlags(pending & Interrupt::EventPending);
+        temp.logPending = TestFlags(pending & Interrupt::LogPending);
 
         // secrete it
         const auto actualBytes = etl::min(requested, sizeof(temp));
@@ -0,0 +1,71 @@
+#ifndef HOSTIF_HANDLERS_LOGLEVELS_H
+#define HOSTIF_HANDLERS_LOGLEVELS_H
+
+#include <etl/algorithm.h>
+#include <etl/span.h>
+
+#include <BlazeNet/HostIf/Commands.h>
+
+#include "Log/Logger.h"
+
+namespace HostIf::Handlers {
+/**
+ * @brief Process a "LogLevels" command
+ *
+ * Reads or updates the per module log level thresholds.
+ */
+struct LogLevels {
+    /**
+     * @brief Handle a read by the host
+     *
+     * Returns the current threshold of each module.
+     */
+    static int DoRead(const uint8_t, const size_t requested, etl::span<uint8_t> outBuffer) {
+        // validate
+        if(requested < sizeof(Response::LogLevels)) {
+            return -1;
+        }
+
+        auto res = reinterpret_cast<Response::LogLevels *>(outBuffer.data());
+        for(size_t i = 0; i < Logger::kNumModules; i++) {
+            res->levels[i] = static_cast<uint8_t>(Logger::GetLevel(
+                        static_cast<Logger::Module>(i)));
+        }
+
+        return sizeof(*res);
+    }
+
+    /**
+     * @brief Handle a write from the host
+     *
+     * Update the threshold of each module given with a nonzero level. The payload may be shorter
+     * than the full table, to allow for modules added later.
+     */
+    static int DoWrite(const uint8_t, etl::span<const uint8_t> payload) {
+        using Level = Logger::Level;
+
+        const auto count = etl::min(payload.size(), Logger::kNumModules);
+
+        // validate all levels before applying any
+        for(size_t i = 0; i < count; i++) {
+            if(payload[i] > static_cast<uint8_t>(Level::Error)) {
+                return -1;
+            }
+        }
+
+        for(size_t i = 0; i < count; i++) {
+            if(!payload[i]) {
+                continue;
+            }
+
+            Logger::SetLevel(static_cast<Logger::Module>(i), static_cast<Level>(payload[i]));
+        }
+
+        Logger::Notice(Logger::Module::HostIf, "LogLevels: %u modules updated",
+                static_cast<unsigned int>(count));
+        return 0;
+    }
+};
+}
+
+#endif
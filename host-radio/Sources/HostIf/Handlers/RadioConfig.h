@@ -5,7 +5,8 @@
 #include <etl/span.h>
 #include <etl/utility.h>
 
-#include "HostIf/Commands.h"
+#include <BlazeNet/HostIf/Commands.h>
+
 #include "Log/Logger.h"
 #include "Radio/Task.h"
 
@@ -34,26 +35,28 @@ struct RadioConfig {
         // update channel
         err = Radio::Task::SetChannel(req->channel);
         if(err) {
-            Logger::Warning("%s failed: %d", "RadioConfig set channel", err);
+            Logger::Warning(Logger::Module::HostIf, "%s failed: %d", "RadioConfig set channel",
+                    err);
             return err;
         }
 
         // update TX power
         err = Radio::Task::SetTxPower(req->txPower);
         if(err) {
-            Logger::Warning("%s failed: %d", "RadioConfig set power", err);
+            Logger::Warning(Logger::Module::HostIf, "%s failed: %d", "RadioConfig set power", err);
             return err;
         }
 
         // update our short MAC address
         err = Radio::Task::SetAddress(req->myAddress);
         if(err) {
-            Logger::Warning("%s failed: %d", "RadioConfig set address", err);
+            Logger::Warning(Logger::Module::HostIf, "%s failed: %d", "RadioConfig set address",
+                    err);
             return err;
         }
 
-        Logger::Debug("RadioConfig: ch=%u, txpwr=%d, addr=$%04x", req->channel, req->txPower,
-                req->myAddress);
+        Logger::Debug(Logger::Module::HostIf, "RadioConfig: ch=%u, txpwr=%d, addr=$%04x",
+                req->channel, req->txPower, req->myAddress);
 
         return 0;
     }
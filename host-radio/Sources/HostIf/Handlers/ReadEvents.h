@@ -0,0 +1,90 @@
+#ifndef HOSTIF_HANDLERS_READEVENTS_H
+#define HOSTIF_HANDLERS_READEVENTS_H
+
+#include <string.h>
+#include <etl/array.h>
+#include <etl/span.h>
+
+#include <BlazeNet/HostIf/Commands.h>
+
+#include "HostIf/EventRing.h"
+
+namespace HostIf::Handlers {
+/**
+ * @brief Process a "ReadEvents" command
+ *
+ * Read out as many events from the event ring as fit. They're only removed from the ring once the
+ * host has read the whole response.
+ */
+struct ReadEvents {
+    /// Header size of the response
+    constexpr static const size_t kHeaderSize{offsetof(Response::ReadEvents, events)};
+    /// Maximum number of events returned in one read
+    constexpr static const size_t kMaxEvents{(UINT8_MAX - kHeaderSize) /
+        sizeof(Response::Event)};
+
+    /// Number of events returned by the last read
+    static size_t gNumRead;
+    /// Number of lost events reported by the last read
+    static uint16_t gLostReported;
+
+    /**
+     * @brief Handle a read by the host
+     */
+    static int DoRead(const uint8_t, const size_t requested, etl::span<uint8_t> outBuffer) {
+        etl::array<Response::Event, kMaxEvents> events;
+
+        // validate
+        const auto toReply = etl::min(requested, outBuffer.size());
+        if(toReply < kHeaderSize) {
+            return -1;
+        }
+
+        memset(outBuffer.data(), 0, toReply);
+
+        // copy out events
+        const auto maxEvents = etl::min((toReply - kHeaderSize) / sizeof(Response::Event),
+                events.size());
+
+        uint16_t lost;
+        const auto numEvents = EventRing::Peek({events.data(), maxEvents}, lost);
+        const auto remaining = EventRing::GetPending() - numEvents;
+
+        Response::ReadEvents hdr{
+            .eventsLost = lost,
+            .numEvents = static_cast<uint8_t>(numEvents),
+            .eventsRemaining = static_cast<uint8_t>(etl::min(remaining,
+                        static_cast<size_t>(UINT8_MAX))),
+        };
+
+        memcpy(outBuffer.data(), &hdr, kHeaderSize);
+        memcpy(outBuffer.data() + kHeaderSize, events.data(),
+                numEvents * sizeof(Response::Event));
+
+        // remember what was read, to remove it later
+        gNumRead = numEvents;
+        gLostReported = lost;
+
+        return toReply;
+    }
+
+    /**
+     * @brief Remove events read by the host
+     *
+     * If the read failed, the events remain in the ring, and will be returned again.
+     */
+    static void PostRead(const uint8_t, const bool success) {
+        if(success) {
+            EventRing::Consume(gNumRead, gLostReported);
+        }
+
+        gNumRead = 0;
+        gLostReported = 0;
+    }
+};
+
+inline size_t ReadEvents::gNumRead{0};
+inline uint16_t ReadEvents::gLostReported{0};
+}
+
+#endif
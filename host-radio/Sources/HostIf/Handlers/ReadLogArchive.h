@@ -0,0 +1,95 @@
+#ifndef HOSTIF_HANDLERS_READLOGARCHIVE_H
+#define HOSTIF_HANDLERS_READLOGARCHIVE_H
+
+#include <string.h>
+#include <etl/algorithm.h>
+#include <etl/span.h>
+
+#include <BlazeNet/HostIf/Commands.h>
+
+#include "Log/Archive.h"
+#include "Log/Logger.h"
+
+namespace HostIf::Handlers {
+/**
+ * @brief Process a "ReadLogArchive" command
+ *
+ * Reads out the persistent log archive in chunks. The read position only advances once the host
+ * has read the whole response.
+ */
+struct ReadLogArchive {
+    /// Header size of the response
+    constexpr static const size_t kHeaderSize{offsetof(Response::ReadLogArchive, data)};
+
+    /**
+     * @brief Handle a read by the host
+     */
+    static int DoRead(const uint8_t, const size_t requested, etl::span<uint8_t> outBuffer) {
+        // validate
+        const auto toReply = etl::min(requested, outBuffer.size());
+        if(toReply < kHeaderSize) {
+            return -1;
+        }
+
+        memset(outBuffer.data(), 0, toReply);
+
+        Response::ReadLogArchive hdr{};
+        hdr.end = 1;
+        hdr.unavailable = 1;
+
+        // copy out as much archive data as fits
+        if constexpr(Logger::kEnableArchive) {
+            if(Log::Archive::IsEnabled()) {
+                bool isEnd;
+                const auto read = Log::Archive::Read(outBuffer.subspan(kHeaderSize,
+                            toReply - kHeaderSize), isEnd);
+
+                hdr.length = static_cast<uint8_t>(read);
+                hdr.end = isEnd ? 1 : 0;
+                hdr.unavailable = 0;
+                hdr.dropped = Log::Archive::GetDropped();
+            }
+        }
+
+        memcpy(outBuffer.data(), &hdr, kHeaderSize);
+
+        return toReply;
+    }
+
+    /**
+     * @brief Advance the read position past the data read by the host
+     *
+     * If the read failed, the same data is returned again by the next read.
+     */
+    static void PostRead(const uint8_t, const bool success) {
+        if constexpr(Logger::kEnableArchive) {
+            if(success && Log::Archive::IsEnabled()) {
+                Log::Archive::CommitRead();
+            }
+        }
+    }
+
+    /**
+     * @brief Handle a write from the host
+     *
+     * Rewinds the read position, if requested.
+     */
+    static int DoWrite(const uint8_t, etl::span<const uint8_t> payload) {
+        if(payload.size() < sizeof(Request::ReadLogArchive)) {
+            return -1;
+        }
+
+        auto req = reinterpret_cast<const Request::ReadLogArchive *>(payload.data());
+
+        if constexpr(Logger::kEnableArchive) {
+            if(req->rewind) {
+                Log::Archive::Rewind();
+            }
+        }
+
+        return 0;
+    }
+};
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef HOSTIF_HANDLERS_READLOGS_H
+#define HOSTIF_HANDLERS_READLOGS_H
+
+#include <string.h>
+#include <etl/algorithm.h>
+#include <etl/span.h>
+
+#include <BlazeNet/HostIf/Commands.h>
+
+#include "HostIf/LogRing.h"
+
+namespace HostIf::Handlers {
+/**
+ * @brief Process a "ReadLogs" command
+ *
+ * Read out as much data from the host log ring as fits. It's only removed from the ring once the
+ * host has read the whole response.
+ */
+struct ReadLogs {
+    /// Header size of the response
+    constexpr static const size_t kHeaderSize{offsetof(Response::ReadLogs, data)};
+
+    /// Number of bytes returned by the last read
+    static size_t gNumRead;
+    /// Number of dropped records reported by the last read
+    static uint16_t gDroppedReported;
+
+    /**
+     * @brief Handle a read by the host
+     */
+    static int DoRead(const uint8_t, const size_t requested, etl::span<uint8_t> outBuffer) {
+        // validate
+        const auto toReply = etl::min(requested, outBuffer.size());
+        if(toReply < kHeaderSize) {
+            return -1;
+        }
+
+        memset(outBuffer.data(), 0, toReply);
+
+        // copy out log data
+        uint16_t dropped;
+        const auto numBytes = LogRing::Peek(outBuffer.subspan(kHeaderSize,
+                    etl::min(toReply - kHeaderSize, static_cast<size_t>(UINT8_MAX))), dropped);
+        const auto remaining = LogRing::GetPending() - numBytes;
+
+        Response::ReadLogs hdr{
+            .dropped = dropped,
+            .length = static_cast<uint8_t>(numBytes),
+            .remaining = static_cast<uint16_t>(etl::min(remaining,
+                        static_cast<size_t>(UINT16_MAX))),
+        };
+
+        memcpy(outBuffer.data(), &hdr, kHeaderSize);
+
+        // remember what was read, to remove it later
+        gNumRead = numBytes;
+        gDroppedReported = dropped;
+
+        return toReply;
+    }
+
+    /**
+     * @brief Remove data read by the host
+     *
+     * If the read failed, the data remains in the ring, and will be returned again.
+     */
+    static void PostRead(const uint8_t, const bool success) {
+        if(success) {
+            LogRing::Consume(gNumRead, gDroppedReported);
+        }
+
+        gNumRead = 0;
+        gDroppedReported = 0;
+    }
+};
+
+inline size_t ReadLogs::gNumRead{0};
+inline uint16_t ReadLogs::gDroppedReported{0};
+}
+
+#endif
@@ -4,7 +4,8 @@
 #include <string.h>
 #include <etl/span.h>
 
-#include "HostIf/Commands.h"
+#include <BlazeNet/HostIf/Commands.h>
+
 #include "Packet/Handler.h"
 
 namespace HostIf::Handlers {
@@ -14,6 +15,7 @@ namespace HostIf::Handlers {
  * Read out the topmost packet on the receive queue.
  */
 struct ReadPacket {
+    /// Packet being read out (released by the post-read routine)
     static Packet::Handler::RxPacketBuffer *gPbuf;
 
     /**
@@ -28,6 +30,11 @@ struct ReadPacket {
 
         // get the packet
         auto pbuf = Packet::Handler::PopRxQueue();
+        gPbuf = pbuf;
+
+        if(!pbuf) {
+            return -1;
+        }
 
         // build the header of the struct
         const auto actualNum = etl::min(requested, sizeof(temp) + pbuf->packetSize);
@@ -41,9 +48,6 @@ struct ReadPacket {
             memcpy(outBuffer.data() + sizeof(temp), pbuf->data, actualNum - sizeof(temp));
         }
 
-        // store packet for releasing later
-        gPbuf = pbuf;
-
         return actualNum;
     }
 
@@ -56,11 +60,14 @@ struct ReadPacket {
      * @param success Whether the command completed successfully (i.e. the entire packet was read)
      */
     static void PostRead(const uint8_t, const bool success) {
-        Packet::Handler::DiscardRxPacket(gPbuf, success);
+        if(gPbuf) {
+            Packet::Handler::DiscardRxPacket(gPbuf, success);
+            gPbuf = nullptr;
+        }
     }
 };
 
-Packet::Handler::RxPacketBuffer *ReadPacket::gPbuf{nullptr};
+inline Packet::Handler::RxPacketBuffer *ReadPacket::gPbuf{nullptr};
 }
 
 #endif
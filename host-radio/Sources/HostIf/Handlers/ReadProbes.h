@@ -0,0 +1,51 @@
+#ifndef HOSTIF_HANDLERS_READPROBES_H
+#define HOSTIF_HANDLERS_READPROBES_H
+
+#include <string.h>
+#include <etl/algorithm.h>
+#include <etl/span.h>
+
+#include <BlazeNet/HostIf/Commands.h>
+
+#include "Debug/Probes.h"
+
+namespace HostIf::Handlers {
+/**
+ * @brief Process a "ReadProbes" command
+ *
+ * Read out the profiling probe table. The probes are reset once the host has read the whole
+ * response; measurements completed in between are lost.
+ */
+struct ReadProbes {
+    /**
+     * @brief Handle a read by the host
+     *
+     * Short reads are allowed: they return only the first probes.
+     */
+    static int DoRead(const uint8_t, const size_t requested, etl::span<uint8_t> outBuffer) {
+        Response::ReadProbes res;
+
+        // validate
+        const auto toReply = etl::min(etl::min(requested, outBuffer.size()), sizeof(res));
+        if(toReply < offsetof(Response::ReadProbes, probes)) {
+            return -1;
+        }
+
+        Debug::Probes::Read(res);
+        memcpy(outBuffer.data(), &res, toReply);
+
+        return toReply;
+    }
+
+    /**
+     * @brief Reset the probes once the host has read them
+     */
+    static void PostRead(const uint8_t, const bool success) {
+        if(success) {
+            Debug::Probes::Reset();
+        }
+    }
+};
+}
+
+#endif
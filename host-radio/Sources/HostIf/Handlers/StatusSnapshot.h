@@ -0,0 +1,136 @@
+#ifndef HOSTIF_HANDLERS_STATUSSNAPSHOT_H
+#define HOSTIF_HANDLERS_STATUSSNAPSHOT_H
+
+#include <string.h>
+#include <etl/span.h>
+
+#include <BlazeNet/HostIf/Commands.h>
+
+#include "HostIf/Handlers/Batch.h"
+#include "HostIf/EventRing.h"
+#include "HostIf/IrqManager.h"
+#include "HostIf/Task.h"
+#include "Log/Logger.h"
+#include "Packet/Handler.h"
+#include "Radio/Task.h"
+#include "Rtos/Rtos.h"
+
+namespace HostIf::Handlers {
+/**
+ * @brief Process a "StatusSnapshot" command
+ *
+ * Reads the interrupt state, status register and queue state all at once; optionally the
+ * reported interrupts are acknowledged once the host has read the snapshot.
+ */
+struct StatusSnapshot {
+    /// Acknowledge reported interrupts after a successful read
+    static bool gAckOnRead;
+    /// Interrupts reported in the last snapshot
+    static Interrupt gReported;
+    /// Whether the last snapshot reported a command error
+    static bool gReportedError;
+
+    /**
+     * @brief Handle a read by the host
+     *
+     * Assemble the snapshot; all state is captured inside a single critical section so the
+     * individual fields are consistent with one another.
+     */
+    static int DoRead(const uint8_t, const size_t requested, etl::span<uint8_t> outBuffer) {
+        Response::StatusSnapshot temp;
+
+        taskENTER_CRITICAL();
+
+        // interrupt state
+        const auto pending = IrqManager::GetPending();
+        const auto mask = IrqManager::GetMask();
+
+        temp.irqPending.commandError = TestFlags(pending & Interrupt::CommandError);
+        temp.irqPending.rxQueueNotEmpty = TestFlags(pending & Interrupt::PacketReceived);
+        temp.irqPending.txPacket = TestFlags(pending & Interrupt::PacketTransmitted);
+        temp.irqPending.txQueueEmpty = TestFlags(pending & Interrupt::TxQueueEmpty);
+        temp.irqPending.eventPending = TestFlags(pending & Interrupt::EventPending);
+        temp.irqPending.logPending = TestFlags(pending & Interrupt::LogPending);
+
+        temp.irqMask.commandError = TestFlags(mask & Interrupt::CommandError);
+        temp.irqMask.rxQueueNotEmpty = TestFlags(mask & Interrupt::PacketReceived);
+        temp.irqMask.txPacket = TestFlags(mask & Interrupt::PacketTransmitted);
+        temp.irqMask.txQueueEmpty = TestFlags(mask & Interrupt::TxQueueEmpty);
+        temp.irqMask.eventPending = TestFlags(mask & Interrupt::EventPending);
+        temp.irqMask.logPending = TestFlags(mask & Interrupt::LogPending);
+
+        // status register (same as GetStatus, but the error flag is left alone)
+        temp.status.cmdSuccess = !Task::gErrorFlag;
+        temp.status.radioActive = Radio::Task::IsActive();
+
+        temp.status.rxQueueNotEmpty = !Packet::Handler::GetRxEmptyFlag();
+        temp.status.rxQueueFull = Packet::Handler::GetRxFullFlag();
+        temp.status.rxQueueOverflow = Packet::Handler::GetRxOverflowFlag();
+
+        temp.status.txQueueEmpty = Packet::Handler::GetTxEmptyFlag();
+        temp.status.txQueueOverflow = Packet::Handler::GetTxOverflowFlag();
+
+        // queues and timestamp
+        Packet::Handler::ReadSnapshot(&temp);
+        temp.currentTicks = xTaskGetTickCount();
+        temp.batchResponseBytes = Batch::GetPendingBytes();
+        temp.eventsPending = etl::min(EventRing::GetPending(), static_cast<size_t>(UINT8_MAX));
+
+        // remember what we reported, for acknowledging later
+        gReported = pending;
+        gReportedError = Task::gErrorFlag;
+
+        taskEXIT_CRITICAL();
+
+        // copy out the correct amount
+        const auto actualNum = etl::min(requested, sizeof(temp));
+        memcpy(outBuffer.data(), &temp, actualNum);
+        return actualNum;
+    }
+
+    /**
+     * @brief Acknowledge reported interrupts
+     *
+     * If requested, acknowledge the interrupts that were reported in the snapshot the host just
+     * finished reading. Nothing is acknowledged if the read failed, so no events get lost.
+     */
+    static void PostRead(const uint8_t, const bool success) {
+        if(!success || !gAckOnRead) {
+            return;
+        }
+
+        IrqManager::Acknowledge(gReported);
+        if(gReportedError) {
+            Task::gErrorFlag = false;
+        }
+
+        gReported = Interrupt::None;
+        gReportedError = false;
+    }
+
+    /**
+     * @brief Handle a write from the host
+     *
+     * Update the snapshot read options.
+     */
+    static int DoWrite(const uint8_t, etl::span<const uint8_t> payload) {
+        // validate payload
+        if(payload.size() < sizeof(Request::StatusSnapshot)) {
+            return -1;
+        }
+
+        auto req = reinterpret_cast<const Request::StatusSnapshot *>(payload.data());
+        gAckOnRead = !!req->ackOnRead;
+
+        Logger::Notice(Logger::Module::HostIf, "StatusSnapshot: ack on read=%u",
+                gAckOnRead ? 1 : 0);
+        return 0;
+    }
+};
+
+inline bool StatusSnapshot::gAckOnRead{false};
+inline Interrupt StatusSnapshot::gReported{Interrupt::None};
+inline bool StatusSnapshot::gReportedError{false};
+}
+
+#endif
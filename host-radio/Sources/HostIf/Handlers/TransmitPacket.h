@@ -3,7 +3,8 @@
 
 #include <etl/span.h>
 
-#include "HostIf/Commands.h"
+#include <BlazeNet/HostIf/Commands.h>
+
 #include "Packet/Handler.h"
 
 namespace HostIf::Handlers {
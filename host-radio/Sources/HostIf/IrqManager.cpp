@@ -68,11 +68,10 @@ void IrqManager::Update() {
 
     taskEXIT_CRITICAL();
 
-    // optional logging later
-    if(changed) {
-        if(kLogChanges) {
-            Logger::Notice("IRQ: %08x -> %08x", prev, result);
-        }
+    // optional logging later; not for changes to LogPending alone, as the message would itself
+    // land in the host log ring, and keep it from ever draining
+    if(changed && TestFlags((prev ^ result) & ~Interrupt::LogPending)) {
+        Logger::Trace(Logger::Module::HostIf, "IRQ: %08x -> %08x", prev, result);
     }
 }
 
@@ -44,6 +44,25 @@ enum class Interrupt: uintptr_t {
      * Set: All pending packets are transmitted
      */
     TxQueueEmpty                                = (1 << 3),
+
+    /**
+     * @brief Event pending
+     *
+     * Set: The event ring is not empty
+     *
+     * This reflects a condition rather than an edge: it can't be acknowledged by the host, and is
+     * instead deasserted by the event ring once it's been drained.
+     */
+    EventPending                                = (1 << 4),
+    /**
+     * @brief Log records pending
+     *
+     * Set: The host log ring is not empty
+     *
+     * Like EventPending, this reflects a condition, and is deasserted by the log ring once it's
+     * been drained.
+     */
+    LogPending                                  = (1 << 5),
 };
 ENUM_FLAGS_EX(Interrupt, uintptr_t);
 
@@ -59,8 +78,6 @@ ENUM_FLAGS_EX(Interrupt, uintptr_t);
  */
 class IrqManager {
     private:
-        /// Whether IRQ state changes are logged
-        constexpr static const bool kLogChanges{false};
         /// Does the IRQ line toggle every IRQ change, or is it level activated?
         constexpr static const bool kToggleIrqLine{false};
 
@@ -122,11 +139,23 @@ class IrqManager {
          * @brief Deassert (clear) an interrupt line
          *
          * Marks the specified interrupt lines as being deasserted, and updates the physical
-         * interrupt line.
+         * interrupt line. Condition interrupts (EventPending, LogPending) are left alone.
          *
          * @param which Interrupt line(s) to be deasserted
          */
         static inline void Acknowledge(const Interrupt which) {
+            Deassert(which & ~(Interrupt::EventPending | Interrupt::LogPending));
+        }
+
+        /**
+         * @brief Deassert an interrupt on behalf of its owner
+         *
+         * Like Acknowledge(), but also clears condition interrupts (such as EventPending) which
+         * the host can't acknowledge itself.
+         *
+         * @param which Interrupt line(s) to be deasserted
+         */
+        static inline void Deassert(const Interrupt which) {
             taskENTER_CRITICAL();
             gActive &= ~which;
 
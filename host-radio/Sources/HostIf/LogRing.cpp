@@ -0,0 +1,139 @@
+#include <em_device.h>
+
+#include <etl/algorithm.h>
+
+#include "Rtos/Rtos.h"
+
+#include "IrqManager.h"
+#include "LogRing.h"
+
+using namespace HostIf;
+
+etl::circular_buffer<uint8_t, LogRing::kCapacity> LogRing::gData;
+uint16_t LogRing::gDropped{0};
+
+/**
+ * @brief Assert the log pending interrupt for records written during startup
+ *
+ * Records written before the scheduler was started don't touch the interrupt state; invoke this
+ * once it's running.
+ */
+void LogRing::Start() {
+    if(!gData.empty() || gDropped) {
+        IrqManager::Assert(Interrupt::LogPending);
+    }
+}
+
+/**
+ * @brief Append a record
+ *
+ * @param record Complete binary log record
+ *
+ * @return Whether the record was written; if not, the ring was full, and it was dropped
+ *
+ * @remark Asserting the interrupt may log a message itself, so the caller must be done with the
+ *         record's buffer.
+ *
+ * @remark When invoked from an interrupt, the record is only added to the ring; the interrupt is
+ *         asserted along with the next record written from a task.
+ */
+bool LogRing::Write(etl::span<const uint8_t> record) {
+    bool ok{false};
+
+    if(__get_IPSR()) {
+        const auto saved = taskENTER_CRITICAL_FROM_ISR();
+        ok = Push(record);
+        taskEXIT_CRITICAL_FROM_ISR(saved);
+        return ok;
+    }
+
+    const bool hasScheduler = (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED);
+    if(hasScheduler) {
+        taskENTER_CRITICAL();
+    }
+
+    ok = Push(record);
+
+    if(hasScheduler) {
+        taskEXIT_CRITICAL();
+
+        IrqManager::Assert(Interrupt::LogPending);
+    }
+
+    return ok;
+}
+
+/**
+ * @brief Insert a record into the ring, or count it as dropped if there isn't space
+ *
+ * @remark The caller must ensure exclusive access to the ring.
+ */
+bool LogRing::Push(etl::span<const uint8_t> record) {
+    if(gData.available() >= record.size()) {
+        gData.push(record.begin(), record.end());
+        return true;
+    } else if(gDropped != UINT16_MAX) {
+        gDropped++;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Copy out the oldest data, without removing it
+ *
+ * @param outData Buffer to receive record data
+ * @param outDropped Variable to receive the number of records dropped since the last read
+ *
+ * @return Number of bytes copied
+ */
+size_t LogRing::Peek(etl::span<uint8_t> outData, uint16_t &outDropped) {
+    taskENTER_CRITICAL();
+
+    const auto num = etl::min(outData.size(), gData.size());
+    for(size_t i = 0; i < num; i++) {
+        outData[i] = gData[i];
+    }
+    outDropped = gDropped;
+
+    taskEXIT_CRITICAL();
+
+    return num;
+}
+
+/**
+ * @brief Remove data that was read by the host
+ *
+ * The log pending interrupt is deasserted once the ring is empty and all dropped records have been
+ * reported.
+ *
+ * @param numBytes Number of bytes (from the head of the ring) to remove
+ * @param droppedReported Number of dropped records the host was told about
+ */
+void LogRing::Consume(const size_t numBytes, const uint16_t droppedReported) {
+    taskENTER_CRITICAL();
+
+    for(size_t i = 0; i < numBytes && !gData.empty(); i++) {
+        gData.pop();
+    }
+    gDropped -= etl::min(gDropped, droppedReported);
+
+    const bool drained = gData.empty() && !gDropped;
+
+    taskEXIT_CRITICAL();
+
+    if(!drained) {
+        return;
+    }
+
+    IrqManager::Deassert(Interrupt::LogPending);
+
+    // a record written in the meantime may have asserted the interrupt before it was deasserted
+    taskENTER_CRITICAL();
+    const bool pending = !gData.empty() || gDropped;
+    taskEXIT_CRITICAL();
+
+    if(pending) {
+        IrqManager::Assert(Interrupt::LogPending);
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef HOSTIF_LOGRING_H
+#define HOSTIF_LOGRING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <etl/circular_buffer.h>
+#include <etl/span.h>
+
+namespace HostIf {
+/**
+ * @brief Log records for the host
+ *
+ * The logger appends each message, as a binary record (see Log::Tokenizer), to this ring; the host
+ * reads them out with the ReadLogs command, as a byte stream. This makes logs available on boards
+ * where the log UART isn't connected to anything. The LogPending interrupt is asserted as long as
+ * the ring is not empty.
+ *
+ * When the ring doesn't have space for a record, it's dropped (rather than overwriting older
+ * records, or waiting) and counted; the count is reported to the host with the next read.
+ *
+ * @remark Records may be written from any context, including interrupts and before the scheduler
+ *         is started; they're reported to the host only once the scheduler runs, or a task
+ *         writes a record, respectively.
+ */
+class LogRing {
+    public:
+        /// Size of the ring (bytes)
+        constexpr static const size_t kCapacity{1024};
+
+    public:
+        static void Start();
+
+        static bool Write(etl::span<const uint8_t> record);
+
+        static size_t Peek(etl::span<uint8_t> outData, uint16_t &outDropped);
+        static void Consume(const size_t numBytes, const uint16_t droppedReported);
+
+        /**
+         * @brief Get the number of bytes in the ring
+         */
+        static inline size_t GetPending() {
+            return gData.size();
+        }
+
+    private:
+        static bool Push(etl::span<const uint8_t> record);
+
+    private:
+        /// Pending record data
+        static etl::circular_buffer<uint8_t, kCapacity> gData;
+        /// Records dropped since the last successful read
+        static uint16_t gDropped;
+};
+}
+
+#endif
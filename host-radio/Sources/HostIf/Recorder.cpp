@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <rail.h>
+
+#include <etl/algorithm.h>
+
+#include "Log/Logger.h"
+#include "Rtos/Rtos.h"
+
+#include "Recorder.h"
+
+using namespace HostIf;
+
+etl::circular_buffer<uint8_t, Recorder::kBufferSize> Recorder::gBuffer;
+Recorder::Record Recorder::gCurrent{};
+bool Recorder::gActive{false};
+bool Recorder::gDumping{false};
+size_t Recorder::gOverwritten{0};
+
+/**
+ * @brief Start a new record
+ *
+ * Timestamp the transaction and store its header; it's written to the ring once it completes.
+ */
+void Recorder::BeginRecord(const CommandHeader &header) {
+    gCurrent = {
+        .timestamp = RAIL_GetTime(),
+        .command = header.command,
+        .length = header.payloadLength,
+        .status = 0,
+        .size = 0,
+    };
+    gActive = true;
+}
+
+/**
+ * @brief Complete the current record and insert it into the ring
+ *
+ * Oldest records are removed from the ring as needed to make space.
+ */
+void Recorder::FinishRecord(const Status status, etl::span<const uint8_t> payload,
+        const size_t responseBytes) {
+    if(!gActive) {
+        return;
+    }
+    gActive = false;
+
+    const bool isRead = (gCurrent.command & 0x80);
+    const auto numBytes = etl::min(isRead ? responseBytes : payload.size(), size_t{UINT8_MAX});
+
+    gCurrent.status = static_cast<uint8_t>(status);
+    gCurrent.size = numBytes;
+
+    taskENTER_CRITICAL();
+
+    // a dump reads the ring outside the critical section, so it mustn't change underneath it
+    if(gDumping) {
+        taskEXIT_CRITICAL();
+        return;
+    }
+
+    MakeSpace(sizeof(gCurrent) + (isRead ? 0 : numBytes));
+
+    const auto header = reinterpret_cast<const uint8_t *>(&gCurrent);
+    gBuffer.push(header, header + sizeof(gCurrent));
+    if(!isRead) {
+        gBuffer.push(payload.begin(), payload.begin() + numBytes);
+    }
+
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Drop the oldest records until there's space for a new one
+ *
+ * Only ever drops whole records (the first one has to be complete, so that a dump can be parsed.)
+ *
+ * @param numBytes Size of the new record, including its data
+ *
+ * @remark Call with the ring locked
+ */
+void Recorder::MakeSpace(const size_t numBytes) {
+    while(gBuffer.available() < numBytes && !gBuffer.empty()) {
+        Record oldest;
+        auto out = reinterpret_cast<uint8_t *>(&oldest);
+        for(size_t i = 0; i < sizeof(oldest); i++) {
+            out[i] = gBuffer[i];
+        }
+
+        // reads don't carry any data
+        size_t oldestBytes = sizeof(oldest) + ((oldest.command & 0x80) ? 0 : oldest.size);
+        while(oldestBytes--) {
+            gBuffer.pop();
+        }
+
+        gOverwritten++;
+    }
+}
+
+/**
+ * @brief Output all records to the log
+ *
+ * The ring is written as hex, kBytesPerLine bytes per line, between a header line (which indicates
+ * the total size) and a trailer line. Recording is suspended while the dump is in progress.
+ */
+void Recorder::DumpRecords() {
+    char line[kBytesPerLine * 2 + 1];
+
+    if(gBuffer.empty()) {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    gDumping = true;
+    const auto total = gBuffer.size();
+    taskEXIT_CRITICAL();
+
+    Logger::Notice("%s: begin %u bytes (%u records overwritten)", kLogTag.data(), total,
+            gOverwritten);
+
+    for(size_t offset = 0; offset < total; offset += kBytesPerLine) {
+        const auto numBytes = etl::min(kBytesPerLine, total - offset);
+        for(size_t i = 0; i < numBytes; i++) {
+            snprintf(line + (i * 2), 3, "%02x", gBuffer[offset + i]);
+        }
+        line[numBytes * 2] = '\0';
+
+        Logger::Notice("%s: %s", kLogTag.data(), line);
+    }
+
+    Logger::Notice("%s: end", kLogTag.data());
+
+    taskENTER_CRITICAL();
+    gBuffer.clear();
+    gOverwritten = 0;
+    gDumping = false;
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,128 @@
+#ifndef HOSTIF_RECORDER_H
+#define HOSTIF_RECORDER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <etl/circular_buffer.h>
+#include <etl/span.h>
+#include <etl/string_view.h>
+
+#include <BlazeNet/HostIf/Commands.h>
+
+namespace HostIf {
+/**
+ * @brief Host transaction recorder
+ *
+ * Captures every transaction the host performs (command header, write payload, and the outcome
+ * and size of the response) with a timestamp, into a ring that always holds the most recent
+ * transactions. The ring is dumped to the log (as hex lines tagged with kLogTag) when host
+ * communications are lost, so that a customer's traffic can be replayed against a host build of
+ * the firmware with the `host-sim-replay` tool.
+ *
+ * Disabled by default; when disabled, all calls compile to nothing.
+ *
+ * @remark Transactions are recorded from the host interface task only.
+ */
+class Recorder {
+    public:
+        /// Whether transactions are recorded
+        constexpr static const bool kEnabled{false};
+        /// Size of the record ring (bytes)
+        constexpr static const size_t kBufferSize{4096};
+        /// Tag prefixed to each line of a dump
+        constexpr static const etl::string_view kLogTag{"hostif-rec"};
+        /// Number of ring bytes output per line of a dump
+        constexpr static const size_t kBytesPerLine{32};
+
+        /// Outcome of a transaction
+        enum class Status: uint8_t {
+            /// Command executed successfully
+            Success                     = 0,
+            /// Command handler returned an error
+            Failed                      = 1,
+            /// Command doesn't support the requested direction
+            Unsupported                 = 2,
+            /// Command id is invalid
+            Invalid                     = 3,
+            /// Payload could not be received
+            Aborted                     = 4,
+        };
+
+        /**
+         * @brief A recorded transaction
+         *
+         * Write transactions are immediately followed by `size` payload bytes; for reads, `size`
+         * is the number of response bytes, which are not recorded.
+         */
+        struct Record {
+            /// Time the command header was received (µs, radio timebase)
+            uint32_t timestamp;
+            /// Command header as received, including the read bit
+            uint8_t command;
+            /// Payload length requested in the command header
+            uint8_t length;
+            /// Outcome (a Status value)
+            uint8_t status;
+            /// Payload bytes that follow (writes) or response bytes sent (reads)
+            uint8_t size;
+        } __attribute__((packed));
+
+    public:
+        /**
+         * @brief Start recording a transaction
+         *
+         * @param header Command header received from the host
+         */
+        static inline void Begin(const CommandHeader &header) {
+            if constexpr(kEnabled) {
+                BeginRecord(header);
+            }
+        }
+
+        /**
+         * @brief Finish recording the current transaction
+         *
+         * @param status Outcome of the transaction
+         * @param payload Payload received from the host (for writes)
+         * @param responseBytes Number of response bytes (for reads)
+         */
+        static inline void Finish(const Status status, etl::span<const uint8_t> payload = {},
+                const size_t responseBytes = 0) {
+            if constexpr(kEnabled) {
+                FinishRecord(status, payload, responseBytes);
+            }
+        }
+
+        /**
+         * @brief Output the ring to the log, then clear it
+         */
+        static inline void Dump() {
+            if constexpr(kEnabled) {
+                DumpRecords();
+            }
+        }
+
+    private:
+        static void BeginRecord(const CommandHeader &header);
+        static void FinishRecord(const Status status, etl::span<const uint8_t> payload,
+                const size_t responseBytes);
+        static void DumpRecords();
+
+        static void MakeSpace(const size_t numBytes);
+
+    private:
+        /// Recorded transactions (whole records; oldest first)
+        static etl::circular_buffer<uint8_t, kBufferSize> gBuffer;
+        /// Transaction being recorded
+        static Record gCurrent;
+        /// Whether a transaction is being recorded
+        static bool gActive;
+        /// Set while the ring is being dumped, to suspend recording
+        static bool gDumping;
+        /// Number of records dropped to make space since the last dump
+        static size_t gOverwritten;
+};
+}
+
+#endif
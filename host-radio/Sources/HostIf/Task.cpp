@@ -1,12 +1,16 @@
+#include <BlazeNet/HostIf/Commands.h>
+
 #include "Drivers/sl_spidrv_instances.h"
 #include "gecko-config/pin_config.h"
 #include "sl_spidrv_eusart_host_config.h"
 
+#include "Debug/Probes.h"
 #include "Log/Logger.h"
 #include "Rtos/Rtos.h"
 
-#include "Commands.h"
 #include "IrqManager.h"
+#include "LogRing.h"
+#include "Recorder.h"
 #include "Watchdog.h"
 #include "Task.h"
 
@@ -21,6 +25,7 @@ size_t Task::gPayloadBytesReceived{0};
 etl::array<uint8_t, Task::kMaxPayloadSize> Task::gPayloadBuffer;
 
 bool Task::gErrorFlag{false};
+TickType_t Task::gLastActivity{0};
 
 /**
  * @brief Initialize the host interface task
@@ -46,7 +51,8 @@ void Task::Main() {
     BaseType_t ok;
 
     // perform deferred setup
-    Logger::Trace("%s: init", "hostif");
+    Logger::Trace(Logger::Module::HostIf, "%s: init", "hostif");
+    LogRing::Start();
 
     ReadCommand();
 
@@ -58,42 +64,60 @@ void Task::Main() {
                 portMAX_DELAY);
         REQUIRE(ok == pdTRUE, "%s failed: %d", "xTaskNotifyWaitIndexed", ok);
 
-        // received a command
-        if(note & TaskNotifyBits::CmdReceiveComplete) {
-            // handle command if valid
-            if(gCommandBufferValid) {
-                ProcessCommand();
-            }
-            // if not valid, simply receive another command
-            else {
-                Logger::Warning("Cmd not valid!");
-                ReadCommand();
-            }
-
-            // update comms state
-            Watchdog::Kick();
+        HandleNotifications(note);
+    }
+}
+
+/**
+ * @brief Process task notifications
+ *
+ * Advance the SPI state machine according to the transfers that completed. Exactly one transfer
+ * is armed when this returns.
+ *
+ * @param note Notification bits received (see TaskNotifyBits)
+ */
+void Task::HandleNotifications(const uint32_t note) {
+    gLastActivity = xTaskGetTickCount();
+
+    // received a command
+    if(note & TaskNotifyBits::CmdReceiveComplete) {
+        // handle command if valid
+        if(gCommandBufferValid) {
+            Recorder::Begin(gCommandBuffer);
+            ProcessCommand();
         }
-        // finished receiving command payload
-        if(note & TaskNotifyBits::PayloadReceiveComplete) {
-            // bail if the payload reading stage had a failure
-            if(!gPayloadBytesReceived) {
-                Logger::Warning("failed to read payload bytes");
-                break;
-            }
-
-            // process the command with payload and set up to receive next one
-            DispatchCommand(gCommandBuffer.command & ~0x80,
-                    {gPayloadBuffer.data(), gPayloadBytesReceived});
+        // if not valid, simply receive another command
+        else {
+            Logger::Warning(Logger::Module::HostIf, "Cmd not valid!");
             ReadCommand();
         }
-        // finished transmitting command response; receive next command
-        if(note & TaskNotifyBits::ResponseTransmitComplete) {
-            // invoke post routine (if any)
-            DispatchCommandPostRead(gCommandBuffer.command & ~0x80, true);
 
-            // read out next command
-            ReadCommand();
+        // update comms state
+        Watchdog::Kick();
+    }
+    // finished receiving command payload
+    if(note & TaskNotifyBits::PayloadReceiveComplete) {
+        // discard the command if the payload couldn't be read
+        if(!gPayloadBytesReceived) {
+            Logger::Warning(Logger::Module::HostIf, "failed to read payload bytes");
+            Recorder::Finish(Recorder::Status::Aborted);
+        }
+        // process the command with payload
+        else {
+            DispatchCommand(gCommandBuffer.command & ~0x80,
+                    {gPayloadBuffer.data(), gPayloadBytesReceived});
         }
+
+        // either way, set up to receive next one
+        ReadCommand();
+    }
+    // finished transmitting command response; receive next command
+    if(note & TaskNotifyBits::ResponseTransmitComplete) {
+        // invoke post routine (if any)
+        DispatchCommandPostRead(gCommandBuffer.command & ~0x80, true);
+
+        // read out next command
+        ReadCommand();
     }
 }
 
@@ -109,8 +133,9 @@ void Task::ProcessCommand() {
     // get the command handler
     const auto cmd = gCommandBuffer.command & ~0x80;
 
-    if(cmd > static_cast<uint8_t>(CommandId::NumCommands)) {
-        Logger::Warning("Invalid cmd %02x", cmd);
+    if(cmd >= static_cast<uint8_t>(CommandId::NumCommands)) {
+        Logger::Warning(Logger::Module::HostIf, "Invalid cmd %02x", cmd);
+        Recorder::Finish(Recorder::Status::Invalid);
         ReadCommand();
         return;
     }
@@ -152,17 +177,22 @@ void Task::DispatchCommand(const uint8_t cmd, etl::span<uint8_t> payload) {
     int err;
 
     if(!TestFlags(gCurrentHandler->flags & HandlerFlags::SupportsWrite)) {
-        Logger::Warning("Cmd %02x doesn't support %s", cmd, "write");
+        Logger::Warning(Logger::Module::HostIf, "Cmd %02x doesn't support %s", cmd, "write");
+        Recorder::Finish(Recorder::Status::Unsupported, payload);
         return;
     }
 
+    PROBE_BEGIN(DispatchCommand);
     err = gCurrentHandler->write(cmd, payload);
+    PROBE_END(DispatchCommand);
     gErrorFlag = !!err;
 
     if(err) {
-        Logger::Warning("Cmd %02x(%s) failed: %d", cmd, "write", err);
+        Logger::Warning(Logger::Module::HostIf, "Cmd %02x(%s) failed: %d", cmd, "write", err);
         IrqManager::Assert(Interrupt::CommandError);
     }
+
+    Recorder::Finish(err ? Recorder::Status::Failed : Recorder::Status::Success, payload);
 }
 
 /**
@@ -178,7 +208,9 @@ void Task::DispatchCommandWithResponse(const uint8_t cmd, const size_t numRespon
     int ret;
 
     if(!TestFlags(gCurrentHandler->flags & HandlerFlags::SupportsRead)) {
-        Logger::Warning("Cmd %02x doesn't support %s", cmd, "read");
+        Logger::Warning(Logger::Module::HostIf, "Cmd %02x doesn't support %s", cmd, "read");
+        Recorder::Finish(Recorder::Status::Unsupported);
+        ReadCommand();
         return;
     }
 
@@ -186,15 +218,26 @@ void Task::DispatchCommandWithResponse(const uint8_t cmd, const size_t numRespon
     gErrorFlag = (ret < 0);
 
     if(ret < 0) {
-        Logger::Warning("Cmd %02x(%s) failed: %d", cmd, "read", ret);
+        Logger::Warning(Logger::Module::HostIf, "Cmd %02x(%s) failed: %d", cmd, "read", ret);
         IrqManager::Assert(Interrupt::CommandError);
 
         // important: invoke the post-read (with success set to "false") to avoid leaking resources
         DispatchCommandPostRead(cmd, false);
 
+        Recorder::Finish(Recorder::Status::Failed);
+        ReadCommand();
+        return;
+    }
+    REQUIRE(static_cast<size_t>(ret) <= gPayloadBuffer.size(), "invalid reply length: %d", ret);
+
+    Recorder::Finish(Recorder::Status::Success, {}, ret);
+
+    // nothing to send (the driver rejects empty transfers)
+    if(!ret) {
+        DispatchCommandPostRead(cmd, true);
+        ReadCommand();
         return;
     }
-    REQUIRE(ret < gPayloadBuffer.size(), "invalid reply length: %d", ret);
 
     // send response
     err = SPIDRV_STransmit(sl_spidrv_eusart_host_handle, gPayloadBuffer.data(), ret,
@@ -225,6 +268,71 @@ void Task::DispatchCommandPostRead(const uint8_t cmd, const bool success) {
 }
 
 
+/**
+ * @brief Execute a command synchronously
+ *
+ * Runs a command's handler to completion against the provided buffers, rather than the SPI
+ * interface; this is used to execute the individual commands in a batch (and by the host-side
+ * benchmarks.) For reads, the post-read callback is invoked immediately, as the response has
+ * already been captured in full.
+ *
+ * @param cmd Command to execute (without read bit)
+ * @param isRead Whether the command is a read (rather than a write)
+ * @param payload Payload for a write command
+ * @param response Buffer to receive the response of a read command; its size is the number of
+ *        bytes requested.
+ *
+ * @return Number of response bytes (0 for writes) or a negative error code
+ */
+int Task::ExecuteInline(const uint8_t cmd, const bool isRead, etl::span<const uint8_t> payload,
+        etl::span<uint8_t> response) {
+    int ret;
+
+    // batches may not be nested
+    if(cmd >= static_cast<uint8_t>(CommandId::NumCommands) ||
+            cmd == static_cast<uint8_t>(CommandId::Batch)) {
+        return -1;
+    }
+
+    const auto handler = &gHandlers[cmd];
+
+    if(isRead) {
+        if(!TestFlags(handler->flags & HandlerFlags::SupportsRead)) {
+            return -1;
+        }
+
+        ret = handler->read(cmd, response.size(), response);
+        if(ret > static_cast<int>(response.size())) {
+            ret = -1;
+        }
+
+        if(TestFlags(handler->flags & HandlerFlags::WantsPostRead)) {
+            handler->readComplete(cmd, ret >= 0);
+        }
+    } else {
+        if(!TestFlags(handler->flags & HandlerFlags::SupportsWrite)) {
+            return -1;
+        }
+
+        // write handlers may return any non-zero value to indicate failure
+        ret = handler->write(cmd, payload);
+        if(ret > 0) {
+            ret = -ret;
+        }
+    }
+
+    gErrorFlag = (ret < 0);
+
+    if(ret < 0) {
+        Logger::Warning(Logger::Module::HostIf, "Cmd %02x(%s) failed: %d", cmd,
+                isRead ? "batch read" : "batch write", ret);
+        IrqManager::Assert(Interrupt::CommandError);
+    }
+
+    return ret;
+}
+
+
 
 /**
  * @brief Set up a command data read
@@ -11,12 +11,20 @@
 #include "bitflags.h"
 #include "Rtos/Rtos.h"
 
+#ifdef HOST_SIM_FUZZ_HARNESS
+namespace Fuzz {
+class Harness;
+}
+#endif
+
 namespace HostIf {
 namespace Response {
 struct GetStatus;
 }
 namespace Handlers {
+struct Batch;
 struct GetStatus;
+struct StatusSnapshot;
 }
 
 /**
@@ -42,7 +50,12 @@ ENUM_FLAGS_EX(HandlerFlags, uintptr_t);
  * to the host. It also controls the host interrupt line.
  */
 class Task {
+    friend struct Handlers::Batch;
     friend struct Handlers::GetStatus;
+    friend struct Handlers::StatusSnapshot;
+#ifdef HOST_SIM_FUZZ_HARNESS
+    friend class Fuzz::Harness;
+#endif
 
     private:
         /// Runtime priority level
@@ -57,7 +70,7 @@ class Task {
         /// Maximum payload size (bytes)
         static const constexpr size_t kMaxPayloadSize{256};
         /// Maximum supported command id (TODO: keep in sync with CommandId enum)
-        static const constexpr size_t kMaxCommandId{0x0B};
+        static const constexpr size_t kMaxCommandId{0x15};
 
         /**
          * @brief Command handler
@@ -129,8 +142,19 @@ class Task {
     public:
         static void Init();
 
+        static int ExecuteInline(const uint8_t, const bool, etl::span<const uint8_t>,
+                etl::span<uint8_t>);
+
+        /**
+         * @brief Get the tick count of the most recent host interface activity
+         */
+        static inline TickType_t GetLastActivity() {
+            return gLastActivity;
+        }
+
     private:
         static void Main();
+        static void HandleNotifications(const uint32_t note);
         static void ProcessCommand();
         static void DispatchCommand(const uint8_t, etl::span<uint8_t>);
         static void DispatchCommandWithResponse(const uint8_t, const size_t);
@@ -159,6 +183,8 @@ class Task {
 
         /// Error flag (set if the last command returned an error; cleared on status read)
         static bool gErrorFlag;
+        /// Tick count at which the task last handled a transfer
+        static TickType_t gLastActivity;
 };
 }
 
@@ -3,6 +3,8 @@
 #include "Log/Logger.h"
 #include "Rtos/Rtos.h"
 
+#include "EventRing.h"
+#include "Recorder.h"
 #include "Watchdog.h"
 
 using namespace HostIf;
@@ -21,7 +23,7 @@ void Watchdog::Init() {
     gTimerHandle = xTimerCreateStatic("hostif comms wdog", pdMS_TO_TICKS(kWdogInterval), pdTRUE,
             nullptr, [](auto) {
         if(++gCheckinsMissed > kWdogThreshold && !gCommsLostFlag) {
-            Logger::Warning("host comms lost!");
+            Logger::Warning(Logger::Module::HostIf, "host comms lost!");
             HandleCommsLost();
         }
     }, &gTimerStorage);
@@ -40,8 +42,13 @@ void Watchdog::HandleCommsLost() {
     gCommsLostFlag = true;
     Hw::Indicators::BlinkAttentionFast();
 
+    EventRing::CommsStateChanged(true);
+
     // notify components
     BlazeNet::Beacon::CommsLost();
+
+    // output the transactions leading up to this (if recording)
+    Recorder::Dump();
 }
 
 /**
@@ -53,7 +60,9 @@ void Watchdog::HandleCommsRegained() {
     gCommsLostFlag = false;
     Hw::Indicators::TurnOffAttention();
 
+    EventRing::CommsStateChanged(false);
+
     BlazeNet::Beacon::CommsRegained();
 
-    Logger::Notice("host comms regained");
+    Logger::Notice(Logger::Module::HostIf, "host comms regained");
 }
@@ -1,16 +1,18 @@
 #include <stddef.h>
 #include <stdlib.h>
 
+#include "Rtos/Heap.h"
+
 void *operator new(size_t numBytes) {
-    return malloc(numBytes);
+    return Rtos::Heap::Alloc(Rtos::Heap::Class::Other, numBytes);
 }
 
 void operator delete(void* p) {
-    free(p);
+    Rtos::Heap::Free(Rtos::Heap::Class::Other, p);
 }
 
 // Same as above, just a C++14 specialization.
 // (See http://en.cppreference.com/w/cpp/memory/new/operator_delete)
 void operator delete(void* p, size_t t) {
-    free(p);
+    Rtos::Heap::Free(Rtos::Heap::Class::Other, p);
 }
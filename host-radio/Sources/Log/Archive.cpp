@@ -0,0 +1,456 @@
+#include <stddef.h>
+#include <string.h>
+
+#include <etl/algorithm.h>
+
+#include "Fs/Flash.h"
+#include "Fs/FlashInfo.h"
+
+#include "Archive.h"
+#include "Tokenizer.h"
+
+using namespace Log;
+
+Fs::Flash *Archive::gFlash{nullptr};
+uint32_t Archive::gStart{0};
+uint32_t Archive::gSectorSize{0};
+size_t Archive::gNumSectors{0};
+
+Archive::Sector Archive::gSectors[kMaxSectors];
+size_t Archive::gCurrent{0};
+uint32_t Archive::gOffset{0};
+uint32_t Archive::gSequence{0};
+
+SemaphoreHandle_t Archive::gLock{nullptr};
+
+uint8_t Archive::gBuffers[2][kBufferSize];
+size_t Archive::gActiveBuffer{0};
+size_t Archive::gBufferBytes{0};
+uint32_t Archive::gDropped{0};
+
+Archive::Cursor Archive::gReadCursor{};
+Archive::Cursor Archive::gPendingCursor{};
+bool Archive::gRewind{false};
+
+/**
+ * @brief Initialize the archive
+ *
+ * Read the headers of all sectors in the partition to find the most recent one, and the end of
+ * its records, so that appending can continue from there. If the partition holds no archive yet,
+ * or the most recent sector is damaged, a new sector is started.
+ *
+ * @param flash Flash the partition lives on
+ * @param start Start address of the partition (sector aligned)
+ * @param end End address of the partition (exclusive)
+ */
+void Archive::Init(Fs::Flash *flash, const uint32_t start, const uint32_t end) {
+    static StaticSemaphore_t gLockStorage;
+    gLock = xSemaphoreCreateMutexStatic(&gLockStorage);
+    REQUIRE(!!gLock, "failed to initialize %s", "log archive lock");
+
+    gSectorSize = flash->getInfo()->sectorSizeBytes();
+    gStart = start;
+    gNumSectors = etl::min(static_cast<size_t>((end - start) / gSectorSize), kMaxSectors);
+
+    REQUIRE(!(start & (gSectorSize - 1)), "log archive unaligned: %08x", start);
+    if(gNumSectors < 2) {
+        Logger::Warning(Logger::Module::Fs, "log archive too small (%u sectors)", gNumSectors);
+        return;
+    }
+
+    gFlash = flash;
+
+    // read sector headers, finding the most recent one
+    bool found{false};
+
+    for(size_t i = 0; i < gNumSectors; i++) {
+        SectorHeader hdr;
+        const auto err = flash->read(SectorAddress(i), {reinterpret_cast<uint8_t *>(&hdr),
+                sizeof(hdr)});
+        if(err) {
+            Disable(err);
+            return;
+        }
+
+        if(hdr.magic != kSectorMagic || hdr.sequence == kInvalid) {
+            gSectors[i] = {kInvalid, kInvalid};
+            continue;
+        }
+
+        gSectors[i] = {hdr.sequence, hdr.length};
+
+        if(!found || hdr.sequence > gSequence) {
+            found = true;
+            gCurrent = i;
+            gSequence = hdr.sequence;
+        }
+    }
+
+    // continue appending to the most recent sector, if it's intact
+    int err{0};
+
+    if(!found) {
+        gCurrent = gNumSectors - 1;
+        gSequence = 0;
+        err = NextSector();
+    } else if(gSectors[gCurrent].length != kInvalid) {
+        gOffset = gSectors[gCurrent].length;
+        err = NextSector();
+    } else {
+        const bool clean = ScanSector(gCurrent, gOffset);
+        if(!clean) {
+            err = NextSector();
+        }
+    }
+
+    if(err) {
+        Disable(err);
+        return;
+    }
+
+    gReadCursor = gPendingCursor = Oldest();
+
+    Logger::Notice(Logger::Module::Fs, "log archive: %u sectors at $%06x, current %u (seq %u)",
+            gNumSectors, start, gCurrent, gSequence);
+}
+
+/**
+ * @brief Append a record to the archive
+ *
+ * The record is copied into the RAM buffer; it's written to flash by the next Flush().
+ *
+ * @param record A complete binary record (header and arguments)
+ *
+ * @return Whether the record was buffered; if not, the buffer was full and it was dropped
+ */
+bool Archive::Append(etl::span<const uint8_t> record) {
+    bool ok{false};
+
+    if(record.size() < sizeof(Tokenizer::Header) || record[1] != record.size()) {
+        return false;
+    }
+
+    const bool hasScheduler = (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED);
+    if(hasScheduler) {
+        taskENTER_CRITICAL();
+    }
+
+    if(gBufferBytes + record.size() <= kBufferSize) {
+        memcpy(gBuffers[gActiveBuffer] + gBufferBytes, record.data(), record.size());
+        gBufferBytes += record.size();
+        ok = true;
+    } else {
+        gDropped++;
+    }
+
+    if(hasScheduler) {
+        taskEXIT_CRITICAL();
+    }
+
+    return ok;
+}
+
+/**
+ * @brief Write all buffered records to flash
+ *
+ * The RAM buffers are swapped, so that records can be appended while the flash is being written.
+ *
+ * @param isPanic Set when invoked during a panic, with interrupts disabled (possibly from an
+ *        interrupt handler or critical section). The flash is switched to polled operation, and
+ *        no locks are taken; if the archive or the flash is busy (for example, because the panic
+ *        happened while it was being written) nothing is written, rather than waiting.
+ */
+void Archive::Flush(const bool isPanic) {
+    if(!gFlash) {
+        return;
+    }
+
+    const bool hasScheduler = !isPanic &&
+        (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING);
+    if(isPanic) {
+        Fs::Flash::EnterPanicMode();
+
+        if(xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED &&
+                xSemaphoreGetMutexHolderFromISR(gLock)) {
+            return;
+        }
+    } else if(hasScheduler) {
+        xSemaphoreTake(gLock, portMAX_DELAY);
+    }
+    if(!Fs::Flash::Lock(isPanic ? 0 : portMAX_DELAY)) {
+        if(hasScheduler) {
+            xSemaphoreGive(gLock);
+        }
+        return;
+    }
+
+    while(gFlash) {
+        if(hasScheduler) {
+            taskENTER_CRITICAL();
+        }
+
+        const auto buffer = gActiveBuffer;
+        const auto bytes = gBufferBytes;
+        gActiveBuffer ^= 1;
+        gBufferBytes = 0;
+
+        if(hasScheduler) {
+            taskEXIT_CRITICAL();
+        }
+
+        if(!bytes) {
+            break;
+        }
+
+        const auto err = WriteRecords({gBuffers[buffer], bytes});
+        if(err) {
+            Disable(err);
+        }
+    }
+
+    Fs::Flash::Unlock();
+    if(hasScheduler) {
+        xSemaphoreGive(gLock);
+    }
+}
+
+/**
+ * @brief Write records to flash
+ *
+ * As many records as fit are written to the current sector with a single (page split) program
+ * operation; once it's full, the next sector is started. Records never span sectors.
+ */
+int Archive::WriteRecords(etl::span<const uint8_t> records) {
+    int err;
+
+    while(!records.empty()) {
+        // find how many whole records fit in the current sector
+        size_t length{0};
+        const auto space = SectorCapacity() - gOffset;
+
+        while(length + 2 <= records.size()) {
+            const size_t recordLength = records[length + 1];
+            if(length + recordLength > space) {
+                break;
+            }
+            length += recordLength;
+        }
+
+        if(!length) {
+            err = NextSector();
+            if(err) {
+                return err;
+            }
+            continue;
+        }
+
+        err = gFlash->write(SectorAddress(gCurrent) + sizeof(SectorHeader) + gOffset,
+                records.first(length));
+        if(err) {
+            return err;
+        }
+
+        gOffset += length;
+        records = records.subspan(length);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Start a new sector
+ *
+ * The current sector is closed, by writing its length into its header. Then the following sector
+ * (the oldest) is erased, and a header with the next sequence number is written to it.
+ */
+int Archive::NextSector() {
+    int err;
+
+    // close the current sector
+    auto &current = gSectors[gCurrent];
+
+    if(current.sequence != kInvalid && current.length == kInvalid) {
+        err = gFlash->write(SectorAddress(gCurrent) + offsetof(SectorHeader, length),
+                {reinterpret_cast<const uint8_t *>(&gOffset), sizeof(gOffset)});
+        if(err) {
+            return err;
+        }
+
+        current.length = gOffset;
+    }
+
+    // recycle the next one
+    const auto next = (gCurrent + 1) % gNumSectors;
+    gSectors[next] = {kInvalid, kInvalid};
+
+    err = gFlash->eraseSector(SectorAddress(next));
+    if(err) {
+        return err;
+    }
+
+    const SectorHeader hdr{
+        .magic = kSectorMagic,
+        .sequence = ++gSequence,
+        .length = kInvalid,
+    };
+    err = gFlash->write(SectorAddress(next), {reinterpret_cast<const uint8_t *>(&hdr),
+            offsetof(SectorHeader, length)});
+    if(err) {
+        return err;
+    }
+
+    gSectors[next] = {hdr.sequence, kInvalid};
+    gCurrent = next;
+    gOffset = 0;
+
+    return 0;
+}
+
+/**
+ * @brief Find the end of the records in a sector
+ *
+ * Walks the records from the start of the sector, until reaching erased flash.
+ *
+ * @param sector Sector to scan
+ * @param outLength Length of the valid records in the sector
+ *
+ * @return Whether the records end cleanly (they're followed by erased flash, or fill the sector)
+ */
+bool Archive::ScanSector(const size_t sector, uint32_t &outLength) {
+    const auto base = SectorAddress(sector) + sizeof(SectorHeader);
+    uint32_t offset{0};
+
+    while(offset + 2 <= SectorCapacity()) {
+        uint8_t hdr[2];
+        if(gFlash->read(base + offset, hdr)) {
+            break;
+        }
+
+        if(hdr[0] == 0xFF) {
+            outLength = offset;
+            return true;
+        } else if(hdr[0] != Tokenizer::kSync || hdr[1] < sizeof(Tokenizer::Header) ||
+                offset + hdr[1] > SectorCapacity()) {
+            break;
+        }
+
+        offset += hdr[1];
+    }
+
+    outLength = offset;
+    return offset + 2 > SectorCapacity();
+}
+
+/**
+ * @brief Stop archiving, after a flash error
+ */
+void Archive::Disable(const int err) {
+    gFlash = nullptr;
+    Logger::Warning(Logger::Module::Fs, "log archive disabled: flash error %d", err);
+}
+
+
+/**
+ * @brief Find the oldest data in the archive
+ *
+ * That's the sector with the lowest sequence number.
+ */
+Archive::Cursor Archive::Oldest() {
+    Cursor oldest{gCurrent, gSectors[gCurrent].sequence, 0};
+
+    for(size_t i = 0; i < gNumSectors; i++) {
+        if(gSectors[i].sequence != kInvalid && gSectors[i].sequence < oldest.sequence) {
+            oldest = {i, gSectors[i].sequence, 0};
+        }
+    }
+
+    return oldest;
+}
+
+/**
+ * @brief Move the host read position to the oldest data in the archive
+ *
+ * This takes effect with the next read.
+ */
+void Archive::Rewind() {
+    gRewind = true;
+}
+
+/**
+ * @brief Read archived records for the host
+ *
+ * Copies data from the read position; the position is only advanced (by CommitRead()) once the
+ * host has received it. If the sector at the read position was recycled in the meantime, reading
+ * continues from the oldest data.
+ *
+ * @param buffer Buffer to receive data
+ * @param isEnd Set if all data (written so far) was read
+ *
+ * @return Number of bytes read; this may be 0 even if not at the end, if the archive is busy
+ *
+ * @remark The read position is only accessed by the host interface task, so it's not protected
+ *         by the lock.
+ */
+size_t Archive::Read(etl::span<uint8_t> buffer, bool &isEnd) {
+    size_t read{0};
+    isEnd = false;
+
+    if(!gFlash) {
+        isEnd = true;
+        return 0;
+    }
+    if(!xSemaphoreTake(gLock, kReadLockTimeout)) {
+        return 0;
+    }
+    if(!Fs::Flash::Lock(kReadLockTimeout)) {
+        xSemaphoreGive(gLock);
+        return 0;
+    }
+
+    auto cursor = gReadCursor;
+    if(gRewind || gSectors[cursor.sector].sequence != cursor.sequence) {
+        cursor = Oldest();
+        gRewind = false;
+    }
+
+    while(read < buffer.size()) {
+        const auto length = SectorLength(cursor.sector);
+
+        // go to the next sector, if this one is done
+        if(cursor.offset >= length) {
+            if(cursor.sector == gCurrent) {
+                isEnd = true;
+                break;
+            }
+
+            cursor.sector = (cursor.sector + 1) % gNumSectors;
+            cursor.sequence = gSectors[cursor.sector].sequence;
+            cursor.offset = 0;
+            continue;
+        }
+
+        const auto chunk = etl::min(static_cast<size_t>(length - cursor.offset),
+                buffer.size() - read);
+        const auto err = gFlash->read(SectorAddress(cursor.sector) + sizeof(SectorHeader) +
+                cursor.offset, buffer.subspan(read, chunk));
+        if(err) {
+            break;
+        }
+
+        read += chunk;
+        cursor.offset += chunk;
+    }
+
+    gPendingCursor = cursor;
+
+    Fs::Flash::Unlock();
+    xSemaphoreGive(gLock);
+    return read;
+}
+
+/**
+ * @brief Advance the host read position past the data returned by the last Read()
+ */
+void Archive::CommitRead() {
+    gReadCursor = gPendingCursor;
+}
@@ -0,0 +1,177 @@
+#ifndef LOG_ARCHIVE_H
+#define LOG_ARCHIVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <etl/span.h>
+
+#include "Rtos/Rtos.h"
+
+#include "Logger.h"
+
+namespace Fs {
+class Flash;
+}
+
+namespace Log {
+/**
+ * @brief Persistent log archive on the external flash
+ *
+ * Important messages (warnings and up, including the panic dump) are also appended, as binary
+ * records (see Log::Tokenizer), to a partition on the external flash that's reserved for this by
+ * the superblock. It bypasses the filesystem: the partition is a ring of sectors, each starting
+ * with a small header, that are filled in order, erasing (and thus recycling) the oldest one when
+ * the current one is full. After a reboot, the host reads the archive out, oldest first, with the
+ * ReadLogArchive command.
+ *
+ * Logging only copies the record into a RAM buffer; the log drain task writes buffered records out
+ * as a single (page split) program operation. If the buffer fills up before then, records are
+ * dropped. A panic flushes the buffer directly.
+ *
+ * @remark Records of tokenized messages can only be decoded against the firmware build that
+ *         wrote them.
+ */
+class Archive {
+    public:
+        /// Minimum level of messages that are archived
+        constexpr static const Logger::Level kMinLevel{Logger::Level::Warning};
+
+    private:
+        /// Size of each of the two RAM buffers (bytes)
+        constexpr static const size_t kBufferSize{1024};
+        /// Maximum number of sectors in the partition
+        constexpr static const size_t kMaxSectors{32};
+        /// Time to wait for the archive (and flash bus) lock, when reading for the host
+        constexpr static const TickType_t kReadLockTimeout{pdMS_TO_TICKS(5)};
+
+        /// Sector header magic value ("BLOG")
+        constexpr static const uint32_t kSectorMagic{0x424C4F47};
+        /// Sequence number (or length) of a sector that's not valid (or not closed)
+        constexpr static const uint32_t kInvalid{UINT32_MAX};
+
+        /**
+         * @brief Header at the start of each sector
+         */
+        struct SectorHeader {
+            /// Always kSectorMagic
+            uint32_t magic;
+            /// Sequence number, increments with each sector started
+            uint32_t sequence;
+            /// Bytes of records in the sector; written once the sector is full (erased until)
+            uint32_t length;
+        };
+
+        /**
+         * @brief In memory state of a sector
+         */
+        struct Sector {
+            /// Sequence number, or kInvalid if the sector holds no archive data
+            uint32_t sequence;
+            /// Bytes of records, or kInvalid if this is the sector currently being written
+            uint32_t length;
+        };
+
+        /**
+         * @brief Position in the archive
+         */
+        struct Cursor {
+            /// Sector index
+            size_t sector;
+            /// Sequence number of the sector, to detect when it's recycled
+            uint32_t sequence;
+            /// Offset into the sector's records
+            uint32_t offset;
+        };
+
+    public:
+        static void Init(Fs::Flash *flash, const uint32_t start, const uint32_t end);
+
+        /**
+         * @brief Whether the archive is available
+         */
+        static inline bool IsEnabled() {
+            return !!gFlash;
+        }
+
+        static bool Append(etl::span<const uint8_t> record);
+        static void Flush(const bool isPanic = false);
+
+        static void Rewind();
+        static size_t Read(etl::span<uint8_t> buffer, bool &isEnd);
+        static void CommitRead();
+
+        /**
+         * @brief Get the number of records dropped because the RAM buffer was full
+         */
+        static inline uint32_t GetDropped() {
+            return gDropped;
+        }
+
+    private:
+        static int WriteRecords(etl::span<const uint8_t> records);
+        static int NextSector();
+        static bool ScanSector(const size_t sector, uint32_t &outLength);
+        static void Disable(const int err);
+
+        /// Get the address of a sector
+        static inline uint32_t SectorAddress(const size_t sector) {
+            return gStart + sector * gSectorSize;
+        }
+        /// Get the number of bytes of records a sector can hold
+        static inline uint32_t SectorCapacity() {
+            return gSectorSize - sizeof(SectorHeader);
+        }
+        /// Get the number of bytes of records in a sector
+        static inline uint32_t SectorLength(const size_t sector) {
+            if(sector == gCurrent) {
+                return gOffset;
+            } else if(gSectors[sector].sequence == kInvalid) {
+                return 0;
+            }
+            return (gSectors[sector].length < SectorCapacity()) ? gSectors[sector].length :
+                SectorCapacity();
+        }
+        static Cursor Oldest();
+
+    private:
+        /// Flash the partition lives on, or `nullptr` if there's no archive
+        static Fs::Flash *gFlash;
+        /// Start address of the partition
+        static uint32_t gStart;
+        /// Size of a sector (bytes)
+        static uint32_t gSectorSize;
+        /// Number of sectors in the partition
+        static size_t gNumSectors;
+
+        /// State of each sector
+        static Sector gSectors[kMaxSectors];
+        /// Sector currently being written
+        static size_t gCurrent;
+        /// Write offset into the current sector's records
+        static uint32_t gOffset;
+        /// Sequence number of the current sector
+        static uint32_t gSequence;
+
+        /// Protects the flash and sector state
+        static SemaphoreHandle_t gLock;
+
+        /// RAM buffers: records are appended to one while the other is written out
+        static uint8_t gBuffers[2][kBufferSize];
+        /// Buffer currently appended to
+        static size_t gActiveBuffer;
+        /// Bytes in the active buffer
+        static size_t gBufferBytes;
+        /// Number of records dropped
+        static uint32_t gDropped;
+
+        /// Host read position
+        static Cursor gReadCursor;
+        /// Read position after the last read, applied when the host completes it
+        static Cursor gPendingCursor;
+        /// Set to move the read position to the oldest data on the next read
+        static bool gRewind;
+};
+}
+
+#endif
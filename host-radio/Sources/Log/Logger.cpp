@@ -4,13 +4,22 @@
 #include "sl_debug_swo.h"
 
 #include "Logger.h"
+#include "Archive.h"
+#include "Ring.h"
+#include "Tokenizer.h"
 
+#include "Debug/Probes.h"
+#include "HostIf/LogRing.h"
 #include "Drivers/sl_uartdrv_instances.h"
+#include "Rtos/Heap.h"
 #include "Rtos/Rtos.h"
 
 #include <printf/printf.h>
+#include <rail.h>
 #include <stdarg.h>
 #include <stdlib.h>
+#include <string.h>
+#include <etl/algorithm.h>
 #include <etl/array.h>
 
 using namespace Log;
@@ -22,19 +31,31 @@ using namespace Log;
  * case, fall back to just printing them out the swd trace line.
  */
 bool Logger::gInitialized{false};
+bool Logger::gHasTimebase{false};
+bool Logger::gPanicking{false};
 
 /**
- * @brief Log level
+ * @brief Log level threshold for each module
  *
- * All log messages with a level that is numerically lower than this one will be discarded.
+ * All log messages with a level that is numerically lower than their module's threshold will be
+ * discarded.
  */
-Logger::Level Logger::gLevel{Logger::Level::Trace};
+Logger::Level Logger::gLevels[kNumModules]{
+    kDefaultLevel, kDefaultLevel, kDefaultLevel, kDefaultLevel, kDefaultLevel, kDefaultLevel,
+    kDefaultLevel,
+};
+static_assert(Logger::kNumModules == 7, "update default module levels");
 
 /**
  * @brief UART transmit completion flag
  */
 SemaphoreHandle_t Logger::gUartCompletion{nullptr};
 
+/**
+ * @brief Log drain task
+ */
+TaskHandle_t Logger::gDrainTask{nullptr};
+
 
 /**
  * @brief Initialize the logger instance
@@ -59,10 +80,35 @@ void Logger::Init() {
 
         xSemaphoreGive(gUartCompletion);
     }
+
+    // and the task that feeds it (and the archive)
+    if(kEnableUartTty || kEnableArchive) {
+        static StaticTask_t gTaskStorage;
+        static StackType_t gTaskStack[kDrainStackSize];
+
+        gDrainTask = xTaskCreateStatic([](auto param) {
+            DrainMain();
+        }, kDrainTaskName.data(), kDrainStackSize, nullptr, kDrainPriority, gTaskStack,
+                &gTaskStorage);
+        REQUIRE(!!gDrainTask, "failed to initialize %s", "log drain task");
+    }
 }
 
 
 
+/**
+ * @brief Set the level threshold of a module
+ *
+ * @remark Error messages are always output, regardless of the threshold.
+ */
+void Logger::SetLevel(const Module module, const Level level) {
+    if(module >= kNumModules) {
+        return;
+    }
+
+    gLevels[module] = level;
+}
+
 /**
  * @brief Output a log message.
  *
@@ -72,14 +118,20 @@ void Logger::Init() {
  * @param args Arguments to format
  *
  * This formats the message into an intermediate task specific buffer; this avoids needing to take
- * a lock during this process, only when we actually modify the trace buffer do we do so from
- * inside a critical section.
+ * a lock during this process. Buffered messages are then appended to the log ring, which doesn't
+ * block either; the drain task sends them to the UART in the background. If the ring is full, the
+ * message is dropped.
  *
  * @remark Do not add a trailing newline on the message's format string. This is automatically
  *         added, if necessary, to signify the end of a message by the underlying output drivers.
  */
-void Logger::Log(const Level level, const bool buffered, const etl::string_view &format, va_list args) {
-    int numChars{0};
+void Logger::Log(const Level level, const bool buffered, const etl::string_view &format,
+        va_list args) {
+    PROBE_SCOPE(LoggerLog);
+
+    // timestamp the message first, before any other work
+    const auto timestamp = GetTimestamp();
+
     size_t bufferSz{0}, bytesWritten{0};
     char *buffer{nullptr}, *bufferStart{nullptr};
     bool hasScheduler{true};
@@ -93,7 +145,7 @@ void Logger::Log(const Level level, const bool buffered, const etl::string_view
      * Get the task-specific log buffer (and its length) if the scheduler has been started;
      * otherwise use a statically allocated buffer (which is then re-used for the first task)
      */
-    if(xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED || !buffered) {
+    if(xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED || !buffered || gPanicking) {
         buffer = gLogBuffer;
         bufferSz = kTaskLogBufferSize;
         hasScheduler = false;
@@ -110,7 +162,8 @@ void Logger::Log(const Level level, const bool buffered, const etl::string_view
             }
             // otherwise we need to allocate a buffer
             else {
-                buffer = static_cast<char *>(malloc(kTaskLogBufferSize));
+                buffer = static_cast<char *>(Rtos::Heap::Alloc(Rtos::Heap::Class::LogBuffer,
+                            kTaskLogBufferSize));
                 REQUIRE(buffer, "failed to allocate log buffer");
             }
 
@@ -125,69 +178,262 @@ void Logger::Log(const Level level, const bool buffered, const etl::string_view
         // buffer is always this same size
         bufferSz = kTaskLogBufferSize;
 
-        if(kEnableUartTty) {
-            // acquire UART output
-            // XXX: could be skipped if we're outputting a different buffer right now
-            xSemaphoreTake(gUartCompletion, portMAX_DELAY);
-        }
     }
 
     bufferStart = buffer;
 
-    // output a timestamp (TODO: use something with better resolution than ticks?)
-    const auto ticks = xTaskGetTickCount();
-    numChars = snprintf(buffer, bufferSz, "[%10u] ", ticks);
 
-    bytesWritten += numChars;
-    bufferSz -= numChars;
-    buffer += numChars;
+    // output text via trace SWO
+    if(kEnableTraceSwo) {
+        va_list textArgs;
+        va_copy(textArgs, args);
+        bytesWritten = FormatText({buffer, bufferSz}, timestamp, format, textArgs);
+        va_end(textArgs);
 
-    // format the message
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wformat-nonliteral"
-    numChars = vsnprintf(buffer, bufferSz, format.data(), args);
-#pragma clang diagnostic pop
+        if(hasScheduler) {
+            taskENTER_CRITICAL();
+        }
+        TracePutString({bufferStart, bytesWritten});
+        if(hasScheduler) {
+            taskEXIT_CRITICAL();
+        }
+    }
+
+    auto bytes = reinterpret_cast<uint8_t *>(bufferStart);
+
+    /*
+     * Binary records go to the archive (important messages only) and the host interface. If the
+     * UART doesn't use them, encode one separately.
+     *
+     * The record is handed to the host interface last: that may log a message itself, which
+     * reuses the buffer.
+     */
+    constexpr static const bool kBinaryUart{kEnableUartTty && kBinaryUartTty};
 
-    if(numChars >= bufferSz) {
-        numChars = (bufferSz - 1);
+    bool archive{false};
+    if constexpr(kEnableArchive) {
+        archive = Archive::IsEnabled() &&
+            static_cast<uint8_t>(level) >= static_cast<uint8_t>(Archive::kMinLevel);
     }
 
-    bytesWritten += numChars;
-    bufferSz -= numChars;
-    buffer += numChars;
+    if((archive || kEnableHostLogs) && !kBinaryUart) {
+        va_list recordArgs;
+        va_copy(recordArgs, args);
+        bytesWritten = EncodeRecord({bytes, bufferSz}, level, timestamp, format, recordArgs);
+        va_end(recordArgs);
 
-    // write it to our output devices
+        if(archive) {
+            ArchiveRecord({bytes, bytesWritten});
+        }
+        if(kEnableHostLogs && !gPanicking) {
+            HostIf::LogRing::Write({bytes, bytesWritten});
+        }
+    }
+
+    if(!kEnableUartTty) {
+        return;
+    }
+
+    // format (or encode) the message for the UART
+    if(!kBinaryUartTty) {
+        bytesWritten = FormatText({buffer, bufferSz - 2}, timestamp, format, args);
+        buffer[bytesWritten++] = '\r';
+        buffer[bytesWritten++] = '\n';
+    } else {
+        bytesWritten = EncodeRecord({bytes, bufferSz}, level, timestamp, format, args);
+
+        if(archive) {
+            ArchiveRecord({bytes, bytesWritten});
+        }
+    }
+
+    // queue it for the drain task
     if(hasScheduler) {
-        taskENTER_CRITICAL();
+        if(Ring::Write({bytes, bytesWritten})) {
+            xTaskNotifyGive(gDrainTask);
+        }
+    }
+    // scheduler isn't running (or this is urgent), so write it out directly
+    else {
+        UARTDRV_ForceTransmit(sl_uartdrv_eusart_tty_handle, bytes, bytesWritten);
     }
 
-    if(kEnableTraceSwo) {
-        TracePutString({bufferStart, bytesWritten});
+    if(kEnableHostLogs && kBinaryUart && !gPanicking) {
+        HostIf::LogRing::Write({bytes, bytesWritten});
     }
-    if(kEnableUartTty) {
-        // TODO: transmit timestamp, severity as binary
-        if(hasScheduler && buffered) {
-            // use DMA driven transmission here
-            UARTDRV_Transmit(sl_uartdrv_eusart_tty_handle, reinterpret_cast<uint8_t *>(bufferStart),
-                    bytesWritten, [](auto handle, auto status, auto data, auto dataLen) {
+}
+
+/**
+ * @brief Log drain task
+ *
+ * Takes messages out of the log ring, as many at a time as fit in the transmit buffer, and
+ * sends them to the UART with a single DMA transfer. Dropped messages are reported once the ring
+ * has been drained. Then, records appended to the archive are written to flash.
+ */
+void Logger::DrainMain() {
+    static uint8_t gBuffer[kDrainBufferSize];
+    uint32_t lastDropped{0};
+
+    while(true) {
+        // write out records archived before the scheduler started, or since the last wakeup
+        if constexpr(kEnableArchive) {
+            Archive::Flush();
+        }
+
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        while(kEnableUartTty && !Ring::IsEmpty()) {
+            // wait for the previous transfer out of the buffer to complete
+            xSemaphoreTake(gUartCompletion, portMAX_DELAY);
+
+            // if the oldest message is still being written, its writer will notify us again
+            const auto read = Ring::Read(gBuffer);
+            if(!read) {
+                xSemaphoreGive(gUartCompletion);
+                break;
+            }
+
+            UARTDRV_Transmit(sl_uartdrv_eusart_tty_handle, gBuffer, read,
+                    [](auto handle, auto status, auto data, auto dataLen) {
                 BaseType_t woken{pdFALSE};
                 xSemaphoreGiveFromISR(gUartCompletion, &woken);
                 portYIELD_FROM_ISR(woken);
             });
-            UARTDRV_Transmit(sl_uartdrv_eusart_tty_handle,
-                    reinterpret_cast<uint8_t *>(const_cast<char *>("\r\n")), 2, nullptr);
+        }
+
+        const auto dropped = Ring::GetDropped();
+        if(dropped != lastDropped) {
+            Warning("Log ring overflow: %lu messages dropped",
+                    static_cast<unsigned long>(dropped - lastDropped));
+            lastDropped = dropped;
+        }
+    }
+}
+
+/**
+ * @brief Append a record to the log archive
+ *
+ * Once the scheduler is running, the drain task is woken to write it out; this includes unbuffered
+ * (error) messages, which may be logged from interrupt context. During a panic, the panic handler
+ * flushes the archive itself.
+ *
+ * @param record Binary record to append
+ */
+void Logger::ArchiveRecord(etl::span<const uint8_t> record) {
+    if constexpr(kEnableArchive) {
+        if(!Archive::Append(record) || gPanicking ||
+                xTaskGetSchedulerState() != taskSCHEDULER_RUNNING) {
+            return;
+        }
+
+        if(__get_IPSR()) {
+            BaseType_t woken{pdFALSE};
+            vTaskNotifyGiveFromISR(gDrainTask, &woken);
+            portYIELD_FROM_ISR(woken);
         } else {
-            // scheduler isn't running, so write it out directly
-            UARTDRV_ForceTransmit(sl_uartdrv_eusart_tty_handle, reinterpret_cast<uint8_t *>(bufferStart),
-                    bytesWritten);
-            UARTDRV_ForceTransmit(sl_uartdrv_eusart_tty_handle,
-                    reinterpret_cast<uint8_t *>(const_cast<char *>("\r\n")), 2);
+            xTaskNotifyGive(gDrainTask);
         }
     }
+}
 
-    if(hasScheduler) {
-        taskEXIT_CRITICAL();
+/**
+ * @brief Get the timestamp of a message being logged
+ *
+ * This is the RAIL time (in µs) so that messages can be correlated with radio events and packet
+ * timestamps. It wraps around about every 71 minutes.
+ */
+uint32_t Logger::GetTimestamp() {
+    return gHasTimebase ? RAIL_GetTime() : 0;
+}
+
+/**
+ * @brief Format a message as text
+ *
+ * @param buffer Buffer to receive the message (it's truncated if it doesn't fit)
+ * @param timestamp Timestamp to prefix the message with (µs)
+ * @param format Format string
+ * @param args Arguments to format
+ *
+ * @return Number of characters written, not including the terminating zero byte
+ */
+size_t Logger::FormatText(etl::span<char> buffer, const uint32_t timestamp,
+        const etl::string_view &format, va_list args) {
+    size_t written{0};
+
+    int numChars = snprintf(buffer.data(), buffer.size(), "[%10u] ", timestamp);
+    written += etl::min(static_cast<size_t>(numChars), buffer.size() - 1);
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wformat-nonliteral"
+    numChars = vsnprintf(buffer.data() + written, buffer.size() - written, format.data(), args);
+#pragma clang diagnostic pop
+    written += etl::min(static_cast<size_t>(numChars), buffer.size() - written - 1);
+
+    return written;
+}
+
+/**
+ * @brief Encode a message as a binary record
+ *
+ * Messages are tokenized if possible; otherwise, they're formatted on the device.
+ *
+ * @return Length of the record (bytes)
+ */
+size_t Logger::EncodeRecord(etl::span<uint8_t> buffer, const Level level,
+        const uint32_t timestamp, const etl::string_view &format, va_list args) {
+    if(IsTokenizable(format)) {
+        return Tokenizer::Encode(buffer, static_cast<uint8_t>(level), timestamp, format.data(),
+                args);
     }
+    return EncodeFormatted(buffer, level, timestamp, format, args);
+}
+
+/**
+ * @brief Encode an already formatted message as a binary record
+ *
+ * Used for messages whose format string isn't in flash (and thus can't be looked up by the
+ * decoder.) The record's format address is 0, and the formatted message follows the header.
+ *
+ * @return Total size of the record
+ */
+size_t Logger::EncodeFormatted(etl::span<uint8_t> buffer, const Level level,
+        const uint32_t timestamp, const etl::string_view &format, va_list args) {
+    using Header = Tokenizer::Header;
+
+    const auto size = etl::min(buffer.size(), Tokenizer::kMaxRecordSize);
+    auto text = reinterpret_cast<char *>(buffer.data() + sizeof(Header));
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wformat-nonliteral"
+    const int numChars = vsnprintf(text, size - sizeof(Header), format.data(), args);
+#pragma clang diagnostic pop
+
+    const Header hdr{
+        .sync = Tokenizer::kSync,
+        .length = static_cast<uint8_t>(sizeof(Header) + etl::min(static_cast<size_t>(numChars),
+                    size - sizeof(Header) - 1)),
+        .level = static_cast<uint8_t>(level),
+        .timestamp = timestamp,
+        .format = 0,
+    };
+    memcpy(buffer.data(), &hdr, sizeof(hdr));
+
+    return hdr.length;
+}
+
+/**
+ * @brief Determine whether a message can be tokenized
+ *
+ * Only format strings in flash are also in the firmware's ELF file, where the host can look them
+ * up; anything else (for example, a string built at runtime) must be formatted on the device.
+ */
+bool Logger::IsTokenizable(const etl::string_view &format) {
+#if defined(__arm__)
+    const auto address = reinterpret_cast<uintptr_t>(format.data());
+    return (address >= FLASH_BASE) && (address < (FLASH_BASE + FLASH_SIZE));
+#else
+    return false;
+#endif
 }
 
 /**
@@ -196,24 +442,26 @@ void Logger::Log(const Level level, const bool buffered, const etl::string_view
  * This disables interrupts and lands ourselves into an infinite loop and/or breakpoint.
  */
 void Logger::Panic() {
+    // anything logged from here on (including by the archive flush) is written out directly
+    gPanicking = true;
+
     // print a message
     Error("Panic! at the system, halting");
     // Hw::StatusLed::Set(Hw::StatusLed::Color::Red);
 
     // get task info (if scheduler is running)
-    unsigned long totalRuntime{0};
+    uint32_t totalRuntime{0};
     constexpr static const size_t kTaskInfoSize{8};
     static etl::array<TaskStatus_t, kTaskInfoSize> gTaskInfo;
 
     if(xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) {
-        //const auto ok = uxTaskGetSystemState(gTaskInfo.data(), kTaskInfoSize, &totalRuntime);
-        const auto ok = uxTaskGetSystemState(gTaskInfo.data(), kTaskInfoSize, nullptr);
+        const auto ok = uxTaskGetSystemState(gTaskInfo.data(), kTaskInfoSize, &totalRuntime);
 
         if(!ok) {
             Error("Failed to get RTOS state");
         } else {
             Error("========== RTOS state ==========");
-            Error("Total runtime: %10lu", totalRuntime);
+            Error("Total runtime: %10lu", static_cast<unsigned long>(totalRuntime));
             Error("%8s %-16s S %10s %3s %3s", "Handle", "Name", "Runtime", "PRI", "STK");
 
             for(size_t i = 0; i < ok; i++) {
@@ -241,13 +489,18 @@ void Logger::Panic() {
                 }
 
                 Error("%08x %-16s %c %10lu %3u %03x", task.xHandle, task.pcTaskName, stateChar,
-                        task.ulRunTimeCounter, task.uxCurrentPriority, task.usStackHighWaterMark);
+                        static_cast<unsigned long>(task.ulRunTimeCounter), task.uxCurrentPriority, task.usStackHighWaterMark);
             }
         }
     }
 
-    // stop machine
+    // stop machine, but save the messages above to the archive first (with polled flash I/O)
     __disable_irq();
+
+    if constexpr(kEnableArchive) {
+        Archive::Flush(true);
+    }
+
     __BKPT(0xf3);
 
     while(1) {}
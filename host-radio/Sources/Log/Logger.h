@@ -8,6 +8,8 @@
 #include <etl/span.h>
 #include <etl/string_view.h>
 
+#include <BlazeNet/HostIf/Commands.h>
+
 #include "Rtos/Rtos.h"
 
 extern "C" void log_panic(const char *, ...);
@@ -48,6 +50,54 @@ class Logger {
          */
         constexpr static const bool kEnableUartTty{true};
 
+        /**
+         * @brief Whether UART messages are output in the binary (tokenized) format
+         *
+         * Instead of formatting messages, the format string's address and the raw arguments are
+         * sent; the `host-log-decode` tool formats them, using the firmware's ELF file. See
+         * Log::Tokenizer for the format. Host builds always output text, since their format
+         * strings can't be looked up that way.
+         */
+#if defined(__arm__)
+        constexpr static const bool kBinaryUartTty{true};
+#else
+        constexpr static const bool kBinaryUartTty{false};
+#endif
+
+        /**
+         * @brief Whether log messages are queued for the host interface
+         *
+         * Messages are appended, as binary records, to a ring that the host reads out over SPI
+         * with the ReadLogs command (see HostIf::LogRing); this works on boards where the log
+         * UART isn't connected. If the host doesn't keep up, messages are dropped.
+         */
+        constexpr static const bool kEnableHostLogs{true};
+
+        /**
+         * @brief Whether important messages are archived to external flash
+         *
+         * See Log::Archive for details. Host builds have no external flash.
+         */
+#if defined(__arm__)
+        constexpr static const bool kEnableArchive{true};
+#else
+        constexpr static const bool kEnableArchive{false};
+#endif
+
+    private:
+        /// Log drain task priority
+        constexpr static const UBaseType_t kDrainPriority{Rtos::TaskPriority::AppLow};
+        /// Size of the log drain task's stack, in words
+        constexpr static const size_t kDrainStackSize{320};
+        /// Log drain task name
+        constexpr static const etl::string_view kDrainTaskName{"LogDrain"};
+        /**
+         * @brief Size of the drain task's UART transmit buffer (bytes)
+         *
+         * This is the largest amount of log data sent with one DMA transfer.
+         */
+        constexpr static const size_t kDrainBufferSize{512};
+
     private:
         static void TracePutString(etl::span<const char> str);
 
@@ -71,6 +121,21 @@ class Logger {
             Trace                       = 1,
         };
 
+        /**
+         * @brief Firmware module
+         *
+         * Messages may be tagged with the module that logged them; each module has its own level
+         * threshold, which the host can change at runtime with the LogLevels command. Untagged
+         * messages belong to the System module.
+         */
+        using Module = HostIf::Response::LogLevels::Module;
+
+        /// Number of modules
+        constexpr static const size_t kNumModules{Module::NumModules};
+
+        /// Default level threshold for all modules
+        constexpr static const Level kDefaultLevel{Level::Debug};
+
     public:
         static void Init();
 
@@ -106,6 +171,19 @@ class Logger {
             Log(Level::Error, false, fmt, va);
             va_end(va);
         }
+        /**
+         * @brief Output an error level message on behalf of a module.
+         *
+         * @param module Module logging the message
+         * @param fmt Format string
+         * @param ... Arguments to message
+         */
+        static void Error(const Module module, const etl::string_view fmt, ...) {
+            va_list va;
+            va_start(va, fmt);
+            Log(Level::Error, false, fmt, va);
+            va_end(va);
+        }
 
         /**
          * @brief Output a warning level message.
@@ -114,7 +192,22 @@ class Logger {
          * @param ... Arguments to message
          */
         static void Warning(const etl::string_view fmt, ...) {
-            if(static_cast<uint8_t>(gLevel) > static_cast<uint8_t>(Level::Warning)) return;
+            if(!IsEnabled(Module::System, Level::Warning)) return;
+
+            va_list va;
+            va_start(va, fmt);
+            Log(Level::Warning, true, fmt, va);
+            va_end(va);
+        }
+        /**
+         * @brief Output a warning level message on behalf of a module.
+         *
+         * @param module Module logging the message
+         * @param fmt Format string
+         * @param ... Arguments to message
+         */
+        static void Warning(const Module module, const etl::string_view fmt, ...) {
+            if(!IsEnabled(module, Level::Warning)) return;
 
             va_list va;
             va_start(va, fmt);
@@ -129,7 +222,22 @@ class Logger {
          * @param ... Arguments to message
          */
         static void Notice(const etl::string_view fmt, ...) {
-            if(static_cast<uint8_t>(gLevel) > static_cast<uint8_t>(Level::Notice)) return;
+            if(!IsEnabled(Module::System, Level::Notice)) return;
+
+            va_list va;
+            va_start(va, fmt);
+            Log(Level::Notice, true, fmt, va);
+            va_end(va);
+        }
+        /**
+         * @brief Output a notice level message on behalf of a module.
+         *
+         * @param module Module logging the message
+         * @param fmt Format string
+         * @param ... Arguments to message
+         */
+        static void Notice(const Module module, const etl::string_view fmt, ...) {
+            if(!IsEnabled(module, Level::Notice)) return;
 
             va_list va;
             va_start(va, fmt);
@@ -144,7 +252,22 @@ class Logger {
          * @param ... Arguments to message
          */
         static void Debug(const etl::string_view fmt, ...) {
-            if(static_cast<uint8_t>(gLevel) > static_cast<uint8_t>(Level::Debug)) return;
+            if(!IsEnabled(Module::System, Level::Debug)) return;
+
+            va_list va;
+            va_start(va, fmt);
+            Log(Level::Debug, true, fmt, va);
+            va_end(va);
+        }
+        /**
+         * @brief Output a debug level message on behalf of a module.
+         *
+         * @param module Module logging the message
+         * @param fmt Format string
+         * @param ... Arguments to message
+         */
+        static void Debug(const Module module, const etl::string_view fmt, ...) {
+            if(!IsEnabled(module, Level::Debug)) return;
 
             va_list va;
             va_start(va, fmt);
@@ -159,7 +282,22 @@ class Logger {
          * @param ... Arguments to message
          */
         static void Trace(const etl::string_view fmt, ...) {
-            if(static_cast<uint8_t>(gLevel) > static_cast<uint8_t>(Level::Trace)) return;
+            if(!IsEnabled(Module::System, Level::Trace)) return;
+
+            va_list va;
+            va_start(va, fmt);
+            Log(Level::Trace, true, fmt, va);
+            va_end(va);
+        }
+        /**
+         * @brief Output a trace level message on behalf of a module.
+         *
+         * @param module Module logging the message
+         * @param fmt Format string
+         * @param ... Arguments to message
+         */
+        static void Trace(const Module module, const etl::string_view fmt, ...) {
+            if(!IsEnabled(module, Level::Trace)) return;
 
             va_list va;
             va_start(va, fmt);
@@ -170,14 +308,56 @@ class Logger {
         static void Log(const Level lvl, const bool buffered, const etl::string_view &fmt,
                 va_list args);
 
+        /**
+         * @brief Check whether a module's messages at the given level are output
+         *
+         * Use this to skip expensive preparation of a message (such as a hex dump) that would be
+         * discarded anyway.
+         */
+        static inline bool IsEnabled(const Module module, const Level level) {
+            return static_cast<uint8_t>(gLevels[module]) <= static_cast<uint8_t>(level);
+        }
+
+        /// Get the level threshold of a module
+        static inline Level GetLevel(const Module module) {
+            return gLevels[module];
+        }
+        static void SetLevel(const Module module, const Level level);
+
+        /**
+         * @brief Start timestamping messages with the RAIL timebase
+         *
+         * Invoked once RAIL is initialized; messages logged before then have a timestamp of 0.
+         */
+        static inline void EnableTimestamps() {
+            gHasTimebase = true;
+        }
+
     private:
         [[noreturn]] static void Panic();
 
+        static uint32_t GetTimestamp();
+
+        static void DrainMain();
+
+        static size_t FormatText(etl::span<char> buffer, const uint32_t timestamp,
+                const etl::string_view &format, va_list args);
+        static void ArchiveRecord(etl::span<const uint8_t> record);
+
+        static size_t EncodeRecord(etl::span<uint8_t> buffer, const Level level,
+                const uint32_t timestamp, const etl::string_view &format, va_list args);
+        static size_t EncodeFormatted(etl::span<uint8_t> buffer, const Level level,
+                const uint32_t timestamp, const etl::string_view &format, va_list args);
+        static bool IsTokenizable(const etl::string_view &format);
+
     private:
         static bool gInitialized;
-        static Level gLevel;
+        static bool gHasTimebase;
+        static bool gPanicking;
+        static Level gLevels[kNumModules];
 
         static SemaphoreHandle_t gUartCompletion;
+        static TaskHandle_t gDrainTask;
 };
 }
 
@@ -0,0 +1,106 @@
+#include <string.h>
+
+#include "Ring.h"
+
+using namespace Log;
+
+alignas(uint32_t) uint8_t Ring::gBuffer[kSize];
+uint32_t Ring::gWritePos{0};
+uint32_t Ring::gReadPos{0};
+uint32_t Ring::gDropped{0};
+
+/**
+ * @brief Append a message to the ring
+ *
+ * @param message Message to append
+ *
+ * @return Whether the message was written; if not, it was too long or the ring was full
+ */
+bool Ring::Write(etl::span<const uint8_t> message) {
+    if(message.size() > kMaxMessageSize) {
+        __atomic_fetch_add(&gDropped, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    const auto size = EntrySize(message.size());
+
+    // reserve space, including padding if the entry would wrap
+    uint32_t pos, padding;
+    auto writePos = __atomic_load_n(&gWritePos, __ATOMIC_RELAXED);
+
+    do {
+        pos = writePos;
+
+        const auto offset = pos & kMask;
+        padding = (kSize - offset < size) ? (kSize - offset) : 0;
+
+        const auto readPos = __atomic_load_n(&gReadPos, __ATOMIC_ACQUIRE);
+        if((pos - readPos) + padding + size > kSize) {
+            __atomic_fetch_add(&gDropped, 1, __ATOMIC_RELAXED);
+            return false;
+        }
+    } while(!__atomic_compare_exchange_n(&gWritePos, &writePos, pos + padding + size, true,
+                __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+
+    if(padding) {
+        __atomic_store_n(HeaderAt(pos), kCommitted | kPadding | (padding - sizeof(uint32_t)),
+                __ATOMIC_RELEASE);
+        pos += padding;
+    }
+
+    // copy the message, then publish it
+    auto header = HeaderAt(pos);
+    memcpy(header + 1, message.data(), message.size());
+    __atomic_store_n(header, kCommitted | message.size(), __ATOMIC_RELEASE);
+
+    return true;
+}
+
+/**
+ * @brief Read messages out of the ring
+ *
+ * Copies as many complete messages as fit into the buffer, back to back, and releases their space
+ * in the ring. Reading stops at the first message that's still being written.
+ *
+ * @param buffer Buffer to receive messages
+ *
+ * @return Number of bytes read
+ *
+ * @remark Only one task may read from the ring.
+ */
+size_t Ring::Read(etl::span<uint8_t> buffer) {
+    size_t read{0};
+
+    auto pos = gReadPos;
+    const auto writePos = __atomic_load_n(&gWritePos, __ATOMIC_ACQUIRE);
+
+    while(pos != writePos) {
+        auto header = HeaderAt(pos);
+        const auto value = __atomic_load_n(header, __ATOMIC_ACQUIRE);
+        if(!(value & kCommitted)) {
+            break;
+        }
+
+        const size_t length = value & kLengthMask;
+        if(!(value & kPadding)) {
+            if(read + length > buffer.size()) {
+                break;
+            }
+
+            memcpy(buffer.data() + read, header + 1, length);
+            read += length;
+        }
+
+        /*
+         * Clear the entry, so that no stale header is seen as committed once its space is
+         * reserved again; then release it to writers.
+         */
+        const auto size = (value & kPadding) ? (sizeof(uint32_t) + length) : EntrySize(length);
+        memset(header, 0, size);
+
+        pos += size;
+        __atomic_store_n(&gReadPos, pos, __ATOMIC_RELEASE);
+    }
+
+    return read;
+}
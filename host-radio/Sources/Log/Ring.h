@@ -0,0 +1,92 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <etl/span.h>
+
+namespace Log {
+/**
+ * @brief Lock-free multiple producer, single consumer log message ring
+ *
+ * Tasks append complete messages to the ring without blocking or entering a critical section: a
+ * writer reserves space by atomically advancing the write position, copies its message in, then
+ * publishes it by setting the committed flag in the entry's header. The consumer (the logger's
+ * drain task) takes committed messages out in order, stopping at the first one that's still
+ * being written.
+ *
+ * Each entry is a 32-bit header (message length and flags) followed by the message, padded to a
+ * multiple of 4 bytes. Entries never wrap around the end of the ring; instead, the rest of the
+ * ring is filled with a padding entry, which is reserved together with the message.
+ *
+ * When there's not enough free space, the message is dropped (and counted) rather than waiting
+ * for the consumer.
+ *
+ * @remark Messages may be written from any task context, but not from interrupts.
+ */
+class Ring {
+    public:
+        /// Size of the ring (bytes); must be a power of two
+        constexpr static const size_t kSize{2048};
+        /// Maximum length of a single message (bytes)
+        constexpr static const size_t kMaxMessageSize{kSize / 4};
+
+    private:
+        static_assert(!(kSize & (kSize - 1)), "ring size must be a power of two");
+
+        /// Mask to convert a position to an offset into the ring
+        constexpr static const uint32_t kMask{kSize - 1};
+
+        /// Entry header: message length mask
+        constexpr static const uint32_t kLengthMask{0xFFFF};
+        /// Entry header: the entry is complete
+        constexpr static const uint32_t kCommitted{(1U << 31)};
+        /// Entry header: the entry is padding, and holds no message
+        constexpr static const uint32_t kPadding{(1U << 30)};
+
+    public:
+        [[nodiscard]] static bool Write(etl::span<const uint8_t> message);
+        static size_t Read(etl::span<uint8_t> buffer);
+
+        /**
+         * @brief Check whether there are messages to read
+         */
+        static inline bool IsEmpty() {
+            return __atomic_load_n(&gReadPos, __ATOMIC_RELAXED) ==
+                __atomic_load_n(&gWritePos, __ATOMIC_RELAXED);
+        }
+
+        /**
+         * @brief Get the number of messages dropped because the ring was full
+         */
+        static inline uint32_t GetDropped() {
+            return __atomic_load_n(&gDropped, __ATOMIC_RELAXED);
+        }
+
+    private:
+        /// Get the size of the entry holding a message of the given length
+        static constexpr inline size_t EntrySize(const size_t length) {
+            return sizeof(uint32_t) + ((length + 3) & ~3);
+        }
+
+        /// Get the header of the entry at the given position
+        static inline uint32_t *HeaderAt(const uint32_t pos) {
+            return reinterpret_cast<uint32_t *>(gBuffer + (pos & kMask));
+        }
+
+    private:
+        /// Ring storage
+        alignas(uint32_t) static uint8_t gBuffer[kSize];
+
+        /// Position at which the next entry is reserved (free running)
+        static uint32_t gWritePos;
+        /// Position of the oldest entry not yet read (free running)
+        static uint32_t gReadPos;
+
+        /// Number of messages dropped
+        static uint32_t gDropped;
+};
+}
+
+#endif
@@ -0,0 +1,145 @@
+#include <string.h>
+
+#include "Tokenizer.h"
+
+using namespace Log;
+
+namespace {
+/**
+ * @brief Record writer
+ *
+ * Appends to a buffer; once it's full, further writes are dropped and the writer is marked as
+ * truncated.
+ */
+struct Writer {
+    etl::span<uint8_t> buffer;
+    size_t offset{0};
+    bool truncated{false};
+
+    void put(const uint8_t byte) {
+        if(offset >= buffer.size()) {
+            truncated = true;
+            return;
+        }
+        buffer[offset++] = byte;
+    }
+
+    void putVarint(uint64_t value) {
+        do {
+            const uint8_t byte = value & 0x7F;
+            value >>= 7;
+            this->put(byte | (value ? 0x80 : 0));
+        } while(value);
+    }
+
+    void putSigned(const int64_t value) {
+        this->putVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    void putBytes(const void *data, const size_t length) {
+        const auto bytes = reinterpret_cast<const uint8_t *>(data);
+        for(size_t i = 0; i < length; i++) {
+            this->put(bytes[i]);
+        }
+    }
+
+    void putString(const char *str) {
+        if(!str) {
+            str = "(null)";
+        }
+
+        // always leave room for the terminator
+        while(*str && offset + 1 < buffer.size()) {
+            this->put(*str++);
+        }
+        if(*str) {
+            truncated = true;
+        }
+        if(offset < buffer.size()) {
+            this->put('\0');
+        }
+    }
+};
+}
+
+/**
+ * @brief Encode a log message as a record
+ *
+ * The arguments are encoded as described by the format string; the format string itself is
+ * referenced by address only, so it must remain valid (i.e. be in flash.) If the record doesn't
+ * fit in the buffer, its arguments are truncated.
+ *
+ * @param buffer Buffer to receive the record (at most kMaxRecordSize bytes are used)
+ * @param level Message level
+ * @param timestamp Message timestamp
+ * @param format Format string
+ * @param args Arguments to the format string
+ *
+ * @return Total size of the record
+ */
+size_t Tokenizer::Encode(etl::span<uint8_t> buffer, const uint8_t level,
+        const uint32_t timestamp, const char *format, va_list args) {
+    if(buffer.size() > kMaxRecordSize) {
+        buffer = buffer.first(kMaxRecordSize);
+    }
+    if(buffer.size() < sizeof(Header)) {
+        return 0;
+    }
+
+    Writer writer{.buffer = buffer.subspan(sizeof(Header))};
+
+    // encode arguments
+    const char *pos = format;
+    Conversion conv;
+
+    while(NextConversion(pos, conv)) {
+        for(size_t i = 0; i < conv.stars; i++) {
+            writer.putSigned(va_arg(args, int));
+        }
+
+        switch(conv.type) {
+            case ArgType::Int:
+                writer.putSigned(conv.longs ? va_arg(args, long) : va_arg(args, int));
+                break;
+            case ArgType::Uint:
+                writer.putVarint(conv.longs ? va_arg(args, unsigned long) :
+                        va_arg(args, unsigned int));
+                break;
+            case ArgType::Int64:
+                writer.putSigned(va_arg(args, long long));
+                break;
+            case ArgType::Uint64:
+                writer.putVarint(va_arg(args, unsigned long long));
+                break;
+            case ArgType::Pointer:
+                writer.putVarint(reinterpret_cast<uintptr_t>(va_arg(args, void *)));
+                break;
+            case ArgType::Double: {
+                const auto value = va_arg(args, double);
+                writer.putBytes(&value, sizeof(value));
+                break;
+            }
+            case ArgType::String:
+                writer.putString(va_arg(args, const char *));
+                break;
+            case ArgType::None:
+                break;
+        }
+
+        if(writer.truncated) {
+            break;
+        }
+    }
+
+    // then fill in the header
+    const Header hdr{
+        .sync = kSync,
+        .length = static_cast<uint8_t>(sizeof(Header) + writer.offset),
+        .level = level,
+        .timestamp = timestamp,
+        .format = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(format)),
+    };
+    memcpy(buffer.data(), &hdr, sizeof(hdr));
+
+    return hdr.length;
+}
@@ -0,0 +1,216 @@
+#ifndef LOG_TOKENIZER_H
+#define LOG_TOKENIZER_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <etl/span.h>
+
+namespace Log {
+/**
+ * @brief Binary (tokenized) log message encoding
+ *
+ * Rather than formatting messages on the device, the address of the format string (which lives
+ * in flash, and thus in the firmware's ELF file) is emitted together with the raw arguments. The
+ * host side decoder (`host-log-decode`) looks the format string up in the ELF file, and formats
+ * the message there.
+ *
+ * Each message is a record: a fixed header, followed by the encoded arguments, in order:
+ *
+ * - Integers (including characters and pointers) as LEB128 varints; signed values are zigzag
+ *   encoded first. Field width/precision given as `*` are encoded the same way, before the value.
+ * - Floating point values as 8 raw bytes (little endian double)
+ * - Strings inline, zero terminated (and truncated if the record would be too long)
+ *
+ * A record whose format address is 0 holds an already formatted message instead, for format
+ * strings that are not in flash.
+ *
+ * @remark The same conversion parser is used by the encoder and the decoder, so they can't
+ *         disagree about the arguments a format string takes.
+ */
+class Tokenizer {
+    public:
+        /// Sync byte at the start of every record
+        constexpr static const uint8_t kSync{0xA5};
+        /// Maximum length of a record (bytes, including the header)
+        constexpr static const size_t kMaxRecordSize{UINT8_MAX};
+
+        /**
+         * @brief Record header
+         */
+        struct Header {
+            /// Always kSync
+            uint8_t sync;
+            /// Total length of the record, including this header
+            uint8_t length;
+            /// Message level (Logger::Level)
+            uint8_t level;
+            /// Time the message was logged (µs, in the RAIL timebase)
+            uint32_t timestamp;
+            /// Address of the format string, or 0 if the record holds a formatted message
+            uint32_t format;
+        } __attribute__((packed));
+
+        /**
+         * @brief Type of argument consumed by a conversion
+         */
+        enum class ArgType: uint8_t {
+            /// Conversion doesn't consume an argument (`%%`, or an unsupported conversion)
+            None,
+            /// Signed integer (int or long)
+            Int,
+            /// Unsigned integer (unsigned int or unsigned long, characters)
+            Uint,
+            /// Signed 64-bit integer (long long)
+            Int64,
+            /// Unsigned 64-bit integer (unsigned long long)
+            Uint64,
+            /// Pointer
+            Pointer,
+            /// Floating point (double)
+            Double,
+            /// String
+            String,
+        };
+
+        /**
+         * @brief A single conversion specification in a format string
+         */
+        struct Conversion {
+            /// Start of the specification (the `%` character)
+            const char *start;
+            /// Length of the specification, including the conversion character
+            size_t length;
+            /// Number of `*` width/precision arguments preceding the value
+            uint8_t stars;
+            /// Number of `l` length modifiers (`j` counts as two)
+            uint8_t longs;
+            /// Type of value argument
+            ArgType type;
+            /// Conversion character
+            char conversion;
+        };
+
+    public:
+        /**
+         * @brief Find the next conversion in a format string
+         *
+         * @param format Position in the format string; advanced past the conversion
+         * @param out Conversion found
+         *
+         * @return Whether a conversion was found (false at the end of the string)
+         */
+        static bool NextConversion(const char *&format, Conversion &out) {
+            while(*format && *format != '%') {
+                format++;
+            }
+            if(!*format) {
+                return false;
+            }
+
+            out.start = format++;
+            out.stars = 0;
+
+            // flags, width and precision
+            while(*format && (IsFlag(*format) || (*format >= '0' && *format <= '9') ||
+                        *format == '.' || *format == '*')) {
+                if(*format == '*') {
+                    out.stars++;
+                }
+                format++;
+            }
+
+            // length modifiers
+            out.longs = 0;
+            while(*format && IsLengthModifier(*format)) {
+                if(*format == 'l') {
+                    out.longs++;
+                } else if(*format == 'j') {
+                    out.longs += 2;
+                }
+                format++;
+            }
+
+            out.conversion = *format;
+            if(*format) {
+                format++;
+            }
+            out.length = format - out.start;
+
+            switch(out.conversion) {
+                case 'd':
+                case 'i':
+                    out.type = (out.longs >= 2) ? ArgType::Int64 : ArgType::Int;
+                    break;
+                case 'u':
+                case 'x':
+                case 'X':
+                case 'o':
+                case 'c':
+                    out.type = (out.longs >= 2) ? ArgType::Uint64 : ArgType::Uint;
+                    break;
+                case 'p':
+                    out.type = ArgType::Pointer;
+                    break;
+                case 'f':
+                case 'F':
+                case 'e':
+                case 'E':
+                case 'g':
+                case 'G':
+                    out.type = ArgType::Double;
+                    break;
+                case 's':
+                    out.type = ArgType::String;
+                    break;
+                default:
+                    out.type = ArgType::None;
+                    out.stars = 0;
+                    break;
+            }
+
+            return true;
+        }
+
+        static size_t Encode(etl::span<uint8_t> buffer, const uint8_t level,
+                const uint32_t timestamp, const char *format, va_list args);
+
+        /**
+         * @brief Read a varint from a buffer
+         *
+         * @param data Buffer to read from; advanced past the value
+         * @param out Decoded value
+         *
+         * @return Whether a complete value was read
+         */
+        static bool ReadVarint(etl::span<const uint8_t> &data, uint64_t &out) {
+            out = 0;
+            for(size_t shift = 0; !data.empty() && shift < 64; shift += 7) {
+                const auto byte = data[0];
+                data = data.subspan(1);
+
+                out |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if(!(byte & 0x80)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /// Decode a zigzag encoded signed value
+        static constexpr inline int64_t Unzigzag(const uint64_t value) {
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+
+    private:
+        static constexpr inline bool IsFlag(const char c) {
+            return c == '-' || c == '+' || c == ' ' || c == '#';
+        }
+        static constexpr inline bool IsLengthModifier(const char c) {
+            return c == 'h' || c == 'l' || c == 'z' || c == 'j' || c == 't' || c == 'L';
+        }
+};
+}
+
+#endif
@@ -3,13 +3,16 @@
  *
  * @brief Application entry point
  */
+#include "em_device.h"
 #include "gpiointerrupt.h"
+#include "sl_sleeptimer.h"
 #include "Drivers/sl_spidrv_instances.h"
 #include "Drivers/sl_uartdrv_instances.h"
 
 #include "BuildInfo.h"
 #include "BlazeNet/Init.h"
 #include "Crypto/Init.h"
+#include "Debug/Probes.h"
 #include "Fs/Init.h"
 #include "HostIf/Init.h"
 #include "Hw/Clocks.h"
@@ -32,6 +35,9 @@ static void EarlyInit() {
     // configure system clocks
     Hw::Clocks::Init();
 
+    // start the profiling timer
+    Debug::Probes::Init();
+
     // set up logging
     Logger::Init();
 
@@ -49,6 +55,10 @@ static void HwInit() {
 
     GPIOINT_Init();
 
+    // high resolution timer; its callbacks may use the FreeRTOS API
+    sl_sleeptimer_init();
+    NVIC_SetPriority(SYSRTC_APP_IRQn, configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1);
+
     sl_spidrv_init_instances();
     sl_uartdrv_init_instances();
 }
@@ -2,11 +2,15 @@
 #include <stdlib.h>
 
 #include <BlazeNet/Types.h>
+#include <BlazeNet/HostIf/Commands.h>
 
-#include "HostIf/Commands.h"
+#include "Debug/Probes.h"
+#include "HostIf/EventRing.h"
 #include "HostIf/IrqManager.h"
 #include "Log/Logger.h"
 #include "Radio/Task.h"
+#include "Rtos/Heap.h"
+#include "Rtos/Rtos.h"
 #include "Handler.h"
 
 using namespace Packet;
@@ -15,10 +19,12 @@ bool Handler::gRxOverflowFlag{false};
 size_t Handler::gRxAllocBytes{0}, Handler::gRxQueueDiscarded{0}, Handler::gRxBufferDiscarded{0},
        Handler::gRxBufferAllocFailed{0};
 Handler::RxQueueType *Handler::gRxQueue;
+bool Handler::gRxAboveWatermark{false};
 
 bool Handler::gTxOverflowFlag{false};
 size_t Handler::gTxAllocBytes{0}, Handler::gTxQueueDiscarded{0}, Handler::gTxBufferDiscarded{0},
        Handler::gTxBufferAllocFailed{0}, Handler::gTxPacketsPending{0};
+bool Handler::gTxAboveWatermark{false};
 
 etl::array<Handler::TxQueueType *, 4> Handler::gTxQueues;
 
@@ -47,15 +53,15 @@ void Handler::Init() {
  */
 Handler::RxPacketBuffer *Handler::HandleRxPacket(const struct RAIL_RxPacketInfo &info,
         const struct RAIL_RxPacketDetails &details) {
+    PROBE_SCOPE(HandleRxPacket);
+
     // ensure we've queue space
     if(gRxQueue->full()) {
         gRxOverflowFlag = true;
         gRxQueueDiscarded++;
         UpdateRxQueueState();
 
-        if(kLogRxRejects) {
-            Logger::Warning("RX queue full!");
-        }
+        Logger::Warning(Logger::Module::Packet, "RX queue full!");
         return nullptr;
     }
 
@@ -67,21 +73,20 @@ Handler::RxPacketBuffer *Handler::HandleRxPacket(const struct RAIL_RxPacketInfo
         gRxBufferDiscarded++;
         UpdateRxQueueState();
 
-        if(kLogRxRejects) {
-            Logger::Warning("%s: Buffer alloc overflow (%u alloc)", "rx", gRxAllocBytes);
-        }
+        Logger::Warning(Logger::Module::Packet, "%s: Buffer alloc overflow (%u alloc)", "rx",
+                gRxAllocBytes);
         return nullptr;
     }
 
-    auto buffer = reinterpret_cast<RxPacketBuffer *>(malloc(requiredBytes));
+    auto buffer = reinterpret_cast<RxPacketBuffer *>(Rtos::Heap::Alloc(
+                Rtos::Heap::Class::PacketRx, requiredBytes));
     if(!buffer) {
         gRxOverflowFlag = true;
         gRxBufferAllocFailed++;
         UpdateRxQueueState();
 
-        if(kLogRxRejects) {
-            Logger::Warning("%s: failed to alloc %u bytes", "rx", requiredBytes);
-        }
+        Logger::Warning(Logger::Module::Packet, "%s: failed to alloc %u bytes", "rx",
+                requiredBytes);
         return nullptr;
     }
 
@@ -111,10 +116,8 @@ Handler::RxPacketBuffer *Handler::HandleRxPacket(const struct RAIL_RxPacketInfo
     // enqueue it
     gRxQueue->emplace(buffer);
 
-    if(kLogRx) {
-        Logger::Trace("%s: queue %u/%u (%p)", "rx", gRxQueue->available(), gRxQueue->capacity(),
-                buffer);
-    }
+    Logger::Trace(Logger::Module::Packet, "%s: queue %u/%u (%p)", "rx", gRxQueue->available(),
+            gRxQueue->capacity(), buffer);
 
     UpdateRxQueueState();
 
@@ -137,8 +140,10 @@ void Handler::DiscardRxPacket(RxPacketBuffer *buffer, const bool ack) {
     // release the packet buffer
     const auto numBytes = sizeof(*buffer) + buffer->packetSize;
 
-    free(buffer);
+    Rtos::Heap::Free(Rtos::Heap::Class::PacketRx, buffer);
     gRxAllocBytes -= numBytes;
+
+    UpdateWatermarks();
 }
 
 /**
@@ -151,6 +156,8 @@ void Handler::UpdateRxQueueState() {
     if(!gRxQueue->empty()) {
         HostIf::IrqManager::Assert(HostIf::Interrupt::PacketReceived);
     }
+
+    UpdateWatermarks();
 }
 
 
@@ -173,9 +180,7 @@ int Handler::QueueTxPacket(const TxPacketPriority priority, TxPacketBuffer *pack
         gTxQueueDiscarded++;
         UpdateTxQueueState();
 
-        if(kLogTxRejects) {
-            Logger::Warning("TX queue %u full!", static_cast<size_t>(priority));
-        }
+        Logger::Warning(Logger::Module::Packet, "TX queue %u full!", static_cast<size_t>(priority));
 
         return -1;
     }
@@ -204,22 +209,21 @@ Handler::TxPacketBuffer *Handler::AllocTxPacket(etl::span<const uint8_t> payload
         gTxBufferDiscarded++;
         UpdateTxQueueState();
 
-        if(kLogTxRejects) {
-            Logger::Warning("%s: Buffer alloc overflow (%u alloc)", "tx", gTxAllocBytes);
-        }
+        Logger::Warning(Logger::Module::Packet, "%s: Buffer alloc overflow (%u alloc)", "tx",
+                gTxAllocBytes);
         return nullptr;
     }
 
     // allocate the buffer
-    auto buffer = reinterpret_cast<TxPacketBuffer *>(malloc(requiredBytes));
+    auto buffer = reinterpret_cast<TxPacketBuffer *>(Rtos::Heap::Alloc(
+                Rtos::Heap::Class::PacketTx, requiredBytes));
     if(!buffer) {
         gTxOverflowFlag = true;
         gTxBufferAllocFailed++;
         UpdateTxQueueState();
 
-        if(kLogTxRejects) {
-            Logger::Warning("%s: failed to alloc %u bytes", "tx", requiredBytes);
-        }
+        Logger::Warning(Logger::Module::Packet, "%s: failed to alloc %u bytes", "tx",
+                requiredBytes);
         return nullptr;
     }
 
@@ -261,9 +265,7 @@ Handler::TxPacketBuffer *Handler::QueueTxPacket(const TxPacketPriority priority,
         gTxQueueDiscarded++;
         UpdateTxQueueState();
 
-        if(kLogTxRejects) {
-            Logger::Warning("TX queue %u full!", static_cast<size_t>(priority));
-        }
+        Logger::Warning(Logger::Module::Packet, "TX queue %u full!", static_cast<size_t>(priority));
         return nullptr;
     }
 
@@ -276,7 +278,7 @@ Handler::TxPacketBuffer *Handler::QueueTxPacket(const TxPacketPriority priority,
     // either enqueue packet or transmit it
     err = QueueTxPacketFinal(queue, buffer);
     if(err) {
-        Logger::Warning("%s failed: %d", "EnqueueTxPacket", err);
+        Logger::Warning(Logger::Module::Packet, "%s failed: %d", "EnqueueTxPacket", err);
 
         // clean up resources
         DiscardTxPacket(buffer, true);
@@ -312,10 +314,8 @@ int Handler::QueueTxPacketFinal(TxQueueType *queue, TxPacketBuffer *buffer) {
     else {
         queue->emplace(buffer);
 
-        if(kLogTx) {
-            Logger::Trace("%s: queue %u/%u (%p)", "tx", queue->available(), queue->capacity(),
-                    buffer);
-        }
+        Logger::Trace(Logger::Module::Packet, "%s: queue %u/%u (%p)", "tx", queue->available(),
+                queue->capacity(), buffer);
     }
 
     UpdateTxQueueState();
@@ -333,11 +333,7 @@ int Handler::QueueTxPacketFinal(TxQueueType *queue, TxPacketBuffer *buffer) {
 void Handler::DiscardTxPacket(TxPacketBuffer *buffer, const bool force) {
     // free the packet if it's not sticky
     if(!buffer->isSticky || force) {
-        const auto numBytes = sizeof(*buffer) + buffer->packetSize;
-
-        free(buffer);
-
-        gTxAllocBytes -= numBytes;
+        FreeTxPacket(buffer);
     }
 
     // update generic bookkeeping
@@ -345,6 +341,22 @@ void Handler::DiscardTxPacket(TxPacketBuffer *buffer, const bool force) {
     UpdateTxQueueState();
 }
 
+/**
+ * @brief Release a transmit packet that isn't queued
+ *
+ * Deallocates a packet obtained from AllocTxPacket, without touching the pending packet count;
+ * use this for (sticky) packets that are owned by their allocator between transmissions.
+ *
+ * @param buffer Packet to be released
+ */
+void Handler::FreeTxPacket(TxPacketBuffer *buffer) {
+    const auto numBytes = sizeof(*buffer) + buffer->packetSize;
+
+    Rtos::Heap::Free(Rtos::Heap::Class::PacketTx, buffer);
+
+    gTxAllocBytes -= numBytes;
+}
+
 /**
  * @brief Update the state of the transmit queue
  *
@@ -355,6 +367,51 @@ void Handler::UpdateTxQueueState() {
     if(!gTxPacketsPending) {
         HostIf::IrqManager::Assert(HostIf::Interrupt::TxQueueEmpty);
     }
+
+    UpdateWatermarks();
+}
+
+/**
+ * @brief Check queue buffer usage against the watermarks
+ *
+ * Record an event for the host whenever a queue's buffer usage rises above the high watermark,
+ * or drops below the low watermark after having been above the high one.
+ */
+void Handler::UpdateWatermarks() {
+    using Event = HostIf::Response::Event;
+
+    // called from both the radio and host interface tasks: flip the flags atomically, so that
+    // each crossing is reported exactly once; the events are recorded outside the critical section
+    bool rxChanged{false}, txChanged{false};
+
+    taskENTER_CRITICAL();
+
+    if(!gRxAboveWatermark && gRxAllocBytes > (kMaxRxBufferSize * kHighWatermark) / 100) {
+        gRxAboveWatermark = rxChanged = true;
+    } else if(gRxAboveWatermark && gRxAllocBytes < (kMaxRxBufferSize * kLowWatermark) / 100) {
+        gRxAboveWatermark = false;
+        rxChanged = true;
+    }
+
+    if(!gTxAboveWatermark && gTxAllocBytes > (kMaxTxBufferSize * kHighWatermark) / 100) {
+        gTxAboveWatermark = txChanged = true;
+    } else if(gTxAboveWatermark && gTxAllocBytes < (kMaxTxBufferSize * kLowWatermark) / 100) {
+        gTxAboveWatermark = false;
+        txChanged = true;
+    }
+
+    const bool rxAbove{gRxAboveWatermark}, txAbove{gTxAboveWatermark};
+
+    taskEXIT_CRITICAL();
+
+    if(rxChanged) {
+        HostIf::EventRing::QueueWatermark(Event::RxQueue, rxAbove, gRxAllocBytes,
+                gRxQueue->size());
+    }
+    if(txChanged) {
+        HostIf::EventRing::QueueWatermark(Event::TxQueue, txAbove, gTxAllocBytes,
+                gTxPacketsPending);
+    }
 }
 
 /**
@@ -379,3 +436,24 @@ void Handler::ReadCounters(HostIf::Response::GetCounters *packet) {
     packet->txQueue.bufferAllocFails = etl::exchange(gTxBufferAllocFailed, 0);
     packet->txQueue.queueDiscards = etl::exchange(gTxQueueDiscarded, 0);
 }
+
+/**
+ * @brief Read out the current queue state
+ *
+ * Fills in the receive and transmit queue sections of a status snapshot. Unlike the performance
+ * counters, nothing is cleared by this call.
+ *
+ * @param packet Snapshot to receive the queue state
+ */
+void Handler::ReadSnapshot(HostIf::Response::StatusSnapshot *packet) {
+    // rx queue
+    packet->rxQueue.packetsPending = gRxQueue->size();
+    packet->rxQueue.bufferSize = gRxAllocBytes;
+    packet->rxQueue.nextPacketSize = gRxQueue->empty() ? 0 : gRxQueue->front()->packetSize;
+
+    // tx queue
+    packet->txQueue.packetsPending = gTxPacketsPending;
+    packet->txQueue.bufferSize = gTxAllocBytes;
+    packet->txQueue.credits = (gTxAllocBytes < kMaxTxBufferSize) ?
+        (kMaxTxBufferSize - gTxAllocBytes) : 0;
+}
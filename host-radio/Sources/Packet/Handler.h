@@ -10,6 +10,7 @@
 
 namespace HostIf::Response {
 struct GetCounters;
+struct StatusSnapshot;
 }
 
 namespace Packet {
@@ -26,15 +27,6 @@ namespace Packet {
  */
 class Handler {
     private:
-        /// Log information about rejected receive packets
-        constexpr static const bool kLogRxRejects{true};
-        /// Log when a receive packet is queued
-        constexpr static const bool kLogRx{false};
-        /// Log information about rejected transmit packets
-        constexpr static const bool kLogTxRejects{true};
-        /// Log information about transmit queue packets
-        constexpr static const bool kLogTx{true};
-
         /**
          * @brief Maximum packet data size
          *
@@ -59,6 +51,16 @@ class Handler {
          */
         constexpr static const size_t kMaxRxQueueSize{255};
 
+        /**
+         * @brief Queue watermarks
+         *
+         * Buffer usage (in percent of the queue's buffer size limit) above which a high watermark
+         * event is reported to the host, and below which a subsequent low watermark event is
+         * reported.
+         */
+        constexpr static const size_t kHighWatermark{75}, kLowWatermark{25};
+
+    public:
         /**
          * @brief Maximum size to reserve for transmit buffers
          *
@@ -76,7 +78,6 @@ class Handler {
          */
         constexpr static const size_t kMaxTxQueueSize{16};
 
-    public:
         /**
          * @brief Packet priority values
          *
@@ -184,6 +185,7 @@ class Handler {
         static TxPacketBuffer *QueueTxPacket(const TxPacketPriority priority,
                 etl::span<const uint8_t> payload, const bool isSticky = false);
         static void DiscardTxPacket(TxPacketBuffer *, const bool force = false);
+        static void FreeTxPacket(TxPacketBuffer *);
 
         static RxPacketBuffer *HandleRxPacket(const struct RAIL_RxPacketInfo &,
                 const struct RAIL_RxPacketDetails &);
@@ -204,11 +206,17 @@ class Handler {
          * Returns the first (oldest) packet in the receive queue, and then removes it from the
          * queue.
          *
+         * @return Packet from queue, or `nullptr` if the queue is empty
+         *
          * @remark Be sure to call DiscardRxPacket when done to release the packet's memory.
          *
          * @seeAlso DiscardRxPacket
          */
-        static inline auto PopRxQueue() {
+        static inline RxPacketBuffer *PopRxQueue() {
+            if(gRxQueue->empty()) {
+                return nullptr;
+            }
+
             RxPacketBuffer *buf = gRxQueue->front();
             gRxQueue->pop();
             UpdateRxQueueState();
@@ -277,10 +285,12 @@ class Handler {
         }
 
         static void ReadCounters(HostIf::Response::GetCounters *packet);
+        static void ReadSnapshot(HostIf::Response::StatusSnapshot *packet);
 
     private:
         static void UpdateRxQueueState();
         static void UpdateTxQueueState();
+        static void UpdateWatermarks();
 
         static int QueueTxPacketFinal(TxQueueType *, TxPacketBuffer *);
 
@@ -297,6 +307,8 @@ class Handler {
         static size_t gRxQueueDiscarded;
         /// Queue holding pointers to all received packets
         static RxQueueType *gRxQueue;
+        /// Rx buffer usage is above the high watermark (and hasn't dropped below the low one)
+        static bool gRxAboveWatermark;
 
         /// Tx queue overflow flag (sticky)
         static bool gTxOverflowFlag;
@@ -310,6 +322,8 @@ class Handler {
         static size_t gTxQueueDiscarded;
         /// Total number of packets pending (if 0, transmit directly)
         static size_t gTxPacketsPending;
+        /// Tx buffer usage is above the high watermark (and hasn't dropped below the low one)
+        static bool gTxAboveWatermark;
         /// Containers for receive queues (in ascending priority order)
         static etl::array<TxQueueType *, 4> gTxQueues;
 };
@@ -38,6 +38,9 @@ void Radio::Init() {
     sl_rail_util_rssi_init();
 
     sl_rail_util_init();
+
+    // the RAIL timebase is now running
+    Logger::EnableTimestamps();
 }
 
 /**
@@ -1,7 +1,9 @@
 #include <rail.h>
 #include <BlazeNet/Types.h>
+#include <BlazeNet/HostIf/Commands.h>
 
-#include "HostIf/Commands.h"
+#include "Debug/Probes.h"
+#include "HostIf/EventRing.h"
 #include "Hw/Indicators.h"
 #include "Log/Logger.h"
 #include "Packet/Handler.h"
@@ -19,6 +21,7 @@ uint32_t Task::gCalibrationIr{0};
 size_t Task::gRxFifoOverflows{0}, Task::gRxFrameErrors{0}, Task::gRxFrames{0};
 
 uint16_t Task::gAddress{0};
+TickType_t Task::gLastActivity{0};
 uint16_t Task::gTxChannel{UINT16_MAX};
 size_t Task::gTxFifoDrops{0}, Task::gTxCcaFails{0}, Task::gTxFrames{0};
 Packet::Handler::TxPacketBuffer *Task::gLastTx{nullptr};
@@ -93,7 +96,7 @@ void Task::InitCalibration() {
     err = RAIL_CalibrateIr(gRail, &gCalibrationIr);
     REQUIRE(err == RAIL_STATUS_NO_ERROR, "%s failed: %d", "RAIL_CalibrateIr", err);
 
-    Logger::Debug("Radio IR calib: %08x", gCalibrationIr);
+    Logger::Debug(Logger::Module::Radio, "Radio IR calib: %08x", gCalibrationIr);
 }
 
 
@@ -106,7 +109,7 @@ void Task::Main() {
     BaseType_t ok;
 
     // perform deferred radio setup
-    Logger::Trace("%s: init", "Radio");
+    Logger::Trace(Logger::Module::Radio, "%s: init", "Radio");
 
     RAIL_ResetFifo(gRail, true, true);
 
@@ -121,6 +124,8 @@ void Task::Main() {
                 portMAX_DELAY);
         REQUIRE(ok == pdTRUE, "%s failed: %d", "xTaskNotifyWaitIndexed", ok);
 
+        gLastActivity = xTaskGetTickCount();
+
         // copy out a received packet
         if(note & NotifyBits::PacketReceived) {
             Hw::Indicators::PulseRx();
@@ -132,7 +137,7 @@ void Task::Main() {
         if(note & NotifyBits::PacketTransmitted) {
             Hw::Indicators::PulseTx();
 
-            HandleTxComplete();
+            HandleTxComplete(true);
         }
         // failed to transmit packet: channel busy. retry again
         if(note & NotifyBits::TxChannelBusy) {
@@ -140,30 +145,33 @@ void Task::Main() {
 
             // ensure it's not over the attempts
             if(++gLastTx->csmaFailCount < kMaxCsmaFails) {
-                if(kLogTxCsmaRetries) {
-                    Logger::Notice("tx %p: CSMA retry %u/%u", gLastTx, gLastTx->csmaFailCount,
-                            kMaxCsmaFails);
-                }
+                Logger::Debug(Logger::Module::Radio, "tx %p: CSMA retry %u/%u", gLastTx,
+                        gLastTx->csmaFailCount, kMaxCsmaFails);
 
                 err = TxPacketImmediate(gLastTx);
                 REQUIRE(!err, "%s failed: %d", "TxPacketImmediate", err);
             }
             // otherwise, discard the packet
             else {
-                Logger::Warning("dropped packet %p due to CSMA fail", gLastTx);
-                HandleTxComplete();
+                Logger::Warning(Logger::Module::Radio, "dropped packet %p due to CSMA fail",
+                        gLastTx);
+                HandleTxComplete(false);
             }
         }
         // calibrate radio
         if(note & NotifyBits::CalibrationRequired) {
             // TODO: notify nodes we're going away for a bit
-            Logger::Notice("Calibration required: %08x", RAIL_GetPendingCal(gRail));
+            const auto pending = RAIL_GetPendingCal(gRail);
+            Logger::Notice(Logger::Module::Radio, "Calibration required: %08x", pending);
+            HostIf::EventRing::CalibrationStarted(pending);
 
             // okay, do it
             auto status = RAIL_Calibrate(gRail, &gCalibrationData, RAIL_CAL_ALL_PENDING);
             if(status != RAIL_STATUS_NO_ERROR) {
-                Logger::Warning("Calibration failed: %d", status);
+                Logger::Warning(Logger::Module::Radio, "Calibration failed: %d", status);
             }
+
+            HostIf::EventRing::CalibrationFinished(status);
         }
     }
 }
@@ -181,20 +189,20 @@ void Task::ReadPacket() {
     // get packet handle and then acquire packet details
     auto phandle = RAIL_GetRxPacketInfo(gRail, RAIL_RX_PACKET_HANDLE_OLDEST_COMPLETE, &info);
     if(phandle == RAIL_RX_PACKET_HANDLE_INVALID) {
-        Logger::Warning("failed to read packet!");
+        Logger::Warning(Logger::Module::Radio, "failed to read packet!");
         return;
     }
 
     RAIL_GetRxPacketDetails(gRail, phandle, &details);
 
-    if(kLogRx) {
-        Logger::Notice("Rx(%u) rssi: %d", info.packetBytes, details.rssi);
-    }
+    Logger::Trace(Logger::Module::Radio, "Rx(%u) rssi: %d", info.packetBytes, details.rssi);
 
     // enqueue the packet (it will be copied)
-    Packet::Handler::HandleRxPacket(info, details);
+    const auto buffer = Packet::Handler::HandleRxPacket(info, details);
     gRxFrames++;
 
+    HostIf::EventRing::FrameReceived(info.packetBytes, details.rssi, details.lqi, !!buffer);
+
 /*
     // generate acknowledgement
     static etl::array<uint8_t, 6> gAckBuffer;
@@ -219,6 +227,7 @@ void Task::ReadPacket() {
  * @return 0 on success or a negative error code
  */
 int Task::TxPacketImmediate(Packet::Handler::TxPacketBuffer *packet) {
+    PROBE_SCOPE(TxPacketImmediate);
     RAIL_Status_t err;
 
     taskENTER_CRITICAL();
@@ -244,23 +253,24 @@ int Task::TxPacketImmediate(Packet::Handler::TxPacketBuffer *packet) {
     gLastTx = packet;
     taskEXIT_CRITICAL();
 
-    if(kLogTx) {
-        Logger::Notice("start tx %p", packet);
-    }
+    Logger::Trace(Logger::Module::Radio, "start tx %p", packet);
 
     return 0;
 }
 
 /**
- * @brief The last packet was successfully transmitted
+ * @brief The last packet finished transmitting
  *
  * Release the packet buffer associated with the packet, and set up for transmitting the next
  * packet, if any.
+ *
+ * @param success Whether the packet was transmitted (otherwise, it was dropped)
  */
-void Task::HandleTxComplete() {
+void Task::HandleTxComplete(const bool success) {
     int err;
 
-    // TODO: anything else?
+    HostIf::EventRing::TxComplete(gLastTx->packetSize, success ?
+            HostIf::Response::Event::Success : HostIf::Response::Event::ChannelBusy);
 
     // discard the buffer
     Packet::Handler::DiscardTxPacket(gLastTx);
@@ -298,7 +308,7 @@ int Task::SetChannel(const uint16_t newChannel) {
 
     // validate channel number
     if(RAIL_IsValidChannel(gRail, newChannel) != RAIL_STATUS_NO_ERROR) {
-        Logger::Warning("invalid channel %u", newChannel);
+        Logger::Warning(Logger::Module::Radio, "invalid channel %u", newChannel);
         return -2;
     }
 
@@ -309,7 +319,7 @@ int Task::SetChannel(const uint16_t newChannel) {
     err = RAIL_StartRx(gRail, newChannel, nullptr);
 
     if(err != RAIL_STATUS_NO_ERROR) {
-        Logger::Warning("%s failed: %d", "RAIL_StartRx", err);
+        Logger::Warning(Logger::Module::Radio, "%s failed: %d", "RAIL_StartRx", err);
         return -1;
     }
 
@@ -433,7 +443,7 @@ void Task::QueueAck(etl::span<const uint8_t> packet) {
     // queue it for transmission
     auto tx = Packet::Handler::QueueTxPacket(Packet::Handler::TxPacketPriority::NetworkControl,
             buffer);
-    REQUIRE(!tx, "failed to ack packet (src=%04x, tag=%02x): %s", inHdr->source, inHdr->sequence,
+    REQUIRE(tx, "failed to ack packet (src=%04x, tag=%02x): %s", inHdr->source, inHdr->sequence,
             "failed to alloc tx buf");
 }
 
@@ -469,7 +479,7 @@ extern "C" void sl_rail_util_on_event(RAIL_Handle_t handle, RAIL_Events_t events
     BaseType_t woken{pdFALSE};
 
 #if 0
-    Logger::Notice("RAIL(%p) event: %016llx", handle, (uint64_t) events);
+    Logger::Notice(Logger::Module::Radio, "RAIL(%p) event: %016llx", handle, (uint64_t) events);
 #endif
 
     // packet received
@@ -40,13 +40,6 @@ class Task {
         /// Notification index
         static const constexpr size_t kNotificationIndex{Rtos::TaskNotifyIndex::TaskSpecific};
 
-        /// Should received packets be logged?
-        static const constexpr bool kLogRx{false};
-        /// Should transmit packets be logged?
-        static const constexpr bool kLogTx{false};
-        /// Should CSMA transmit failures be logged?
-        static const constexpr bool kLogTxCsmaRetries{true};
-
         /**
          * @brief Enable clear channel assessment before transmit
          *
@@ -90,6 +83,13 @@ class Task {
 
         static bool IsActive();
 
+        /**
+         * @brief Get the tick count of the most recent radio event
+         */
+        static inline TickType_t GetLastActivity() {
+            return gLastActivity;
+        }
+
         static void QueueAck(etl::span<const uint8_t> packet);
         [[nodiscard]] static int TxPacketImmediate(Packet::Handler::TxPacketBuffer *packet);
 
@@ -102,7 +102,7 @@ class Task {
         static void Main();
 
         static void ReadPacket();
-        static void HandleTxComplete();
+        static void HandleTxComplete(const bool success);
 
     private:
         /// CSMA configuration
@@ -139,6 +139,9 @@ class Task {
 
         /// Short MAC address of the coordinator node
         static uint16_t gAddress;
+
+        /// Tick count at which the task last handled an event
+        static TickType_t gLastActivity;
 };
 }
 
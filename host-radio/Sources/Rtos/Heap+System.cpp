@@ -0,0 +1,38 @@
+/**
+ * @file
+ *
+ * @brief System heap state (newlib)
+ *
+ * The heap occupies the region between the `__HeapBase` and `__HeapLimit` symbols defined by the
+ * linker script.
+ */
+#include <malloc.h>
+#include <stdlib.h>
+
+#include <etl/algorithm.h>
+
+#include "Rtos.h"
+#include "Heap.h"
+
+using namespace Rtos;
+
+extern "C" char __HeapBase[], __HeapLimit[];
+
+/**
+ * @brief Get the state of the system heap
+ *
+ * Everything is taken from mallinfo(), rather than probing with allocations: those could block
+ * on the allocator's lock (held by a preempted task) and would grow the arena. As the allocator
+ * doesn't track its largest free block, the contiguous free space at the end of the heap is
+ * reported instead: the part not yet claimed from sbrk, plus the releasable chunk at the top of
+ * the arena. It's a lower bound; free chunks further down count as fragmented.
+ */
+void Heap::GetSystemStats(SystemStats &out) {
+    const auto info = mallinfo();
+
+    out.size = __HeapLimit - __HeapBase;
+    out.free = (info.uordblks < out.size) ? (out.size - info.uordblks) : 0;
+
+    const size_t unclaimed = (info.arena < out.size) ? (out.size - info.arena) : 0;
+    out.largestFree = etl::min(unclaimed + info.keepcost, out.free);
+}
@@ -0,0 +1,97 @@
+#include <malloc.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <etl/algorithm.h>
+
+#include "Rtos.h"
+#include "Heap.h"
+
+using namespace Rtos;
+
+HostIf::Response::HeapClass Heap::gClasses[kNumClasses];
+size_t Heap::gBytes{0};
+size_t Heap::gPeakBytes{0};
+
+/**
+ * @brief Allocate memory
+ *
+ * @param cls Class to account the allocation to
+ * @param bytes Number of bytes to allocate
+ *
+ * @return Allocated memory, or `nullptr` if out of memory
+ */
+void *Heap::Alloc(const Class cls, const size_t bytes) {
+    auto ptr = malloc(bytes);
+    const auto size = ptr ? malloc_usable_size(ptr) : 0;
+    auto &counters = gClasses[cls];
+
+    taskENTER_CRITICAL();
+
+    if(!ptr) {
+        counters.failures++;
+    } else {
+        counters.allocs++;
+        counters.bytes += size;
+        counters.peakBytes = etl::max(counters.peakBytes, counters.bytes);
+
+        gBytes += size;
+        gPeakBytes = etl::max(gPeakBytes, gBytes);
+    }
+
+    taskEXIT_CRITICAL();
+
+    return ptr;
+}
+
+/**
+ * @brief Release memory obtained from Alloc()
+ *
+ * @param cls Class the memory was allocated with
+ * @param ptr Memory to release (may be `nullptr`)
+ */
+void Heap::Free(const Class cls, void *ptr) {
+    if(!ptr) {
+        return;
+    }
+
+    const auto size = malloc_usable_size(ptr);
+    free(ptr);
+
+    auto &counters = gClasses[cls];
+
+    taskENTER_CRITICAL();
+
+    counters.frees++;
+    counters.bytes -= size;
+    gBytes -= size;
+
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Report heap usage
+ *
+ * @param out Response to fill in
+ */
+void Heap::Read(HostIf::Response::GetHeapStats &out) {
+    SystemStats system{};
+    GetSystemStats(system);
+
+    memset(&out, 0, sizeof(out));
+
+    out.heapSize = system.size;
+    out.heapFree = system.free;
+    out.largestFree = system.largestFree;
+    if(system.free) {
+        out.fragmentation = 1000 - (static_cast<uint64_t>(system.largestFree) * 1000 / system.free);
+    }
+
+    taskENTER_CRITICAL();
+
+    out.bytes = gBytes;
+    out.peakBytes = gPeakBytes;
+    memcpy(out.classes, gClasses, sizeof(gClasses));
+
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,59 @@
+#ifndef RTOS_HEAP_H
+#define RTOS_HEAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <BlazeNet/HostIf/Commands.h>
+
+namespace Rtos {
+/**
+ * @brief Instrumented heap allocations
+ *
+ * Firmware allocations go through here, tagged with a class (packet buffers, log buffers, and so
+ * on) so that current and peak usage can be tracked for each of them. Together with the state of
+ * the system heap (free space and fragmentation) these are reported to the host by the
+ * GetHeapStats command.
+ *
+ * Allocations are accounted with their usable size, which includes the allocator's rounding.
+ *
+ * @remark Allocations may be made from any task context, but not from interrupts.
+ */
+class Heap {
+    public:
+        using Class = HostIf::Response::GetHeapStats::Class;
+
+        /// Number of allocation classes
+        constexpr static const size_t kNumClasses{Class::NumClasses};
+
+    public:
+        [[nodiscard]] static void *Alloc(const Class cls, const size_t bytes);
+        static void Free(const Class cls, void *ptr);
+
+        static void Read(HostIf::Response::GetHeapStats &out);
+
+    private:
+        /// State of the system heap
+        struct SystemStats {
+            /// Total heap size (bytes)
+            size_t size;
+            /// Free space (bytes)
+            size_t free;
+            /// Largest block known to be available for allocation (bytes)
+            size_t largestFree;
+        };
+
+        /// Platform specific: get the system heap state
+        static void GetSystemStats(SystemStats &out);
+
+    private:
+        /// Counters for each allocation class
+        static HostIf::Response::HeapClass gClasses[kNumClasses];
+        /// Bytes currently allocated over all classes
+        static size_t gBytes;
+        /// Peak bytes allocated over all classes
+        static size_t gPeakBytes;
+};
+}
+
+#endif
@@ -83,6 +83,8 @@ enum TaskNotifyIndex: size_t {
      * The assignment is as follows:
      * - Bit 0: confd service requests
      * - Bit 1: ResourceManager requests
+     * - Bit 2: Fs::Flash asynchronous transfer completion
+     * - Bit 3: Fs::Flash completion poll timer
      */
     DriverPrivate                       = 1,
     /// First task specific value
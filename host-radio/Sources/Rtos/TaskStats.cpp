@@ -0,0 +1,97 @@
+#include <string.h>
+
+#include <etl/algorithm.h>
+
+#include "Log/Logger.h"
+
+#include "TaskStats.h"
+
+using namespace Rtos;
+
+etl::array<TaskStatus_t, TaskStats::kMaxTasks> TaskStats::gStatus;
+
+etl::array<TaskStats::Baseline, TaskStats::kMaxTasks> TaskStats::gBaseline;
+size_t TaskStats::gNumBaseline{0};
+uint32_t TaskStats::gBaselineTotal{0};
+
+etl::array<TaskStats::Baseline, TaskStats::kMaxTasks> TaskStats::gPending;
+size_t TaskStats::gNumPending{0};
+uint32_t TaskStats::gPendingTotal{0};
+
+/**
+ * @brief Take a report
+ *
+ * Fill in the run time of each task since the last delivered report, as well as its current
+ * priority and stack high water mark. Tasks are reported in the order the kernel returns them.
+ *
+ * @param header Report header to fill in
+ * @param outTasks Buffer to receive task records (it may be smaller than the number of tasks)
+ *
+ * @return Number of task records written
+ */
+size_t TaskStats::Read(HostIf::Response::GetTaskStats &header,
+        etl::span<HostIf::Response::TaskInfo> outTasks) {
+    uint32_t total{0};
+
+    const auto numTasks = uxTaskGetSystemState(gStatus.data(), gStatus.size(), &total);
+    if(!numTasks) {
+        Logger::Warning("Failed to get RTOS state");
+    }
+
+    const auto numRecords = etl::min(static_cast<size_t>(numTasks), outTasks.size());
+
+    header.interval = total - gBaselineTotal;
+    header.numTasks = numTasks;
+    header.numRecords = numRecords;
+
+    for(size_t i = 0; i < numRecords; i++) {
+        const auto &task = gStatus[i];
+        auto &record = outTasks[i];
+
+        memset(&record, 0, sizeof(record));
+        strncpy(record.name, task.pcTaskName, sizeof(record.name));
+
+        record.runTime = task.ulRunTimeCounter - GetBaseline(task.xTaskNumber);
+        record.stackHighWater = task.usStackHighWaterMark;
+        record.priority = task.uxCurrentPriority;
+        record.state = task.eCurrentState;
+    }
+
+    // remember counters to use as the next baseline
+    for(size_t i = 0; i < numTasks; i++) {
+        gPending[i] = {
+            .taskNumber = gStatus[i].xTaskNumber,
+            .runTime = static_cast<uint32_t>(gStatus[i].ulRunTimeCounter),
+        };
+    }
+    gNumPending = numTasks;
+    gPendingTotal = total;
+
+    return numRecords;
+}
+
+/**
+ * @brief Mark the last report as delivered
+ *
+ * The next report is relative to the counters captured by it.
+ */
+void TaskStats::Commit() {
+    gBaseline = gPending;
+    gNumBaseline = gNumPending;
+    gBaselineTotal = gPendingTotal;
+}
+
+/**
+ * @brief Get a task's run time counter as of the last delivered report
+ *
+ * @return Counter value, or 0 if the task didn't exist yet
+ */
+uint32_t TaskStats::GetBaseline(const UBaseType_t taskNumber) {
+    for(size_t i = 0; i < gNumBaseline; i++) {
+        if(gBaseline[i].taskNumber == taskNumber) {
+            return gBaseline[i].runTime;
+        }
+    }
+
+    return 0;
+}
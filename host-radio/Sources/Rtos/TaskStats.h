@@ -0,0 +1,61 @@
+#ifndef RTOS_TASKSTATS_H
+#define RTOS_TASKSTATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <etl/array.h>
+#include <etl/span.h>
+
+#include <BlazeNet/HostIf/Commands.h>
+
+#include "Rtos.h"
+
+namespace Rtos {
+/**
+ * @brief Per-task CPU utilization
+ *
+ * Reports the run time each task accumulated since the previous report, using the kernel's run
+ * time statistics. The counters are only advanced once a report has been delivered (Commit) so a
+ * failed read doesn't lose an interval.
+ *
+ * @remark Reports must be taken from a single task.
+ */
+class TaskStats {
+    public:
+        /// Maximum number of tasks that can be reported
+        constexpr static const size_t kMaxTasks{12};
+
+    public:
+        static size_t Read(HostIf::Response::GetTaskStats &header,
+                etl::span<HostIf::Response::TaskInfo> outTasks);
+        static void Commit();
+
+    private:
+        /// Run time counter of a task at the time of a report
+        struct Baseline {
+            /// Kernel assigned task number
+            UBaseType_t taskNumber;
+            /// Task's run time counter
+            uint32_t runTime;
+        };
+
+        static uint32_t GetBaseline(const UBaseType_t taskNumber);
+
+    private:
+        /// Task state buffer
+        static etl::array<TaskStatus_t, kMaxTasks> gStatus;
+
+        /// Counters as of the last delivered report
+        static etl::array<Baseline, kMaxTasks> gBaseline;
+        static size_t gNumBaseline;
+        static uint32_t gBaselineTotal;
+
+        /// Counters as of the last report taken (not yet delivered)
+        static etl::array<Baseline, kMaxTasks> gPending;
+        static size_t gNumPending;
+        static uint32_t gPendingTotal;
+};
+}
+
+#endif
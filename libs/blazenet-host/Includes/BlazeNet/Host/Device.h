@@ -0,0 +1,277 @@
+/**
+ * @file
+ *
+ * @brief Host-side radio driver
+ */
+#ifndef BLAZENET_HOST_DEVICE_H
+#define BLAZENET_HOST_DEVICE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <BlazeNet/HostIf/Commands.h>
+
+#include "Transport.h"
+
+namespace BlazeNet::Host {
+/**
+ * @brief Host-controlled radio
+ *
+ * Drives a radio over a transport. All commands are submitted to an asynchronous queue, and
+ * executed in order by a worker thread, which owns the transport; callers get a future that's
+ * completed once the command has been executed.
+ *
+ * When the firmware supports it, consecutive queued commands are combined into a single batch
+ * transaction, and received packets are read out several at a time.
+ *
+ * The radio's interrupt line is monitored by a separate thread, which wakes the worker to read a
+ * status snapshot (acknowledging the interrupts it reports) and drain the receive queue. Received
+ * packets are handed to the receive callback, on the worker thread.
+ */
+class Device {
+    public:
+        /**
+         * @brief Driver configuration
+         */
+        struct Config {
+            /// Combine queued commands into batches, if the firmware supports it
+            bool useBatch{true};
+            /**
+             * @brief Largest packet expected to be received
+             *
+             * Batched receive reads have to guess the size of packets beyond the first; if this
+             * is small enough that a packet fits in a single batch record, received packets are
+             * read out in batches.
+             */
+            size_t maxRxPacketSize{255};
+            /// Maximum number of commands combined into one batch
+            size_t maxBatchCommands{32};
+            /// Interval at which the device is polled if no interrupt arrives
+            std::chrono::milliseconds irqPollInterval{100};
+            /**
+             * @brief Read out firmware log records over the host interface
+             *
+             * Records are handed to the log callback. They're read after received packets, a few
+             * reads at a time; if the host doesn't keep up, the firmware drops them.
+             */
+            bool readLogs{false};
+        };
+
+        /**
+         * @brief A received packet
+         */
+        struct RxPacket {
+            /// Packet RSSI (in dB)
+            int8_t rssi;
+            /// Link quality indicator
+            uint8_t lqi;
+            /// Packet data (including MAC headers)
+            std::vector<uint8_t> data;
+        };
+
+        /**
+         * @brief Result of a read command
+         */
+        template<typename T>
+        struct Result {
+            /// Command status: 0 on success, negative error code otherwise
+            int status{0};
+            /// Data read from the device (only valid if status is 0)
+            T value{};
+        };
+
+        /**
+         * @brief Driver statistics
+         */
+        struct Stats {
+            /// Number of transport transactions executed
+            size_t transactions{0};
+            /// Number of batch transactions written
+            size_t batches{0};
+            /// Number of commands executed as part of a batch
+            size_t batchedCommands{0};
+            /// Number of interrupts serviced
+            size_t irqs{0};
+            /// Number of packets received
+            size_t rxPackets{0};
+            /// Number of bytes of log records received
+            size_t logBytes{0};
+        };
+
+        /**
+         * @brief A chunk of the device's log archive
+         */
+        struct LogArchiveChunk {
+            /// Archive data (binary log records, possibly split across chunks)
+            std::vector<uint8_t> data;
+            /// All archived data has been read
+            bool end{false};
+            /// The device has no log archive
+            bool unavailable{false};
+            /// Number of records the device dropped rather than archiving
+            uint32_t dropped{0};
+        };
+
+        using RxHandler = std::function<void(const RxPacket &)>;
+        /**
+         * @brief Log record callback
+         *
+         * Receives the firmware's binary log record stream (see `host-log-decode`) in chunks,
+         * which may split records, and the number of records the firmware dropped before it.
+         */
+        using LogHandler = std::function<void(std::span<const uint8_t>, const size_t)>;
+
+        /**
+         * @brief Error codes
+         */
+        enum Error: int {
+            /// The device returned a malformed response
+            InvalidResponse                     = -3000,
+            /// The command was not executed (e.g. the batch response ring was full)
+            NotExecuted                         = -3001,
+            /// The driver is shutting down
+            Shutdown                            = -3002,
+            /// Arguments are invalid
+            InvalidArguments                    = -3003,
+        };
+
+    public:
+        Device(std::shared_ptr<Transport> transport, const Config &config);
+        ~Device();
+
+        void setRxHandler(RxHandler handler);
+        void setLogHandler(LogHandler handler);
+
+        std::future<Result<HostIf::Response::GetInfo>> getInfo();
+        std::future<Result<HostIf::Response::GetCounters>> readCounters();
+        std::future<Result<HostIf::Response::ReadProbes>> readProbes();
+        std::future<Result<HostIf::Response::GetHeapStats>> readHeapStats();
+        std::future<Result<HostIf::Response::GetFsStats>> readFsStats();
+        std::future<Result<HostIf::Response::LogLevels>> readLogLevels();
+        std::future<int> setLogLevels(const HostIf::Request::LogLevels &levels);
+        std::future<Result<LogArchiveChunk>> readLogArchive();
+        std::future<int> rewindLogArchive();
+        std::future<int> configureRadio(const HostIf::Request::RadioConfig &config);
+        std::future<int> transmit(const uint8_t priority, std::span<const uint8_t> data);
+
+        std::future<int> write(const HostIf::CommandId command, std::span<const uint8_t> payload);
+        std::future<Result<std::vector<uint8_t>>> read(const HostIf::CommandId command,
+                const size_t length);
+
+        /**
+         * @brief Whether commands are combined into batches
+         */
+        inline bool isBatching() const {
+            return this->batching;
+        }
+
+        Stats getStats();
+
+    private:
+        /**
+         * @brief Queued command
+         */
+        struct Command {
+            /// Command id, including the read bit
+            uint8_t command;
+            /// Payload (writes)
+            std::vector<uint8_t> payload;
+            /// Number of bytes to read (reads)
+            size_t readLength{0};
+
+            /// Completed with the status and response when the command has executed
+            std::promise<Result<std::vector<uint8_t>>> promise;
+        };
+
+        /// Size of the batch and batch record headers
+        constexpr static const size_t kBatchHeaderSize{offsetof(HostIf::Response::Batch, records)};
+        constexpr static const size_t kRecordHeaderSize{
+            offsetof(HostIf::Response::BatchRecord, data)};
+        /// Maximum length of a single transaction's payload
+        constexpr static const size_t kMaxTransfer{UINT8_MAX};
+        /// Size of the firmware's batch response ring
+        constexpr static const size_t kResponseRingSize{1024};
+        /// Maximum number of log reads per interrupt
+        constexpr static const size_t kMaxLogReads{4};
+
+    private:
+        std::future<Result<std::vector<uint8_t>>> enqueue(Command &&cmd);
+
+        void probe();
+        void workerMain();
+        void irqMain();
+
+        void executeSingle(Command &cmd);
+        void executeBatch(std::vector<Command> &cmds);
+        int readBatchRecords(const size_t numRecords, size_t maxBytes,
+                std::vector<std::pair<int, std::vector<uint8_t>>> &outRecords);
+
+        void serviceIrq();
+        void drainRxQueue(size_t numPending, size_t nextSize);
+        void readPacketsSingle(size_t numPending, size_t nextSize);
+        void readPacketsBatched(size_t numPending, size_t nextSize);
+        void deliverPacket(std::span<const uint8_t> record);
+        void drainLogs();
+
+        int transportRead(const HostIf::CommandId command, std::span<uint8_t> buffer);
+        int transportWrite(const HostIf::CommandId command, std::span<const uint8_t> payload);
+
+    private:
+        /// Transport used to communicate with the radio
+        std::shared_ptr<Transport> transport;
+        /// Driver configuration
+        Config config;
+
+        /// Whether the firmware supports status snapshots
+        bool hasSnapshot{false};
+        /// Whether commands are batched
+        bool batching{false};
+
+        /// Lock protecting the command queue and interrupt flags
+        std::mutex lock;
+        /// Signalled when a command is queued or an interrupt fires
+        std::condition_variable workCond;
+        /// Signalled when the worker has serviced an interrupt
+        std::condition_variable irqDoneCond;
+
+        /// Commands waiting to be executed
+        std::deque<Command> queue;
+        /// Set when the interrupt thread detects an asserted interrupt
+        bool irqPending{false};
+        /// Set to terminate all threads
+        bool shutdown{false};
+
+        /// Receive callback
+        RxHandler rxHandler;
+        /// Lock protecting the receive callback
+        std::mutex rxHandlerLock;
+
+        /// Log record callback
+        LogHandler logHandler;
+        /// Lock protecting the log callback
+        std::mutex logHandlerLock;
+
+        /// Worker thread (executes commands)
+        std::thread worker;
+        /// Interrupt thread (monitors the interrupt line)
+        std::thread irqThread;
+
+        /// Statistics (updated by the worker)
+        Stats stats;
+        /// Lock protecting statistics
+        std::mutex statsLock;
+};
+}
+
+#endif
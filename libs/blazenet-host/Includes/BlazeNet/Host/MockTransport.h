@@ -0,0 +1,176 @@
+#ifndef BLAZENET_HOST_MOCKTRANSPORT_H
+#define BLAZENET_HOST_MOCKTRANSPORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <BlazeNet/HostIf/Commands.h>
+
+#include "Transport.h"
+
+namespace BlazeNet::Host {
+/**
+ * @brief In-process radio emulation
+ *
+ * Emulates the radio firmware's host interface task (and, crudely, its packet handler and radio)
+ * so the host driver can be exercised and benchmarked without hardware. Command handling follows
+ * the firmware: same queue limits, interrupt semantics, status snapshot and batch behavior.
+ *
+ * Transmitted packets occupy the (emulated) channel for their airtime, and may optionally be
+ * looped back into the receive queue. The SPI link is modelled by delaying each transaction
+ * according to the configured clock and command turnaround time.
+ */
+class MockTransport: public Transport {
+    public:
+        /**
+         * @brief Emulation configuration
+         */
+        struct Config {
+            /// SPI clock rate to emulate (Hz); 0 for infinitely fast
+            uint32_t spiClock{4'000'000};
+            /// Time the firmware takes to process a command header and arm the next transfer
+            std::chrono::microseconds turnaround{20};
+
+            /// Over the air bit rate (bits/sec); 0 for instant transmission
+            uint32_t airBitrate{250'000};
+            /// Per-frame overhead over the air (preamble, sync word, PHY header, CRC) in bytes
+            size_t airOverhead{12};
+            /// Feed transmitted packets back into the receive queue
+            bool loopback{true};
+
+            /// Whether batched commands are supported (otherwise, emulate an older firmware)
+            bool supportsBatch{true};
+        };
+
+    public:
+        MockTransport(const Config &config);
+        ~MockTransport() override;
+
+        int write(const uint8_t command, std::span<const uint8_t> payload) override;
+        int read(const uint8_t command, std::span<uint8_t> buffer) override;
+        bool waitForIrq(const std::chrono::microseconds timeout) override;
+
+        bool injectRxPacket(std::span<const uint8_t> data, const int8_t rssi = -50,
+                const uint8_t lqi = 255);
+
+        /**
+         * @brief Get the total number of transactions executed
+         */
+        inline size_t getNumTransactions() const {
+            return this->numTransactions;
+        }
+
+    private:
+        /// Interrupt bits (same as the firmware)
+        enum Irq: uint32_t {
+            CommandError                        = (1 << 0),
+            PacketReceived                      = (1 << 1),
+            PacketTransmitted                   = (1 << 2),
+            TxQueueEmpty                        = (1 << 3),
+        };
+
+        /// A packet in the receive queue
+        struct RxPacket {
+            int8_t rssi;
+            uint8_t lqi;
+            std::vector<uint8_t> data;
+        };
+
+        /// Limits of the firmware packet handler
+        constexpr static const size_t kMaxRxBufferSize{8 * 1024};
+        constexpr static const size_t kMaxRxQueueSize{255};
+        constexpr static const size_t kMaxTxBufferSize{4 * 1024};
+        constexpr static const size_t kMaxTxQueueSize{16};
+        /// Per-buffer bookkeeping overhead (sizeof the firmware's packet buffer structs)
+        constexpr static const size_t kBufferOverhead{6};
+        /// Size of the firmware's payload buffer
+        constexpr static const size_t kMaxPayloadSize{256};
+        /// Size of the batch response ring
+        constexpr static const size_t kResponseRingSize{1024};
+
+    private:
+        int transact(const uint8_t command, std::span<const uint8_t> payload,
+                std::span<uint8_t> response);
+        int execute(const uint8_t cmd, const bool isRead, std::span<const uint8_t> payload,
+                std::span<uint8_t> response);
+        void postRead(const uint8_t cmd, const bool success);
+
+        int doBatchWrite(std::span<const uint8_t> payload);
+        int doBatchRead(std::span<uint8_t> response);
+        int doTransmit(std::span<const uint8_t> payload);
+        int doReadPacket(std::span<uint8_t> response);
+        void fillSnapshot(HostIf::Response::StatusSnapshot &snap);
+
+        void assertIrq(const uint32_t which);
+        void acknowledgeIrq(const uint32_t which);
+        void delayFor(const size_t numBytes);
+
+        void radioMain();
+
+    private:
+        /// Emulation configuration
+        Config config;
+
+        /// Lock protecting all emulated device state
+        std::mutex lock;
+        /// Signalled when the interrupt line changes
+        std::condition_variable irqCond;
+        /// Signalled when a packet is queued for transmission
+        std::condition_variable txCond;
+
+        /// Radio emulation thread
+        std::thread radioThread;
+        /// Set to terminate the radio thread
+        bool shutdown{false};
+
+        /// Active interrupts
+        uint32_t irqActive{0};
+        /// Interrupt mask
+        uint32_t irqMask{0};
+        /// Error flag (set if the last command failed)
+        bool errorFlag{false};
+
+        /// Receive queue
+        std::deque<RxPacket> rxQueue;
+        /// Bytes allocated for receive buffers
+        size_t rxAllocBytes{0};
+        /// Receive queue overflow (sticky)
+        bool rxOverflow{false};
+
+        /// Transmit queues, by priority
+        std::array<std::deque<std::vector<uint8_t>>, 4> txQueues;
+        /// Total number of transmit packets pending (including the one being transmitted)
+        size_t txPending{0};
+        /// Bytes allocated for transmit buffers
+        size_t txAllocBytes{0};
+        /// Transmit queue overflow (sticky)
+        bool txOverflow{false};
+
+        /// Snapshot: acknowledge on read
+        bool snapshotAckOnRead{false};
+        /// Snapshot: interrupts reported in last read
+        uint32_t snapshotReported{0};
+        /// Snapshot: reported error flag
+        bool snapshotReportedError{false};
+
+        /// Batch response ring
+        std::deque<uint8_t> batchResponses;
+
+        /// Performance counters (a subset of what the firmware reports)
+        HostIf::Response::GetCounters counters{};
+
+        /// Total number of transactions
+        std::atomic_size_t numTransactions{0};
+};
+}
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef BLAZENET_HOST_SPIDEVTRANSPORT_H
+#define BLAZENET_HOST_SPIDEVTRANSPORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <string>
+
+#include "Transport.h"
+
+namespace BlazeNet::Host {
+/**
+ * @brief Linux spidev transport
+ *
+ * Talks to the radio through a spidev device node; the interrupt line is read through the GPIO
+ * character device interface, as a falling edge (the line is active low) event.
+ */
+class SpidevTransport: public Transport {
+    public:
+        /**
+         * @brief Transport configuration
+         */
+        struct Config {
+            /// spidev device node (for example, /dev/spidev0.0)
+            std::string spiDevice;
+            /// SPI clock rate (Hz)
+            uint32_t spiClock{4'000'000};
+
+            /// GPIO chip device node the interrupt line is connected to (for example, /dev/gpiochip0)
+            std::string gpioChip;
+            /// Line offset of the interrupt line on the GPIO chip
+            uint32_t irqLine{0};
+
+            /**
+             * @brief Command turnaround time
+             *
+             * Time to wait between sending a command header and its payload, to give the radio's
+             * host interface task time to process the header and set up the payload transfer.
+             */
+            std::chrono::microseconds turnaround{50};
+        };
+
+        /// Error codes
+        enum Error: int {
+            /// Failed to open or configure a device node
+            OpenFailed                          = -2000,
+            /// An SPI transfer failed
+            IoFailed                            = -2001,
+            /// Invalid arguments (for example, a payload longer than 255 bytes)
+            InvalidArguments                    = -2002,
+        };
+
+    public:
+        SpidevTransport(const Config &config);
+        ~SpidevTransport() override;
+
+        int write(const uint8_t command, std::span<const uint8_t> payload) override;
+        int read(const uint8_t command, std::span<uint8_t> buffer) override;
+        bool waitForIrq(const std::chrono::microseconds timeout) override;
+
+    private:
+        int transfer(const uint8_t command, const uint8_t length, const void *txBuf,
+                void *rxBuf);
+
+    private:
+        /// Transport configuration
+        Config config;
+
+        /// spidev file descriptor
+        int spiFd{-1};
+        /// GPIO line event file descriptor (for the interrupt line)
+        int irqFd{-1};
+};
+}
+
+#endif
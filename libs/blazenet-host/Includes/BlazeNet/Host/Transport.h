@@ -0,0 +1,66 @@
+/**
+ * @file
+ *
+ * @brief Host interface transport
+ *
+ * Abstract interface to the physical link between the host and the radio.
+ */
+#ifndef BLAZENET_HOST_TRANSPORT_H
+#define BLAZENET_HOST_TRANSPORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <span>
+
+namespace BlazeNet::Host {
+/**
+ * @brief Host interface transport
+ *
+ * A transport carries individual host interface transactions (a command header, followed by an
+ * optional payload in either direction) to the radio, and provides access to its interrupt line.
+ *
+ * Transports are not required to be thread safe, with the exception of waitForIrq(), which may
+ * be called concurrently with transactions.
+ */
+class Transport {
+    public:
+        virtual ~Transport() = default;
+
+        /**
+         * @brief Execute a write command
+         *
+         * Send the command header, followed by the payload (if any).
+         *
+         * @param command Command id (without the read bit)
+         * @param payload Payload to write; may be empty
+         *
+         * @return 0 on success, or a negative error code
+         */
+        virtual int write(const uint8_t command, std::span<const uint8_t> payload) = 0;
+
+        /**
+         * @brief Execute a read command
+         *
+         * Send the command header (with the read bit set) and read back the response.
+         *
+         * @param command Command id (without the read bit)
+         * @param buffer Buffer to receive the response; its size is the requested length
+         *
+         * @return Number of bytes read, or a negative error code
+         */
+        virtual int read(const uint8_t command, std::span<uint8_t> buffer) = 0;
+
+        /**
+         * @brief Wait for the interrupt line to be asserted
+         *
+         * @param timeout Maximum time to wait
+         *
+         * @return Whether the interrupt line is asserted
+         */
+        virtual bool waitForIrq(const std::chrono::microseconds timeout) = 0;
+};
+}
+
+#endif
@@ -0,0 +1,856 @@
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
+#include <BlazeNet/HostIf/Commands.h>
+#include <BlazeNet/Host/Device.h>
+
+using namespace BlazeNet::Host;
+using namespace HostIf;
+
+/**
+ * @brief Convert a raw read result into a typed one
+ */
+template<typename T>
+static Device::Result<T> Convert(const Device::Result<std::vector<uint8_t>> &raw) {
+    Device::Result<T> result{.status = raw.status};
+
+    if(!raw.status) {
+        if(raw.value.size() < sizeof(T)) {
+            result.status = Device::Error::InvalidResponse;
+        } else {
+            memcpy(&result.value, raw.value.data(), sizeof(T));
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Initialize the driver
+ *
+ * Probe the device's capabilities, configure its interrupts, and start the worker and interrupt
+ * threads.
+ */
+Device::Device(std::shared_ptr<Transport> transport, const Config &config) :
+    transport(std::move(transport)), config(config) {
+    this->probe();
+
+    this->worker = std::thread(&Device::workerMain, this);
+    this->irqThread = std::thread(&Device::irqMain, this);
+}
+
+/**
+ * @brief Shut down the driver
+ *
+ * Terminate the worker threads. Any commands still queued are completed with an error.
+ */
+Device::~Device() {
+    {
+        std::lock_guard lg(this->lock);
+        this->shutdown = true;
+    }
+    this->workCond.notify_all();
+    this->irqDoneCond.notify_all();
+
+    this->irqThread.join();
+    this->worker.join();
+
+    for(auto &cmd : this->queue) {
+        cmd.promise.set_value({.status = Error::Shutdown});
+    }
+}
+
+/**
+ * @brief Set the receive callback
+ *
+ * It's invoked on the worker thread, for each packet received; it should not block for long.
+ */
+void Device::setRxHandler(RxHandler handler) {
+    std::lock_guard lg(this->rxHandlerLock);
+    this->rxHandler = std::move(handler);
+}
+
+/**
+ * @brief Set the log record callback
+ *
+ * It's invoked on the worker thread, if log reading is enabled in the driver config.
+ */
+void Device::setLogHandler(LogHandler handler) {
+    std::lock_guard lg(this->logHandlerLock);
+    this->logHandler = std::move(handler);
+}
+
+/**
+ * @brief Read device information
+ */
+std::future<Device::Result<Response::GetInfo>> Device::getInfo() {
+    auto raw = this->read(CommandId::GetInfo, sizeof(Response::GetInfo));
+
+    return std::async(std::launch::deferred, [raw = std::move(raw)]() mutable {
+        return Convert<Response::GetInfo>(raw.get());
+    });
+}
+
+/**
+ * @brief Read (and reset) the device's performance counters
+ */
+std::future<Device::Result<Response::GetCounters>> Device::readCounters() {
+    auto raw = this->read(CommandId::GetCounters, sizeof(Response::GetCounters));
+
+    return std::async(std::launch::deferred, [raw = std::move(raw)]() mutable {
+        return Convert<Response::GetCounters>(raw.get());
+    });
+}
+
+/**
+ * @brief Read (and reset) the device's profiling probes
+ */
+std::future<Device::Result<Response::ReadProbes>> Device::readProbes() {
+    auto raw = this->read(CommandId::ReadProbes, sizeof(Response::ReadProbes));
+
+    return std::async(std::launch::deferred, [raw = std::move(raw)]() mutable {
+        return Convert<Response::ReadProbes>(raw.get());
+    });
+}
+
+/**
+ * @brief Read the device's heap usage and allocation counters
+ */
+std::future<Device::Result<Response::GetHeapStats>> Device::readHeapStats() {
+    auto raw = this->read(CommandId::GetHeapStats, sizeof(Response::GetHeapStats));
+
+    return std::async(std::launch::deferred, [raw = std::move(raw)]() mutable {
+        return Convert<Response::GetHeapStats>(raw.get());
+    });
+}
+
+/**
+ * @brief Read the device's filesystem cache counters
+ */
+std::future<Device::Result<Response::GetFsStats>> Device::readFsStats() {
+    auto raw = this->read(CommandId::GetFsStats, sizeof(Response::GetFsStats));
+
+    return std::async(std::launch::deferred, [raw = std::move(raw)]() mutable {
+        return Convert<Response::GetFsStats>(raw.get());
+    });
+}
+
+/**
+ * @brief Read the log level threshold of each firmware module
+ */
+std::future<Device::Result<Response::LogLevels>> Device::readLogLevels() {
+    auto raw = this->read(CommandId::LogLevels, sizeof(Response::LogLevels));
+
+    return std::async(std::launch::deferred, [raw = std::move(raw)]() mutable {
+        return Convert<Response::LogLevels>(raw.get());
+    });
+}
+
+/**
+ * @brief Set the log level threshold of firmware modules
+ *
+ * @param levels New level for each module (1 = trace, 5 = error), or 0 to leave it unchanged
+ */
+std::future<int> Device::setLogLevels(const Request::LogLevels &levels) {
+    return this->write(CommandId::LogLevels, {reinterpret_cast<const uint8_t *>(&levels),
+            sizeof(levels)});
+}
+
+/**
+ * @brief Read the next chunk of the device's log archive
+ *
+ * The device advances its read position once the chunk was read; keep reading until the chunk
+ * indicates the end of the archive.
+ */
+std::future<Device::Result<Device::LogArchiveChunk>> Device::readLogArchive() {
+    auto raw = this->read(CommandId::ReadLogArchive, kMaxTransfer);
+
+    return std::async(std::launch::deferred, [raw = std::move(raw)]() mutable {
+        constexpr static const size_t kHeaderSize{offsetof(Response::ReadLogArchive, data)};
+
+        const auto response = raw.get();
+        Result<LogArchiveChunk> result{.status = response.status};
+
+        if(!response.status) {
+            Response::ReadLogArchive hdr;
+
+            if(response.value.size() < kHeaderSize) {
+                result.status = Error::InvalidResponse;
+                return result;
+            }
+            memcpy(&hdr, response.value.data(), kHeaderSize);
+
+            if(kHeaderSize + hdr.length > response.value.size()) {
+                result.status = Error::InvalidResponse;
+                return result;
+            }
+
+            auto data = response.value.begin() + kHeaderSize;
+            result.value.data.assign(data, data + hdr.length);
+            result.value.end = hdr.end;
+            result.value.unavailable = hdr.unavailable;
+            result.value.dropped = hdr.dropped;
+        }
+
+        return result;
+    });
+}
+
+/**
+ * @brief Move the log archive read position back to the oldest archived data
+ */
+std::future<int> Device::rewindLogArchive() {
+    Request::ReadLogArchive req{};
+    req.rewind = 1;
+
+    return this->write(CommandId::ReadLogArchive, {reinterpret_cast<const uint8_t *>(&req),
+            sizeof(req)});
+}
+
+/**
+ * @brief Configure the radio PHY
+ */
+std::future<int> Device::configureRadio(const Request::RadioConfig &config) {
+    return this->write(CommandId::RadioConfig, {reinterpret_cast<const uint8_t *>(&config),
+            sizeof(config)});
+}
+
+/**
+ * @brief Queue a packet for transmission
+ *
+ * @param priority Packet priority (0 = lowest, 3 = highest)
+ * @param data Packet data, including MAC headers
+ */
+std::future<int> Device::transmit(const uint8_t priority, std::span<const uint8_t> data) {
+    if(priority > 3 || data.size() + sizeof(Request::TransmitPacket) > kMaxTransfer) {
+        std::promise<int> promise;
+        promise.set_value(Error::InvalidArguments);
+        return promise.get_future();
+    }
+
+    Command cmd{.command = static_cast<uint8_t>(CommandId::TransmitPacket)};
+    cmd.payload.reserve(sizeof(Request::TransmitPacket) + data.size());
+    cmd.payload.push_back(priority & 0x03);
+    cmd.payload.insert(cmd.payload.end(), data.begin(), data.end());
+
+    auto raw = this->enqueue(std::move(cmd));
+    return std::async(std::launch::deferred, [raw = std::move(raw)]() mutable {
+        return raw.get().status;
+    });
+}
+
+/**
+ * @brief Queue an arbitrary write command
+ *
+ * @remark Unless the command is executed as part of a batch, its status is not known to the
+ *         host; in that case, failures are only reported by the command error interrupt.
+ */
+std::future<int> Device::write(const CommandId command, std::span<const uint8_t> payload) {
+    if(payload.size() > kMaxTransfer) {
+        std::promise<int> promise;
+        promise.set_value(Error::InvalidArguments);
+        return promise.get_future();
+    }
+
+    Command cmd{
+        .command = static_cast<uint8_t>(command),
+        .payload = {payload.begin(), payload.end()},
+    };
+
+    auto raw = this->enqueue(std::move(cmd));
+    return std::async(std::launch::deferred, [raw = std::move(raw)]() mutable {
+        return raw.get().status;
+    });
+}
+
+/**
+ * @brief Queue an arbitrary read command
+ *
+ * @param length Number of bytes to read
+ */
+std::future<Device::Result<std::vector<uint8_t>>> Device::read(const CommandId command,
+        const size_t length) {
+    if(!length || length > kMaxTransfer) {
+        std::promise<Result<std::vector<uint8_t>>> promise;
+        promise.set_value({.status = Error::InvalidArguments});
+        return promise.get_future();
+    }
+
+    return this->enqueue(Command{
+        .command = static_cast<uint8_t>(static_cast<uint8_t>(command) | 0x80),
+        .readLength = length,
+    });
+}
+
+/**
+ * @brief Get a copy of the driver statistics
+ */
+Device::Stats Device::getStats() {
+    std::lock_guard lg(this->statsLock);
+    return this->stats;
+}
+
+
+
+/**
+ * @brief Add a command to the queue
+ */
+std::future<Device::Result<std::vector<uint8_t>>> Device::enqueue(Command &&cmd) {
+    auto future = cmd.promise.get_future();
+
+    {
+        std::lock_guard lg(this->lock);
+
+        if(this->shutdown) {
+            cmd.promise.set_value({.status = Error::Shutdown});
+            return future;
+        }
+
+        this->queue.emplace_back(std::move(cmd));
+    }
+
+    this->workCond.notify_one();
+    return future;
+}
+
+/**
+ * @brief Probe device capabilities
+ *
+ * Read a status snapshot to find out whether the firmware supports snapshots (and batches). If
+ * so, have it acknowledge interrupts when reading the snapshot. Then, enable the interrupts we
+ * care about.
+ */
+void Device::probe() {
+    Response::StatusSnapshot snap{};
+    this->transportRead(CommandId::StatusSnapshot, {reinterpret_cast<uint8_t *>(&snap),
+            sizeof(snap)});
+
+    // older firmware doesn't know the command (and will return garbage)
+    if(snap.version >= 1 && snap.version < 0x80 &&
+            snap.length >= offsetof(Response::StatusSnapshot, batchResponseBytes)) {
+        this->hasSnapshot = true;
+        this->batching = this->config.useBatch && (snap.version >= 2);
+
+        const Request::StatusSnapshot req{.ackOnRead = 1};
+        this->transportWrite(CommandId::StatusSnapshot, {reinterpret_cast<const uint8_t *>(&req),
+                sizeof(req)});
+    }
+
+    // enable interrupts
+    const Request::IrqConfig irqs{
+        .commandError = 1,
+        .rxQueueNotEmpty = 1,
+        .logPending = this->config.readLogs,
+    };
+    this->transportWrite(CommandId::IrqConfig, {reinterpret_cast<const uint8_t *>(&irqs),
+            sizeof(irqs)});
+}
+
+/**
+ * @brief Worker thread
+ *
+ * Services interrupts (which take priority) and executes queued commands. Where possible, all
+ * queued commands are combined into a single batch.
+ */
+void Device::workerMain() {
+    std::unique_lock lk(this->lock);
+
+    while(!this->shutdown) {
+        this->workCond.wait(lk, [this] {
+            return this->shutdown || this->irqPending || !this->queue.empty();
+        });
+
+        if(this->shutdown) {
+            break;
+        }
+
+        // handle interrupts first
+        if(this->irqPending) {
+            lk.unlock();
+            this->serviceIrq();
+            lk.lock();
+
+            this->irqPending = false;
+            this->irqDoneCond.notify_all();
+            continue;
+        }
+
+        // pick up commands to execute
+        std::vector<Command> cmds;
+
+        if(!this->batching) {
+            cmds.emplace_back(std::move(this->queue.front()));
+            this->queue.pop_front();
+        } else {
+            size_t payloadBytes{0}, responseBytes{0};
+
+            while(!this->queue.empty() && cmds.size() < this->config.maxBatchCommands) {
+                const auto &next = this->queue.front();
+                const size_t entryBytes = sizeof(CommandHeader) + next.payload.size();
+                const size_t recordBytes = kRecordHeaderSize + next.readLength;
+
+                // the record must be readable in one go, and fit in the batch and response ring
+                if(kBatchHeaderSize + recordBytes > kMaxTransfer) {
+                    if(cmds.empty()) {
+                        cmds.emplace_back(std::move(this->queue.front()));
+                        this->queue.pop_front();
+                    }
+                    break;
+                } else if(payloadBytes + entryBytes > kMaxTransfer ||
+                        responseBytes + recordBytes > kResponseRingSize) {
+                    break;
+                }
+
+                payloadBytes += entryBytes;
+                responseBytes += recordBytes;
+
+                cmds.emplace_back(std::move(this->queue.front()));
+                this->queue.pop_front();
+            }
+        }
+
+        // execute them
+        lk.unlock();
+
+        if(cmds.size() == 1) {
+            this->executeSingle(cmds.front());
+        } else {
+            this->executeBatch(cmds);
+        }
+
+        lk.lock();
+    }
+}
+
+/**
+ * @brief Interrupt thread
+ *
+ * Waits for the interrupt line to be asserted, then has the worker service the interrupt; it
+ * waits for that to complete before monitoring the line again. If no interrupt arrives for some
+ * time, the device is polled anyways, in case an edge was missed.
+ */
+void Device::irqMain() {
+    std::unique_lock lk(this->lock);
+
+    while(!this->shutdown) {
+        lk.unlock();
+        this->transport->waitForIrq(this->config.irqPollInterval);
+        lk.lock();
+
+        if(this->shutdown) {
+            break;
+        }
+
+        this->irqPending = true;
+        this->workCond.notify_one();
+
+        this->irqDoneCond.wait(lk, [this] {
+            return this->shutdown || !this->irqPending;
+        });
+    }
+}
+
+
+
+/**
+ * @brief Execute a single command
+ */
+void Device::executeSingle(Command &cmd) {
+    const auto id = static_cast<CommandId>(cmd.command & ~0x80);
+
+    if(cmd.command & 0x80) {
+        Result<std::vector<uint8_t>> result;
+        result.value.resize(cmd.readLength);
+
+        const auto ret = this->transportRead(id, result.value);
+        if(ret < 0) {
+            result.status = ret;
+            result.value.clear();
+        } else {
+            result.value.resize(ret);
+        }
+
+        cmd.promise.set_value(std::move(result));
+    } else {
+        const auto ret = this->transportWrite(id, cmd.payload);
+        cmd.promise.set_value({.status = (ret < 0) ? ret : 0});
+    }
+}
+
+/**
+ * @brief Execute several commands as a batch
+ *
+ * Write all of them in a single batch, then read back the response records to complete each of
+ * the commands.
+ */
+void Device::executeBatch(std::vector<Command> &cmds) {
+    // build the batch
+    std::vector<uint8_t> payload;
+
+    for(const auto &cmd : cmds) {
+        payload.push_back(cmd.command);
+
+        if(cmd.command & 0x80) {
+            payload.push_back(static_cast<uint8_t>(cmd.readLength));
+        } else {
+            payload.push_back(static_cast<uint8_t>(cmd.payload.size()));
+            payload.insert(payload.end(), cmd.payload.begin(), cmd.payload.end());
+        }
+    }
+
+    // execute it and get the results
+    std::vector<std::pair<int, std::vector<uint8_t>>> records;
+    int err = this->transportWrite(CommandId::Batch, payload);
+
+    if(!err) {
+        size_t maxBytes{0};
+        for(const auto &cmd : cmds) {
+            maxBytes += kRecordHeaderSize + cmd.readLength;
+        }
+
+        err = this->readBatchRecords(cmds.size(), maxBytes, records);
+    }
+
+    {
+        std::lock_guard lg(this->statsLock);
+        this->stats.batches++;
+        this->stats.batchedCommands += cmds.size();
+    }
+
+    // complete commands
+    for(size_t i = 0; i < cmds.size(); i++) {
+        if(i >= records.size()) {
+            cmds[i].promise.set_value({.status = err ? err : Error::NotExecuted});
+            continue;
+        }
+
+        auto &[status, data] = records[i];
+        cmds[i].promise.set_value({.status = status, .value = std::move(data)});
+    }
+}
+
+/**
+ * @brief Read records from the batch response ring
+ *
+ * Keep reading until the given number of records was received, or the ring is empty.
+ *
+ * Reads are sized according to the maximum size of the outstanding records, so that small
+ * responses don't incur the cost of clocking out a full length transfer.
+ *
+ * @param numRecords Number of records expected
+ * @param maxBytes Maximum total size of the expected records (including their headers)
+ * @param outRecords Records read (status and payload)
+ *
+ * @return 0 on success, or a negative error code
+ */
+int Device::readBatchRecords(const size_t numRecords, size_t maxBytes,
+        std::vector<std::pair<int, std::vector<uint8_t>>> &outRecords) {
+    std::array<uint8_t, kMaxTransfer> buffer;
+
+    while(outRecords.size() < numRecords) {
+        const auto length = std::clamp(kBatchHeaderSize + std::min(maxBytes, kMaxTransfer),
+                kBatchHeaderSize + kRecordHeaderSize, kMaxTransfer);
+
+        const auto ret = this->transportRead(CommandId::Batch, {buffer.data(), length});
+        if(ret < 0) {
+            return ret;
+        } else if(static_cast<size_t>(ret) < kBatchHeaderSize) {
+            return Error::InvalidResponse;
+        }
+
+        Response::Batch hdr;
+        memcpy(&hdr, buffer.data(), kBatchHeaderSize);
+
+        // extract records
+        size_t offset{kBatchHeaderSize};
+
+        for(size_t i = 0; i < hdr.numRecords; i++) {
+            if(offset + kRecordHeaderSize > static_cast<size_t>(ret)) {
+                return Error::InvalidResponse;
+            }
+
+            Response::BatchRecord record;
+            memcpy(&record, buffer.data() + offset, kRecordHeaderSize);
+            offset += kRecordHeaderSize;
+
+            if(offset + record.length > static_cast<size_t>(ret)) {
+                return Error::InvalidResponse;
+            }
+
+            outRecords.emplace_back(record.status, std::vector<uint8_t>{buffer.begin() + offset,
+                    buffer.begin() + offset + record.length});
+            offset += record.length;
+
+            maxBytes -= std::min(maxBytes, kRecordHeaderSize + record.length);
+        }
+
+        // stop if the ring is drained (remaining commands weren't executed)
+        if(!hdr.bytesRemaining) {
+            break;
+        } else if(!hdr.numRecords) {
+            return Error::InvalidResponse;
+        }
+    }
+
+    return 0;
+}
+
+
+
+/**
+ * @brief Service an interrupt
+ *
+ * Figure out what the device wants, acknowledging the interrupts in the process, then read out
+ * any received packets.
+ */
+void Device::serviceIrq() {
+    {
+        std::lock_guard lg(this->statsLock);
+        this->stats.irqs++;
+    }
+
+    if(this->hasSnapshot) {
+        Response::StatusSnapshot snap{};
+        if(this->transportRead(CommandId::StatusSnapshot, {reinterpret_cast<uint8_t *>(&snap),
+                    sizeof(snap)}) < 0) {
+            return;
+        }
+
+        // discard stale batch responses (from a batch whose results we failed to read)
+        if(this->batching && snap.batchResponseBytes) {
+            std::vector<std::pair<int, std::vector<uint8_t>>> stale;
+            this->readBatchRecords(SIZE_MAX, SIZE_MAX, stale);
+        }
+
+        if(snap.rxQueue.packetsPending) {
+            this->drainRxQueue(snap.rxQueue.packetsPending, snap.rxQueue.nextPacketSize);
+        }
+        if(snap.irqPending.logPending) {
+            this->drainLogs();
+        }
+    } else {
+        Response::IrqStatus irqs{};
+        if(this->transportRead(CommandId::IrqStatus, {reinterpret_cast<uint8_t *>(&irqs),
+                    sizeof(irqs)}) < 0) {
+            return;
+        }
+
+        // the number of packets (and size of the first) is unknown
+        this->drainRxQueue(SIZE_MAX, 0);
+
+        if(irqs.logPending) {
+            this->drainLogs();
+        }
+    }
+}
+
+/**
+ * @brief Read out pending received packets
+ *
+ * @param numPending Number of packets pending, if known (SIZE_MAX otherwise)
+ * @param nextSize Size of the first pending packet, if known (0 otherwise)
+ */
+void Device::drainRxQueue(size_t numPending, size_t nextSize) {
+    const size_t guessedRecord = kRecordHeaderSize + offsetof(Response::ReadPacket, payload) +
+        this->config.maxRxPacketSize;
+
+    if(this->batching && numPending != SIZE_MAX && numPending > 1 &&
+            kBatchHeaderSize + guessedRecord <= kMaxTransfer) {
+        this->readPacketsBatched(numPending, nextSize);
+    } else {
+        this->readPacketsSingle(numPending, nextSize);
+    }
+}
+
+/**
+ * @brief Read received packets one at a time
+ *
+ * If the size of a packet isn't known, it's found by reading the packet queue status first.
+ */
+void Device::readPacketsSingle(size_t numPending, size_t nextSize) {
+    std::array<uint8_t, kMaxTransfer> buffer;
+
+    while(numPending) {
+        if(!nextSize) {
+            Response::GetPacketQueueStatus status{};
+            if(this->transportRead(CommandId::GetPacketQueueStatus,
+                        {reinterpret_cast<uint8_t *>(&status), sizeof(status)}) < 0 ||
+                    !status.rxPacketPending) {
+                break;
+            }
+
+            nextSize = status.rxPacketSize;
+        }
+
+        const auto length = std::min(kMaxTransfer,
+                offsetof(Response::ReadPacket, payload) + nextSize);
+        const auto ret = this->transportRead(CommandId::ReadPacket, {buffer.data(), length});
+        if(ret < 0) {
+            break;
+        }
+
+        this->deliverPacket({buffer.data(), static_cast<size_t>(ret)});
+
+        if(numPending != SIZE_MAX) {
+            numPending--;
+        }
+        nextSize = 0;
+    }
+}
+
+/**
+ * @brief Read received packets in batches
+ *
+ * Issue a batch of packet reads: the first is sized exactly (if known) while all others are
+ * sized for the largest packet expected. The firmware truncates each read to the actual packet
+ * size, so the record length is the packet's length.
+ */
+void Device::readPacketsBatched(size_t numPending, size_t nextSize) {
+    constexpr static const size_t kReadHeaderSize{offsetof(Response::ReadPacket, payload)};
+
+    const size_t guessedLength = kReadHeaderSize + this->config.maxRxPacketSize;
+
+    while(numPending) {
+        std::vector<uint8_t> payload;
+        size_t numReads{0}, responseBytes{0};
+
+        while(numReads < numPending && numReads < this->config.maxBatchCommands &&
+                payload.size() + sizeof(CommandHeader) <= kMaxTransfer) {
+            const size_t length = (!numReads && nextSize) ?
+                std::min(guessedLength, kReadHeaderSize + nextSize) : guessedLength;
+
+            if(responseBytes + kRecordHeaderSize + length > kResponseRingSize) {
+                break;
+            }
+
+            payload.push_back(static_cast<uint8_t>(CommandId::ReadPacket) | 0x80);
+            payload.push_back(static_cast<uint8_t>(length));
+
+            responseBytes += kRecordHeaderSize + length;
+            numReads++;
+        }
+
+        if(this->transportWrite(CommandId::Batch, payload) < 0) {
+            break;
+        }
+
+        std::vector<std::pair<int, std::vector<uint8_t>>> records;
+        const auto err = this->readBatchRecords(numReads, responseBytes, records);
+
+        {
+            std::lock_guard lg(this->statsLock);
+            this->stats.batches++;
+            this->stats.batchedCommands += numReads;
+        }
+
+        for(const auto &[status, data] : records) {
+            if(!status) {
+                this->deliverPacket(data);
+            }
+        }
+
+        if(err || records.size() != numReads) {
+            break;
+        }
+
+        numPending -= numReads;
+        nextSize = 0;
+    }
+}
+
+/**
+ * @brief Hand a received packet to the receive callback
+ *
+ * @param record Response to a ReadPacket command
+ */
+void Device::deliverPacket(std::span<const uint8_t> record) {
+    constexpr static const size_t kReadHeaderSize{offsetof(Response::ReadPacket, payload)};
+
+    if(record.size() < kReadHeaderSize) {
+        return;
+    }
+
+    RxPacket packet{
+        .rssi = static_cast<int8_t>(record[0]),
+        .lqi = record[1],
+        .data = {record.begin() + kReadHeaderSize, record.end()},
+    };
+
+    {
+        std::lock_guard lg(this->statsLock);
+        this->stats.rxPackets++;
+    }
+
+    std::lock_guard lg(this->rxHandlerLock);
+    if(this->rxHandler) {
+        this->rxHandler(packet);
+    }
+}
+
+/**
+ * @brief Read out pending log records
+ *
+ * Only a few reads are done at a time, so that received packets aren't held up; the log pending
+ * interrupt remains asserted until all records have been read.
+ */
+void Device::drainLogs() {
+    constexpr static const size_t kHeaderSize{offsetof(Response::ReadLogs, data)};
+    std::array<uint8_t, kMaxTransfer> buffer;
+
+    for(size_t i = 0; i < kMaxLogReads; i++) {
+        const auto ret = this->transportRead(CommandId::ReadLogs, buffer);
+        if(ret < static_cast<int>(kHeaderSize)) {
+            break;
+        }
+
+        Response::ReadLogs hdr;
+        memcpy(&hdr, buffer.data(), kHeaderSize);
+        if(kHeaderSize + hdr.length > static_cast<size_t>(ret)) {
+            break;
+        }
+
+        {
+            std::lock_guard lg(this->statsLock);
+            this->stats.logBytes += hdr.length;
+        }
+
+        {
+            std::lock_guard lg(this->logHandlerLock);
+            if(this->logHandler && (hdr.length || hdr.dropped)) {
+                this->logHandler({buffer.data() + kHeaderSize, hdr.length}, hdr.dropped);
+            }
+        }
+
+        if(!hdr.remaining) {
+            break;
+        }
+    }
+}
+
+
+
+/**
+ * @brief Execute a read command on the transport
+ */
+int Device::transportRead(const CommandId command, std::span<uint8_t> buffer) {
+    {
+        std::lock_guard lg(this->statsLock);
+        this->stats.transactions++;
+    }
+
+    return this->transport->read(static_cast<uint8_t>(command), buffer);
+}
+
+/**
+ * @brief Execute a write command on the transport
+ */
+int Device::transportWrite(const CommandId command, std::span<const uint8_t> payload) {
+    {
+        std::lock_guard lg(this->statsLock);
+        this->stats.transactions++;
+    }
+
+    return this->transport->write(static_cast<uint8_t>(command), payload);
+}
@@ -0,0 +1,630 @@
+#include <string.h>
+
+#include <algorithm>
+
+#include <BlazeNet/HostIf/Commands.h>
+#include <BlazeNet/Host/MockTransport.h>
+
+using namespace BlazeNet::Host;
+using namespace HostIf;
+
+/**
+ * @brief Wait for the given amount of time
+ *
+ * Short delays are busy-waited, as sleeping has far too coarse a granularity to emulate SPI
+ * transfers.
+ */
+static void Delay(const std::chrono::nanoseconds time) {
+    using Clock = std::chrono::steady_clock;
+
+    if(time >= std::chrono::milliseconds(1)) {
+        std::this_thread::sleep_for(time);
+        return;
+    }
+
+    const auto deadline = Clock::now() + time;
+    while(Clock::now() < deadline) {}
+}
+
+/**
+ * @brief Initialize the emulated radio
+ *
+ * Start the radio emulation thread.
+ */
+MockTransport::MockTransport(const Config &config) : config(config) {
+    this->radioThread = std::thread(&MockTransport::radioMain, this);
+}
+
+/**
+ * @brief Shut down the emulated radio
+ */
+MockTransport::~MockTransport() {
+    {
+        std::lock_guard lg(this->lock);
+        this->shutdown = true;
+    }
+    this->txCond.notify_all();
+
+    this->radioThread.join();
+}
+
+/**
+ * @brief Execute a write command
+ */
+int MockTransport::write(const uint8_t command, std::span<const uint8_t> payload) {
+    if(payload.size() > UINT8_MAX) {
+        return -1;
+    }
+    return this->transact(command & ~0x80, payload, {});
+}
+
+/**
+ * @brief Execute a read command
+ */
+int MockTransport::read(const uint8_t command, std::span<uint8_t> buffer) {
+    if(buffer.empty() || buffer.size() > UINT8_MAX) {
+        return -1;
+    }
+    return this->transact(command | 0x80, {}, buffer);
+}
+
+/**
+ * @brief Wait for the (emulated) interrupt line to be asserted
+ */
+bool MockTransport::waitForIrq(const std::chrono::microseconds timeout) {
+    std::unique_lock lk(this->lock);
+    return this->irqCond.wait_for(lk, timeout, [this] {
+        return (this->irqActive & this->irqMask) || this->shutdown;
+    }) && !this->shutdown;
+}
+
+/**
+ * @brief Inject a received packet
+ *
+ * Places the packet in the receive queue, as if it had been received over the air.
+ *
+ * @return Whether the packet was queued (it's discarded if the receive queue is full)
+ */
+bool MockTransport::injectRxPacket(std::span<const uint8_t> data, const int8_t rssi,
+        const uint8_t lqi) {
+    std::lock_guard lg(this->lock);
+
+    const auto required = kBufferOverhead + data.size();
+
+    if(this->rxQueue.size() >= kMaxRxQueueSize) {
+        this->rxOverflow = true;
+        this->counters.rxQueue.queueDiscards++;
+        return false;
+    } else if(this->rxAllocBytes + required > kMaxRxBufferSize) {
+        this->rxOverflow = true;
+        this->counters.rxQueue.bufferDiscards++;
+        return false;
+    }
+
+    this->rxQueue.push_back(RxPacket{rssi, lqi, {data.begin(), data.end()}});
+    this->rxAllocBytes += required;
+    this->counters.rxRadio.goodFrames++;
+
+    this->assertIrq(Irq::PacketReceived);
+    return true;
+}
+
+
+
+/**
+ * @brief Execute a single host interface transaction
+ *
+ * Mirrors the firmware's host interface task: receive the header, dispatch the command, then
+ * transfer the payload.
+ *
+ * @param command Command byte (including read bit)
+ * @param payload Payload written by host
+ * @param response Buffer for payload read by host
+ *
+ * @return Number of bytes read, or 0 for writes
+ */
+int MockTransport::transact(const uint8_t command, std::span<const uint8_t> payload,
+        std::span<uint8_t> response) {
+    const bool isRead = (command & 0x80);
+    const uint8_t cmd = (command & ~0x80);
+
+    this->numTransactions++;
+
+    // clock out header and wait for the firmware to process it
+    this->delayFor(sizeof(CommandHeader));
+    Delay(this->config.turnaround);
+
+    {
+        std::lock_guard lg(this->lock);
+
+        if(cmd >= static_cast<uint8_t>(CommandId::NumCommands) ||
+                (cmd == static_cast<uint8_t>(CommandId::Batch) && !this->config.supportsBatch)) {
+            // firmware simply ignores unknown commands: the host reads back garbage
+            std::fill(response.begin(), response.end(), 0xff);
+        } else {
+            std::array<uint8_t, kMaxPayloadSize> buffer{};
+
+            const auto ret = this->execute(cmd, isRead, payload,
+                    isRead ? std::span<uint8_t>{buffer.data(), response.size()} :
+                    std::span<uint8_t>{});
+
+            if(ret < 0) {
+                this->errorFlag = true;
+                this->assertIrq(Irq::CommandError);
+            } else {
+                this->errorFlag = false;
+            }
+
+            // copy out response (the host clocks the full requested length)
+            if(isRead) {
+                memcpy(response.data(), buffer.data(), response.size());
+                this->postRead(cmd, ret >= 0);
+            }
+        }
+    }
+
+    // clock the payload; like the real link, the command's status isn't visible to the host
+    this->delayFor(isRead ? response.size() : payload.size());
+    return isRead ? static_cast<int>(response.size()) : 0;
+}
+
+/**
+ * @brief Execute a command
+ *
+ * Equivalent to invoking the firmware's command handlers.
+ *
+ * @return Number of response bytes (reads), 0 (writes) or a negative error code
+ */
+int MockTransport::execute(const uint8_t cmd, const bool isRead,
+        std::span<const uint8_t> payload, std::span<uint8_t> response) {
+    const auto id = static_cast<CommandId>(cmd);
+
+    if(isRead) {
+        switch(id) {
+            case CommandId::GetInfo: {
+                Response::GetInfo info{};
+                info.status = 1;
+                info.fw.protocolVersion = 0x01;
+                info.fw.minor = 0x01;
+                strncpy(info.fw.build, "mock", sizeof(info.fw.build));
+                info.hw.rev = 1;
+                strncpy(info.hw.serial, "MOCK0001", sizeof(info.hw.serial));
+                info.radio.maxTxPower = 140;
+
+                const auto num = std::min(response.size(), sizeof(info));
+                memcpy(response.data(), &info, num);
+                return num;
+            }
+            case CommandId::GetStatus: {
+                Response::GetStatus status;
+                status.cmdSuccess = !this->errorFlag;
+                status.radioActive = 1;
+                status.rxQueueNotEmpty = !this->rxQueue.empty();
+                status.rxQueueFull = (this->rxQueue.size() >= kMaxRxQueueSize);
+                status.rxQueueOverflow = this->rxOverflow;
+                status.txQueueEmpty = !this->txPending;
+                status.txQueueOverflow = this->txOverflow;
+
+                const auto num = std::min(response.size(), sizeof(status));
+                memcpy(response.data(), &status, num);
+                return num;
+            }
+            case CommandId::IrqConfig:
+            case CommandId::IrqStatus: {
+                if(response.size() < 1) {
+                    return -1;
+                }
+
+                const auto bits = (id == CommandId::IrqConfig) ? this->irqMask :
+                    (this->irqActive & this->irqMask);
+                response[0] = static_cast<uint8_t>(bits & 0x0f);
+
+                if(id == CommandId::IrqStatus) {
+                    this->acknowledgeIrq(bits);
+                }
+                return 1;
+            }
+            case CommandId::GetPacketQueueStatus: {
+                Response::GetPacketQueueStatus status;
+                status.rxPacketPending = !this->rxQueue.empty();
+                status.txPacketPending = !!this->txPending;
+                if(!this->rxQueue.empty()) {
+                    status.rxPacketSize = this->rxQueue.front().data.size();
+                }
+
+                const auto num = std::min(response.size(), sizeof(status));
+                memcpy(response.data(), &status, num);
+                return num;
+            }
+            case CommandId::ReadPacket:
+                return this->doReadPacket(response);
+            case CommandId::GetCounters: {
+                if(response.size() < sizeof(Response::GetCounters)) {
+                    return -1;
+                }
+
+                this->counters.currentTicks = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch()).count() / 4;
+                this->counters.rxQueue.packetsPending = this->rxQueue.size();
+                this->counters.rxQueue.bufferSize = this->rxAllocBytes;
+                this->counters.txQueue.packetsPending = this->txPending;
+                this->counters.txQueue.bufferSize = this->txAllocBytes;
+
+                memcpy(response.data(), &this->counters, sizeof(this->counters));
+
+                // clear the counters (except for current state)
+                this->counters = {};
+                return response.size();
+            }
+            case CommandId::StatusSnapshot: {
+                Response::StatusSnapshot snap;
+                this->fillSnapshot(snap);
+
+                const auto num = std::min(response.size(), sizeof(snap));
+                memcpy(response.data(), &snap, num);
+                return num;
+            }
+            case CommandId::Batch:
+                return this->doBatchRead(response);
+
+            default:
+                return -1;
+        }
+    } else {
+        switch(id) {
+            case CommandId::NoOp:
+                return 0;
+            case CommandId::RadioConfig:
+                return (payload.size() < sizeof(Request::RadioConfig)) ? -1 : 0;
+            case CommandId::IrqConfig:
+                if(payload.empty()) {
+                    return -1;
+                }
+                this->irqMask = payload[0] & 0x0f;
+                this->assertIrq(0);
+                return 0;
+            case CommandId::IrqStatus:
+                if(payload.empty()) {
+                    return -1;
+                }
+                this->acknowledgeIrq(payload[0] & 0x0f);
+                return 0;
+            case CommandId::TransmitPacket:
+                return this->doTransmit(payload);
+            case CommandId::BeaconConfig:
+                return (payload.size() < offsetof(Request::BeaconConfig, data)) ? -1 : 0;
+            case CommandId::StatusSnapshot:
+                if(payload.size() < sizeof(Request::StatusSnapshot)) {
+                    return -1;
+                }
+                this->snapshotAckOnRead = !!(payload[0] & 0x01);
+                return 0;
+            case CommandId::Batch:
+                return this->doBatchWrite(payload);
+
+            default:
+                return -1;
+        }
+    }
+}
+
+/**
+ * @brief Invoke post-read callbacks
+ */
+void MockTransport::postRead(const uint8_t cmd, const bool success) {
+    if(static_cast<CommandId>(cmd) == CommandId::StatusSnapshot && success &&
+            this->snapshotAckOnRead) {
+        this->acknowledgeIrq(this->snapshotReported);
+        if(this->snapshotReportedError) {
+            this->errorFlag = false;
+        }
+    }
+}
+
+/**
+ * @brief Read out a received packet
+ */
+int MockTransport::doReadPacket(std::span<uint8_t> response) {
+    if(this->rxQueue.empty() || response.size() < offsetof(Response::ReadPacket, payload)) {
+        return -1;
+    }
+
+    auto packet = std::move(this->rxQueue.front());
+    this->rxQueue.pop_front();
+    this->rxAllocBytes -= kBufferOverhead + packet.data.size();
+
+    const auto num = std::min(response.size(),
+            offsetof(Response::ReadPacket, payload) + packet.data.size());
+
+    response[0] = static_cast<uint8_t>(packet.rssi);
+    response[1] = packet.lqi;
+    memcpy(response.data() + 2, packet.data.data(), num - 2);
+
+    // the firmware keeps asserting the irq until the queue is drained
+    if(!this->rxQueue.empty()) {
+        this->assertIrq(Irq::PacketReceived);
+    }
+
+    return num;
+}
+
+/**
+ * @brief Queue a packet for transmission
+ */
+int MockTransport::doTransmit(std::span<const uint8_t> payload) {
+    if(payload.size() < sizeof(Request::TransmitPacket)) {
+        return -1;
+    }
+
+    const auto priority = payload[0] & 0x03;
+    const auto data = payload.subspan(sizeof(Request::TransmitPacket));
+    const auto required = kBufferOverhead + data.size();
+
+    auto &queue = this->txQueues[priority];
+    if(queue.size() >= kMaxTxQueueSize) {
+        this->txOverflow = true;
+        this->counters.txQueue.queueDiscards++;
+        return -2;
+    } else if(this->txAllocBytes + required > kMaxTxBufferSize) {
+        this->txOverflow = true;
+        this->counters.txQueue.bufferDiscards++;
+        return -2;
+    }
+
+    queue.emplace_back(data.begin(), data.end());
+    this->txAllocBytes += required;
+    this->txPending++;
+
+    this->txCond.notify_one();
+    return 0;
+}
+
+/**
+ * @brief Fill in a status snapshot
+ */
+void MockTransport::fillSnapshot(Response::StatusSnapshot &snap) {
+    const auto pending = this->irqActive & this->irqMask;
+
+    snap.irqPending.commandError = !!(pending & Irq::CommandError);
+    snap.irqPending.rxQueueNotEmpty = !!(pending & Irq::PacketReceived);
+    snap.irqPending.txPacket = !!(pending & Irq::PacketTransmitted);
+    snap.irqPending.txQueueEmpty = !!(pending & Irq::TxQueueEmpty);
+
+    snap.irqMask.commandError = !!(this->irqMask & Irq::CommandError);
+    snap.irqMask.rxQueueNotEmpty = !!(this->irqMask & Irq::PacketReceived);
+    snap.irqMask.txPacket = !!(this->irqMask & Irq::PacketTransmitted);
+    snap.irqMask.txQueueEmpty = !!(this->irqMask & Irq::TxQueueEmpty);
+
+    snap.status.cmdSuccess = !this->errorFlag;
+    snap.status.radioActive = 1;
+    snap.status.rxQueueNotEmpty = !this->rxQueue.empty();
+    snap.status.rxQueueFull = (this->rxQueue.size() >= kMaxRxQueueSize);
+    snap.status.rxQueueOverflow = this->rxOverflow;
+    snap.status.txQueueEmpty = !this->txPending;
+    snap.status.txQueueOverflow = this->txOverflow;
+
+    snap.rxQueue.packetsPending = this->rxQueue.size();
+    snap.rxQueue.bufferSize = this->rxAllocBytes;
+    snap.rxQueue.nextPacketSize = this->rxQueue.empty() ? 0 : this->rxQueue.front().data.size();
+
+    snap.txQueue.packetsPending = this->txPending;
+    snap.txQueue.bufferSize = this->txAllocBytes;
+    snap.txQueue.credits = kMaxTxBufferSize - this->txAllocBytes;
+
+    snap.currentTicks = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count() / 4;
+    snap.batchResponseBytes = this->batchResponses.size();
+
+    // the event ring isn't emulated
+    if(!this->config.supportsBatch) {
+        snap.version = 1;
+        snap.length = offsetof(Response::StatusSnapshot, batchResponseBytes);
+    } else {
+        snap.version = 2;
+        snap.length = offsetof(Response::StatusSnapshot, eventsPending);
+    }
+
+    this->snapshotReported = pending;
+    this->snapshotReportedError = this->errorFlag;
+}
+
+/**
+ * @brief Execute a batch of commands
+ *
+ * Same semantics as the firmware: commands are executed in order, each producing a record in the
+ * response ring; execution stops if a response wouldn't fit.
+ */
+int MockTransport::doBatchWrite(std::span<const uint8_t> payload) {
+    constexpr static const auto kRecordHeaderSize{offsetof(Response::BatchRecord, data)};
+
+    size_t offset{0};
+    bool anyFailed{false};
+
+    while(offset < payload.size()) {
+        if(payload.size() - offset < sizeof(CommandHeader)) {
+            return -1;
+        }
+
+        const uint8_t command = payload[offset], length = payload[offset + 1];
+        offset += sizeof(CommandHeader);
+
+        const bool isRead = (command & 0x80);
+        const uint8_t cmd = (command & ~0x80);
+
+        std::span<const uint8_t> cmdPayload;
+        size_t responseBytes{0};
+
+        if(isRead) {
+            responseBytes = std::min<size_t>(length, kMaxPayloadSize);
+        } else {
+            if(payload.size() - offset < length) {
+                return -1;
+            }
+            cmdPayload = payload.subspan(offset, length);
+            offset += length;
+        }
+
+        if(kResponseRingSize - this->batchResponses.size() < kRecordHeaderSize + responseBytes) {
+            return -2;
+        }
+
+        std::array<uint8_t, kMaxPayloadSize> scratch{};
+        int ret{-1};
+
+        if(cmd < static_cast<uint8_t>(CommandId::NumCommands) &&
+                cmd != static_cast<uint8_t>(CommandId::Batch)) {
+            ret = this->execute(cmd, isRead, cmdPayload, {scratch.data(), responseBytes});
+            if(isRead) {
+                this->postRead(cmd, ret >= 0);
+            }
+        }
+
+        if(ret < 0) {
+            anyFailed = true;
+            this->assertIrq(Irq::CommandError);
+        }
+
+        const auto resultBytes = (ret > 0) ? static_cast<size_t>(ret) : 0;
+
+        this->batchResponses.push_back(command);
+        this->batchResponses.push_back(static_cast<uint8_t>((ret < 0) ?
+                    std::max(ret, static_cast<int>(INT8_MIN)) : 0));
+        this->batchResponses.push_back(static_cast<uint8_t>(resultBytes));
+        this->batchResponses.insert(this->batchResponses.end(), scratch.begin(),
+                scratch.begin() + resultBytes);
+    }
+
+    return anyFailed ? -3 : 0;
+}
+
+/**
+ * @brief Drain records from the batch response ring
+ */
+int MockTransport::doBatchRead(std::span<uint8_t> response) {
+    constexpr static const auto kHeaderSize{offsetof(Response::Batch, records)};
+    constexpr static const auto kRecordHeaderSize{offsetof(Response::BatchRecord, data)};
+
+    if(response.size() < kHeaderSize) {
+        return -1;
+    }
+
+    std::fill(response.begin(), response.end(), 0);
+
+    size_t offset{kHeaderSize};
+    uint8_t numRecords{0};
+
+    while(!this->batchResponses.empty() && numRecords < UINT8_MAX) {
+        const size_t recordSize = kRecordHeaderSize + this->batchResponses[2];
+        if(offset + recordSize > response.size()) {
+            break;
+        }
+
+        std::copy_n(this->batchResponses.begin(), recordSize, response.begin() + offset);
+        this->batchResponses.erase(this->batchResponses.begin(),
+                this->batchResponses.begin() + recordSize);
+
+        offset += recordSize;
+        numRecords++;
+    }
+
+    Response::Batch hdr{
+        .bytesRemaining = static_cast<uint16_t>(this->batchResponses.size()),
+        .numRecords = numRecords,
+    };
+    memcpy(response.data(), &hdr, kHeaderSize);
+
+    return response.size();
+}
+
+
+
+/**
+ * @brief Update interrupt state
+ *
+ * Mark the given interrupts as active, and wake up anyone waiting for the interrupt line.
+ *
+ * @remark Must be called with the lock held.
+ */
+void MockTransport::assertIrq(const uint32_t which) {
+    this->irqActive |= which;
+
+    if(this->irqActive & this->irqMask) {
+        this->irqCond.notify_all();
+    }
+}
+
+/**
+ * @brief Acknowledge interrupts
+ *
+ * @remark Must be called with the lock held.
+ */
+void MockTransport::acknowledgeIrq(const uint32_t which) {
+    this->irqActive &= ~which;
+}
+
+/**
+ * @brief Delay for the time it takes to clock the given number of bytes over SPI
+ */
+void MockTransport::delayFor(const size_t numBytes) {
+    if(!this->config.spiClock || !numBytes) {
+        return;
+    }
+
+    Delay(std::chrono::nanoseconds((numBytes * 8ULL * 1'000'000'000ULL) /
+                this->config.spiClock));
+}
+
+/**
+ * @brief Radio emulation thread
+ *
+ * Transmits packets from the transmit queues (highest priority first) one at a time, holding the
+ * channel for each packet's airtime. Transmitted packets are looped back if enabled.
+ */
+void MockTransport::radioMain() {
+    std::unique_lock lk(this->lock);
+
+    while(!this->shutdown) {
+        // find the next packet to transmit
+        std::vector<uint8_t> packet;
+        bool found{false};
+
+        for(size_t i = 0; i < this->txQueues.size(); i++) {
+            auto &queue = this->txQueues[this->txQueues.size() - 1 - i];
+            if(!queue.empty()) {
+                packet = std::move(queue.front());
+                queue.pop_front();
+                found = true;
+                break;
+            }
+        }
+
+        if(!found) {
+            this->txCond.wait(lk);
+            continue;
+        }
+
+        // transmit it (without holding the lock)
+        lk.unlock();
+
+        if(this->config.airBitrate) {
+            const auto bits = (packet.size() + this->config.airOverhead) * 8ULL;
+            Delay(std::chrono::nanoseconds((bits * 1'000'000'000ULL) / this->config.airBitrate));
+        }
+
+        if(this->config.loopback) {
+            this->injectRxPacket(packet);
+        }
+
+        lk.lock();
+
+        // complete transmission
+        this->txAllocBytes -= kBufferOverhead + packet.size();
+        this->counters.txRadio.goodFrames++;
+
+        uint32_t irqs{Irq::PacketTransmitted};
+        if(!--this->txPending) {
+            irqs |= Irq::TxQueueEmpty;
+        }
+        this->assertIrq(irqs);
+    }
+}
@@ -0,0 +1,188 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <linux/gpio.h>
+#include <linux/spi/spidev.h>
+
+#include <stdexcept>
+#include <system_error>
+
+#include <BlazeNet/HostIf/Commands.h>
+#include <BlazeNet/Host/SpidevTransport.h>
+
+using namespace BlazeNet::Host;
+
+/**
+ * @brief Open the SPI device and interrupt line
+ *
+ * @throws std::system_error If the device nodes couldn't be opened or configured
+ */
+SpidevTransport::SpidevTransport(const Config &config) : config(config) {
+    int err;
+
+    // open and configure the SPI device
+    this->spiFd = open(config.spiDevice.c_str(), O_RDWR | O_CLOEXEC);
+    if(this->spiFd == -1) {
+        throw std::system_error(errno, std::generic_category(), "open spidev");
+    }
+
+    uint8_t mode{SPI_MODE_0}, bits{8};
+    uint32_t speed{config.spiClock};
+
+    if(ioctl(this->spiFd, SPI_IOC_WR_MODE, &mode) == -1 ||
+            ioctl(this->spiFd, SPI_IOC_WR_BITS_PER_WORD, &bits) == -1 ||
+            ioctl(this->spiFd, SPI_IOC_WR_MAX_SPEED_HZ, &speed) == -1) {
+        err = errno;
+        close(this->spiFd);
+        throw std::system_error(err, std::generic_category(), "configure spidev");
+    }
+
+    // request the interrupt line (active low, so we want falling edges)
+    const auto chipFd = open(config.gpioChip.c_str(), O_RDWR | O_CLOEXEC);
+    if(chipFd == -1) {
+        err = errno;
+        close(this->spiFd);
+        throw std::system_error(err, std::generic_category(), "open gpiochip");
+    }
+
+    struct gpioevent_request req{};
+    req.lineoffset = config.irqLine;
+    req.handleflags = GPIOHANDLE_REQUEST_INPUT;
+    req.eventflags = GPIOEVENT_REQUEST_FALLING_EDGE;
+    strncpy(req.consumer_label, "blazenet-irq", sizeof(req.consumer_label) - 1);
+
+    if(ioctl(chipFd, GPIO_GET_LINEEVENT_IOCTL, &req) == -1) {
+        err = errno;
+        close(chipFd);
+        close(this->spiFd);
+        throw std::system_error(err, std::generic_category(), "request irq line");
+    }
+
+    close(chipFd);
+    this->irqFd = req.fd;
+}
+
+/**
+ * @brief Release device nodes
+ */
+SpidevTransport::~SpidevTransport() {
+    if(this->irqFd != -1) {
+        close(this->irqFd);
+    }
+    if(this->spiFd != -1) {
+        close(this->spiFd);
+    }
+}
+
+/**
+ * @brief Execute a write command
+ */
+int SpidevTransport::write(const uint8_t command, std::span<const uint8_t> payload) {
+    if(payload.size() > UINT8_MAX) {
+        return Error::InvalidArguments;
+    }
+
+    return this->transfer(command & ~0x80, payload.size(), payload.data(), nullptr);
+}
+
+/**
+ * @brief Execute a read command
+ *
+ * @remark The radio only transmits as many bytes as the command produced; the remainder of the
+ *         buffer is undefined.
+ */
+int SpidevTransport::read(const uint8_t command, std::span<uint8_t> buffer) {
+    int err;
+
+    if(buffer.empty() || buffer.size() > UINT8_MAX) {
+        return Error::InvalidArguments;
+    }
+
+    err = this->transfer(command | 0x80, buffer.size(), nullptr, buffer.data());
+    return err ? err : static_cast<int>(buffer.size());
+}
+
+/**
+ * @brief Perform a single transaction
+ *
+ * Clock out the command header, wait for the turnaround time, then transfer the payload (if any)
+ * in the same ioctl, so the two are not separated by other bus traffic.
+ *
+ * @param command Command byte (including read bit)
+ * @param length Payload length
+ * @param txBuf Payload to write, if any
+ * @param rxBuf Buffer to receive payload, if any
+ */
+int SpidevTransport::transfer(const uint8_t command, const uint8_t length, const void *txBuf,
+        void *rxBuf) {
+    HostIf::CommandHeader hdr{
+        .command = command,
+        .payloadLength = length,
+    };
+
+    struct spi_ioc_transfer xfers[2]{};
+
+    xfers[0].tx_buf = reinterpret_cast<uintptr_t>(&hdr);
+    xfers[0].len = sizeof(hdr);
+    xfers[0].speed_hz = this->config.spiClock;
+    xfers[0].delay_usecs = static_cast<uint16_t>(this->config.turnaround.count());
+
+    xfers[1].tx_buf = reinterpret_cast<uintptr_t>(txBuf);
+    xfers[1].rx_buf = reinterpret_cast<uintptr_t>(rxBuf);
+    xfers[1].len = length;
+    xfers[1].speed_hz = this->config.spiClock;
+
+    const auto numXfers = length ? 2 : 1;
+    if(ioctl(this->spiFd, SPI_IOC_MESSAGE(numXfers), xfers) == -1) {
+        return Error::IoFailed;
+    }
+
+    /*
+     * The radio re-arms its receiver for the next command header only once it's processed this
+     * one; give it the same turnaround time before we return, so back to back commands don't get
+     * lost.
+     */
+    usleep(this->config.turnaround.count());
+
+    return 0;
+}
+
+/**
+ * @brief Wait for an interrupt
+ *
+ * Check the current level of the interrupt line; if not asserted, wait for a falling edge.
+ */
+bool SpidevTransport::waitForIrq(const std::chrono::microseconds timeout) {
+    // check the current level first (we may have missed the edge)
+    struct gpiohandle_data data{};
+    if(ioctl(this->irqFd, GPIOHANDLE_GET_LINE_VALUES_IOCTL, &data) == -1) {
+        return false;
+    }
+    if(!data.values[0]) {
+        return true;
+    }
+
+    // wait for an edge event
+    struct pollfd pfd{
+        .fd = this->irqFd,
+        .events = POLLIN | POLLPRI,
+        .revents = 0,
+    };
+
+    const auto msec = std::chrono::duration_cast<std::chrono::milliseconds>(timeout).count();
+    if(poll(&pfd, 1, static_cast<int>(msec)) <= 0) {
+        return false;
+    }
+
+    // consume the event
+    struct gpioevent_data event;
+    if(::read(this->irqFd, &event, sizeof(event)) != sizeof(event)) {
+        return false;
+    }
+
+    return true;
+}
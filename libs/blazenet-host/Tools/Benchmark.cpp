@@ -0,0 +1,227 @@
+/**
+ * @file
+ *
+ * @brief Host driver benchmark
+ *
+ * Measures packet throughput and latency of the host driver against the in-process radio
+ * emulation: packets are transmitted (with a sequence number and timestamp in their payload) and
+ * looped back by the emulated radio, so the round trip through the driver's transmit and receive
+ * paths can be timed.
+ *
+ * Each configuration is run both with and without command batching, to compare the two.
+ *
+ * With the default parameters, the emulated airtime of each packet is the bottleneck, and the
+ * transmit window only ever releases one packet at a time; so batches rarely form, and batching
+ * makes no difference. It pays off once the SPI link is the bottleneck instead (for example with
+ * `--air-bitrate 0`) and commands queue up behind each other.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include <BlazeNet/Host/Device.h>
+#include <BlazeNet/Host/MockTransport.h>
+
+using namespace BlazeNet::Host;
+using Clock = std::chrono::steady_clock;
+
+/// Benchmark parameters
+struct Params {
+    /// Number of packets to send
+    size_t numPackets{2000};
+    /// Size of each packet (bytes)
+    size_t packetSize{32};
+    /// Maximum number of packets in flight
+    size_t window{8};
+
+    /// Emulation parameters
+    MockTransport::Config mock;
+};
+
+/// Results of a single run
+struct Results {
+    double seconds{0};
+    size_t received{0};
+    size_t txErrors{0};
+
+    std::vector<double> latencies;
+    Device::Stats stats;
+    size_t transactions{0};
+};
+
+/**
+ * @brief Run the benchmark in one configuration
+ */
+static Results Run(const Params &params, const bool useBatch) {
+    // set up the driver
+    auto mock = std::make_shared<MockTransport>(params.mock);
+
+    Device::Config config;
+    config.useBatch = useBatch;
+    config.maxRxPacketSize = params.packetSize;
+
+    Device dev(mock, config);
+
+    // receive handler: record latency
+    std::mutex lock;
+    std::condition_variable cond;
+    Results res;
+    res.latencies.reserve(params.numPackets);
+
+    dev.setRxHandler([&](const Device::RxPacket &packet) {
+        Clock::rep sent;
+        if(packet.data.size() < sizeof(uint32_t) + sizeof(sent)) {
+            return;
+        }
+        memcpy(&sent, packet.data.data() + sizeof(uint32_t), sizeof(sent));
+
+        const auto now = Clock::now().time_since_epoch().count();
+
+        std::lock_guard lg(lock);
+        res.latencies.push_back(static_cast<double>(now - sent) / 1000.);
+        res.received++;
+        cond.notify_all();
+    });
+
+    // transmit all packets, keeping the configured number in flight
+    std::vector<uint8_t> packet(params.packetSize);
+    std::vector<std::future<int>> pending;
+
+    const auto start = Clock::now();
+
+    for(uint32_t seq = 0; seq < params.numPackets; seq++) {
+        {
+            std::unique_lock lk(lock);
+            if(!cond.wait_for(lk, std::chrono::seconds(5), [&] {
+                return (seq - res.received - res.txErrors) < params.window;
+            })) {
+                fprintf(stderr, "timed out waiting for packet %u\n", seq);
+                break;
+            }
+        }
+
+        const auto now = Clock::now().time_since_epoch().count();
+        memcpy(packet.data(), &seq, sizeof(seq));
+        memcpy(packet.data() + sizeof(seq), &now, sizeof(now));
+
+        pending.emplace_back(dev.transmit(1, packet));
+
+        // reap completed transmit requests
+        std::erase_if(pending, [&](auto &f) {
+            if(f.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                return false;
+            }
+            if(f.get()) {
+                std::lock_guard lg(lock);
+                res.txErrors++;
+            }
+            return true;
+        });
+    }
+
+    // wait for the remaining packets
+    {
+        std::unique_lock lk(lock);
+        cond.wait_for(lk, std::chrono::seconds(5), [&] {
+            return res.received + res.txErrors >= params.numPackets;
+        });
+    }
+
+    res.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    res.stats = dev.getStats();
+    res.transactions = mock->getNumTransactions();
+
+    dev.setRxHandler(nullptr);
+    return res;
+}
+
+/**
+ * @brief Print results of a run
+ */
+static void Print(const char *name, const Params &params, Results &res) {
+    std::sort(res.latencies.begin(), res.latencies.end());
+
+    auto percentile = [&](const double p) -> double {
+        if(res.latencies.empty()) {
+            return 0;
+        }
+        return res.latencies[std::min(res.latencies.size() - 1,
+                static_cast<size_t>(p * res.latencies.size()))];
+    };
+
+    const double pps = res.received / res.seconds;
+
+    printf("%-10s %8.0f pkt/s %8.1f kB/s | latency (us) p50 %8.1f p90 %8.1f p99 %8.1f "
+            "max %8.1f | %5.2f xfers/pkt, %zu batches (%zu cmds), %zu irqs, %zu tx errors, "
+            "%zu lost\n",
+            name, pps, pps * params.packetSize / 1000., percentile(.5), percentile(.9),
+            percentile(.99), res.latencies.empty() ? 0 : res.latencies.back(),
+            res.received ? static_cast<double>(res.transactions) / res.received : 0,
+            res.stats.batches, res.stats.batchedCommands, res.stats.irqs, res.txErrors,
+            params.numPackets - res.received - res.txErrors);
+}
+
+static void Usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--packets N] [--size BYTES] [--window N] [--spi-clock HZ]\n"
+            "       [--turnaround US] [--air-bitrate BPS]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    Params params;
+
+    // parse arguments
+    for(int i = 1; i < argc; i++) {
+        const std::string_view arg{argv[i]};
+
+        if(i + 1 >= argc) {
+            Usage(argv[0]);
+            return 1;
+        }
+        const auto value = strtoul(argv[++i], nullptr, 0);
+
+        if(arg == "--packets") {
+            params.numPackets = value;
+        } else if(arg == "--size") {
+            params.packetSize = value;
+        } else if(arg == "--window") {
+            params.window = value;
+        } else if(arg == "--spi-clock") {
+            params.mock.spiClock = value;
+        } else if(arg == "--turnaround") {
+            params.mock.turnaround = std::chrono::microseconds(value);
+        } else if(arg == "--air-bitrate") {
+            params.mock.airBitrate = value;
+        } else {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if(params.packetSize < sizeof(uint32_t) + sizeof(Clock::rep) || params.packetSize > 250 ||
+            !params.window) {
+        fprintf(stderr, "packet size must be between %zu and 250 bytes; window must be > 0\n",
+                sizeof(uint32_t) + sizeof(Clock::rep));
+        return 1;
+    }
+
+    printf("%zu packets of %zu bytes, window %zu; SPI %u Hz (%lld us turnaround), air %u bps\n",
+            params.numPackets, params.packetSize, params.window, params.mock.spiClock,
+            static_cast<long long>(params.mock.turnaround.count()), params.mock.airBitrate);
+
+    auto single = Run(params, false);
+    Print("single", params, single);
+
+    auto batched = Run(params, true);
+    Print("batched", params, batched);
+
+    return 0;
+}
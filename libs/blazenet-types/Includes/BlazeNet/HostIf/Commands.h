@@ -0,0 +1,1051 @@
+/**
+ * @file
+ *
+ * @brief Host interface protocol
+ *
+ * Defines the commands (and their request/response payloads) exchanged over the SPI interface
+ * between a host-controlled radio and its host. These are shared between the radio firmware and
+ * host-side drivers.
+ */
+#ifndef BLAZENET_HOSTIF_COMMANDS_H
+#define BLAZENET_HOSTIF_COMMANDS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace HostIf {
+/**
+ * @brief Command identifiers
+ */
+enum class CommandId: uint8_t {
+    NoOp                                        = 0x00,
+    GetInfo                                     = 0x01,
+    RadioConfig                                 = 0x02,
+    GetStatus                                   = 0x03,
+    IrqConfig                                   = 0x04,
+    GetPacketQueueStatus                        = 0x05,
+    ReadPacket                                  = 0x06,
+    TransmitPacket                              = 0x07,
+    BeaconConfig                                = 0x08,
+    GetCounters                                 = 0x09,
+    IrqStatus                                   = 0x0A,
+    StatusSnapshot                              = 0x0B,
+    Batch                                       = 0x0C,
+    ReadEvents                                  = 0x0D,
+    ReadProbes                                  = 0x0E,
+    GetTaskStats                                = 0x0F,
+    GetHeapStats                                = 0x10,
+    LogLevels                                   = 0x11,
+    ReadLogArchive                              = 0x12,
+    ReadLogs                                    = 0x13,
+    GetFsStats                                  = 0x14,
+
+    /// Total number of defined commands
+    NumCommands,
+};
+
+/**
+ * @brief Host command header structure
+ *
+ * A small, packed structure received from the host. It indicates the command id and the length of
+ * the (optional) payload.
+ */
+struct CommandHeader {
+    /**
+     * @brief Command identifier
+     *
+     * Command IDs are 7 bits in length. The high bit of the command is used to indicate
+     * that the host is _reading_ data from the controller, rather than the other way
+     * around.
+     *
+     * @seeAlso CommandId
+     */
+    uint8_t command;
+    /// Number of payload bytes following the command
+    uint8_t payloadLength;
+} __attribute__((packed));
+
+/// Holds command payload structures (sent to host)
+namespace Response {
+/**
+ * @brief Information sent as part of a "Get Info" command
+ */
+struct GetInfo {
+    /// Hardware feature flags
+    enum HwFeatures: uint8_t {
+        /// Controller has dedicated, private storage
+        PrivateStorage                          = (1 << 0),
+    };
+
+    /// Command status (1 = success)
+    uint8_t status;
+
+    /// Firmware version information
+    struct {
+        /// Protocol version (current is 1)
+        uint8_t protocolVersion;
+        /// Major version
+        uint8_t major;
+        /// Minor version
+        uint8_t minor;
+
+        /// Build revision (ASCII string)
+        char build[8];
+    } fw;
+
+    /// Hardware information
+    struct {
+        /// Hardware revision
+        uint8_t rev;
+        /// Hardware features supported
+        uint8_t features;
+
+        /// Serial number (ASCII string)
+        char serial[16];
+        /// EUI-64 (for radio use)
+        uint8_t eui64[8];
+    } hw;
+
+    /// Radio capabilities
+    struct {
+        /// Maximum transmit power (in 1/10th dBm)
+        uint8_t maxTxPower;
+    } radio;
+} __attribute__((packed));
+
+/**
+ * @brief "Get Status" command response
+ *
+ * This is basically one gigantic bitfield of event flags.
+ */
+struct GetStatus {
+    /// Last command was successful
+    uint8_t cmdSuccess                          :1{0};
+    /// Radio is active (tuned to channel and receiving or transmitting)
+    uint8_t radioActive                         :1{0};
+
+    /// At least one packet is pending in the receive queue
+    uint8_t rxQueueNotEmpty                     :1{0};
+    /// The receive queue is full
+    uint8_t rxQueueFull                         :1{0};
+    /// Receive queue overflow (packets have been discarded)
+    uint8_t rxQueueOverflow                     :1{0};
+
+    /// Transmit queue is empty
+    uint8_t txQueueEmpty                        :1{0};
+    /// Transmit queue is full
+    uint8_t txQueueFull                         :1{0};
+    /// Transmit queue overflow (packets have been discarded)
+    uint8_t txQueueOverflow                     :1{0};
+} __attribute__((packed));
+
+/**
+ * @brief "Irq configuration" command response
+ *
+ * Indicates the state of which interrupts are masked (0) or allowed (1) to generate a physical
+ * interrupt.
+ */
+struct IrqConfig {
+    /**
+     * @brief Command error interrupt
+     *
+     * Set: Asserted any time a radio command fails.
+     *
+     * Clear: Read status register
+     */
+    uint8_t commandError                        :1{0};
+
+    /**
+     * @brief Receive queue not empty
+     *
+     * Set: A packet was received and is waiting in the receive queue
+     *
+     * Clear: Read out all pending packets
+     */
+    uint8_t rxQueueNotEmpty                     :1{0};
+
+    /**
+     * @brief Packet transmitted
+     *
+     * Set: A packet was successfully transmitted
+     *
+     * Clear: Read status register
+     */
+    uint8_t txPacket                            :1{0};
+
+    /**
+     * @brief Transmit queue empty
+     *
+     * Set: The last pending packet has been transmitted
+     *
+     * Clear: Read status register
+     */
+    uint8_t txQueueEmpty                        :1{0};
+
+    /**
+     * @brief Event pending
+     *
+     * Set: At least one record is waiting in the event ring (or events were lost)
+     *
+     * Clear: Read out all pending events
+     */
+    uint8_t eventPending                        :1{0};
+
+    /**
+     * @brief Log records pending
+     *
+     * Set: Log records are waiting in the host log ring (or records were dropped)
+     *
+     * Clear: Read out all pending log records
+     */
+    uint8_t logPending                          :1{0};
+
+    uint8_t reserved                            :2{};
+} __attribute__((packed));
+
+/**
+ * @brief "Get packet queue status" command response
+ *
+ * Indicates the state of the receive and transmit queues.
+ */
+struct GetPacketQueueStatus {
+    /// Is at least one receive packet pending?
+    uint8_t rxPacketPending                     :1{0};
+    /// Is there a transmit packet pending?
+    uint8_t txPacketPending                     :1{0};
+    uint8_t reserved                            :6{0};
+
+    /// Size of the next packet to be read from the receive queue
+    uint8_t rxPacketSize{};
+} __attribute__((packed));
+
+/**
+ * @brief "ReadPacket" command response
+ *
+ * Returns the contents of a buffer slot in the receive queue.
+ *
+ * @remark This does _not_ contain the packet payload length, as it's expected that you previously
+ * retrieved this with a call to GetPacketQueueStatus.
+ */
+struct ReadPacket {
+    /// Packet RSSI (in dB)
+    int8_t rssi;
+    /// Link quality (relative scale, where 0 is worst and 255 is best)
+    uint8_t lqi;
+
+    /// Actual payload data
+    uint8_t payload[];
+} __attribute__((packed));
+
+/**
+ * @brief "GetCounters" command response
+ *
+ * Reads out various performance counters to the host. If this command completes successfully, the
+ * counters will be cleared to zero.
+ */
+struct GetCounters {
+    /// Current internal tick timestamp
+    uint32_t currentTicks;
+
+    /// Transmit queue
+    struct {
+        /// Current number of packets pending
+        uint32_t packetsPending;
+        /// Number of bytes currently allocated
+        uint32_t bufferSize;
+
+        /// Packets discarded because buffer size limit was reached
+        uint32_t bufferDiscards;
+        /// Packets discarded because allocation failed (other reason)
+        uint32_t bufferAllocFails;
+        /// Packets discarded because queue is full
+        uint32_t queueDiscards;
+    } txQueue;
+    /// Radio (transmit)
+    struct {
+        /// Drops because FIFO is full
+        uint32_t fifoDrops;
+        /// CSMA detection fails
+        uint32_t ccaFails;
+        /// Number of successfully transmitted frames
+        uint32_t goodFrames;
+    } txRadio;
+
+    /// Receive queue
+    struct {
+        /// Current number of packets pending
+        uint32_t packetsPending;
+        /// Number of bytes currently allocated
+        uint32_t bufferSize;
+
+        /// Packets discarded because buffer size limit was reached
+        uint32_t bufferDiscards;
+        /// Packets discarded because allocation failed (other reason)
+        uint32_t bufferAllocFails;
+        /// Packets discarded because queue is full
+        uint32_t queueDiscards;
+    } rxQueue;
+    /// Radio (receive)
+    struct {
+        /// FIFO overflows
+        uint32_t fifoOverflows;
+        /// Frame errors
+        uint32_t frameErrors;
+        /// Number of good frames
+        uint32_t goodFrames;
+    } rxRadio;
+} __attribute__((packed));
+
+/**
+ * @brief Response to an "IRQ Status" command
+ *
+ * This reads out the interrupt status register, showing which interrupts are currently active.
+ */
+struct IrqStatus {
+    /**
+     * @brief Command error interrupt
+     *
+     * Set: Asserted any time a radio command fails.
+     */
+    uint8_t commandError                        :1{0};
+
+    /**
+     * @brief Receive queue not empty
+     *
+     * Set: A packet was received and is waiting in the receive queue
+     */
+    uint8_t rxQueueNotEmpty                     :1{0};
+
+    /**
+     * @brief Packet transmitted
+     *
+     * Set: A packet was successfully transmitted
+     */
+    uint8_t txPacket                            :1{0};
+
+    /**
+     * @brief Transmit queue empty
+     *
+     * Set: The last pending packet has been transmitted
+     */
+    uint8_t txQueueEmpty                        :1{0};
+
+    /**
+     * @brief Event pending
+     *
+     * Set: At least one record is waiting in the event ring
+     *
+     * @remark This interrupt can't be acknowledged; it's cleared once all events are read out.
+     */
+    uint8_t eventPending                        :1{0};
+
+    /**
+     * @brief Log records pending
+     *
+     * Set: Log records are waiting in the host log ring
+     *
+     * @remark This interrupt can't be acknowledged; it's cleared once all records are read out.
+     */
+    uint8_t logPending                          :1{0};
+
+    uint8_t reserved                            :2{};
+} __attribute__((packed));
+
+/**
+ * @brief Response to a "StatusSnapshot" command
+ *
+ * Combines the interrupt status, status register, and packet queue state in one contiguous
+ * structure, so the host's interrupt handler can find out everything it needs with a single
+ * transaction. All fields are captured atomically.
+ *
+ * New fields are only ever appended to the end of the structure; the host should check the
+ * version and length fields before interpreting the rest of it.
+ */
+struct StatusSnapshot {
+    /// Current snapshot format version
+    constexpr static const uint8_t kVersion{0x03};
+
+    /// Snapshot format version
+    uint8_t version{kVersion};
+    /// Total length of the snapshot structure, in bytes
+    uint8_t length{sizeof(StatusSnapshot)};
+
+    /// Pending (unmasked) interrupts
+    IrqStatus irqPending;
+    /// Current interrupt mask
+    IrqConfig irqMask;
+    /// Status register (the command success flag is not cleared by reading it here)
+    GetStatus status;
+
+    /// Receive queue
+    struct {
+        /// Number of packets pending to be read
+        uint16_t packetsPending;
+        /// Number of bytes currently allocated
+        uint16_t bufferSize;
+        /// Size of the next packet to be read (0 if none pending)
+        uint8_t nextPacketSize;
+    } __attribute__((packed)) rxQueue{};
+
+    /// Transmit queue
+    struct {
+        /// Number of packets pending transmission (including the one currently on air)
+        uint16_t packetsPending;
+        /// Number of bytes currently allocated
+        uint16_t bufferSize;
+        /// Number of bytes of packet buffer space available for new packets
+        uint16_t credits;
+    } __attribute__((packed)) txQueue{};
+
+    /// Current internal tick timestamp
+    uint32_t currentTicks{0};
+
+    /// Number of bytes waiting in the batch response ring (added in version 2)
+    uint16_t batchResponseBytes{0};
+
+    /// Number of records waiting in the event ring, saturated to 255 (added in version 3)
+    uint8_t eventsPending{0};
+} __attribute__((packed));
+
+/**
+ * @brief Record in the batch response ring
+ *
+ * Each command executed as part of a batch produces one of these records, in the order the
+ * commands were executed. Only commands that read data have a payload.
+ */
+struct BatchRecord {
+    /// Command that was executed (including the read bit)
+    uint8_t command;
+    /// Return code of the command (0 = success, negative error code otherwise)
+    int8_t status;
+    /// Number of payload bytes that follow
+    uint8_t length;
+
+    /// Response payload (for read commands)
+    uint8_t data[];
+} __attribute__((packed));
+
+/**
+ * @brief "Batch" command response
+ *
+ * Drains complete records from the batch response ring. Only whole records are returned; any
+ * remaining space in the requested read length is zero filled.
+ */
+struct Batch {
+    /// Number of bytes still left in the response ring after this read
+    uint16_t bytesRemaining;
+    /// Number of records that follow
+    uint8_t numRecords;
+
+    /// Records (a sequence of BatchRecord structs)
+    uint8_t records[];
+} __attribute__((packed));
+
+/**
+ * @brief Record in the event ring
+ *
+ * Events are recorded by the firmware in the order they occur, each with a timestamp and a
+ * type-specific payload. All records have the same size, regardless of type.
+ *
+ * Every event is assigned a sequence number, even if it couldn't be stored because the ring was
+ * full; so a gap in sequence numbers indicates lost events.
+ */
+struct Event {
+    /**
+     * @brief Event types
+     */
+    enum Type: uint8_t {
+        /// A frame was received
+        FrameReceived                           = 0x01,
+        /// Transmission of a frame completed (successfully or not)
+        TxComplete                              = 0x02,
+        /// A packet queue's buffer usage crossed a watermark
+        QueueWatermark                          = 0x03,
+        /// Radio calibration started
+        CalibrationStarted                      = 0x04,
+        /// Radio calibration finished
+        CalibrationFinished                     = 0x05,
+        /// Host communications state changed
+        CommsStateChanged                       = 0x06,
+    };
+
+    /**
+     * @brief Transmit completion status
+     */
+    enum TxStatus: int8_t {
+        /// Frame was transmitted
+        Success                                 = 0,
+        /// Frame was dropped because the channel was busy (CSMA failed too many times)
+        ChannelBusy                             = -1,
+    };
+
+    /**
+     * @brief Packet queues (for the watermark event)
+     */
+    enum Queue: uint8_t {
+        RxQueue                                 = 0,
+        TxQueue                                 = 1,
+    };
+
+    /// Event type
+    uint8_t type;
+    uint8_t reserved;
+    /// Sequence number
+    uint16_t sequence;
+    /// Time at which the event occurred (µs, radio timebase; wraps around)
+    uint32_t timestamp;
+
+    /// Event specific data
+    union {
+        /// FrameReceived: details of the received frame
+        struct {
+            /// Frame size (bytes)
+            uint16_t size;
+            /// Frame RSSI (dB)
+            int8_t rssi;
+            /// Link quality indicator
+            uint8_t lqi;
+            /// Whether the frame was placed in the receive queue (otherwise, it was discarded)
+            uint8_t queued;
+        } __attribute__((packed)) frameReceived;
+
+        /// TxComplete: transmit status
+        struct {
+            /// Frame size (bytes)
+            uint16_t size;
+            /// Completion status (a TxStatus value)
+            int8_t status;
+        } __attribute__((packed)) txComplete;
+
+        /// QueueWatermark: queue state after crossing the watermark
+        struct {
+            /// Which queue crossed a watermark (a Queue value)
+            uint8_t queue;
+            /// Set if the high watermark was exceeded, clear if usage dropped below low watermark
+            uint8_t high;
+            /// Bytes of buffer space allocated
+            uint16_t bufferSize;
+            /// Number of packets in the queue
+            uint16_t packetsPending;
+        } __attribute__((packed)) queueWatermark;
+
+        /// CalibrationStarted: calibrations to be performed
+        struct {
+            /// Pending calibrations (RAIL calibration mask)
+            uint32_t pending;
+        } __attribute__((packed)) calibrationStarted;
+
+        /// CalibrationFinished: calibration result
+        struct {
+            /// Status code (0 = success)
+            int32_t status;
+        } __attribute__((packed)) calibrationFinished;
+
+        /// CommsStateChanged: new state
+        struct {
+            /// Set if host communication was lost, clear if it was (re)established
+            uint8_t lost;
+        } __attribute__((packed)) commsState;
+
+        uint8_t raw[8];
+    } data;
+} __attribute__((packed));
+
+/**
+ * @brief "ReadEvents" command response
+ *
+ * Reads out as many records from the event ring as fit in the requested length. Any remaining
+ * space is zero filled.
+ *
+ * Events are only removed from the ring once the read completes successfully.
+ */
+struct ReadEvents {
+    /// Number of events dropped (because the ring was full) since the last successful read
+    uint16_t eventsLost;
+    /// Number of event records that follow
+    uint8_t numEvents;
+    /// Number of events remaining in the ring after this read (saturated to 255)
+    uint8_t eventsRemaining;
+
+    /// Event records
+    Event events[];
+} __attribute__((packed));
+
+/**
+ * @brief Accumulated measurements of a single profiling probe
+ *
+ * Times are in ticks of the probe timer; see ReadProbes::timerFrequency.
+ */
+struct Probe {
+    /// Number of completed measurements
+    uint32_t count;
+    /// Shortest measured duration
+    uint32_t min;
+    /// Longest measured duration
+    uint32_t max;
+    /// Sum of all measured durations
+    uint64_t total;
+} __attribute__((packed));
+
+/**
+ * @brief "ReadProbes" command response
+ *
+ * Reads out the profiling probe table. Each probe measures the time spent in one of the firmware's
+ * hot paths. If the read completes successfully, all probes are reset.
+ *
+ * Firmware built without probe support reports `enabled` as 0, and all probes as zero.
+ */
+struct ReadProbes {
+    /**
+     * @brief Probe identifiers
+     *
+     * Index into the probe table.
+     */
+    enum Id: uint8_t {
+        /// Packet handler: receive a frame into the receive queue
+        HandleRxPacket                          = 0,
+        /// Radio task: load a frame into the transmit FIFO and start transmitting
+        TxPacketImmediate                       = 1,
+        /// Host interface: execute a write command
+        DispatchCommand                         = 2,
+        /// Format and output a log message
+        LoggerLog                               = 3,
+        /// Filesystem: read from external flash
+        FsRead                                  = 4,
+        /// Filesystem: write to external flash
+        FsWrite                                 = 5,
+        /// Filesystem: erase external flash
+        FsErase                                 = 6,
+
+        /// Total number of probes
+        NumProbes,
+    };
+
+    /// Frequency of the probe timer (Hz)
+    uint32_t timerFrequency;
+    /// Set if the firmware was built with probes enabled
+    uint8_t enabled;
+    /// Number of probes that follow
+    uint8_t numProbes;
+    uint8_t reserved[2];
+
+    /// Probe measurements, indexed by probe id
+    Probe probes[NumProbes];
+} __attribute__((packed));
+
+/**
+ * @brief Run time statistics of a single task
+ */
+struct TaskInfo {
+    /// Task name (not necessarily zero terminated)
+    char name[12];
+    /// Time spent running since the last successful read (µs)
+    uint32_t runTime;
+    /// Minimum amount of stack space that remained free (words)
+    uint16_t stackHighWater;
+    /// Current priority
+    uint8_t priority;
+    /// Current state: 0 = running, 1 = ready, 2 = blocked, 3 = suspended
+    uint8_t state;
+} __attribute__((packed));
+
+/**
+ * @brief "GetTaskStats" command response
+ *
+ * Reports how much CPU time each task used since the previous successful read of this command,
+ * along with its priority and stack usage. Read as many bytes as there are tasks to report; any
+ * remaining space is zero filled. Run time counters are only advanced once the read completes.
+ */
+struct GetTaskStats {
+    /// Total elapsed time since the last successful read (µs)
+    uint32_t interval;
+    /// Number of tasks in the system
+    uint8_t numTasks;
+    /// Number of task records that follow
+    uint8_t numRecords;
+    uint8_t reserved[2];
+
+    /// Task records
+    TaskInfo tasks[];
+} __attribute__((packed));
+
+/**
+ * @brief Allocation counters of a class of heap allocations
+ */
+struct HeapClass {
+    /// Number of successful allocations
+    uint32_t allocs;
+    /// Number of allocations released
+    uint32_t frees;
+    /// Number of allocations that failed
+    uint32_t failures;
+    /// Bytes currently allocated
+    uint32_t bytes;
+    /// Maximum number of bytes allocated at any one time
+    uint32_t peakBytes;
+} __attribute__((packed));
+
+/**
+ * @brief "GetHeapStats" command response
+ *
+ * Reports the usage of the system heap, as well as allocation counters for each class of
+ * allocation made by the firmware. Peak values are since boot.
+ */
+struct GetHeapStats {
+    /**
+     * @brief Allocation classes
+     *
+     * Index into the class table.
+     */
+    enum Class: uint8_t {
+        /// Received packet buffers
+        PacketRx                                = 0,
+        /// Transmit packet buffers
+        PacketTx                                = 1,
+        /// Per task log message buffers
+        LogBuffer                               = 2,
+        /// Filesystem work and cache buffers
+        FsCache                                 = 3,
+        /// Everything else allocated by the firmware (including C++ objects)
+        Other                                   = 4,
+
+        /// Total number of allocation classes
+        NumClasses,
+    };
+
+    /// Total heap size (bytes)
+    uint32_t heapSize;
+    /// Free heap space (bytes)
+    uint32_t heapFree;
+    /**
+     * @brief Largest block known to be available for allocation (bytes)
+     *
+     * This is the contiguous free space at the end of the heap; a free block elsewhere may be
+     * larger.
+     */
+    uint32_t largestFree;
+    /**
+     * @brief Fragmentation index
+     *
+     * The fraction of free space that is not part of the contiguous free space at the end of the
+     * heap, in units of 0.1%; 0 means all free space is contiguous.
+     */
+    uint16_t fragmentation;
+    uint8_t reserved[2];
+
+    /// Bytes currently allocated, over all classes
+    uint32_t bytes;
+    /// Maximum number of bytes allocated at any one time, over all classes
+    uint32_t peakBytes;
+
+    /// Counters for each allocation class
+    HeapClass classes[NumClasses];
+} __attribute__((packed));
+
+/**
+ * @brief "LogLevels" command response
+ *
+ * Reports the log level threshold of each firmware module: messages from the module below its
+ * threshold are discarded. Levels are numbered from 1 (trace) to 5 (error); error messages are
+ * always output.
+ */
+struct LogLevels {
+    /**
+     * @brief Firmware modules
+     *
+     * Index into the level table.
+     */
+    enum Module: uint8_t {
+        /// Everything not covered by a more specific module
+        System                                  = 0,
+        /// Radio task and RAIL
+        Radio                                   = 1,
+        /// Packet queues
+        Packet                                  = 2,
+        /// Host interface
+        HostIf                                  = 3,
+        /// External flash and filesystem
+        Fs                                      = 4,
+        /// Beacon generation
+        Beacon                                  = 5,
+        /// Cryptography and key storage
+        Crypto                                  = 6,
+
+        /// Total number of modules
+        NumModules,
+    };
+
+    /// Level threshold for each module
+    uint8_t levels[NumModules];
+} __attribute__((packed));
+
+/**
+ * @brief "ReadLogArchive" command response
+ *
+ * Reads out the next chunk of the persistent log archive, oldest data first. The data is a
+ * sequence of binary log records (decode it with `host-log-decode`), though records may be split
+ * across chunks.
+ *
+ * The read position only advances once the read completes successfully; it's reset to the oldest
+ * data with a "ReadLogArchive" write.
+ */
+struct ReadLogArchive {
+    /// Number of bytes of archive data that follow
+    uint8_t length;
+
+    /// All archived data has been read
+    uint8_t end                                 :1{0};
+    /// The device has no log archive
+    uint8_t unavailable                         :1{0};
+    uint8_t reserved                            :6{0};
+
+    /// Number of records not archived because the archive's buffer was full (since boot)
+    uint32_t dropped;
+
+    /// Archive data
+    uint8_t data[];
+} __attribute__((packed));
+
+/**
+ * @brief "ReadLogs" command response
+ *
+ * Reads out the oldest data in the host log ring: a stream of binary log records (decode it with
+ * `host-log-decode`), which may be split across reads.
+ *
+ * Data is only removed from the ring once the read completes successfully.
+ */
+struct ReadLogs {
+    /// Number of records dropped (because the ring was full) since the last successful read
+    uint16_t dropped;
+    /// Number of bytes of log data that follow
+    uint8_t length;
+    /// Number of bytes remaining in the ring after this read (saturated to 65535)
+    uint16_t remaining;
+
+    /// Log data
+    uint8_t data[];
+} __attribute__((packed));
+
+/**
+ * @brief "GetFsStats" command response
+ *
+ * Reports counters of the filesystem on the external flash: the block cache below SPIFFS,
+ * SPIFFS' own page cache above it, and garbage collection, as well as the key/value store.
+ * Counters are since boot.
+ *
+ * Garbage collection runs not started by the maintenance task (`gcRuns - maintenanceGcRuns`)
+ * happened inside writes, and stalled them.
+ */
+struct GetFsStats {
+    /// The filesystem is mounted
+    uint8_t mounted                             :1{0};
+    uint8_t reserved                            :7{0};
+
+    /// Number of block cache lines (0 if the cache is disabled)
+    uint16_t cacheLines;
+    /// Size of a block cache line (bytes)
+    uint16_t cacheLineSize;
+    /// Block cache lines read from the cache
+    uint32_t cacheHits;
+    /// Block cache lines read from the flash
+    uint32_t cacheMisses;
+    /// Reads that bypassed the block cache
+    uint32_t cacheBypassed;
+
+    /// SPIFFS page cache hits
+    uint32_t spiffsCacheHits;
+    /// SPIFFS page cache misses
+    uint32_t spiffsCacheMisses;
+
+    /// Total number of filesystem blocks
+    uint16_t blocks;
+    /// Number of free (erased) blocks
+    uint16_t freeBlocks;
+    /// Number of pages holding deleted data, to be reclaimed
+    uint32_t deletedPages;
+    /// SPIFFS garbage collection runs
+    uint32_t gcRuns;
+    /// Garbage collection runs started by the maintenance task
+    uint32_t maintenanceGcRuns;
+    /// Blocks erased ahead of time by the maintenance task
+    uint32_t maintenanceErases;
+    /// Failed maintenance operations
+    uint32_t maintenanceErrors;
+
+    /// Number of keys in the key/value store
+    uint16_t kvKeys;
+    /// Number of free key/value store sectors (0 if there's no store)
+    uint16_t kvFreeSectors;
+    /// Key/value records written
+    uint32_t kvRecordsWritten;
+    /// Key/value store sectors compacted inside writes (which stalled them)
+    uint32_t kvForegroundCompactions;
+    /// Key/value store sectors compacted by the maintenance task
+    uint32_t kvIdleCompactions;
+    /// Damaged key/value records found
+    uint32_t kvCorruptRecords;
+} __attribute__((packed));
+};
+
+
+/**
+ * @brief Packet formats for requests sent by the host to the controller
+ */
+namespace Request {
+/**
+ * @brief "RadioConfig" command request
+ *
+ * This command is used to configure the radio PHY on the device for proper operation.
+ */
+struct RadioConfig {
+    /// Channel number to use
+    uint16_t channel;
+    /**
+     * @brief Maximum transmit power (in ⅒th of dBm) for any outgoing packets
+     *
+     * This is the power level used for multicast and broadcast frames, as well as network
+     * management frames such as beacons. Unicast communications may use a (continuously adjusted)
+     * lower transmit power.
+     */
+    uint16_t txPower;
+
+    /**
+     * @brief Radio short address
+     *
+     * 16-bit short address of the coordinator node; used for filtering of auto-ack messages and
+     * when generating internal frames.
+     */
+    uint16_t myAddress;
+} __attribute__((packed));
+
+/**
+ * @brief "TransmitPacket" command
+ *
+ * Enqueues a packet into the radio's transmit queue, which will cause it to be transmitted
+ * immediately (if radio is available) or after any pending transmissions have completed.
+ */
+struct TransmitPacket {
+    /**
+     * @brief Packet priority value
+     *
+     * Indicates the relative priority of the packet, used for queuing the packet while it's
+     * waiting for transmission.
+     *
+     * @remark Numerically _low_ values correspond to _low_ priorities, e.g. 0 is lowest.
+     */
+    uint8_t priority                            :2;
+    uint8_t reserved                            :6;
+
+    /// Packet payload data (including MAC headers)
+    uint8_t data[];
+} __attribute__((packed));
+
+/**
+ * @brief "IrqConfig" command
+ *
+ * This is the same format as the read out command.
+ */
+using IrqConfig = Response::IrqConfig;
+
+/**
+ * @brief "BeaconConfig" command
+ *
+ * Configures automatic beacon transmission. If only the first two fields are specified (that is,
+ * the command is sent such that the payload length is 0) the payload will not be altered.
+ */
+struct BeaconConfig {
+    /**
+     * @brief Update configuration
+     *
+     * When set, the basic beacon configuration is updated. This can be cleared to only update the
+     * packet payload instead of the configuration.
+     */
+    uint8_t updateConfig                        :1{0};
+
+    /**
+     * @brief Are automatic beacons enabled?
+     */
+    uint8_t enabled                             :1{0};
+
+    uint8_t reserved                            :6{0};
+
+    /**
+     * @brief Beacon interval, in ms
+     */
+    uint16_t interval;
+
+    /**
+     * @brief Beacon frame payload
+     *
+     * All data that follows here is considered part of the beacon frame.
+     */
+    uint8_t data[];
+} __attribute__((packed));
+
+/**
+ * @brief "IrqStatus" write command
+ *
+ * This is used to clear pending interrupts, and thus release the interrupt line state.
+ */
+using IrqStatus = Response::IrqStatus;
+
+/**
+ * @brief "StatusSnapshot" write command
+ *
+ * Configures the behavior of subsequent status snapshot reads. The options persist until they are
+ * written again.
+ */
+struct StatusSnapshot {
+    /**
+     * @brief Acknowledge reported interrupts on read
+     *
+     * When set, once the host has read out the entire snapshot, all interrupts it reported as
+     * pending are acknowledged and the command error flag is cleared. Interrupts raised after the
+     * snapshot was taken remain pending.
+     */
+    uint8_t ackOnRead                           :1{0};
+
+    uint8_t reserved                            :7{0};
+} __attribute__((packed));
+
+/**
+ * @brief "Batch" write command
+ *
+ * Executes several commands in a single transaction. The payload is a sequence of command
+ * headers, each immediately followed by its payload for write commands. For read commands (the
+ * high bit of the command id is set) no payload follows, and the header's payload length is the
+ * number of response bytes to capture.
+ *
+ * Commands are executed in order, and each produces a record in the batch response ring, which
+ * is read out with a "Batch" read. If the ring doesn't have space for a command's response, that
+ * command and all following it are not executed.
+ *
+ * @remark Batches may not be nested.
+ */
+struct Batch {
+    /// Command entries (a sequence of CommandHeader and payload)
+    uint8_t entries[0];
+} __attribute__((packed));
+
+/**
+ * @brief "LogLevels" write command
+ *
+ * Sets the log level threshold of each module. This is the same format as the read out command;
+ * modules whose level is 0 (or that are not included in the payload) are left unchanged.
+ */
+using LogLevels = Response::LogLevels;
+
+/**
+ * @brief "ReadLogArchive" write command
+ *
+ * Controls the archive read position.
+ */
+struct ReadLogArchive {
+    /// Move the read position back to the oldest data in the archive
+    uint8_t rewind                              :1{0};
+    uint8_t reserved                            :7{0};
+} __attribute__((packed));
+};
+}
+
+#endif